@@ -264,7 +264,6 @@ template<> struct ldlt_inplace<Lower>
   static bool unblocked(MatrixType& mat, TranspositionType& transpositions, Workspace& temp, SignMatrix& sign)
   {
     using std::abs;
-    typedef typename MatrixType::Scalar Scalar;
     typedef typename MatrixType::RealScalar RealScalar;
     typedef typename MatrixType::Index Index;
     eigen_assert(mat.rows()==mat.cols());
@@ -287,23 +286,7 @@ template<> struct ldlt_inplace<Lower>
       index_of_biggest_in_corner += k;
 
       transpositions.coeffRef(k) = index_of_biggest_in_corner;
-      if(k != index_of_biggest_in_corner)
-      {
-        // apply the transposition while taking care to consider only
-        // the lower triangular part
-        Index s = size-index_of_biggest_in_corner-1; // trailing size after the biggest element
-        mat.row(k).head(k).swap(mat.row(index_of_biggest_in_corner).head(k));
-        mat.col(k).tail(s).swap(mat.col(index_of_biggest_in_corner).tail(s));
-        std::swap(mat.coeffRef(k,k),mat.coeffRef(index_of_biggest_in_corner,index_of_biggest_in_corner));
-        for(int i=k+1;i<index_of_biggest_in_corner;++i)
-        {
-          Scalar tmp = mat.coeffRef(i,k);
-          mat.coeffRef(i,k) = numext::conj(mat.coeffRef(index_of_biggest_in_corner,i));
-          mat.coeffRef(index_of_biggest_in_corner,i) = numext::conj(tmp);
-        }
-        if(NumTraits<Scalar>::IsComplex)
-          mat.coeffRef(index_of_biggest_in_corner,k) = numext::conj(mat.coeff(index_of_biggest_in_corner,k));
-      }
+      symmetric_swap(mat, k, index_of_biggest_in_corner);
 
       // partition the matrix:
       //       A00 |  -  |  -
@@ -330,19 +313,127 @@ template<> struct ldlt_inplace<Lower>
       if((rs>0) && (abs(realAkk) > RealScalar(0)))
         A21 /= realAkk;
 
-      if (sign == PositiveSemiDef) {
-        if (realAkk < 0) sign = Indefinite;
-      } else if (sign == NegativeSemiDef) {
-        if (realAkk > 0) sign = Indefinite;
-      } else if (sign == ZeroSign) {
-        if (realAkk > 0) sign = PositiveSemiDef;
-        else if (realAkk < 0) sign = NegativeSemiDef;
-      }
+      update_sign(sign, realAkk);
+    }
+
+    return true;
+  }
+
+  /** \internal same as unblocked(), for large matrices.
+    *
+    * As the pivots are chosen among the diagonal entries of the trailing part before they are updated, they
+    * only depend on the diagonal of \a mat. The permutation is thus applied first, and the permuted matrix is
+    * factorized by panels of columns: each panel is factorized by the left-looking algorithm of unblocked(),
+    * and the trailing part is then updated by a matrix product computing only its lower triangular part.
+    */
+  template<typename MatrixType, typename TranspositionType, typename Workspace>
+  static bool blocked(MatrixType& mat, TranspositionType& transpositions, Workspace& temp, SignMatrix& sign)
+  {
+    using std::abs;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::RealScalar RealScalar;
+    typedef typename MatrixType::Index Index;
+    typedef Matrix<Scalar,Dynamic,Dynamic> WorkMatrixType;
+    eigen_assert(mat.rows()==mat.cols());
+    const Index size = mat.rows();
+
+    if(size<64)
+      return unblocked(mat, transpositions, temp, sign);
+
+    Index blockSize = size/8;
+    blockSize = (blockSize/16)*16;
+    blockSize = (std::min)((std::max)(blockSize,Index(8)), Index(128));
+
+    for (Index k = 0; k < size; ++k)
+    {
+      Index index_of_biggest_in_corner;
+      mat.diagonal().tail(size-k).cwiseAbs().maxCoeff(&index_of_biggest_in_corner);
+      index_of_biggest_in_corner += k;
+      transpositions.coeffRef(k) = index_of_biggest_in_corner;
+      symmetric_swap(mat, k, index_of_biggest_in_corner);
     }
 
+    WorkMatrixType W;
+    for (Index k = 0; k < size; k += blockSize)
+    {
+      // partition the matrix:
+      //       A00 |  -  |  -
+      // lu  = A10 | A11 |  -
+      //       A20 | A21 | A22
+      Index bs = (std::min)(blockSize, size-k);
+      Index rs = size - k - bs;
+
+      for (Index j = k; j < k+bs; ++j)
+      {
+        Index i = j - k;      // number of factorized columns of the panel
+        Index js = size-j-1;  // remaining size below the diagonal
+        Block<MatrixType,Dynamic,1> A21(mat,j+1,j,js,1);
+        Block<MatrixType,1,Dynamic> A10(mat,j,k,1,i);
+        Block<MatrixType,Dynamic,Dynamic> A20(mat,j+1,k,js,i);
+
+        if(i>0)
+        {
+          temp.head(i) = mat.diagonal().real().segment(k,i).asDiagonal() * A10.adjoint();
+          mat.coeffRef(j,j) -= (A10 * temp.head(i)).value();
+          if(js>0)
+            A21.noalias() -= A20 * temp.head(i);
+        }
+
+        RealScalar realAjj = numext::real(mat.coeffRef(j,j));
+        if((js>0) && (abs(realAjj) > RealScalar(0)))
+          A21 /= realAjj;
+        update_sign(sign, realAjj);
+      }
+
+      if(rs>0)
+      {
+        Block<MatrixType,Dynamic,Dynamic> L21(mat,k+bs,k,rs,bs);
+        Block<MatrixType,Dynamic,Dynamic> A22(mat,k+bs,k+bs,rs,rs);
+        W.noalias() = L21 * mat.diagonal().real().segment(k,bs).asDiagonal();
+        A22.template triangularView<Lower>() -= W * L21.adjoint();
+      }
+    }
     return true;
   }
 
+  /** \internal applies the symmetric transposition of the rows and columns \a k and \a p, with \a k <= \a p,
+    * to the lower triangular part of \a mat, the rows of the first \a k columns being swapped too. */
+  template<typename MatrixType>
+  static void symmetric_swap(MatrixType& mat, typename MatrixType::Index k, typename MatrixType::Index p)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::Index Index;
+    if(k == p)
+      return;
+    // apply the transposition while taking care to consider only
+    // the lower triangular part
+    Index s = mat.rows()-p-1; // trailing size after the biggest element
+    mat.row(k).head(k).swap(mat.row(p).head(k));
+    mat.col(k).tail(s).swap(mat.col(p).tail(s));
+    std::swap(mat.coeffRef(k,k),mat.coeffRef(p,p));
+    for(Index i=k+1;i<p;++i)
+    {
+      Scalar tmp = mat.coeffRef(i,k);
+      mat.coeffRef(i,k) = numext::conj(mat.coeffRef(p,i));
+      mat.coeffRef(p,i) = numext::conj(tmp);
+    }
+    if(NumTraits<Scalar>::IsComplex)
+      mat.coeffRef(p,k) = numext::conj(mat.coeff(p,k));
+  }
+
+  template<typename RealScalar>
+  static void update_sign(SignMatrix& sign, const RealScalar& realAkk)
+  {
+    if (sign == PositiveSemiDef) {
+      if (realAkk < 0) sign = Indefinite;
+    } else if (sign == NegativeSemiDef) {
+      if (realAkk > 0) sign = Indefinite;
+    } else if (sign == ZeroSign) {
+      if (realAkk > 0) sign = PositiveSemiDef;
+      else if (realAkk < 0) sign = NegativeSemiDef;
+    }
+  }
+
   // Reference for the algorithm: Davis and Hager, "Multiple Rank
   // Modifications of a Sparse Cholesky Factorization" (Algorithm 1)
   // Trivial rearrangements of their computations (Timothy E. Holy)
@@ -408,6 +499,13 @@ template<> struct ldlt_inplace<Upper>
     return ldlt_inplace<Lower>::unblocked(matt, transpositions, temp, sign);
   }
 
+  template<typename MatrixType, typename TranspositionType, typename Workspace>
+  static EIGEN_STRONG_INLINE bool blocked(MatrixType& mat, TranspositionType& transpositions, Workspace& temp, SignMatrix& sign)
+  {
+    Transpose<MatrixType> matt(mat);
+    return ldlt_inplace<Lower>::blocked(matt, transpositions, temp, sign);
+  }
+
   template<typename MatrixType, typename TranspositionType, typename Workspace, typename WType>
   static EIGEN_STRONG_INLINE bool update(MatrixType& mat, TranspositionType& transpositions, Workspace& tmp, WType& w, const typename MatrixType::RealScalar& sigma=1)
   {
@@ -451,7 +549,7 @@ LDLT<MatrixType,_UpLo>& LDLT<MatrixType,_UpLo>::compute(const MatrixType& a)
   m_temporary.resize(size);
   m_sign = internal::ZeroSign;
 
-  internal::ldlt_inplace<UpLo>::unblocked(m_matrix, m_transpositions, m_temporary, m_sign);
+  internal::ldlt_inplace<UpLo>::blocked(m_matrix, m_transpositions, m_temporary, m_sign);
 
   m_isInitialized = true;
   return *this;
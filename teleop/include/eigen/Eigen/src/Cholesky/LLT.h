@@ -307,6 +307,15 @@ template<typename Scalar> struct llt_inplace<Scalar, Lower>
     blockSize = (blockSize/16)*16;
     blockSize = (std::min)((std::max)(blockSize,Index(8)), Index(128));
 
+#ifdef EIGEN_HAS_OPENMP
+    // do not create nested parallel regions, and require enough tiles per thread
+    Index threads = 1;
+    if(omp_get_num_threads()==1 && size>=256)
+      threads = (std::min)(Index(nbThreads()), size/blockSize-1);
+    if(threads>1)
+      return tiled(m, blockSize, threads);
+#endif
+
     for (Index k=0; k<size; k+=blockSize)
     {
       // partition the matrix:
@@ -327,6 +336,85 @@ template<typename Scalar> struct llt_inplace<Scalar, Lower>
     return -1;
   }
 
+  /** \internal factorizes the tile column [\a k, \a k + \a bs) of \a m: the diagonal tile A11 = L11 L11^*,
+    * and then the tiles below it L21 = A21 L11^-*. \returns the index of the first non positive pivot or -1. */
+  template<typename MatrixType>
+  static typename MatrixType::Index factorize_tile_column(MatrixType& m, typename MatrixType::Index k, typename MatrixType::Index bs)
+  {
+    typedef typename MatrixType::Index Index;
+    Index rs = m.rows() - k - bs;
+    Block<MatrixType,Dynamic,Dynamic> A11(m,k,   k,bs,bs);
+    Block<MatrixType,Dynamic,Dynamic> A21(m,k+bs,k,rs,bs);
+
+    Index ret;
+    if((ret=unblocked(A11))>=0) return k+ret;
+    if(rs>0) A11.adjoint().template triangularView<Upper>().template solveInPlace<OnTheRight>(A21);
+    return -1;
+  }
+
+  /** \internal updates the tile column [\a j, \a j + \a cs) of \a m with the factorized tile column [\a k, \a k + \a bs):
+    * the diagonal tile by a rank update, and the tiles below it by a matrix product. */
+  template<typename MatrixType>
+  static void update_tile_column(MatrixType& m, typename MatrixType::Index k, typename MatrixType::Index bs,
+                                 typename MatrixType::Index j, typename MatrixType::Index cs)
+  {
+    typedef typename MatrixType::Index Index;
+    Index rs = m.rows() - j - cs;
+    Block<MatrixType,Dynamic,Dynamic> Ljk(m,j,   k,cs,bs);
+    Block<MatrixType,Dynamic,Dynamic> Ajj(m,j,   j,cs,cs);
+    Ajj.template selfadjointView<Lower>().rankUpdate(Ljk,-1);
+    if(rs>0)
+    {
+      Block<MatrixType,Dynamic,Dynamic> Lrk(m,j+cs,k,rs,bs);
+      Block<MatrixType,Dynamic,Dynamic> Arj(m,j+cs,j,rs,cs);
+      Arj.noalias() -= Lrk * Ljk.adjoint();
+    }
+  }
+
+#ifdef EIGEN_HAS_OPENMP
+  /** \internal performs the blocked factorization of \a m on \a threads threads. The matrix is split into
+    * tile columns of \a blockSize columns. At each step, the first thread updates the next tile column and
+    * factorizes it (look-ahead), while the other threads update the remaining tile columns. The factorization
+    * of the diagonal tiles and the triangular solves, which are sequential, are thus overlapped with the
+    * rank updates and the matrix products of the trailing tiles.
+    */
+  template<typename MatrixType>
+  static typename MatrixType::Index tiled(MatrixType& m, typename MatrixType::Index blockSize, typename MatrixType::Index threads)
+  {
+    typedef typename MatrixType::Index Index;
+    Index size = m.rows();
+    Index ret = factorize_tile_column(m, 0, (std::min)(blockSize, size));
+    for (Index k=0; k<size && ret<0; k+=blockSize)
+    {
+      Index bs = (std::min)(blockSize, size-k);
+      Index rs = size - k - bs;
+      if(rs==0) break;
+      Index nbs = (std::min)(blockSize, rs);
+      Index tiles = (rs+blockSize-1)/blockSize;
+
+      #pragma omp parallel num_threads(int(threads))
+      {
+        Index t = omp_get_thread_num(), workers = (std::max)(omp_get_num_threads()-1, 1);
+        if(t==0)
+        {
+          update_tile_column(m, k, bs, k+bs, nbs);
+          ret = factorize_tile_column(m, k+bs, nbs);
+        }
+        if(t>0 || omp_get_num_threads()==1)
+        {
+          // the remaining tile columns are distributed cyclically, since their height decreases
+          for(Index i=1+(t>0?t-1:0); i<tiles; i+=workers)
+          {
+            Index j = k + bs + i*blockSize;
+            update_tile_column(m, k, bs, j, (std::min)(blockSize, size-j));
+          }
+        }
+      }
+    }
+    return ret;
+  }
+#endif
+
   template<typename MatrixType, typename VectorType>
   static typename MatrixType::Index rankUpdate(MatrixType& mat, const VectorType& vec, const RealScalar& sigma)
   {
@@ -272,6 +272,8 @@ template<typename Derived> class DenseBase
 
     CommaInitializer<Derived> operator<< (const Scalar& s);
 
+    ParallelAssign<Derived> parallel();
+
     template<unsigned int Added,unsigned int Removed>
     const Flagged<Derived, Added, Removed> flagged() const;
 
@@ -148,6 +148,37 @@ pxor(const Packet& a, const Packet& b) { return a ^ b; }
 template<typename Packet> inline Packet
 pandnot(const Packet& a, const Packet& b) { return a & (!b); }
 
+/** \internal \returns a packet whose bits are all set if \a b is true, and all cleared otherwise */
+template<typename Packet> inline Packet
+pmask(bool b) { Packet res; std::memset(&res, b ? 0xff : 0, sizeof(Packet)); return res; }
+
+/** \internal \returns a mask with all the bits of a coefficient set where a < b, and cleared elsewhere (coeff-wise) */
+template<typename Packet> inline Packet
+pcmp_lt(const Packet& a, const Packet& b) { return pmask<Packet>(a<b); }
+
+/** \internal \returns a mask with all the bits of a coefficient set where a <= b, and cleared elsewhere (coeff-wise) */
+template<typename Packet> inline Packet
+pcmp_le(const Packet& a, const Packet& b) { return pmask<Packet>(a<=b); }
+
+/** \internal \returns a mask with all the bits of a coefficient set where a == b, and cleared elsewhere (coeff-wise) */
+template<typename Packet> inline Packet
+pcmp_eq(const Packet& a, const Packet& b) { return pmask<Packet>(a==b); }
+
+/** \internal \returns the coefficients of \a a where \a mask is set, and those of \a b elsewhere.
+  * \a mask must be the result of one of the pcmp_* functions. */
+template<typename Packet> inline Packet
+pselect(const Packet& mask, const Packet& a, const Packet& b)
+{
+  Packet res;
+  const unsigned char* m = reinterpret_cast<const unsigned char*>(&mask);
+  const unsigned char* pa = reinterpret_cast<const unsigned char*>(&a);
+  const unsigned char* pb = reinterpret_cast<const unsigned char*>(&b);
+  unsigned char* r = reinterpret_cast<unsigned char*>(&res);
+  for(std::size_t i=0; i<sizeof(Packet); ++i)
+    r[i] = (unsigned char)((m[i] & pa[i]) | (~m[i] & pb[i]));
+  return res;
+}
+
 /** \internal \returns a packet version of \a *from, from must be 16 bytes aligned */
 template<typename Packet> inline Packet
 pload(const typename unpacket_traits<Packet>::type* from) { return *from; }
@@ -0,0 +1,199 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_PARALLEL_ASSIGN_H
+#define EIGEN_PARALLEL_ASSIGN_H
+
+/** \internal Minimal number of coefficients assigned by each thread of ParallelAssign.
+  * Expressions having less than twice this number of coefficients are assigned serially. */
+#ifndef EIGEN_PARALLEL_ASSIGN_THRESHOLD
+#define EIGEN_PARALLEL_ASSIGN_THRESHOLD 65536
+#endif
+
+namespace Eigen {
+
+namespace internal {
+
+struct parallel_assign_op
+{
+  template<typename Dst, typename Src> void operator()(Dst& dst, const Src& src) const { dst.lazyAssign(src); }
+};
+
+struct parallel_add_assign_op
+{
+  template<typename Dst, typename Src> void operator()(Dst& dst, const Src& src) const { dst += src; }
+};
+
+struct parallel_sub_assign_op
+{
+  template<typename Dst, typename Src> void operator()(Dst& dst, const Src& src) const { dst -= src; }
+};
+
+/** \internal \returns the number of threads assigning an expression of \a size coefficients */
+inline DenseIndex parallel_assign_threads(DenseIndex size)
+{
+#ifdef EIGEN_HAS_OPENMP
+  // do not create nested parallel regions
+  if(omp_get_num_threads()>1)
+    return 1;
+  return (std::max)(DenseIndex(1), (std::min)(DenseIndex(nbThreads()), size/DenseIndex(EIGEN_PARALLEL_ASSIGN_THRESHOLD)));
+#else
+  EIGEN_UNUSED_VARIABLE(size);
+  return 1;
+#endif
+}
+
+/** \internal Applies \a func to \a threads pairs of matching blocks of \a dst and \a src, in parallel.
+  * When there are enough inner vectors, each thread gets a range of whole inner vectors.
+  * Otherwise the inner vectors are cut into ranges whose lengths are multiples of 64 bytes. These ranges
+  * keep the alignment of the vectorized traversals, but they are measured from the start of the inner
+  * vectors, which are not necessarily aligned on a cache line: the neighbouring threads may still share
+  * a cache line at each split point, such that the false sharing is only reduced. */
+template<typename Dst, typename Src, typename Func>
+void parallel_assign_impl(Dst& dst, const Src& src, DenseIndex threads, const Func& func)
+{
+  typedef typename Dst::Index Index;
+  typedef typename Dst::Scalar Scalar;
+  enum {
+    IsRowMajor = Dst::IsRowMajor,
+    CacheLine = sizeof(Scalar)<64 ? 64/sizeof(Scalar) : 1
+  };
+  eigen_assert(dst.rows()==src.rows() && dst.cols()==src.cols());
+  const Index outerSize = dst.outerSize(), innerSize = dst.innerSize();
+  const bool splitOuter = outerSize >= 4*threads;
+  const Index chunks = splitOuter ? outerSize : (innerSize+CacheLine-1)/CacheLine;
+
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for num_threads(int(threads)) schedule(static,1)
+#endif
+  for(DenseIndex t=0; t<threads; ++t)
+  {
+    const Index start = Index((chunks*t)/threads), end = Index((chunks*(t+1))/threads);
+    if(start==end)
+      continue;
+    Index outerStart = 0, outerLength = outerSize, innerStart = 0, innerLength = innerSize;
+    if(splitOuter)
+    {
+      outerStart = start;
+      outerLength = end-start;
+    }
+    else
+    {
+      innerStart = start*CacheLine;
+      innerLength = (std::min)(end*CacheLine, innerSize) - innerStart;
+    }
+    const Index row = IsRowMajor ? outerStart : innerStart, col = IsRowMajor ? innerStart : outerStart;
+    const Index rows = IsRowMajor ? outerLength : innerLength, cols = IsRowMajor ? innerLength : outerLength;
+    Block<Dst> dstBlock(dst, row, col, rows, cols);
+    func(dstBlock, src.block(row, col, rows, cols));
+  }
+}
+
+} // end namespace internal
+
+/** \class ParallelAssign
+  * \ingroup Core_Module
+  *
+  * \brief Pseudo expression providing assignment operators evaluated by several threads
+  *
+  * \param ExpressionType the type of the object on which to do the assignment
+  *
+  * This class represents an expression with special assignment operators splitting the
+  * destination into one block per thread, each block being assigned with the usual, possibly
+  * vectorized, traversals. It is the return type of DenseBase::parallel()
+  * and most of the time this is the only way it is used.
+  *
+  * \sa DenseBase::parallel()
+  */
+template<typename ExpressionType>
+class ParallelAssign
+{
+  public:
+    ParallelAssign(ExpressionType& expression) : m_expression(expression) {}
+
+    /** Behaves like DenseBase::operator=(other) */
+    template<typename OtherDerived>
+    ExpressionType& operator=(const DenseBase<OtherDerived>& other)
+    {
+      const DenseIndex threads = internal::parallel_assign_threads(other.size());
+      if(threads==1)
+        return m_expression = other.derived();
+      m_expression.resize(other.rows(), other.cols());
+      return run(other.derived(), threads, internal::parallel_assign_op());
+    }
+
+    /** Behaves like DenseBase::operator+=(other) */
+    template<typename OtherDerived>
+    ExpressionType& operator+=(const DenseBase<OtherDerived>& other)
+    {
+      const DenseIndex threads = internal::parallel_assign_threads(other.size());
+      if(threads==1)
+        return m_expression += other.derived();
+      return run(other.derived(), threads, internal::parallel_add_assign_op());
+    }
+
+    /** Behaves like DenseBase::operator-=(other) */
+    template<typename OtherDerived>
+    ExpressionType& operator-=(const DenseBase<OtherDerived>& other)
+    {
+      const DenseIndex threads = internal::parallel_assign_threads(other.size());
+      if(threads==1)
+        return m_expression -= other.derived();
+      return run(other.derived(), threads, internal::parallel_sub_assign_op());
+    }
+
+    ExpressionType& expression() const
+    {
+      return m_expression;
+    }
+
+  protected:
+    template<typename OtherDerived, typename Func>
+    ExpressionType& run(const OtherDerived& other, DenseIndex threads, const Func& func)
+    {
+      // products and other expressions which must be evaluated before being nested are evaluated first
+      typedef typename internal::nested<OtherDerived>::type OtherNested;
+      typedef typename internal::remove_all<OtherNested>::type _OtherNested;
+      OtherNested otherNested(other);
+      internal::parallel_assign_impl(m_expression, static_cast<const _OtherNested&>(otherNested), threads, func);
+      return m_expression;
+    }
+
+    ExpressionType& m_expression;
+};
+
+/** \returns a pseudo expression of \c *this whose assignment operators are evaluated by several threads.
+  *
+  * This is meant for large coefficient-wise expressions, which are otherwise evaluated by a single thread:
+  * \code
+  * image.parallel() = (a * image + b * background).max(0);
+  * x.parallel() += dt * v;
+  * \endcode
+  * The destination is split into one block per thread, made of whole columns (or rows), or of pieces
+  * of columns whose lengths are multiples of a cache line when there are only a few columns. The threads are the
+  * ones of OpenMP, in the limit set by setNbThreads(). Expressions having less than
+  * 2 * \c EIGEN_PARALLEL_ASSIGN_THRESHOLD coefficients, or assigned from within a parallel region,
+  * are assigned serially as with the usual operators.
+  *
+  * As for lazyAssign(), each coefficient of the source must only depend on the coefficients of
+  * the destination of the same index. Expressions which can alias otherwise, such as
+  * \code
+  * A.parallel() = A.transpose();
+  * \endcode
+  * lead to a \b wrong result. Matrix products are first evaluated into a temporary.
+  *
+  * \sa class ParallelAssign, setNbThreads()
+  */
+template<typename Derived>
+ParallelAssign<Derived> DenseBase<Derived>::parallel()
+{
+  return derived();
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_PARALLEL_ASSIGN_H
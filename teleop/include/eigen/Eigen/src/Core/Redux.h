@@ -11,6 +11,12 @@
 #ifndef EIGEN_REDUX_H
 #define EIGEN_REDUX_H
 
+/** \internal Minimal number of coefficients reduced by each thread by the vectorized reductions.
+  * Smaller vectors are reduced serially. */
+#ifndef EIGEN_PARALLEL_REDUX_THRESHOLD
+#define EIGEN_PARALLEL_REDUX_THRESHOLD 262144
+#endif
+
 namespace Eigen { 
 
 namespace internal {
@@ -189,6 +195,126 @@ struct redux_impl<Func,Derived, DefaultTraversal, CompleteUnrolling>
   : public redux_novec_unroller<Func,Derived, 0, Derived::SizeAtCompileTime>
 {};
 
+/** \internal Blocked pairwise reduction of the \a packets packets of \a mat starting at \a start.
+  * Ranges of up to \c LeafPackets packets are reduced linearly with four independent accumulators,
+  * and larger ranges are cut in two halves whose results are combined. For a sum, the rounding
+  * errors thus grow with the logarithm of the size rather than linearly.
+  * The tree only depends on the size, which makes the result independent of the number of threads. */
+template<typename Func, typename Derived, int Alignment>
+struct redux_pairwise
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename packet_traits<Scalar>::type PacketScalar;
+  typedef typename Derived::Index Index;
+  enum {
+    PacketSize = packet_traits<Scalar>::size,
+    LeafPackets = 128,
+    MaxNodes = 64
+  };
+
+  static Index leftPackets(Index packets)
+  {
+    return ((packets+LeafPackets-1)/LeafPackets/2)*LeafPackets;
+  }
+
+  static PacketScalar leaf(const Derived& mat, const Func& func, Index start, Index packets)
+  {
+    PacketScalar p0 = mat.template packet<Alignment>(start);
+    Index k = 1;
+    if(packets>=4)
+    {
+      PacketScalar p1 = mat.template packet<Alignment>(start+PacketSize);
+      PacketScalar p2 = mat.template packet<Alignment>(start+2*PacketSize);
+      PacketScalar p3 = mat.template packet<Alignment>(start+3*PacketSize);
+      for(k=4; k+4<=packets; k+=4)
+      {
+        const Index index = start + k*PacketSize;
+        p0 = func.packetOp(p0, mat.template packet<Alignment>(index));
+        p1 = func.packetOp(p1, mat.template packet<Alignment>(index+PacketSize));
+        p2 = func.packetOp(p2, mat.template packet<Alignment>(index+2*PacketSize));
+        p3 = func.packetOp(p3, mat.template packet<Alignment>(index+3*PacketSize));
+      }
+      p0 = func.packetOp(func.packetOp(p0,p1), func.packetOp(p2,p3));
+    }
+    for(; k<packets; ++k)
+      p0 = func.packetOp(p0, mat.template packet<Alignment>(start+k*PacketSize));
+    return p0;
+  }
+
+  static PacketScalar run(const Derived& mat, const Func& func, Index start, Index packets)
+  {
+    if(packets<=LeafPackets)
+      return leaf(mat, func, start, packets);
+    const Index left = leftPackets(packets);
+    return func.packetOp(run(mat, func, start, left), run(mat, func, start+left*PacketSize, packets-left));
+  }
+
+  // collects the nodes of the tree at the given depth, or the leaves above it
+  static void nodes(Index start, Index packets, int depth, Index* starts, Index* sizes, int& count)
+  {
+    if(depth==0 || packets<=LeafPackets)
+    {
+      starts[count] = start;
+      sizes[count] = packets;
+      ++count;
+      return;
+    }
+    const Index left = leftPackets(packets);
+    nodes(start, left, depth-1, starts, sizes, count);
+    nodes(start+left*PacketSize, packets-left, depth-1, starts, sizes, count);
+  }
+
+  // combines the results of the nodes collected by nodes() in the order of the tree
+  static PacketScalar combine(const Func& func, Index packets, int depth, const PacketScalar* results, int& k)
+  {
+    if(depth==0 || packets<=LeafPackets)
+      return results[k++];
+    const Index left = leftPackets(packets);
+    PacketScalar l = combine(func, left, depth-1, results, k);
+    PacketScalar r = combine(func, packets-left, depth-1, results, k);
+    return func.packetOp(l, r);
+  }
+
+  static PacketScalar run(const Derived& mat, const Func& func, Index start, Index packets, Index threads)
+  {
+#ifdef EIGEN_HAS_OPENMP
+    if(threads>1)
+    {
+      // the top of the tree is cut into at least one node per thread
+      int depth = 0;
+      while((1<<depth)<threads && (2<<depth)<=MaxNodes)
+        ++depth;
+      Index starts[MaxNodes], sizes[MaxNodes];
+      PacketScalar results[MaxNodes];
+      int count = 0;
+      nodes(start, packets, depth, starts, sizes, count);
+      #pragma omp parallel for num_threads(int(threads)) schedule(dynamic,1)
+      for(int i=0; i<count; ++i)
+        results[i] = run(mat, func, starts[i], sizes[i]);
+      int k = 0;
+      return combine(func, packets, depth, results, k);
+    }
+#else
+    EIGEN_UNUSED_VARIABLE(threads);
+#endif
+    return run(mat, func, start, packets);
+  }
+};
+
+/** \internal \returns the number of threads reducing an expression of \a size coefficients */
+inline DenseIndex redux_threads(DenseIndex size)
+{
+#ifdef EIGEN_HAS_OPENMP
+  // do not create nested parallel regions
+  if(omp_get_num_threads()>1)
+    return 1;
+  return (std::max)(DenseIndex(1), (std::min)(DenseIndex(nbThreads()), size/DenseIndex(EIGEN_PARALLEL_REDUX_THRESHOLD)));
+#else
+  EIGEN_UNUSED_VARIABLE(size);
+  return 1;
+#endif
+}
+
 template<typename Func, typename Derived>
 struct redux_impl<Func, Derived, LinearVectorizedTraversal, NoUnrolling>
 {
@@ -206,28 +332,12 @@ struct redux_impl<Func, Derived, LinearVectorizedTraversal, NoUnrolling>
       alignment = bool(Derived::Flags & DirectAccessBit) || bool(Derived::Flags & AlignedBit)
                 ? Aligned : Unaligned
     };
-    const Index alignedSize2 = ((size-alignedStart)/(2*packetSize))*(2*packetSize);
     const Index alignedSize = ((size-alignedStart)/(packetSize))*(packetSize);
-    const Index alignedEnd2 = alignedStart + alignedSize2;
     const Index alignedEnd  = alignedStart + alignedSize;
     Scalar res;
     if(alignedSize)
     {
-      PacketScalar packet_res0 = mat.template packet<alignment>(alignedStart);
-      if(alignedSize>packetSize) // we have at least two packets to partly unroll the loop
-      {
-        PacketScalar packet_res1 = mat.template packet<alignment>(alignedStart+packetSize);
-        for(Index index = alignedStart + 2*packetSize; index < alignedEnd2; index += 2*packetSize)
-        {
-          packet_res0 = func.packetOp(packet_res0, mat.template packet<alignment>(index));
-          packet_res1 = func.packetOp(packet_res1, mat.template packet<alignment>(index+packetSize));
-        }
-
-        packet_res0 = func.packetOp(packet_res0,packet_res1);
-        if(alignedEnd>alignedEnd2)
-          packet_res0 = func.packetOp(packet_res0, mat.template packet<alignment>(alignedEnd2));
-      }
-      res = func.predux(packet_res0);
+      res = func.predux(redux_pairwise<Func, Derived, alignment>::run(mat, func, alignedStart, alignedSize/packetSize, redux_threads(size)));
 
       for(Index index = 0; index < alignedStart; ++index)
         res = func(res,mat.coeff(index));
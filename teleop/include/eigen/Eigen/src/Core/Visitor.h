@@ -162,6 +162,196 @@ struct functor_traits<max_coeff_visitor<Scalar> > {
   };
 };
 
+/** \internal
+  * \brief Vectorized search of the min (or max) coefficient of a linearly accessible expression and of its index
+  *
+  * The packets are reduced by blocks of \c BlockPackets packets with pmin (or pmax). After each block, the lanes
+  * where the block improves on the best values found so far are updated with a compare and a blend, together with
+  * the index of the block. The first occurrence of the result is finally found by scanning a single block.
+  * The expressions holding NaNs or infinities, which are detected while reducing the packets, are searched with scalars.
+  */
+template<typename Derived, bool IsMax>
+struct minmax_coeff_vectorized
+{
+  typedef typename Derived::Index Index;
+  typedef typename Derived::Scalar Scalar;
+  typedef typename packet_traits<Scalar>::type Packet;
+  enum {
+    PacketSize = packet_traits<Scalar>::size,
+    BlockPackets = 32,
+    BlockSize = BlockPackets * PacketSize,
+    Alignment = bool(Derived::Flags & DirectAccessBit) || bool(Derived::Flags & AlignedBit) ? Aligned : Unaligned,
+    Vectorize = (int(Derived::Flags)&ActualPacketAccessBit) && (int(Derived::Flags)&LinearAccessBit)
+             && !NumTraits<Scalar>::IsComplex && packet_traits<Scalar>::HasMin && packet_traits<Scalar>::HasMax
+             && (Derived::SizeAtCompileTime==Dynamic || Derived::SizeAtCompileTime>=2*BlockSize)
+             // the linear order must be the column-major order of the visitors, which resolves the ties
+             && (!int(Derived::IsRowMajor) || Derived::RowsAtCompileTime==1 || Derived::ColsAtCompileTime==1)
+  };
+
+  static inline bool better(const Scalar& a, const Scalar& b) { return IsMax ? b<a : a<b; }
+  static inline Packet pbest(const Packet& a, const Packet& b) { return IsMax ? pmax(a,b) : pmin(a,b); }
+
+  // reduces a block of packets, and accumulates p-p into finite, which stays zero if all the coefficients are finite
+  static inline Packet block(const Derived& mat, Index start, Index packets, Packet& finite)
+  {
+    Packet p0 = mat.template packet<Alignment>(start);
+    finite = padd(finite, psub(p0,p0));
+    Index k = 1;
+    if(packets>=4)
+    {
+      Packet p1 = mat.template packet<Alignment>(start+PacketSize);
+      Packet p2 = mat.template packet<Alignment>(start+2*PacketSize);
+      Packet p3 = mat.template packet<Alignment>(start+3*PacketSize);
+      Packet f0 = psub(p1,p1), f1 = psub(p2,p2), f2 = psub(p3,p3);
+      for(k=4; k+4<=packets; k+=4)
+      {
+        const Index index = start + k*PacketSize;
+        const Packet q0 = mat.template packet<Alignment>(index);
+        const Packet q1 = mat.template packet<Alignment>(index+PacketSize);
+        const Packet q2 = mat.template packet<Alignment>(index+2*PacketSize);
+        const Packet q3 = mat.template packet<Alignment>(index+3*PacketSize);
+        f0 = padd(f0, psub(q0,q0));
+        f1 = padd(f1, psub(q1,q1));
+        f2 = padd(f2, psub(q2,q2));
+        finite = padd(finite, psub(q3,q3));
+        p0 = pbest(p0, q0);
+        p1 = pbest(p1, q1);
+        p2 = pbest(p2, q2);
+        p3 = pbest(p3, q3);
+      }
+      p0 = pbest(pbest(p0,p1), pbest(p2,p3));
+      finite = padd(finite, padd(f0, padd(f1, f2)));
+    }
+    for(; k<packets; ++k)
+    {
+      const Packet q = mat.template packet<Alignment>(start+k*PacketSize);
+      finite = padd(finite, psub(q,q));
+      p0 = pbest(p0, q);
+    }
+    return p0;
+  }
+
+  // scalar search of the first best coefficient in [start,end)
+  static inline Index scalar(const Derived& mat, Index start, Index end, Scalar& res)
+  {
+    Index index = start;
+    res = mat.coeff(start);
+    for(Index i = start+1; i < end; ++i)
+    {
+      if(better(mat.coeff(i), res))
+      {
+        res = mat.coeff(i);
+        index = i;
+      }
+    }
+    return index;
+  }
+
+  static Index run(const Derived& mat, Scalar& res)
+  {
+    const Index size = mat.size();
+    eigen_assert(size>0 && "you are using an empty matrix");
+    const Index alignedStart = internal::first_aligned(mat);
+    const Index packets = (size-alignedStart)/PacketSize;
+    const Index alignedEnd = alignedStart + packets*PacketSize;
+    const Index blocks = (packets+BlockPackets-1)/BlockPackets;
+    // the block indices must be exactly representable by a Scalar
+    const Index maxBlocks = Index(1) << (std::min)(std::numeric_limits<Scalar>::digits, 30);
+    if(packets<2*BlockPackets || blocks>=maxBlocks)
+      return scalar(mat, 0, size, res);
+
+    Packet finite = pset1<Packet>(Scalar(0));
+    Packet best = block(mat, alignedStart, BlockPackets, finite);
+    Packet bestBlock = pset1<Packet>(Scalar(0));
+    for(Index b = 1; b < blocks; ++b)
+    {
+      const Packet p = block(mat, alignedStart + b*BlockSize, (std::min)(Index(BlockPackets), packets-b*BlockPackets), finite);
+      const Packet mask = IsMax ? pcmp_lt(best, p) : pcmp_lt(p, best);
+      best = pselect(mask, p, best);
+      bestBlock = pselect(mask, pset1<Packet>(Scalar(b)), bestBlock);
+    }
+    // pmin and pmax do not order NaNs like the comparisons of the visitors
+    if(predux(finite)!=Scalar(0))
+      return scalar(mat, 0, size, res);
+
+    // among the lanes holding the result, the one with the smallest block index gives the first occurrence
+    EIGEN_ALIGN16 Scalar values[PacketSize];
+    EIGEN_ALIGN16 Scalar blockIds[PacketSize];
+    pstore(values, best);
+    pstore(blockIds, bestBlock);
+    res = values[0];
+    Scalar b = blockIds[0];
+    for(int l = 1; l < PacketSize; ++l)
+    {
+      if(better(values[l], res) || (values[l]==res && blockIds[l]<b))
+      {
+        res = values[l];
+        b = blockIds[l];
+      }
+    }
+    Index index = alignedStart + Index(b)*BlockSize;
+    const Index blockEnd = (std::min)(index + Index(BlockSize), alignedEnd);
+    while(index<blockEnd && mat.coeff(index)!=res)
+      ++index;
+    if(res!=res || index==blockEnd)
+      return scalar(mat, 0, size, res);
+
+    // the unaligned head comes first and the remaining tail last
+    if(alignedStart>0)
+    {
+      Scalar headRes;
+      const Index headIndex = scalar(mat, 0, alignedStart, headRes);
+      if(!better(res, headRes))
+      {
+        res = headRes;
+        index = headIndex;
+      }
+    }
+    for(Index i = alignedEnd; i < size; ++i)
+    {
+      if(better(mat.coeff(i), res))
+      {
+        res = mat.coeff(i);
+        index = i;
+      }
+    }
+    return index;
+  }
+};
+
+/** \internal Computes the min (or max) coefficient of \a mat and its location, with a visitor,
+  * or with minmax_coeff_vectorized for large vectorizable column-major expressions and vectors */
+template<typename Derived, bool IsMax, bool Vectorize = minmax_coeff_vectorized<Derived,IsMax>::Vectorize>
+struct minmax_coeff_selector
+{
+  typedef typename Derived::Index Index;
+  typedef typename Derived::Scalar Scalar;
+  static inline Scalar run(const Derived& mat, Index& row, Index& col)
+  {
+    typedef typename conditional<IsMax, max_coeff_visitor<Derived>, min_coeff_visitor<Derived> >::type Visitor;
+    Visitor visitor;
+    mat.visit(visitor);
+    row = visitor.row;
+    col = visitor.col;
+    return visitor.res;
+  }
+};
+
+template<typename Derived, bool IsMax>
+struct minmax_coeff_selector<Derived, IsMax, true>
+{
+  typedef typename Derived::Index Index;
+  typedef typename Derived::Scalar Scalar;
+  static inline Scalar run(const Derived& mat, Index& row, Index& col)
+  {
+    Scalar res;
+    const Index index = minmax_coeff_vectorized<Derived,IsMax>::run(mat, res);
+    row = index % mat.rows();
+    col = index / mat.rows();
+    return res;
+  }
+};
+
 } // end namespace internal
 
 /** \returns the minimum of all coefficients of *this and puts in *row and *col its location.
@@ -174,11 +364,11 @@ template<typename IndexType>
 typename internal::traits<Derived>::Scalar
 DenseBase<Derived>::minCoeff(IndexType* rowId, IndexType* colId) const
 {
-  internal::min_coeff_visitor<Derived> minVisitor;
-  this->visit(minVisitor);
-  *rowId = minVisitor.row;
-  if (colId) *colId = minVisitor.col;
-  return minVisitor.res;
+  Index row, col;
+  Scalar res = internal::minmax_coeff_selector<Derived,false>::run(derived(), row, col);
+  *rowId = row;
+  if (colId) *colId = col;
+  return res;
 }
 
 /** \returns the minimum of all coefficients of *this and puts in *index its location.
@@ -192,10 +382,10 @@ typename internal::traits<Derived>::Scalar
 DenseBase<Derived>::minCoeff(IndexType* index) const
 {
   EIGEN_STATIC_ASSERT_VECTOR_ONLY(Derived)
-  internal::min_coeff_visitor<Derived> minVisitor;
-  this->visit(minVisitor);
-  *index = (RowsAtCompileTime==1) ? minVisitor.col : minVisitor.row;
-  return minVisitor.res;
+  Index row, col;
+  Scalar res = internal::minmax_coeff_selector<Derived,false>::run(derived(), row, col);
+  *index = (RowsAtCompileTime==1) ? col : row;
+  return res;
 }
 
 /** \returns the maximum of all coefficients of *this and puts in *row and *col its location.
@@ -208,11 +398,11 @@ template<typename IndexType>
 typename internal::traits<Derived>::Scalar
 DenseBase<Derived>::maxCoeff(IndexType* rowPtr, IndexType* colPtr) const
 {
-  internal::max_coeff_visitor<Derived> maxVisitor;
-  this->visit(maxVisitor);
-  *rowPtr = maxVisitor.row;
-  if (colPtr) *colPtr = maxVisitor.col;
-  return maxVisitor.res;
+  Index row, col;
+  Scalar res = internal::minmax_coeff_selector<Derived,true>::run(derived(), row, col);
+  *rowPtr = row;
+  if (colPtr) *colPtr = col;
+  return res;
 }
 
 /** \returns the maximum of all coefficients of *this and puts in *index its location.
@@ -226,10 +416,10 @@ typename internal::traits<Derived>::Scalar
 DenseBase<Derived>::maxCoeff(IndexType* index) const
 {
   EIGEN_STATIC_ASSERT_VECTOR_ONLY(Derived)
-  internal::max_coeff_visitor<Derived> maxVisitor;
-  this->visit(maxVisitor);
-  *index = (RowsAtCompileTime==1) ? maxVisitor.col : maxVisitor.row;
-  return maxVisitor.res;
+  Index row, col;
+  Scalar res = internal::minmax_coeff_selector<Derived,true>::run(derived(), row, col);
+  *index = (RowsAtCompileTime==1) ? col : row;
+  return res;
 }
 
 } // end namespace Eigen
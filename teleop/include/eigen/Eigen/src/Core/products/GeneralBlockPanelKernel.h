@@ -54,6 +54,60 @@ inline void manage_caching_sizes(Action action, std::ptrdiff_t* l1=0, std::ptrdi
   }
 }
 
+/** \internal Identifies the scalar types for which tuned blocking sizes can be registered.
+  * The value is -1 for scalar types which are not tunable. */
+template<typename Scalar> struct tuned_blocking_scalar_id { enum { value = -1 }; };
+template<> struct tuned_blocking_scalar_id<float>                { enum { value = 0 }; };
+template<> struct tuned_blocking_scalar_id<double>               { enum { value = 1 }; };
+template<> struct tuned_blocking_scalar_id<std::complex<float> >  { enum { value = 2 }; };
+template<> struct tuned_blocking_scalar_id<std::complex<double> > { enum { value = 3 }; };
+
+enum {
+  TunedBlockingScalarCount = 4,
+  /** \internal m x k times k x n products without any particularly small dimension */
+  GeneralProductShape = 0,
+  /** \internal products with a small depth compared to the result, i.e., rank-k updates */
+  RankUpdateProductShape = 1,
+  /** \internal products with a thin result compared to the depth, i.e., panel products */
+  PanelProductShape = 2,
+  ProductShapeCount = 3
+};
+
+/** \internal \returns the shape class of a m x k times k x n matrix product */
+inline int product_shape_class(std::ptrdiff_t k, std::ptrdiff_t m, std::ptrdiff_t n)
+{
+  if(4*k<=m && 4*k<=n)
+    return RankUpdateProductShape;
+  if(4*m<=k || 4*n<=k)
+    return PanelProductShape;
+  return GeneralProductShape;
+}
+
+/** \internal Gets or sets the tuned blocking sizes kc and mc for the given scalar type and product shape class.
+  * A zero kc means that no tuned values are available and that the cache size heuristic has to be used. */
+inline void manage_tuned_blocking_sizes(Action action, int scalarId, int shape, std::ptrdiff_t* kc, std::ptrdiff_t* mc)
+{
+  static std::ptrdiff_t m_kc[TunedBlockingScalarCount][ProductShapeCount] = {{0}};
+  static std::ptrdiff_t m_mc[TunedBlockingScalarCount][ProductShapeCount] = {{0}};
+
+  eigen_internal_assert(kc!=0 && mc!=0);
+  eigen_internal_assert(scalarId>=0 && scalarId<TunedBlockingScalarCount && shape>=0 && shape<ProductShapeCount);
+  if(action==SetAction)
+  {
+    m_kc[scalarId][shape] = *kc;
+    m_mc[scalarId][shape] = *mc;
+  }
+  else if(action==GetAction)
+  {
+    *kc = m_kc[scalarId][shape];
+    *mc = m_mc[scalarId][shape];
+  }
+  else
+  {
+    eigen_internal_assert(false);
+  }
+}
+
 /** \brief Computes the blocking parameters for a m x k times k x n matrix product
   *
   * \param[in,out] k Input: the third dimension of the product. Output: the blocking size along the same dimension.
@@ -68,6 +122,9 @@ inline void manage_caching_sizes(Action action, std::ptrdiff_t* l1=0, std::ptrdi
   * - the register level blocking sizes defined by gebp_traits,
   * - the number of scalars that fit into a packet (when vectorization is enabled).
   *
+  * If blocking sizes have been tuned for the scalar type and the shape class of the product
+  * (see the ProductTuner module), they take precedence over the cache size heuristic.
+  *
   * \sa setCpuCacheSizes */
 template<typename LhsScalar, typename RhsScalar, int KcFactor, typename SizeType>
 void computeProductBlockingSizes(SizeType& k, SizeType& m, SizeType& n)
@@ -90,6 +147,19 @@ void computeProductBlockingSizes(SizeType& k, SizeType& m, SizeType& n)
     mr_mask = (0xffffffff/mr)*mr
   };
 
+  enum { ScalarId = tuned_blocking_scalar_id<LhsScalar>::value };
+  if(is_same<LhsScalar,RhsScalar>::value && ScalarId>=0)
+  {
+    std::ptrdiff_t tkc, tmc;
+    manage_tuned_blocking_sizes(GetAction, ScalarId, product_shape_class(k,m,n), &tkc, &tmc);
+    if(tkc>0)
+    {
+      k = std::min<SizeType>(k, std::max<std::ptrdiff_t>(tkc/KcFactor,1));
+      if(tmc<m) m = std::max<SizeType>(SizeType((tmc/mr)*mr), std::min<SizeType>(m, SizeType(mr)));
+      return;
+    }
+  }
+
   manage_caching_sizes(GetAction, &l1, &l2);
   k = std::min<SizeType>(k, l1/kdiv);
   SizeType _m = k>0 ? l2/(4 * sizeof(LhsScalar) * k) : 0;
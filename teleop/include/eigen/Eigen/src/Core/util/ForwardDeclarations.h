@@ -74,6 +74,7 @@ template<typename Derived> class ArrayBase;
 
 template<typename ExpressionType, unsigned int Added, unsigned int Removed> class Flagged;
 template<typename ExpressionType, template <typename> class StorageBase > class NoAlias;
+template<typename ExpressionType> class ParallelAssign;
 template<typename ExpressionType> class NestByValue;
 template<typename ExpressionType> class ForceAlignedAccess;
 template<typename ExpressionType> class SwapWrapper;
@@ -276,6 +277,9 @@ template<typename Derived> class MatrixLogarithmReturnValue;
 template<typename Derived> class MatrixPowerReturnValue;
 template<typename Derived, typename Lhs, typename Rhs> class MatrixPowerProduct;
 
+// defined in products/Parallelizer.h
+inline int nbThreads();
+
 namespace internal {
 template <typename Scalar>
 struct stem_function
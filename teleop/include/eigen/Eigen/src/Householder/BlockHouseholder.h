@@ -41,16 +41,13 @@ void make_block_householder_triangular_factor(TriangularFactorType& triFactor, c
   }
 }
 
-/** \internal */
-template<typename MatrixType,typename VectorsType,typename CoeffsType>
-void apply_block_householder_on_the_left(MatrixType& mat, const VectorsType& vectors, const CoeffsType& hCoeffs)
+/** \internal applies the block reflector I - V T V^* of the triangular factor \a T, as computed by
+  * make_block_householder_triangular_factor(), on the left of \a mat.
+  * Unlike the factorization of \a T, this does not write to \a vectors, such that disjoint column blocks
+  * of a matrix can be updated concurrently. */
+template<typename MatrixType,typename VectorsType,typename TriangularFactorType>
+void apply_block_householder_factor_on_the_left(MatrixType& mat, const VectorsType& vectors, const TriangularFactorType& T)
 {
-  typedef typename MatrixType::Index Index;
-  enum { TFactorSize = MatrixType::ColsAtCompileTime };
-  Index nbVecs = vectors.cols();
-  Matrix<typename MatrixType::Scalar, TFactorSize, TFactorSize, ColMajor> T(nbVecs,nbVecs);
-  make_block_householder_triangular_factor(T, vectors, hCoeffs);
-
   const TriangularView<const VectorsType, UnitLower>& V(vectors);
 
   // A -= V T V^* A
@@ -61,6 +58,18 @@ void apply_block_householder_on_the_left(MatrixType& mat, const VectorsType& vec
   mat.noalias() -= V * tmp;
 }
 
+/** \internal */
+template<typename MatrixType,typename VectorsType,typename CoeffsType>
+void apply_block_householder_on_the_left(MatrixType& mat, const VectorsType& vectors, const CoeffsType& hCoeffs)
+{
+  typedef typename MatrixType::Index Index;
+  enum { TFactorSize = MatrixType::ColsAtCompileTime };
+  Index nbVecs = vectors.cols();
+  Matrix<typename MatrixType::Scalar, TFactorSize, TFactorSize, ColMajor> T(nbVecs,nbVecs);
+  make_block_householder_triangular_factor(T, vectors, hCoeffs);
+  apply_block_householder_factor_on_the_left(mat, vectors, T);
+}
+
 } // end namespace internal
 
 } // end namespace Eigen
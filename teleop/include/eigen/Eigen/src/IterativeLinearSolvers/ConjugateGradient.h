@@ -138,6 +138,11 @@ struct traits<ConjugateGradient<_MatrixType,_UpLo,_Preconditioner> >
   * 
   * By default the iterations start with x=0 as an initial guess of the solution.
   * One can control the start using the solveWithGuess() method.
+  *
+  * \b Multithreading: the sparse matrix-vector products are performed on multiple threads
+  * when OpenMP is enabled and the matrix is row-major. Since the matrix is self-adjoint, a real
+  * column-major matrix is also processed in parallel through its transpose, but only if
+  * \c _UpLo is \c Lower|Upper, i.e., if both triangular parts are stored. See class IterativeSolverBase.
   * 
   * \sa class SimplicialCholesky, DiagonalPreconditioner, IdentityPreconditioner
   */
@@ -201,8 +206,20 @@ public:
   template<typename Rhs,typename Dest>
   void _solveWithGuess(const Rhs& b, Dest& x) const
   {
+    // When the full matrix is used, A = A^T, so a column-major sparse matrix is transposed to
+    // perform the products with a row-major matrix which is multithreaded.
+    enum {
+      TransposeInput = (UpLo==(Lower|Upper))
+                    && (!MatrixType::IsRowMajor)
+                    && (!NumTraits<Scalar>::IsComplex)
+                    && internal::is_same<typename internal::traits<MatrixType>::StorageKind,Sparse>::value
+    };
+    typedef typename internal::conditional<TransposeInput,
+                                           Transpose<const MatrixType>,
+                                           const MatrixType&
+                                          >::type FullMatrixWrapperType;
     typedef typename internal::conditional<UpLo==(Lower|Upper),
-                                           const MatrixType&,
+                                           FullMatrixWrapperType,
                                            SparseSelfAdjointView<const MatrixType, UpLo>
                                           >::type MatrixWrapperType;
     m_iterations = Base::maxIterations();
@@ -160,8 +160,8 @@ class IncompleteLUT : internal::noncopyable
     void _solve(const Rhs& b, Dest& x) const
     {
       x = m_Pinv * b;
-      x = m_lu.template triangularView<UnitLower>().solve(x);
-      x = m_lu.template triangularView<Upper>().solve(x);
+      m_lowerSolver.solveInPlace(m_lu, x);
+      m_upperSolver.solveInPlace(m_lu, x);
       x = m_P * x; 
     }
 
@@ -195,6 +195,8 @@ protected:
     ComputationInfo m_info;
     PermutationMatrix<Dynamic,Dynamic,Index> m_P;     // Fill-reducing permutation
     PermutationMatrix<Dynamic,Dynamic,Index> m_Pinv;  // Inverse permutation
+    SparseTriangularSolver<FactorType,UnitLower> m_lowerSolver;
+    SparseTriangularSolver<FactorType,Upper> m_upperSolver;
 };
 
 /**
@@ -450,6 +452,8 @@ void IncompleteLUT<Scalar>::factorize(const _MatrixType& amat)
 
   m_lu.finalize();
   m_lu.makeCompressed();
+  m_lowerSolver.analyzePattern(m_lu);
+  m_upperSolver.analyzePattern(m_lu);
 
   m_factorizationIsOk = true;
   m_isInitialized = m_factorizationIsOk;
@@ -15,6 +15,12 @@ namespace Eigen {
 /** \ingroup IterativeLinearSolvers_Module
   * \brief Base class for linear iterative solvers
   *
+  * The cost of the iterative solvers is usually dominated by the products of the matrix by
+  * dense vectors. When OpenMP is enabled, these products are performed on Eigen::nbThreads() threads
+  * if the matrix is a row-major SparseMatrix (or a MappedSparseMatrix) with enough non zeros, the rows
+  * being split into ranges having about the same number of non zeros. Column-major matrices are
+  * processed sequentially, except by solvers which exploit the symmetry of the problem.
+  *
   * \sa class SimplicialCholesky, DiagonalPreconditioner, IdentityPreconditioner
   */
 template< typename Derived>
@@ -286,15 +286,100 @@ struct partial_lu_impl
     return first_zero_pivot;
   }
 
+  /** \internal performs the LU decomposition in-place of the panel represented by the variables \a rows, \a cols,
+    * \a lu_data, and \a luStride using a recursive algorithm: the left half of the columns is factorized
+    * recursively, the right half is updated by a triangular solve and a matrix product, and then factorized
+    * recursively. Unlike the unblocked algorithm, which streams the whole panel through the cache for each column,
+    * most of the work is done by matrix products on blocks of decreasing size.
+    *
+    * The arguments and the returned value are the same as for blocked_lu().
+    */
+  static Index recursive_lu(Index rows, Index cols, Scalar* lu_data, Index luStride, PivIndex* row_transpositions, PivIndex& nb_transpositions)
+  {
+    MapLU lu1(lu_data,StorageOrder==RowMajor?rows:luStride,StorageOrder==RowMajor?luStride:cols);
+    MatrixType lu(lu1,0,0,rows,cols);
+
+    const Index size = (std::min)(rows,cols);
+    if(size<=16)
+      return unblocked_lu(lu, row_transpositions, nb_transpositions);
+
+    const Index n1 = size/2;
+    const Index n2 = cols-n1;
+
+    // partition the matrix:
+    //                    A11 | A12
+    // lu  = A_1 | A_2 =  A21 | A22
+    BlockType A_1(lu,0,0,rows,n1);
+    BlockType A_2(lu,0,n1,rows,n2);
+    BlockType A11(lu,0,0,n1,n1);
+    BlockType A12(lu,0,n1,n1,n2);
+    BlockType A21(lu,n1,0,rows-n1,n1);
+    BlockType A22(lu,n1,n1,rows-n1,n2);
+
+    PivIndex nb_transpositions_1, nb_transpositions_2;
+    Index first_zero_pivot = recursive_lu(rows, n1, lu_data, luStride, row_transpositions, nb_transpositions_1);
+
+    for(Index i=0; i<n1; ++i)
+      A_2.row(i).swap(A_2.row(row_transpositions[i]));
+    A11.template triangularView<UnitLower>().solveInPlace(A12);
+    A22.noalias() -= A21 * A12;
+
+    Index ret = recursive_lu(rows-n1, n2, &lu.coeffRef(n1,n1), luStride, row_transpositions+n1, nb_transpositions_2);
+    if(ret>=0 && first_zero_pivot<0)
+      first_zero_pivot = n1+ret;
+
+    for(Index i=n1; i<size; ++i)
+    {
+      Index piv = (row_transpositions[i] += PivIndex(n1));
+      A_1.row(i).swap(A_1.row(piv));
+    }
+    nb_transpositions = nb_transpositions_1 + nb_transpositions_2;
+    return first_zero_pivot;
+  }
+
+  /** \internal Updates the columns [\a start, \a start + \a ncols) of \a lu on the right of the panel of \a bs
+    * columns starting at (\a k, \a k): the row transpositions of the panel are applied, and then
+    * A12 = A11^-1 A12 and A22 -= A21 A12. */
+  static void update_trailing_columns(MatrixType& lu, Index k, Index bs, Index start, Index ncols, const PivIndex* row_transpositions)
+  {
+    const Index rows = lu.rows();
+    BlockType A_2(lu,0,start,rows,ncols);
+    BlockType A11(lu,k,k,bs,bs);
+    BlockType A12(lu,k,start,bs,ncols);
+    BlockType A21(lu,k+bs,k,rows-k-bs,bs);
+    BlockType A22(lu,k+bs,start,rows-k-bs,ncols);
+
+    for(Index i=k; i<k+bs; ++i)
+      A_2.row(i).swap(A_2.row(row_transpositions[i]));
+    A11.template triangularView<UnitLower>().solveInPlace(A12);
+    A22.noalias() -= A21 * A12;
+  }
+
+#ifdef EIGEN_HAS_OPENMP
+  /** \internal \returns the number of threads of the look-ahead factorization of a \a size x \a size matrix
+    * with panels of \a blockSize columns, or 1 if it should not be used. */
+  static Index lookahead_threads(Index size, Index blockSize)
+  {
+    // do not create nested parallel regions, and require enough panels to overlap
+    if(omp_get_num_threads()>1 || size < 4*blockSize || size < 256)
+      return 1;
+    return (std::max)(Index(1), (std::min)(Index(nbThreads()), size/64));
+  }
+#endif
+
   /** \internal performs the LU decomposition in-place of the matrix represented
     * by the variables \a rows, \a cols, \a lu_data, and \a lu_stride using a
-    * recursive, blocked algorithm.
+    * blocked algorithm, the panels being factorized by recursive_lu().
     *
     * In addition, this function returns the row transpositions in the
     * vector \a row_transpositions which must have a size equal to the number
     * of columns of the matrix \a lu, and an integer \a nb_transpositions
     * which returns the actual number of transpositions.
     *
+    * When OpenMP is enabled, the trailing matrix is updated on several threads with a look-ahead: the first
+    * thread updates the columns of the next panel and factorizes it, while the other threads update the
+    * remaining columns, such that the sequential panel factorizations are overlapped with the matrix products.
+    *
     * \returns The index of the first pivot which is exactly zero if any, or a negative number otherwise.
     *
     * \note This very low level interface using pointers, etc. is to:
@@ -323,8 +408,16 @@ struct partial_lu_impl
       blockSize = (std::min)((std::max)(blockSize,Index(8)), maxBlockSize);
     }
 
+#ifdef EIGEN_HAS_OPENMP
+    const Index threads = lookahead_threads(size, blockSize);
+#endif
+
     nb_transpositions = 0;
     Index first_zero_pivot = -1;
+    // whether the current panel has already been factorized by the look-ahead
+    bool factorized = false;
+    Index ret = -1;
+    PivIndex nb_transpositions_in_panel = 0;
     for(Index k = 0; k < size; k+=blockSize)
     {
       Index bs = (std::min)(size-k,blockSize); // actual size of the block
@@ -336,17 +429,11 @@ struct partial_lu_impl
       // lu  = A_0 | A_1 | A_2 =  A10 | A11 | A12
       //                          A20 | A21 | A22
       BlockType A_0(lu,0,0,rows,k);
-      BlockType A_2(lu,0,k+bs,rows,tsize);
-      BlockType A11(lu,k,k,bs,bs);
-      BlockType A12(lu,k,k+bs,bs,tsize);
-      BlockType A21(lu,k+bs,k,trows,bs);
-      BlockType A22(lu,k+bs,k+bs,trows,tsize);
-
-      PivIndex nb_transpositions_in_panel;
-      // recursively call the blocked LU algorithm on [A11^T A21^T]^T
-      // with a very small blocking size:
-      Index ret = blocked_lu(trows+bs, bs, &lu.coeffRef(k,k), luStride,
-                   row_transpositions+k, nb_transpositions_in_panel, 16);
+
+      // recursively factorize [A11^T A21^T]^T
+      if(!factorized)
+        ret = recursive_lu(trows+bs, bs, &lu.coeffRef(k,k), luStride, row_transpositions+k, nb_transpositions_in_panel);
+      factorized = false;
       if(ret>=0 && first_zero_pivot==-1)
         first_zero_pivot = k+ret;
 
@@ -354,20 +441,39 @@ struct partial_lu_impl
       // update permutations and apply them to A_0
       for(Index i=k; i<k+bs; ++i)
       {
-        Index piv = (row_transpositions[i] += k);
+        Index piv = (row_transpositions[i] += PivIndex(k));
         A_0.row(i).swap(A_0.row(piv));
       }
 
       if(trows)
       {
-        // apply permutations to A_2
-        for(Index i=k;i<k+bs; ++i)
-          A_2.row(i).swap(A_2.row(row_transpositions[i]));
-
-        // A12 = A11^-1 A12
-        A11.template triangularView<UnitLower>().solveInPlace(A12);
-
-        A22.noalias() -= A21 * A12;
+#ifdef EIGEN_HAS_OPENMP
+        const Index nbs = (std::min)(tsize, blockSize); // size of the next panel
+        if(threads>1 && nbs>0 && tsize>nbs)
+        {
+          #pragma omp parallel num_threads(int(threads))
+          {
+            const Index t = omp_get_thread_num(), workers = omp_get_num_threads()-1;
+            if(t==0)
+            {
+              // look-ahead: update and factorize the next panel
+              update_trailing_columns(lu, k, bs, k+bs, nbs, row_transpositions);
+              ret = recursive_lu(trows, nbs, &lu.coeffRef(k+bs,k+bs), luStride, row_transpositions+k+bs, nb_transpositions_in_panel);
+            }
+            if(t>0 || workers==0)
+            {
+              // update the remaining columns
+              const Index w = workers==0 ? 0 : t-1, nw = workers==0 ? 1 : workers;
+              const Index start = nbs + ((tsize-nbs)*w)/nw, end = nbs + ((tsize-nbs)*(w+1))/nw;
+              if(end>start)
+                update_trailing_columns(lu, k, bs, k+bs+start, end-start, row_transpositions);
+            }
+          }
+          factorized = true;
+          continue;
+        }
+#endif
+        update_trailing_columns(lu, k, bs, k+bs, tsize, row_transpositions);
       }
     }
     return first_zero_pivot;
@@ -0,0 +1,755 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_NESTED_DISSECTION_H
+#define EIGEN_NESTED_DISSECTION_H
+
+#include <queue>
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal Undirected graph with weighted vertices and edges, stored in compressed adjacency format */
+template<typename Index>
+struct nd_graph
+{
+  typedef Matrix<Index,Dynamic,1> IndexVector;
+  IndexVector xadj;     // start of the adjacency list of each vertex (size n+1)
+  IndexVector adjncy;   // neighbors
+  IndexVector vwgt;     // weight of each vertex
+  IndexVector adjwgt;   // weight of each edge
+  Index totalWeight;
+  Index size() const { return Index(xadj.size())-1; }
+};
+
+/** \internal
+  * \ingroup OrderingMethods_Module
+  * Multilevel nested dissection of the adjacency graph of a symmetric matrix.
+  *
+  * Each subgraph larger than the leaf size is bisected as follows:
+  *  - the graph is coarsened by collapsing heavy edge matchings until it has a few tens of vertices,
+  *  - the coarsest graph is bisected by graph growing from several seeds,
+  *  - the bisection is projected back to the finer graphs and improved at each level by Fiduccia-Mattheyses passes,
+  *  - the resulting edge separator is turned into a minimum vertex separator (minimum vertex cover of the cut edges).
+  * The two parts are ordered recursively, followed by the separator. The leaves are ordered by AMD.
+  *
+  * The recursion defines a separator tree whose nodes are stored in postorder: each node owns a contiguous
+  * range of the new ordering (its separator, or the whole leaf), preceded by the ranges of its subtrees.
+  */
+template<typename Index>
+class nested_dissection
+{
+  public:
+    typedef Matrix<Index,Dynamic,1> IndexVector;
+    typedef nd_graph<Index> Graph;
+    typedef PermutationMatrix<Dynamic,Dynamic,Index> PermutationType;
+
+    enum {
+      CoarsenTo = 64,     // stop the coarsening below this number of vertices
+      InitialTries = 4,   // number of seeds of the initial bisection
+      RefinementPasses = 4
+    };
+
+    nested_dissection(Index leafSize) : m_leafSize(leafSize) {}
+
+    /** Computes the ordering of the graph of the column-major symmetric pattern \a mat.
+      * The diagonal entries are ignored. */
+    template<typename MatrixType>
+    void compute(const MatrixType& mat, PermutationType& perm)
+    {
+      Index n = mat.cols();
+      m_xadj.resize(n+1);
+      m_adjncy.resize(mat.nonZeros());
+      Index nnz = 0;
+      for(Index j=0; j<n; ++j)
+      {
+        m_xadj(j) = nnz;
+        for(typename MatrixType::InnerIterator it(mat,j); it; ++it)
+          if(it.index()!=j)
+            m_adjncy(nnz++) = it.index();
+      }
+      m_xadj(n) = nnz;
+
+      m_map.setConstant(n,-1);
+      m_nodeParent.resize(0);
+      m_nodeStart.resize(0);
+      m_nodeSeparator.resize(0);
+      m_nodeEnd.resize(0);
+      m_nbNodes = 0;
+      perm.resize(n);
+      m_perm = &perm.indices();
+
+      if(n>0)
+      {
+        IndexVector verts(n);
+        for(Index i=0; i<n; ++i) verts(i) = i;
+        Index root = dissect(verts, 0);
+        m_nodeParent(root) = -1;
+      }
+      m_nodeParent.conservativeResize(m_nbNodes);
+      m_nodeStart.conservativeResize(m_nbNodes);
+      m_nodeSeparator.conservativeResize(m_nbNodes);
+      m_nodeEnd.conservativeResize(m_nbNodes);
+    }
+
+    const IndexVector& nodeParent() const { return m_nodeParent; }
+    const IndexVector& nodeStart() const { return m_nodeStart; }
+    const IndexVector& nodeSeparator() const { return m_nodeSeparator; }
+    const IndexVector& nodeEnd() const { return m_nodeEnd; }
+
+  protected:
+
+    /** Orders the vertices \a verts of the input graph at the positions [first,first+verts.size()), and returns the node of the tree */
+    Index dissect(const IndexVector& verts, Index first)
+    {
+      Index nv = verts.size();
+      if(nv > m_leafSize)
+      {
+        Graph g;
+        extractSubgraph(verts, g);
+        IndexVector where;
+        bisect(g, where);
+        vertexSeparator(g, where);
+
+        Index sizes[3] = {0, 0, 0};
+        for(Index i=0; i<nv; ++i) ++sizes[where(i)];
+        if(sizes[0]>0 && sizes[1]>0)
+        {
+          IndexVector parts[3];
+          for(int k=0; k<3; ++k) parts[k].resize(sizes[k]);
+          Index pos[3] = {0, 0, 0};
+          for(Index i=0; i<nv; ++i)
+            parts[where(i)](pos[where(i)]++) = verts(i);
+          g = Graph();
+          where.resize(0);
+
+          Index left = dissect(parts[0], first);
+          parts[0].resize(0);
+          Index right = dissect(parts[1], first+sizes[0]);
+          Index sep = first+sizes[0]+sizes[1];
+          for(Index i=0; i<sizes[2]; ++i)
+            (*m_perm)(sep+i) = parts[2](i);
+          Index node = addNode(first, sep, first+nv);
+          m_nodeParent(left) = node;
+          m_nodeParent(right) = node;
+          return node;
+        }
+        // the bisection failed to split the graph, the whole subgraph is a leaf
+      }
+      orderLeaf(verts, first);
+      return addNode(first, first, first+nv);
+    }
+
+    Index addNode(Index start, Index separator, Index end)
+    {
+      if(m_nbNodes==m_nodeParent.size())
+      {
+        Index size = (std::max)(Index(16), 2*m_nbNodes);
+        m_nodeParent.conservativeResize(size);
+        m_nodeStart.conservativeResize(size);
+        m_nodeSeparator.conservativeResize(size);
+        m_nodeEnd.conservativeResize(size);
+      }
+      m_nodeStart(m_nbNodes) = start;
+      m_nodeSeparator(m_nbNodes) = separator;
+      m_nodeEnd(m_nbNodes) = end;
+      m_nodeParent(m_nbNodes) = -1;
+      return m_nbNodes++;
+    }
+
+    /** Builds the graph induced by the vertices \a verts, with unit weights */
+    void extractSubgraph(const IndexVector& verts, Graph& g)
+    {
+      Index nv = verts.size();
+      Index bound = 0;
+      for(Index i=0; i<nv; ++i)
+      {
+        m_map(verts(i)) = i;
+        bound += m_xadj(verts(i)+1) - m_xadj(verts(i));
+      }
+      g.xadj.resize(nv+1);
+      g.adjncy.resize(bound);
+      Index nnz = 0;
+      for(Index i=0; i<nv; ++i)
+      {
+        g.xadj(i) = nnz;
+        for(Index p=m_xadj(verts(i)); p<m_xadj(verts(i)+1); ++p)
+        {
+          Index u = m_map(m_adjncy(p));
+          if(u>=0)
+            g.adjncy(nnz++) = u;
+        }
+      }
+      g.xadj(nv) = nnz;
+      g.adjncy.conservativeResize(nnz);
+      g.vwgt.setOnes(nv);
+      g.adjwgt.setOnes(nnz);
+      g.totalWeight = nv;
+      for(Index i=0; i<nv; ++i)
+        m_map(verts(i)) = -1;
+    }
+
+    /** Orders a leaf by AMD, or keeps its natural order when AMD is not available */
+    void orderLeaf(const IndexVector& verts, Index first)
+    {
+      Index nv = verts.size();
+#ifndef EIGEN_MPL2_ONLY
+      if(nv > 2)
+      {
+        for(Index i=0; i<nv; ++i)
+          m_map(verts(i)) = i;
+        // the AMD routine expects the diagonal entries to be present
+        std::vector<Triplet<double,Index> > triplets;
+        for(Index i=0; i<nv; ++i)
+        {
+          triplets.push_back(Triplet<double,Index>(i,i,1.0));
+          for(Index p=m_xadj(verts(i)); p<m_xadj(verts(i)+1); ++p)
+          {
+            Index u = m_map(m_adjncy(p));
+            if(u>=0)
+              triplets.push_back(Triplet<double,Index>(u,i,1.0));
+          }
+        }
+        for(Index i=0; i<nv; ++i)
+          m_map(verts(i)) = -1;
+        SparseMatrix<double,ColMajor,Index> C(nv,nv);
+        C.setFromTriplets(triplets.begin(), triplets.end());
+        PermutationType perm;
+        minimum_degree_ordering(C, perm);
+        for(Index k=0; k<nv; ++k)
+          (*m_perm)(first+k) = verts(perm.indices()(k));
+        return;
+      }
+#endif
+      for(Index k=0; k<nv; ++k)
+        (*m_perm)(first+k) = verts(k);
+    }
+
+    /** Coarsens \a g by a heavy edge matching, and returns in \a cmap the coarse vertex of each vertex of \a g */
+    static void coarsen(const Graph& g, Graph& gc, IndexVector& cmap)
+    {
+      Index n = g.size();
+
+      // visit the vertices by increasing degree, such that the low degree vertices are matched first
+      Index maxDegree = 0;
+      for(Index v=0; v<n; ++v)
+        maxDegree = (std::max)(maxDegree, g.xadj(v+1)-g.xadj(v));
+      IndexVector count = IndexVector::Zero(maxDegree+2), order(n);
+      for(Index v=0; v<n; ++v) ++count(g.xadj(v+1)-g.xadj(v)+1);
+      for(Index d=1; d<=maxDegree+1; ++d) count(d) += count(d-1);
+      for(Index v=0; v<n; ++v) order(count(g.xadj(v+1)-g.xadj(v))++) = v;
+
+      Index maxVertexWeight = (std::max)(Index(1), Index((3*g.totalWeight)/(2*CoarsenTo)));
+      IndexVector match = IndexVector::Constant(n,-1), coarseFirst(n);
+      cmap.resize(n);
+      Index nc = 0;
+      for(Index k=0; k<n; ++k)
+      {
+        Index v = order(k);
+        if(match(v)>=0) continue;
+        Index best = v, bestWeight = 0;
+        for(Index p=g.xadj(v); p<g.xadj(v+1); ++p)
+        {
+          Index u = g.adjncy(p);
+          if(match(u)<0 && u!=v && g.adjwgt(p)>bestWeight && g.vwgt(v)+g.vwgt(u)<=maxVertexWeight)
+          {
+            best = u;
+            bestWeight = g.adjwgt(p);
+          }
+        }
+        match(v) = best;
+        match(best) = v;
+        cmap(v) = cmap(best) = nc;
+        coarseFirst(nc++) = v;
+      }
+
+      // merge the adjacency lists of the matched vertices
+      gc.xadj.resize(nc+1);
+      gc.vwgt.resize(nc);
+      gc.adjncy.resize(g.adjncy.size());
+      gc.adjwgt.resize(g.adjncy.size());
+      gc.totalWeight = g.totalWeight;
+      IndexVector position = IndexVector::Constant(nc,-1);
+      Index nnz = 0;
+      for(Index c=0; c<nc; ++c)
+      {
+        gc.xadj(c) = nnz;
+        Index v = coarseFirst(c), u = match(v);
+        gc.vwgt(c) = g.vwgt(v) + (u!=v ? g.vwgt(u) : 0);
+        const int nbMerged = u!=v ? 2 : 1;
+        for(int k=0; k<nbMerged; ++k, v = u)
+        {
+          for(Index p=g.xadj(v); p<g.xadj(v+1); ++p)
+          {
+            Index cu = cmap(g.adjncy(p));
+            if(cu==c) continue;
+            if(position(cu)<0)
+            {
+              position(cu) = nnz;
+              gc.adjncy(nnz) = cu;
+              gc.adjwgt(nnz++) = g.adjwgt(p);
+            }
+            else
+              gc.adjwgt(position(cu)) += g.adjwgt(p);
+          }
+        }
+        for(Index p=gc.xadj(c); p<nnz; ++p)
+          position(gc.adjncy(p)) = -1;
+      }
+      gc.xadj(nc) = nnz;
+      gc.adjncy.conservativeResize(nnz);
+      gc.adjwgt.conservativeResize(nnz);
+    }
+
+    static Index maxPartWeight(const Graph& g)
+    {
+      Index maxVertexWeight = g.size()>0 ? g.vwgt.maxCoeff() : 0;
+      return (std::max)(Index(0.55*double(g.totalWeight)), (g.totalWeight+1)/2 + maxVertexWeight);
+    }
+
+    static Index edgeCut(const Graph& g, const IndexVector& where)
+    {
+      Index cut = 0;
+      for(Index v=0; v<g.size(); ++v)
+        for(Index p=g.xadj(v); p<g.xadj(v+1); ++p)
+          if(where(g.adjncy(p))!=where(v))
+            cut += g.adjwgt(p);
+      return cut/2;
+    }
+
+    /** Multilevel bisection of \a g: \a where is set to the part (0 or 1) of each vertex */
+    static void bisect(const Graph& g, IndexVector& where)
+    {
+      std::vector<Graph> graphs;
+      std::vector<IndexVector> cmaps;
+      graphs.reserve(32);
+      cmaps.reserve(32);
+      while((graphs.empty() ? g : graphs.back()).size() > CoarsenTo)
+      {
+        Graph coarse;
+        IndexVector cmap;
+        const Graph& fine = graphs.empty() ? g : graphs.back();
+        coarsen(fine, coarse, cmap);
+        // stop if the coarsening stalls, e.g., on star-like graphs
+        if(10*coarse.size() > 9*fine.size())
+          break;
+        graphs.push_back(Graph());
+        graphs.back().xadj.swap(coarse.xadj);
+        graphs.back().adjncy.swap(coarse.adjncy);
+        graphs.back().vwgt.swap(coarse.vwgt);
+        graphs.back().adjwgt.swap(coarse.adjwgt);
+        graphs.back().totalWeight = coarse.totalWeight;
+        cmaps.push_back(IndexVector());
+        cmaps.back().swap(cmap);
+      }
+
+      initialBisection(graphs.empty() ? g : graphs.back(), where);
+
+      for(Index level=Index(graphs.size())-1; level>=0; --level)
+      {
+        const Graph& fine = level>0 ? graphs[level-1] : g;
+        const IndexVector& cmap = cmaps[level];
+        IndexVector fineWhere(fine.size());
+        for(Index v=0; v<fine.size(); ++v)
+          fineWhere(v) = where(cmap(v));
+        where.swap(fineWhere);
+        refine(fine, where);
+      }
+    }
+
+    /** Bisects a small graph by growing a part from several seeds, and keeps the best refined result */
+    static void initialBisection(const Graph& g, IndexVector& where)
+    {
+      Index n = g.size();
+      IndexVector trial(n), queue(n), mark(n);
+      Index bestCut = -1;
+      Index tries = (std::min)(Index(InitialTries), n);
+      for(Index t=0; t<tries; ++t)
+      {
+        // breadth first growth of the part 0 until it holds half of the weight
+        trial.setOnes();
+        mark.setZero();
+        Index head = 0, tail = 0, weight = 0, nextSeed = 0;
+        Index seed = (t*n)/tries;
+        queue(tail++) = seed;
+        mark(seed) = 1;
+        while(2*weight < g.totalWeight)
+        {
+          if(head==tail)
+          {
+            // the component is exhausted, continue with another one
+            while(nextSeed<n && mark(nextSeed)) ++nextSeed;
+            if(nextSeed==n) break;
+            queue(tail++) = nextSeed;
+            mark(nextSeed) = 1;
+          }
+          Index v = queue(head++);
+          trial(v) = 0;
+          weight += g.vwgt(v);
+          for(Index p=g.xadj(v); p<g.xadj(v+1); ++p)
+            if(!mark(g.adjncy(p)))
+            {
+              mark(g.adjncy(p)) = 1;
+              queue(tail++) = g.adjncy(p);
+            }
+        }
+        refine(g, trial);
+        Index cut = edgeCut(g, trial);
+        if(bestCut<0 || cut<bestCut)
+        {
+          bestCut = cut;
+          where = trial;
+        }
+      }
+    }
+
+    /** Fiduccia-Mattheyses refinement of the bisection \a where of \a g, under the balance constraint */
+    static void refine(const Graph& g, IndexVector& where)
+    {
+      typedef std::pair<Index,Index> GainVertex;
+      Index n = g.size();
+      if(n<2) return;
+      Index maxWeight = maxPartWeight(g);
+      Index partWeight[2] = {0, 0};
+      IndexVector id = IndexVector::Zero(n), ed = IndexVector::Zero(n);
+      for(Index v=0; v<n; ++v)
+      {
+        partWeight[where(v)] += g.vwgt(v);
+        for(Index p=g.xadj(v); p<g.xadj(v+1); ++p)
+          (where(g.adjncy(p))==where(v) ? id(v) : ed(v)) += g.adjwgt(p);
+      }
+      Index cut = ed.sum()/2;
+      Index maxStall = (std::min)((std::max)(Index(15), n/100), Index(100));
+      IndexVector locked(n), moved(n);
+
+      for(int pass=0; pass<RefinementPasses; ++pass)
+      {
+        std::priority_queue<GainVertex> heap[2];
+        for(Index v=0; v<n; ++v)
+          if(ed(v)>0)
+            heap[where(v)].push(GainVertex(ed(v)-id(v), v));
+        locked.setZero();
+
+        Index nbMoves = 0, bestMoves = 0, bestCut = cut;
+        bool bestFeasible = partWeight[0]<=maxWeight && partWeight[1]<=maxWeight;
+        Index bestImbalance = std::abs(partWeight[0]-partWeight[1]);
+        while(true)
+        {
+          // discard the outdated entries
+          for(int s=0; s<2; ++s)
+            while(!heap[s].empty())
+            {
+              Index v = heap[s].top().second;
+              if(!locked(v) && where(v)==s && heap[s].top().first==ed(v)-id(v)) break;
+              heap[s].pop();
+            }
+
+          int from = -1;
+          if(partWeight[0]>maxWeight)       from = 0;
+          else if(partWeight[1]>maxWeight)  from = 1;
+          else
+          {
+            for(int s=0; s<2; ++s)
+              if(!heap[s].empty() && partWeight[1-s]+g.vwgt(heap[s].top().second)<=maxWeight
+                  && (from<0 || heap[s].top().first>heap[from].top().first))
+                from = s;
+          }
+          if(from<0 || heap[from].empty())
+            break;
+
+          Index v = heap[from].top().second;
+          heap[from].pop();
+          moveVertex(g, v, where, id, ed, partWeight, cut);
+          locked(v) = 1;
+          moved(nbMoves++) = v;
+          for(Index p=g.xadj(v); p<g.xadj(v+1); ++p)
+          {
+            Index u = g.adjncy(p);
+            if(!locked(u) && ed(u)>0)
+              heap[where(u)].push(GainVertex(ed(u)-id(u), u));
+          }
+
+          bool feasible = partWeight[0]<=maxWeight && partWeight[1]<=maxWeight;
+          Index imbalance = std::abs(partWeight[0]-partWeight[1]);
+          if((feasible && !bestFeasible)
+              || (feasible==bestFeasible && (cut<bestCut || (cut==bestCut && imbalance<bestImbalance))))
+          {
+            bestMoves = nbMoves;
+            bestCut = cut;
+            bestFeasible = feasible;
+            bestImbalance = imbalance;
+          }
+          else if(nbMoves-bestMoves > maxStall)
+            break;
+        }
+
+        // undo the moves following the best state
+        for(Index k=nbMoves-1; k>=bestMoves; --k)
+          moveVertex(g, moved(k), where, id, ed, partWeight, cut);
+        if(bestMoves==0)
+          break;
+      }
+    }
+
+    static void moveVertex(const Graph& g, Index v, IndexVector& where, IndexVector& id, IndexVector& ed, Index partWeight[2], Index& cut)
+    {
+      Index to = 1-where(v);
+      partWeight[where(v)] -= g.vwgt(v);
+      partWeight[to] += g.vwgt(v);
+      cut -= ed(v)-id(v);
+      std::swap(id(v), ed(v));
+      where(v) = to;
+      for(Index p=g.xadj(v); p<g.xadj(v+1); ++p)
+      {
+        Index u = g.adjncy(p), w = g.adjwgt(p);
+        if(where(u)==to) { id(u) += w; ed(u) -= w; }
+        else             { id(u) -= w; ed(u) += w; }
+      }
+    }
+
+    /** Moves to the separator (part 2) a minimum vertex cover of the edges cut by the bisection \a where.
+      * The cover is obtained from a maximum matching of the bipartite graph of the cut edges (Koenig's theorem). */
+    static void vertexSeparator(const Graph& g, IndexVector& where)
+    {
+      Index n = g.size();
+      // local numbering of the boundary vertices of each side
+      IndexVector local = IndexVector::Constant(n,-1), boundary(n);
+      Index nb[2] = {0, 0};
+      for(Index v=0; v<n; ++v)
+        for(Index p=g.xadj(v); p<g.xadj(v+1); ++p)
+          if(where(g.adjncy(p))!=where(v))
+          {
+            local(v) = nb[where(v)]++;
+            break;
+          }
+      Index nl = nb[0], nr = nb[1];
+      if(nl==0) return;
+
+      // bipartite graph from the left (part 0) to the right (part 1) boundary vertices
+      IndexVector bxadj(nl+1), badj, leftVertex(nl), rightVertex(nr);
+      Index nnz = 0;
+      for(Index v=0; v<n; ++v)
+        if(local(v)>=0)
+        {
+          if(where(v)==0)
+          {
+            leftVertex(local(v)) = v;
+            for(Index p=g.xadj(v); p<g.xadj(v+1); ++p)
+              if(where(g.adjncy(p))==1) ++nnz;
+          }
+          else
+            rightVertex(local(v)) = v;
+        }
+      badj.resize(nnz);
+      nnz = 0;
+      for(Index i=0; i<nl; ++i)
+      {
+        bxadj(i) = nnz;
+        Index v = leftVertex(i);
+        for(Index p=g.xadj(v); p<g.xadj(v+1); ++p)
+          if(where(g.adjncy(p))==1)
+            badj(nnz++) = local(g.adjncy(p));
+      }
+      bxadj(nl) = nnz;
+
+      // Hopcroft-Karp maximum matching
+      const Index unreached = NumTraits<Index>::highest();
+      IndexVector matchL = IndexVector::Constant(nl,-1), matchR = IndexVector::Constant(nr,-1);
+      IndexVector dist(nl), queue(nl), next(nl), stack(nl), chosen(nl);
+      while(true)
+      {
+        Index head = 0, tail = 0;
+        bool found = false;
+        for(Index i=0; i<nl; ++i)
+        {
+          dist(i) = matchL(i)<0 ? 0 : unreached;
+          if(matchL(i)<0) queue(tail++) = i;
+        }
+        while(head<tail)
+        {
+          Index i = queue(head++);
+          for(Index p=bxadj(i); p<bxadj(i+1); ++p)
+          {
+            Index k = matchR(badj(p));
+            if(k<0) found = true;
+            else if(dist(k)==unreached)
+            {
+              dist(k) = dist(i)+1;
+              queue(tail++) = k;
+            }
+          }
+        }
+        if(!found) break;
+
+        // augment along vertex disjoint shortest paths, found by non recursive depth first searches
+        for(Index i=0; i<nl; ++i) next(i) = bxadj(i);
+        for(Index root=0; root<nl; ++root)
+        {
+          if(matchL(root)>=0 || dist(root)!=0) continue;
+          Index top = 0;
+          stack(top++) = root;
+          while(top>0)
+          {
+            Index i = stack(top-1);
+            if(next(i)==bxadj(i+1))
+            {
+              dist(i) = unreached;
+              --top;
+              continue;
+            }
+            Index r = badj(next(i)++);
+            Index k = matchR(r);
+            if(k<0)
+            {
+              chosen(i) = r;
+              for(Index s=0; s<top; ++s)
+              {
+                matchL(stack(s)) = chosen(stack(s));
+                matchR(chosen(stack(s))) = stack(s);
+              }
+              break;
+            }
+            if(dist(k)==dist(i)+1)
+            {
+              chosen(i) = r;
+              stack(top++) = k;
+            }
+          }
+        }
+      }
+
+      // the cover is made of the unreached left vertices and of the reached right vertices
+      // by alternating paths from the free left vertices
+      IndexVector reachedL = IndexVector::Zero(nl), reachedR = IndexVector::Zero(nr);
+      Index head = 0, tail = 0;
+      for(Index i=0; i<nl; ++i)
+        if(matchL(i)<0)
+        {
+          reachedL(i) = 1;
+          queue(tail++) = i;
+        }
+      while(head<tail)
+      {
+        Index i = queue(head++);
+        for(Index p=bxadj(i); p<bxadj(i+1); ++p)
+        {
+          Index r = badj(p);
+          if(reachedR(r)) continue;
+          reachedR(r) = 1;
+          Index k = matchR(r);
+          if(k>=0 && !reachedL(k))
+          {
+            reachedL(k) = 1;
+            queue(tail++) = k;
+          }
+        }
+      }
+      for(Index i=0; i<nl; ++i)
+        if(!reachedL(i)) where(leftVertex(i)) = 2;
+      for(Index r=0; r<nr; ++r)
+        if(reachedR(r)) where(rightVertex(r)) = 2;
+    }
+
+    Index m_leafSize;
+    IndexVector m_xadj, m_adjncy, m_map;
+    typename PermutationType::IndicesType* m_perm;
+    IndexVector m_nodeParent, m_nodeStart, m_nodeSeparator, m_nodeEnd;
+    Index m_nbNodes;
+};
+
+} // end namespace internal
+
+/** \ingroup OrderingMethods_Module
+  * \class NestedDissectionOrdering
+  *
+  * Functor computing a multilevel \em nested \em dissection ordering.
+  *
+  * The graph of the matrix is recursively split by small vertex separators which are numbered last,
+  * the subgraphs below the leaf size being ordered by AMD (or kept in their natural order if AMD is not
+  * available, i.e., if EIGEN_MPL2_ONLY is defined). The separators are found by multilevel bisection:
+  * heavy edge coarsening, graph growing on the coarsest graph, and Fiduccia-Mattheyses refinement.
+  *
+  * On large 2D and 3D meshes, this ordering usually yields less fill-in and fewer operations than AMD, and its
+  * elimination tree is made of large independent subtrees which are well balanced for a parallel factorization
+  * (see SupernodalLLT::setParallelTreeSchedule). The separator tree of the last computed ordering is available
+  * through nodeParent(), nodeStart(), nodeSeparator() and nodeEnd().
+  *
+  * If the matrix is not structurally symmetric, an ordering of A^T+A is computed.
+  *
+  * \code
+  * SimplicialLDLT<SparseMatrix<double>, Lower, NestedDissectionOrdering<int> > solver(A);
+  * \endcode
+  *
+  * \tparam  Index The type of indices of the matrix
+  * \sa AMDOrdering, MetisOrdering
+  */
+template <typename Index>
+class NestedDissectionOrdering
+{
+  public:
+    typedef PermutationMatrix<Dynamic, Dynamic, Index> PermutationType;
+    typedef Matrix<Index, Dynamic, 1> IndexVector;
+
+    NestedDissectionOrdering() : m_leafSize(128) {}
+
+    /** Sets the size below which the subgraphs are not dissected anymore (default is 128) */
+    void setLeafSize(Index leafSize) { m_leafSize = (std::max)(Index(1), leafSize); }
+
+    /** \returns the size below which the subgraphs are not dissected */
+    Index leafSize() const { return m_leafSize; }
+
+    /** Compute the permutation vector from a sparse matrix */
+    template <typename MatrixType>
+    void operator()(const MatrixType& mat, PermutationType& perm)
+    {
+      SparseMatrix<typename MatrixType::Scalar, ColMajor, Index> symm;
+      internal::ordering_helper_at_plus_a(mat,symm);
+      compute(symm, perm);
+    }
+
+    /** Compute the permutation with a selfadjoint matrix */
+    template <typename SrcType, unsigned int SrcUpLo>
+    void operator()(const SparseSelfAdjointView<SrcType, SrcUpLo>& mat, PermutationType& perm)
+    {
+      SparseMatrix<typename SrcType::Scalar, ColMajor, Index> C; C = mat;
+      compute(C, perm);
+    }
+
+    /** \returns the parent of each node of the separator tree, or -1 for the root(s).
+      * The nodes are numbered in postorder, such that the children of a node precede it. */
+    const IndexVector& nodeParent() const { return m_nodeParent; }
+
+    /** \returns the first position, in the new ordering, of the subtree of each node.
+      * The subtrees of two nodes which are not ancestor of one another are independent: they can be factorized in parallel. */
+    const IndexVector& nodeStart() const { return m_nodeStart; }
+
+    /** \returns the first position, in the new ordering, of the separator of each node (or of the whole leaf) */
+    const IndexVector& nodeSeparator() const { return m_nodeSeparator; }
+
+    /** \returns the position following the subtree, and the separator, of each node */
+    const IndexVector& nodeEnd() const { return m_nodeEnd; }
+
+  protected:
+    template <typename MatrixType>
+    void compute(const MatrixType& mat, PermutationType& perm)
+    {
+      internal::nested_dissection<Index> nd(m_leafSize);
+      nd.compute(mat, perm);
+      m_nodeParent = nd.nodeParent();
+      m_nodeStart = nd.nodeStart();
+      m_nodeSeparator = nd.nodeSeparator();
+      m_nodeEnd = nd.nodeEnd();
+    }
+
+    Index m_leafSize;
+    IndexVector m_nodeParent, m_nodeStart, m_nodeSeparator, m_nodeEnd;
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_NESTED_DISSECTION_H
@@ -285,6 +285,15 @@ struct householder_qr_inplace_blocked
 
     Index blockSize = (std::min)(maxBlockSize,size);
 
+#ifdef EIGEN_HAS_OPENMP
+    // do not create nested parallel regions, and require enough trailing columns per thread
+    Index threads = 1;
+    if(omp_get_num_threads()==1 && size>=256)
+      threads = (std::min)(Index(nbThreads()), cols/(2*blockSize));
+    // whether the current panel has already been factorized by the look-ahead
+    bool factorized = false;
+#endif
+
     Index k = 0;
     for (k = 0; k < size; k += blockSize)
     {
@@ -303,8 +312,47 @@ struct householder_qr_inplace_blocked
       BlockType A11_21 = mat.block(k,k,brows,bs);
       Block<HCoeffs,Dynamic,1> hCoeffsSegment = hCoeffs.segment(k,bs);
 
+#ifdef EIGEN_HAS_OPENMP
+      if(!factorized)
+#endif
       householder_qr_inplace_unblocked(A11_21, hCoeffsSegment, tempData);
 
+#ifdef EIGEN_HAS_OPENMP
+      factorized = false;
+      Index nbs = (std::min)(size-k-bs, blockSize); // size of the next panel
+      if(threads>1 && nbs>0 && tcols>nbs)
+      {
+        // the first thread updates and factorizes the next panel, while the other threads update the remaining
+        // columns, such that the sequential panel factorizations are overlapped with the trailing updates
+        Matrix<Scalar,Dynamic,Dynamic> T(bs,bs);
+        make_block_householder_triangular_factor(T, A11_21, hCoeffsSegment.adjoint());
+        #pragma omp parallel num_threads(int(threads))
+        {
+          Index t = omp_get_thread_num(), workers = (std::max)(omp_get_num_threads()-1, 1);
+          if(t==0)
+          {
+            BlockType A21_22 = mat.block(k,k+bs,brows,nbs);
+            apply_block_householder_factor_on_the_left(A21_22,A11_21,T);
+            BlockType A22 = mat.block(k+bs,k+bs,brows-bs,nbs);
+            Block<HCoeffs,Dynamic,1> nextHCoeffsSegment = hCoeffs.segment(k+bs,nbs);
+            householder_qr_inplace_unblocked(A22, nextHCoeffsSegment, tempData);
+          }
+          if(t>0 || omp_get_num_threads()==1)
+          {
+            Index w = t>0 ? t-1 : 0;
+            Index start = nbs + ((tcols-nbs)*w)/workers, end = nbs + ((tcols-nbs)*(w+1))/workers;
+            if(end>start)
+            {
+              BlockType A21_22 = mat.block(k,k+bs+start,brows,end-start);
+              apply_block_householder_factor_on_the_left(A21_22,A11_21,T);
+            }
+          }
+        }
+        factorized = true;
+        continue;
+      }
+#endif
+
       if(tcols)
       {
         BlockType A21_22 = mat.block(k,k+bs,brows,tcols);
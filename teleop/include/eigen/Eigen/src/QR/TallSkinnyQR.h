@@ -0,0 +1,273 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_TALL_SKINNY_QR_H
+#define EIGEN_TALL_SKINNY_QR_H
+
+namespace Eigen {
+
+/** \ingroup QR_Module
+  *
+  *
+  * \class TallSkinnyQR
+  *
+  * \brief Householder QR decomposition of a tall and skinny matrix by row blocks (TSQR)
+  *
+  * \param MatrixType the type of the matrix of which we are computing the QR decomposition
+  *
+  * This class performs a QR decomposition \f$ \mathbf{A} = \mathbf{Q} \, \mathbf{R} \f$ of a matrix \b A having
+  * many more rows than columns. The rows of \b A are split into blocks which are factorized independently,
+  * on several threads when OpenMP is enabled, and the upper triangular factors of the blocks are then stacked
+  * and factorized again to get \b R. The factor \b Q is the product of the block diagonal matrix of the
+  * Householder reflectors of the blocks and of the reflectors of this reduction.
+  *
+  * Compared to HouseholderQR, each block is small enough to stay in the cache while it is factorized, such that
+  * the matrix is only read once from the memory, and the blocks are independent. The cost is a small reduction
+  * of \f$ n_b \f$ stacked triangular factors, where \f$ n_b \f$ is the number of blocks. The blocks do not depend
+  * on the number of threads, so that the results do not either.
+  *
+  * The number of rows of the blocks can be set by setBlockRows(). It is at least the number of columns, and the
+  * last block also contains the remaining rows.
+  *
+  * Like HouseholderQR, this is \b not a rank-revealing decomposition, and it is meant for least-squares
+  * problems of full column rank: see solve().
+  *
+  * \sa class HouseholderQR
+  */
+template<typename _MatrixType> class TallSkinnyQR
+{
+  public:
+
+    typedef _MatrixType MatrixType;
+    enum {
+      RowsAtCompileTime = MatrixType::RowsAtCompileTime,
+      ColsAtCompileTime = MatrixType::ColsAtCompileTime,
+      Options = MatrixType::Options,
+      MaxRowsAtCompileTime = MatrixType::MaxRowsAtCompileTime,
+      MaxColsAtCompileTime = MatrixType::MaxColsAtCompileTime
+    };
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::RealScalar RealScalar;
+    typedef typename MatrixType::Index Index;
+    typedef Matrix<Scalar, Dynamic, Dynamic> MatrixQRType;
+    typedef Matrix<Scalar, Dynamic, Dynamic> HCoeffsType;
+    typedef Matrix<Scalar, ColsAtCompileTime, ColsAtCompileTime, ColMajor, MaxColsAtCompileTime, MaxColsAtCompileTime> MatrixRType;
+
+    /**
+      * \brief Default Constructor.
+      *
+      * The default constructor is useful in cases in which the user intends to
+      * perform decompositions via TallSkinnyQR::compute(const MatrixType&).
+      */
+    TallSkinnyQR() : m_blockRows(0), m_isInitialized(false) {}
+
+    /** \brief Constructs a QR factorization from a given matrix
+      *
+      * This constructor computes the QR factorization of the matrix \a matrix by calling
+      * the method compute().
+      *
+      * \sa compute()
+      */
+    TallSkinnyQR(const MatrixType& matrix) : m_blockRows(0), m_isInitialized(false)
+    {
+      compute(matrix);
+    }
+
+    /** This method finds the least-squares solution x of the equation Ax=b, where A is the matrix of which
+      * *this is the QR decomposition. A must have full column rank.
+      *
+      * The blocks of rows of \a b are multiplied by the adjoint of the factors \b Q of the blocks in parallel,
+      * and the stacked results by the adjoint of the factor \b Q of the reduction, before the triangular solve.
+      *
+      * \param b the right-hand-side of the equation to solve, which can be a matrix.
+      *
+      * \returns a solution.
+      */
+    template<typename Rhs>
+    inline const internal::solve_retval<TallSkinnyQR, Rhs>
+    solve(const MatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_isInitialized && "TallSkinnyQR is not initialized.");
+      eigen_assert(rows()==b.rows() && "TallSkinnyQR::solve(): invalid number of rows of the right hand side matrix b");
+      return internal::solve_retval<TallSkinnyQR, Rhs>(*this, b.derived());
+    }
+
+    /** \returns the upper triangular factor R, of size cols() x cols() */
+    const MatrixRType& matrixR() const
+    {
+      eigen_assert(m_isInitialized && "TallSkinnyQR is not initialized.");
+      return m_r;
+    }
+
+    /** \returns the Householder reflectors of the blocks, stored in a LAPACK-compatible way below the
+      * diagonals of the blocks of blockRows() rows. */
+    const MatrixQRType& matrixQR() const
+    {
+      eigen_assert(m_isInitialized && "TallSkinnyQR is not initialized.");
+      return m_qr;
+    }
+
+    TallSkinnyQR& compute(const MatrixType& matrix);
+
+    /** Sets the number of rows of the blocks factorized independently. The default, 0, selects blocks
+      * of about 256 KB. Actual blocks have at least cols() rows. */
+    TallSkinnyQR& setBlockRows(Index blockRows)
+    {
+      m_blockRows = blockRows;
+      return *this;
+    }
+
+    /** \returns the number of rows of the blocks of the last factorization */
+    Index blockRows() const
+    {
+      eigen_assert(m_isInitialized && "TallSkinnyQR is not initialized.");
+      return m_actualBlockRows;
+    }
+
+    /** \returns the number of blocks of the last factorization */
+    Index blocks() const
+    {
+      eigen_assert(m_isInitialized && "TallSkinnyQR is not initialized.");
+      return m_hCoeffs.cols();
+    }
+
+    inline Index rows() const { return m_qr.rows(); }
+    inline Index cols() const { return m_qr.cols(); }
+
+    /** \internal \returns the first row of the block \a i */
+    Index blockStart(Index i) const { return i*m_actualBlockRows; }
+    /** \internal \returns the number of rows of the block \a i */
+    Index blockSize(Index i) const { return i+1==m_hCoeffs.cols() ? rows()-i*m_actualBlockRows : m_actualBlockRows; }
+
+    /** \internal */
+    const MatrixQRType& reductionQR() const { return m_reduction; }
+    /** \internal */
+    const HCoeffsType& hCoeffs() const { return m_hCoeffs; }
+    /** \internal */
+    const Matrix<Scalar,Dynamic,1>& reductionHCoeffs() const { return m_reductionHCoeffs; }
+
+    /** \internal \returns the number of threads processing the \a nbBlocks blocks */
+    static Index blockThreads(Index nbBlocks)
+    {
+#ifdef EIGEN_HAS_OPENMP
+      // do not create nested parallel regions
+      if(omp_get_num_threads()==1)
+        return (std::max)(Index(1), (std::min)(Index(nbThreads()), nbBlocks));
+#else
+      EIGEN_UNUSED_VARIABLE(nbBlocks);
+#endif
+      return 1;
+    }
+
+  protected:
+
+    static void check_template_parameters()
+    {
+      EIGEN_STATIC_ASSERT_NON_INTEGER(Scalar);
+    }
+
+    MatrixQRType m_qr;
+    HCoeffsType m_hCoeffs;
+    MatrixQRType m_reduction;
+    Matrix<Scalar,Dynamic,1> m_reductionHCoeffs;
+    MatrixRType m_r;
+    Index m_blockRows;
+    Index m_actualBlockRows;
+    bool m_isInitialized;
+};
+
+/** Performs the QR factorization of the given matrix \a matrix, which must have at least as many rows as columns.
+  * The result of the factorization is stored into \c *this, and a reference to \c *this is returned.
+  *
+  * \sa class TallSkinnyQR, TallSkinnyQR(const MatrixType&)
+  */
+template<typename MatrixType>
+TallSkinnyQR<MatrixType>& TallSkinnyQR<MatrixType>::compute(const MatrixType& matrix)
+{
+  check_template_parameters();
+
+  Index rows = matrix.rows();
+  Index cols = matrix.cols();
+  eigen_assert(rows>=cols && "TallSkinnyQR is only for matrices having at least as many rows as columns");
+
+  m_actualBlockRows = m_blockRows>0 ? m_blockRows : Index(256*1024/sizeof(Scalar))/(std::max)(cols,Index(1));
+  m_actualBlockRows = (std::max)((std::min)(m_actualBlockRows, rows), (std::max)(cols,Index(1)));
+  Index nbBlocks = (std::max)(Index(1), rows/m_actualBlockRows);
+
+  m_qr = matrix;
+  m_hCoeffs.resize(cols, nbBlocks);
+
+  // factorize the blocks
+  typedef Block<MatrixQRType,Dynamic,Dynamic> BlockType;
+  typedef Block<HCoeffsType,Dynamic,1,true> HCoeffsBlockType;
+  Index threads = blockThreads(nbBlocks);
+  EIGEN_UNUSED_VARIABLE(threads);
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for num_threads(int(threads)) schedule(static,1) if(threads>1)
+#endif
+  for(Index i=0; i<nbBlocks; ++i)
+  {
+    BlockType qr(m_qr, blockStart(i), 0, blockSize(i), cols);
+    HCoeffsBlockType hCoeffs(m_hCoeffs.col(i));
+    internal::householder_qr_inplace_blocked<BlockType, HCoeffsBlockType>::run(qr, hCoeffs, 48);
+  }
+
+  // factorize the stacked triangular factors of the blocks
+  m_reduction.setZero(nbBlocks*cols, cols);
+  for(Index i=0; i<nbBlocks; ++i)
+    m_reduction.middleRows(i*cols, cols).template triangularView<Upper>()
+      = m_qr.block(blockStart(i), 0, cols, cols).template triangularView<Upper>();
+  m_reductionHCoeffs.resize(cols);
+  internal::householder_qr_inplace_blocked<MatrixQRType, Matrix<Scalar,Dynamic,1> >::run(m_reduction, m_reductionHCoeffs, 48);
+
+  m_r = m_reduction.topRows(cols).template triangularView<Upper>();
+
+  m_isInitialized = true;
+  return *this;
+}
+
+namespace internal {
+
+template<typename _MatrixType, typename Rhs>
+struct solve_retval<TallSkinnyQR<_MatrixType>, Rhs>
+  : solve_retval_base<TallSkinnyQR<_MatrixType>, Rhs>
+{
+  EIGEN_MAKE_SOLVE_HELPERS(TallSkinnyQR<_MatrixType>,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    typedef Matrix<typename Rhs::Scalar,Dynamic,Dynamic> RhsBlockType;
+    const Index cols = dec().cols(), nbBlocks = dec().blocks();
+
+    // c = Q^* b: each block of b is multiplied by the adjoint of the factor Q of the block, the first cols rows
+    // of the results being stacked, and then by the adjoint of the factor Q of the reduction
+    RhsBlockType c(nbBlocks*cols, rhs().cols());
+    Index threads = TallSkinnyQR<_MatrixType>::blockThreads(nbBlocks);
+    EIGEN_UNUSED_VARIABLE(threads);
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for num_threads(int(threads)) schedule(static,1) if(threads>1)
+#endif
+    for(Index i=0; i<nbBlocks; ++i)
+    {
+      const Index start = dec().blockStart(i), size = dec().blockSize(i);
+      RhsBlockType ci = rhs().middleRows(start, size);
+      // Note that the matrix Q = H_0^* H_1^*... so its inverse is Q^* = (H_0 H_1 ...)^T
+      ci.applyOnTheLeft(householderSequence(dec().matrixQR().middleRows(start, size), dec().hCoeffs().col(i)).transpose());
+      c.middleRows(i*cols, cols) = ci.topRows(cols);
+    }
+    c.applyOnTheLeft(householderSequence(dec().reductionQR(), dec().reductionHCoeffs()).transpose());
+
+    dec().matrixR().template triangularView<Upper>().solveInPlace(c.topRows(cols));
+    dst = c.topRows(cols);
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_TALL_SKINNY_QR_H
@@ -133,6 +133,26 @@ class SimplicialCholeskyBase : internal::noncopyable
       return derived();
     }
 
+    /** Writes the symbolic decomposition, i.e., the permutation, the elimination tree and the column counts,
+      * to the binary stream \a s. The result can be given to loadSymbolic() to skip the symbolic decomposition
+      * of matrices having the same sparsity pattern.
+      *
+      * The format is compact but not portable across machines having different integer representations.
+      *
+      * \returns whether the writing succeeded
+      * \sa loadSymbolic(), analyzePattern()
+      */
+    bool saveSymbolic(std::ostream& s) const
+    {
+      eigen_assert(m_analysisIsOk && "You must first call analyzePattern()");
+      internal::symbolic_writer<Index> writer(s);
+      writer.writeHeader(internal::SymbolicSimplicialCholesky, UpLo, m_matrix.rows(), m_matrix.cols(), m_patternHash);
+      writer.writeVector(m_P.indices());
+      writer.writeVector(m_parent);
+      writer.writeVector(m_nonZerosPerCol);
+      return writer.finish();
+    }
+
 #ifndef EIGEN_PARSED_BY_DOXYGEN
     /** \internal */
     template<typename Stream>
@@ -217,6 +237,25 @@ class SimplicialCholeskyBase : internal::noncopyable
     
     void ordering(const MatrixType& a, CholMatrixType& ap);
 
+    /** \internal allocates the factor L from the column counts, and discards the row markers of rankUpdate() */
+    void allocateFactor(bool doLDLT)
+    {
+      const Index size = m_parent.size();
+      m_updateTags.resize(0);
+      m_matrix.resize(size, size);
+      Index* Lp = m_matrix.outerIndexPtr();
+      Lp[0] = 0;
+      for(Index k = 0; k < size; ++k)
+        Lp[k+1] = Lp[k] + m_nonZerosPerCol[k] + (doLDLT ? 0 : 1);
+      m_matrix.resizeNonZeros(Lp[size]);
+    }
+
+    bool loadSymbolic(std::istream& s, const MatrixType& a, bool doLDLT);
+
+    template<bool DoLDLT>
+    void rankUpdate(const CholMatrixType& w, const RealScalar& sigma);
+    void insertFill(const std::vector<Index>& path, const std::vector<Index>& fillPtr, const std::vector<Index>& fill);
+
     /** keeps off-diagonal entries; drops diagonal entries */
     struct keep_diag {
       inline bool operator() (const Index& row, const Index& col, const Scalar&) const
@@ -236,9 +275,13 @@ class SimplicialCholeskyBase : internal::noncopyable
     VectorXi m_nonZerosPerCol;
     PermutationMatrix<Dynamic,Dynamic,Index> m_P;     // the permutation
     PermutationMatrix<Dynamic,Dynamic,Index> m_Pinv;  // the inverse permutation
+    unsigned int m_patternHash[2];                    // fingerprint of the pattern of the analyzed matrix
 
     RealScalar m_shiftOffset;
     RealScalar m_shiftScale;
+
+    VectorType m_updateWork;                          // dense workspace of rankUpdate(), zero outside of it
+    Matrix<Index,Dynamic,1> m_updateTags;             // row markers of rankUpdate()
 };
 
 template<typename _MatrixType, int _UpLo = Lower, typename _Ordering = AMDOrdering<typename _MatrixType::Index> > class SimplicialLLT;
@@ -354,6 +397,19 @@ public:
       Base::analyzePattern(a, false);
     }
 
+    /** Loads a symbolic decomposition saved by saveSymbolic() from the binary stream \a s, instead of
+      * calling analyzePattern(\a a).
+      *
+      * \returns false, leaving the current state unchanged, if the stream is invalid, or if it has not been
+      * computed from a matrix having the same dimensions and sparsity pattern as \a a.
+      *
+      * \sa saveSymbolic(), analyzePattern()
+      */
+    bool loadSymbolic(std::istream& s, const MatrixType& a)
+    {
+      return Base::loadSymbolic(s, a, false);
+    }
+
     /** Performs a numeric decomposition of \a matrix
       *
       * The given matrix must has the same sparcity than the matrix on which the symbolic decomposition has been performed.
@@ -365,6 +421,38 @@ public:
       Base::template factorize<false>(a);
     }
 
+    /** Updates the factorization such that it becomes the one of \f$ A + \sigma W W^* \f$, where \a w is
+      * a sparse or dense matrix of k columns. This is a rank-k update, or a downdate if \a sigma is negative.
+      *
+      * The columns of \a w are applied one after the other. The cost of each of them is proportional to the
+      * number of nonzeros of L along the path of its first nonzero in the elimination tree, instead of the
+      * cost of a full factorization. The new nonzeros which may appear along this path are inserted into L.
+      * In this case, the symbolic decomposition no longer matches the original matrix, and analyzePattern()
+      * must be called again before the next factorize(), as well as before saveSymbolic().
+      *
+      * If the resulting matrix is not positive definite, info() returns NumericalIssue.
+      *
+      * \returns a reference to \c *this.
+      *
+      * \sa factorize()
+      */
+    template<typename OtherDerived>
+    SimplicialLLT& rankUpdate(const SparseMatrixBase<OtherDerived>& w, const RealScalar& sigma = 1)
+    {
+      Base::template rankUpdate<false>(CholMatrixType(w.derived()), sigma);
+      return *this;
+    }
+
+    /** This is an overloaded version of rankUpdate() for a dense matrix \a w. */
+    template<typename OtherDerived>
+    SimplicialLLT& rankUpdate(const MatrixBase<OtherDerived>& w, const RealScalar& sigma = 1)
+    {
+      CholMatrixType sw;
+      sw = w.derived().sparseView();
+      Base::template rankUpdate<false>(sw, sigma);
+      return *this;
+    }
+
     /** \returns the determinant of the underlying matrix from the current factorization */
     Scalar determinant() const
     {
@@ -449,6 +537,19 @@ public:
       Base::analyzePattern(a, true);
     }
 
+    /** Loads a symbolic decomposition saved by saveSymbolic() from the binary stream \a s, instead of
+      * calling analyzePattern(\a a).
+      *
+      * \returns false, leaving the current state unchanged, if the stream is invalid, or if it has not been
+      * computed from a matrix having the same dimensions and sparsity pattern as \a a.
+      *
+      * \sa saveSymbolic(), analyzePattern()
+      */
+    bool loadSymbolic(std::istream& s, const MatrixType& a)
+    {
+      return Base::loadSymbolic(s, a, true);
+    }
+
     /** Performs a numeric decomposition of \a matrix
       *
       * The given matrix must has the same sparcity than the matrix on which the symbolic decomposition has been performed.
@@ -460,6 +561,39 @@ public:
       Base::template factorize<true>(a);
     }
 
+    /** Updates the factorization such that it becomes the one of \f$ A + \sigma W W^* \f$, where \a w is
+      * a sparse or dense matrix of k columns. This is a rank-k update, or a downdate if \a sigma is negative.
+      *
+      * The columns of \a w are applied one after the other. The cost of each of them is proportional to the
+      * number of nonzeros of L along the path of its first nonzero in the elimination tree, instead of the
+      * cost of a full factorization. The new nonzeros which may appear along this path are inserted into L.
+      * In this case, the symbolic decomposition no longer matches the original matrix, and analyzePattern()
+      * must be called again before the next factorize(), as well as before saveSymbolic().
+      *
+      * As with factorize(), the resulting matrix may be indefinite: info() returns NumericalIssue only if a
+      * diagonal coefficient of D vanishes.
+      *
+      * \returns a reference to \c *this.
+      *
+      * \sa factorize()
+      */
+    template<typename OtherDerived>
+    SimplicialLDLT& rankUpdate(const SparseMatrixBase<OtherDerived>& w, const RealScalar& sigma = 1)
+    {
+      Base::template rankUpdate<true>(CholMatrixType(w.derived()), sigma);
+      return *this;
+    }
+
+    /** This is an overloaded version of rankUpdate() for a dense matrix \a w. */
+    template<typename OtherDerived>
+    SimplicialLDLT& rankUpdate(const MatrixBase<OtherDerived>& w, const RealScalar& sigma = 1)
+    {
+      CholMatrixType sw;
+      sw = w.derived().sparseView();
+      Base::template rankUpdate<true>(sw, sigma);
+      return *this;
+    }
+
     /** \returns the determinant of the underlying matrix from the current factorization */
     Scalar determinant() const
     {
@@ -544,6 +678,19 @@ public:
       Base::analyzePattern(a, m_LDLT);
     }
 
+    /** Loads a symbolic decomposition saved by saveSymbolic() from the binary stream \a s, instead of
+      * calling analyzePattern(\a a).
+      *
+      * \returns false, leaving the current state unchanged, if the stream is invalid, or if it has not been
+      * computed from a matrix having the same dimensions and sparsity pattern as \a a.
+      *
+      * \sa saveSymbolic(), analyzePattern()
+      */
+    bool loadSymbolic(std::istream& s, const MatrixType& a)
+    {
+      return Base::loadSymbolic(s, a, m_LDLT);
+    }
+
     /** Performs a numeric decomposition of \a matrix
       *
       * The given matrix must has the same sparcity than the matrix on which the symbolic decomposition has been performed.
@@ -558,6 +705,39 @@ public:
         Base::template factorize<false>(a);
     }
 
+    /** Updates the factorization such that it becomes the one of \f$ A + \sigma W W^* \f$, where \a w is
+      * a sparse or dense matrix of k columns. This is a rank-k update, or a downdate if \a sigma is negative.
+      *
+      * The columns of \a w are applied one after the other. The cost of each of them is proportional to the
+      * number of nonzeros of L along the path of its first nonzero in the elimination tree, instead of the
+      * cost of a full factorization. The new nonzeros which may appear along this path are inserted into L.
+      * In this case, the symbolic decomposition no longer matches the original matrix, and analyzePattern()
+      * must be called again before the next factorize(), as well as before saveSymbolic().
+      *
+      * In LLT mode, info() returns NumericalIssue if the resulting matrix is not positive definite. In LDLT mode,
+      * this only happens if a diagonal coefficient of D vanishes.
+      *
+      * \returns a reference to \c *this.
+      *
+      * \sa factorize()
+      */
+    template<typename OtherDerived>
+    SimplicialCholesky& rankUpdate(const SparseMatrixBase<OtherDerived>& w, const RealScalar& sigma = 1)
+    {
+      update(CholMatrixType(w.derived()), sigma);
+      return *this;
+    }
+
+    /** This is an overloaded version of rankUpdate() for a dense matrix \a w. */
+    template<typename OtherDerived>
+    SimplicialCholesky& rankUpdate(const MatrixBase<OtherDerived>& w, const RealScalar& sigma = 1)
+    {
+      CholMatrixType sw;
+      sw = w.derived().sparseView();
+      update(sw, sigma);
+      return *this;
+    }
+
     /** \internal */
     template<typename Rhs,typename Dest>
     void _solve(const MatrixBase<Rhs> &b, MatrixBase<Dest> &dest) const
@@ -610,6 +790,14 @@ public:
     }
     
   protected:
+    void update(const CholMatrixType& w, const RealScalar& sigma)
+    {
+      if(m_LDLT)
+        Base::template rankUpdate<true>(w, sigma);
+      else
+        Base::template rankUpdate<false>(w, sigma);
+    }
+
     bool m_LDLT;
 };
 
@@ -634,6 +822,243 @@ void SimplicialCholeskyBase<Derived>::ordering(const MatrixType& a, CholMatrixTy
 
   ap.resize(size,size);
   ap.template selfadjointView<Upper>() = a.template selfadjointView<UpLo>().twistedBy(m_P);
+  internal::sparse_pattern_hash(a, m_patternHash);
+}
+
+template<typename Derived>
+bool SimplicialCholeskyBase<Derived>::loadSymbolic(std::istream& s, const MatrixType& a, bool doLDLT)
+{
+  eigen_assert(a.rows()==a.cols());
+  const Index size = a.rows();
+  unsigned int hash[2];
+  internal::sparse_pattern_hash(a, hash);
+
+  internal::symbolic_reader<Index> reader(s);
+  PermutationMatrix<Dynamic,Dynamic,Index> P;
+  VectorXi parent, nonZerosPerCol;
+  if(!reader.readHeader(internal::SymbolicSimplicialCholesky, UpLo, size, size, hash)
+     || !reader.readVector(P.indices(), size) || !internal::is_valid_permutation(P.indices(), size)
+     || !reader.readIndices(parent, size, -1, int(size)-1) || parent.size()!=size
+     || !reader.readIndices(nonZerosPerCol, size, 0, int(size)) || nonZerosPerCol.size()!=size
+     || !reader.finish())
+    return false;
+  // the factorization assumes that the parent of a node has a larger index
+  for(Index k = 0; k < size; ++k)
+    if(parent[k]!=-1 && parent[k]<=k)
+      return false;
+
+  m_P = P;
+  if(m_P.size()>0)
+    m_Pinv = m_P.inverse();
+  else
+    m_Pinv.resize(0);
+  m_parent.swap(parent);
+  m_nonZerosPerCol.swap(nonZerosPerCol);
+  m_patternHash[0] = hash[0];
+  m_patternHash[1] = hash[1];
+  allocateFactor(doLDLT);
+
+  m_isInitialized     = true;
+  m_info              = Success;
+  m_analysisIsOk      = true;
+  m_factorizationIsOk = false;
+  return true;
+}
+
+template<typename Derived>
+template<bool DoLDLT>
+void SimplicialCholeskyBase<Derived>::rankUpdate(const CholMatrixType& w, const RealScalar& sigma)
+{
+  using std::sqrt;
+  using std::abs;
+
+  eigen_assert(m_factorizationIsOk && "You must first call factorize()");
+  eigen_assert(w.rows()==m_matrix.rows());
+  if(m_info!=Success || sigma==RealScalar(0))
+    return;
+
+  const Index size = m_matrix.rows();
+  if(m_updateTags.size()!=size)
+  {
+    m_updateTags.setConstant(size, -1);
+    m_updateWork.setZero(size);
+  }
+  // the LLT variant applies the rank-1 updates of sqrt(|sigma|) w, with the sign of sigma
+  const RealScalar scale = DoLDLT ? RealScalar(1) : RealScalar(sqrt(abs(sigma)));
+  const bool isUpdate = sigma > RealScalar(0);
+  Index* tags = m_updateTags.data();
+  Scalar* x = m_updateWork.data();
+
+  std::vector<Index> pattern, next, path, fill, fillPtr;
+  for(Index c = 0; c < w.cols(); ++c)
+  {
+    // nonzero pattern of P w(:,c)
+    pattern.clear();
+    for(typename CholMatrixType::InnerIterator it(w,c); it; ++it)
+      if(it.value()!=Scalar(0))
+        pattern.push_back(m_P.size()>0 ? m_P.indices().coeff(it.index()) : it.index());
+    if(pattern.empty())
+      continue;
+    std::sort(pattern.begin(), pattern.end());
+
+    // Symbolic step: the pattern of w propagates along the path from its first nonzero to the root of the
+    // elimination tree. At each node j, the rows of this pattern which are not in L(:,j) are new fill-in,
+    // and the parent of j becomes the first off-diagonal row of the merged pattern.
+    path.clear();
+    fill.clear();
+    fillPtr.clear();
+    {
+      const Index* Lp = m_matrix.outerIndexPtr();
+      const Index* Lnz = m_matrix.innerNonZeroPtr();
+      const Index* Li = m_matrix.innerIndexPtr();
+      for(Index j = pattern[0]; j != -1; j = m_parent[j])
+      {
+        path.push_back(j);
+        fillPtr.push_back(Index(fill.size()));
+        const Index start = Lp[j] + (DoLDLT ? 0 : 1);
+        const Index end = Lnz ? Lp[j] + Lnz[j] : Lp[j+1];
+        // rows are never removed from L(:,j) until the next analysis, so markers left by previous calls remain valid
+        for(Index p = start; p < end; ++p)
+          tags[Li[p]] = j;
+        for(size_t k = 1; k < pattern.size(); ++k)
+          if(tags[pattern[k]]!=j)
+            fill.push_back(pattern[k]);
+        next.resize((end-start) + (fill.size()-fillPtr.back()));
+        std::merge(Li+start, Li+end, fill.begin()+fillPtr.back(), fill.end(), next.begin());
+        m_parent[j] = next.empty() ? -1 : next[0];
+        pattern.swap(next);
+      }
+      fillPtr.push_back(Index(fill.size()));
+    }
+    if(!fill.empty())
+    {
+      insertFill(path, fillPtr, fill);
+      m_analysisIsOk = false;
+    }
+
+    // Numeric step, along the same path
+    const Index* Lp = m_matrix.outerIndexPtr();
+    const Index* Lnz = m_matrix.innerNonZeroPtr();
+    const Index* Li = m_matrix.innerIndexPtr();
+    Scalar* Lx = m_matrix.valuePtr();
+    for(typename CholMatrixType::InnerIterator it(w,c); it; ++it)
+      x[m_P.size()>0 ? m_P.indices().coeff(it.index()) : it.index()] += scale * it.value();
+
+    bool ok = true;
+    RealScalar t = sigma;   // LDLT
+    RealScalar beta = 1;    // LLT
+    for(size_t q = 0; q < path.size() && ok; ++q)
+    {
+      const Index j = path[q];
+      Index p = Lp[j];
+      const Index end = Lnz ? Lp[j] + Lnz[j] : Lp[j+1];
+      if(DoLDLT)
+      {
+        const Scalar xj = x[j];
+        const RealScalar dj = numext::real(m_diag[j]);
+        const RealScalar dbar = dj + t * numext::abs2(xj);
+        if(dbar == RealScalar(0))
+        {
+          ok = false;
+          break;
+        }
+        const Scalar gamma = t * numext::conj(xj) / dbar;
+        t = dj * t / dbar;
+        m_diag[j] = dbar;
+        for(; p < end; ++p)
+        {
+          Scalar& xi = x[Li[p]];
+          xi -= xj * Lx[p];
+          Lx[p] += gamma * xi;
+        }
+      }
+      else
+      {
+        const Scalar alpha = x[j] / Lx[p];
+        RealScalar beta2 = beta*beta + (isUpdate ? numext::abs2(alpha) : -numext::abs2(alpha));
+        if(beta2 <= RealScalar(0))
+        {
+          ok = false;
+          break;
+        }
+        beta2 = sqrt(beta2);
+        const RealScalar delta = isUpdate ? beta/beta2 : beta2/beta;
+        const Scalar gamma = (isUpdate ? numext::conj(alpha) : Scalar(-numext::conj(alpha))) / (beta2*beta);
+        Lx[p] = delta * Lx[p] + (isUpdate ? Scalar(gamma * x[j]) : Scalar(0));
+        beta = beta2;
+        for(++p; p < end; ++p)
+        {
+          Scalar& xi = x[Li[p]];
+          const Scalar w1 = xi;
+          xi -= alpha * Lx[p];
+          Lx[p] = delta * Lx[p] + gamma * (isUpdate ? w1 : xi);
+        }
+      }
+    }
+
+    // the nonzeros of the workspace are on the path
+    for(size_t q = 0; q < path.size(); ++q)
+      x[path[q]] = Scalar(0);
+    if(!ok)
+    {
+      m_info = NumericalIssue;
+      return;
+    }
+  }
+}
+
+/** \internal inserts the sorted rows fill[fillPtr[q]:fillPtr[q+1]] as explicit zeros into the columns path[q] of L,
+  * reserving room for future insertions when a column is full */
+template<typename Derived>
+void SimplicialCholeskyBase<Derived>::insertFill(const std::vector<Index>& path, const std::vector<Index>& fillPtr, const std::vector<Index>& fill)
+{
+  bool full = m_matrix.isCompressed();
+  for(size_t q = 0; q < path.size() && !full; ++q)
+  {
+    const Index j = path[q];
+    const Index* Lp = m_matrix.outerIndexPtr();
+    full = Lp[j+1] - Lp[j] - m_matrix.innerNonZeroPtr()[j] < fillPtr[q+1] - fillPtr[q];
+  }
+  if(full)
+  {
+    // twice the required room, such that repeated updates along the same path do not move L every time
+    VectorXi reserveSizes = VectorXi::Zero(m_matrix.cols());
+    for(size_t q = 0; q < path.size(); ++q)
+      reserveSizes[path[q]] = 2 * (fillPtr[q+1] - fillPtr[q]);
+    m_matrix.reserve(reserveSizes);
+  }
+
+  const Index* Lp = m_matrix.outerIndexPtr();
+  Index* Lnz = m_matrix.innerNonZeroPtr();
+  Index* Li = m_matrix.innerIndexPtr();
+  Scalar* Lx = m_matrix.valuePtr();
+  for(size_t q = 0; q < path.size(); ++q)
+  {
+    const Index j = path[q];
+    Index k = fillPtr[q+1] - 1;
+    if(k < fillPtr[q])
+      continue;
+    // merge from the end of the column
+    Index src = Lp[j] + Lnz[j] - 1;
+    Index dst = src + (fillPtr[q+1] - fillPtr[q]);
+    Lnz[j] += fillPtr[q+1] - fillPtr[q];
+    m_nonZerosPerCol[j] += fillPtr[q+1] - fillPtr[q];
+    for(; k >= fillPtr[q]; --dst)
+    {
+      if(src >= Lp[j] && Li[src] > fill[k])
+      {
+        Li[dst] = Li[src];
+        Lx[dst] = Lx[src];
+        --src;
+      }
+      else
+      {
+        Li[dst] = fill[k];
+        Lx[dst] = Scalar(0);
+        --k;
+      }
+    }
+  }
 }
 
 namespace internal {
@@ -0,0 +1,1023 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SUPERNODAL_CHOLESKY_H
+#define EIGEN_SUPERNODAL_CHOLESKY_H
+
+namespace Eigen {
+
+template<typename _MatrixType, int _UpLo = Lower, typename _Ordering = AMDOrdering<typename _MatrixType::Index> > class SupernodalLLT;
+template<typename _MatrixType, int _UpLo = Lower, typename _Ordering = AMDOrdering<typename _MatrixType::Index> > class SupernodalLDLT;
+
+namespace internal {
+
+/** \internal Computes the elimination tree of the matrix whose upper triangular part is stored in \a ap.
+  * The roots have -1 as parent. */
+template<typename MatrixType, typename IndexVector>
+void supernodal_elimination_tree(const MatrixType& ap, IndexVector& parent)
+{
+  typedef typename MatrixType::Index Index;
+  const Index size = ap.cols();
+  parent.resize(size);
+  IndexVector ancestor(size);
+  for(Index k=0; k<size; ++k)
+  {
+    parent[k] = -1;
+    ancestor[k] = -1;
+    for(typename MatrixType::InnerIterator it(ap,k); it; ++it)
+    {
+      // climb from i to the root of its current subtree, with path compression
+      for(Index i=it.index(); i!=-1 && i<k; )
+      {
+        Index next = ancestor[i];
+        ancestor[i] = k;
+        if(next==-1)
+          parent[i] = k;
+        i = next;
+      }
+    }
+  }
+}
+
+/** \internal In place LDL^T factorization without pivoting of the lower triangular part of the dense matrix \a mat.
+  * \returns the index of the first zero pivot, or -1 on success */
+template<typename MatrixType, typename DiagType>
+typename MatrixType::Index supernodal_ldlt_inplace(MatrixType& mat, DiagType& diag)
+{
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  const Index size = mat.rows();
+  Matrix<Scalar,Dynamic,1> temp(size);
+  for(Index k=0; k<size; ++k)
+  {
+    const Index rs = size-k;
+    if(k>0)
+    {
+      // left-looking update of the column k: A(k:,k) -= L(k:,0:k) D(0:k) L(k,0:k)^*
+      temp.head(k) = diag.head(k).cwiseProduct(mat.row(k).head(k).adjoint());
+      mat.col(k).tail(rs).noalias() -= mat.block(k,0,rs,k) * temp.head(k);
+    }
+    RealScalar d = numext::real(mat.coeff(k,k));
+    diag.coeffRef(k) = d;
+    if(d==RealScalar(0))
+      return k;
+    mat.coeffRef(k,k) = Scalar(1);
+    mat.col(k).tail(rs-1) /= d;
+  }
+  return -1;
+}
+
+} // end namespace internal
+
+/** \ingroup SparseCholesky_Module
+  * \brief Base class of the supernodal sparse Cholesky factorizations
+  *
+  * The supernodal factorizations group the consecutive columns of the factor L sharing the same
+  * sparsity pattern below their diagonal, the so called supernodes, and store each supernode as a
+  * dense column-major panel. The numerical factorization is left-looking: each supernode gathers
+  * the updates of its descendants in the elimination tree as dense matrix products, and is then
+  * factorized with the dense Cholesky and triangular solve routines. All these operations go through
+  * the Eigen's matrix-matrix product kernels, which makes these factorizations much faster than
+  * the simplicial ones as soon as the factor L is not extremely sparse.
+  *
+  * In order to reduce the fill-in, a symmetric permutation P is applied prior to the factorization
+  * such that the factorized matrix is P A P^-1. The elimination tree of P A P^-1 is postordered,
+  * and a few explicit zeros are allowed in the small supernodes to make them larger (relaxed supernodes).
+  *
+  * When OpenMP is enabled, the independent subtrees of the elimination tree can be factorized in
+  * parallel, see setParallelTreeSchedule(). The supernodes of a same level of the tree are then
+  * distributed over the threads, while the large supernodes close to the root still benefit from the
+  * multithreaded matrix products. In both cases, the result does not depend on the number of threads.
+  *
+  * \sa class SupernodalLLT, class SupernodalLDLT, class SimplicialCholeskyBase
+  */
+template<typename Derived>
+class SupernodalCholeskyBase : internal::noncopyable
+{
+  public:
+    typedef typename internal::traits<Derived>::MatrixType MatrixType;
+    typedef typename internal::traits<Derived>::OrderingType OrderingType;
+    enum {
+      UpLo = internal::traits<Derived>::UpLo,
+      DoLDLT = internal::traits<Derived>::DoLDLT
+    };
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::RealScalar RealScalar;
+    typedef typename MatrixType::Index Index;
+    typedef SparseMatrix<Scalar,ColMajor,Index> CholMatrixType;
+    typedef Matrix<Scalar,Dynamic,1> VectorType;
+    typedef Matrix<Index,Dynamic,1> IndexVector;
+    typedef Matrix<DenseIndex,Dynamic,1> OffsetVector;
+    typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrixType;
+    typedef Map<DenseMatrixType> PanelType;
+    typedef Map<const DenseMatrixType> ConstPanelType;
+    typedef Map<DenseMatrixType,0,OuterStride<> > PanelBlockType;
+    typedef Map<const DenseMatrixType,0,OuterStride<> > ConstPanelBlockType;
+
+  public:
+
+    /** Default constructor */
+    SupernodalCholeskyBase()
+      : m_info(Success), m_isInitialized(false), m_factorizationIsOk(false), m_analysisIsOk(false),
+        m_shiftOffset(0), m_shiftScale(1), m_parallelTreeSchedule(false)
+    {}
+
+    Derived& derived() { return *static_cast<Derived*>(this); }
+    const Derived& derived() const { return *static_cast<const Derived*>(this); }
+
+    inline Index cols() const { return m_size; }
+    inline Index rows() const { return m_size; }
+
+    /** Computes the sparse Cholesky decomposition of \a matrix */
+    Derived& compute(const MatrixType& matrix)
+    {
+      analyzePattern(matrix);
+      factorize(matrix);
+      return derived();
+    }
+
+    /** Performs a symbolic decomposition on the sparsity of \a matrix: computes the fill reducing
+      * ordering, the elimination tree, the supernodes and the structure of the factor.
+      *
+      * This function is particularly useful when solving for several problems having the same structure.
+      *
+      * \sa factorize()
+      */
+    void analyzePattern(const MatrixType& matrix);
+
+    /** Performs a numeric decomposition of \a matrix
+      *
+      * The given matrix must have the same sparsity as the matrix on which the symbolic decomposition has been performed.
+      *
+      * \sa analyzePattern()
+      */
+    void factorize(const MatrixType& matrix)
+    {
+      eigen_assert(m_analysisIsOk && "You must first call analyzePattern()");
+      eigen_assert(matrix.rows()==matrix.cols() && matrix.rows()==m_size);
+      CholMatrixType ap(m_size,m_size);
+      ap.template selfadjointView<Lower>() = matrix.template selfadjointView<UpLo>().twistedBy(m_P);
+      factorize_preordered(ap);
+    }
+
+    /** \brief Reports whether previous computation was successful.
+      *
+      * \returns \c Success if computation was succesful,
+      *          \c NumericalIssue if the matrix appears not to be positive definite (LLT), or has a zero pivot (LDLT).
+      */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "Decomposition is not initialized.");
+      return m_info;
+    }
+
+    /** \returns the solution x of \f$ A x = b \f$ using the current decomposition of A.
+      *
+      * \sa compute()
+      */
+    template<typename Rhs>
+    inline const internal::solve_retval<SupernodalCholeskyBase, Rhs>
+    solve(const MatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_isInitialized && "Supernodal LLT or LDLT is not initialized.");
+      eigen_assert(rows()==b.rows()
+                && "SupernodalCholeskyBase::solve(): invalid number of rows of the right hand side matrix b");
+      return internal::solve_retval<SupernodalCholeskyBase, Rhs>(*this, b.derived());
+    }
+
+    /** \returns the solution x of \f$ A x = b \f$ using the current decomposition of A.
+      *
+      * \sa compute()
+      */
+    template<typename Rhs>
+    inline const internal::sparse_solve_retval<SupernodalCholeskyBase, Rhs>
+    solve(const SparseMatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_isInitialized && "Supernodal LLT or LDLT is not initialized.");
+      eigen_assert(rows()==b.rows()
+                && "SupernodalCholeskyBase::solve(): invalid number of rows of the right hand side matrix b");
+      return internal::sparse_solve_retval<SupernodalCholeskyBase, Rhs>(*this, b.derived());
+    }
+
+    /** \returns the permutation P
+      * \sa permutationPinv() */
+    const PermutationMatrix<Dynamic,Dynamic,Index>& permutationP() const
+    { return m_P; }
+
+    /** \returns the inverse P^-1 of the permutation P
+      * \sa permutationP() */
+    const PermutationMatrix<Dynamic,Dynamic,Index>& permutationPinv() const
+    { return m_Pinv; }
+
+    /** Sets the shift parameters that will be used to adjust the diagonal coefficients during the numerical factorization.
+      *
+      * During the numerical factorization, the diagonal coefficients are transformed by the following linear model:\n
+      * \c d_ii = \a offset + \a scale * \c d_ii
+      *
+      * The default is the identity transformation with \a offset=0, and \a scale=1.
+      *
+      * \returns a reference to \c *this.
+      */
+    Derived& setShift(const RealScalar& offset, const RealScalar& scale = 1)
+    {
+      m_shiftOffset = offset;
+      m_shiftScale = scale;
+      return derived();
+    }
+
+    /** Enables or disables the parallel factorization of the independent subtrees of the elimination tree.
+      * This option requires OpenMP, and is disabled by default.
+      *
+      * \returns a reference to \c *this.
+      */
+    Derived& setParallelTreeSchedule(bool enable)
+    {
+      m_parallelTreeSchedule = enable;
+      return derived();
+    }
+
+    /** \returns whether the independent subtrees of the elimination tree are factorized in parallel */
+    bool parallelTreeSchedule() const { return m_parallelTreeSchedule; }
+
+    /** Writes the symbolic decomposition, i.e., the permutation, the elimination tree, the supernodes
+      * and the structure of the factor, to the binary stream \a s. The result can be given to loadSymbolic()
+      * to skip the symbolic decomposition of matrices having the same sparsity pattern.
+      *
+      * The format is compact but not portable across machines having different integer representations.
+      *
+      * \returns whether the writing succeeded
+      * \sa loadSymbolic(), analyzePattern()
+      */
+    bool saveSymbolic(std::ostream& s) const;
+
+    /** Loads a symbolic decomposition saved by saveSymbolic() from the binary stream \a s, instead of
+      * calling analyzePattern(\a matrix). The symbolic decompositions of SupernodalLLT and SupernodalLDLT
+      * are interchangeable.
+      *
+      * \returns false, leaving the current state unchanged, if the stream is invalid, or if it has not been
+      * computed from a matrix having the same dimensions and sparsity pattern as \a matrix.
+      *
+      * \sa saveSymbolic(), analyzePattern()
+      */
+    bool loadSymbolic(std::istream& s, const MatrixType& matrix);
+
+    /** \returns the number of supernodes */
+    Index supernodeCount() const
+    {
+      eigen_assert(m_analysisIsOk && "You must first call analyzePattern()");
+      return m_superStart.size()-1;
+    }
+
+    /** \returns the index of the first column of each supernode, followed by the size of the matrix */
+    const IndexVector& supernodeStarts() const
+    {
+      eigen_assert(m_analysisIsOk && "You must first call analyzePattern()");
+      return m_superStart;
+    }
+
+    /** \returns the number of stored coefficients of the factor L, including the explicit zeros of the relaxed supernodes */
+    DenseIndex nonZeros() const
+    {
+      eigen_assert(m_analysisIsOk && "You must first call analyzePattern()");
+      DenseIndex nnz = 0;
+      for(Index s=0; s<supernodeCount(); ++s)
+      {
+        DenseIndex width = m_superStart[s+1]-m_superStart[s];
+        nnz += width*(m_rowPtr[s+1]-m_rowPtr[s]) - width*(width-1)/2;
+      }
+      return nnz;
+    }
+
+#ifndef EIGEN_PARSED_BY_DOXYGEN
+    /** \internal */
+    template<typename Rhs,typename Dest>
+    void _solve(const MatrixBase<Rhs> &b, MatrixBase<Dest> &dest) const
+    {
+      eigen_assert(m_factorizationIsOk && "The decomposition is not in a valid state for solving, you must first call either compute() or analyzePattern()/factorize()");
+      eigen_assert(m_size==b.rows());
+
+      if(m_info!=Success)
+        return;
+
+      dest = m_P * b;
+      solveInPlace(dest);
+      dest = m_Pinv * dest;
+    }
+#endif // EIGEN_PARSED_BY_DOXYGEN
+
+  protected:
+
+    void factorize_preordered(const CholMatrixType& ap);
+    bool factorizeSupernode(Index s, const CholMatrixType& ap, Index* map, Scalar* buffer);
+
+    template<typename Dest>
+    void solveInPlace(MatrixBase<Dest>& x) const;
+
+    PanelType panel(Index s)
+    {
+      return PanelType(m_values.data()+m_valuePtr[s], m_rowPtr[s+1]-m_rowPtr[s], m_superStart[s+1]-m_superStart[s]);
+    }
+    ConstPanelType panel(Index s) const
+    {
+      return constPanel(s);
+    }
+    ConstPanelType constPanel(Index s) const
+    {
+      return ConstPanelType(m_values.data()+m_valuePtr[s], m_rowPtr[s+1]-m_rowPtr[s], m_superStart[s+1]-m_superStart[s]);
+    }
+
+    /** \returns the sparse representation of the factor L, including the explicit zeros of the relaxed supernodes */
+    CholMatrixType factorL() const
+    {
+      eigen_assert(m_factorizationIsOk && "The decomposition is not in a valid state");
+      CholMatrixType L(m_size,m_size);
+      L.reserve(nonZeros());
+      for(Index s=0; s<supernodeCount(); ++s)
+      {
+        ConstPanelType p = panel(s);
+        const Index* rows = m_rowIdx.data()+m_rowPtr[s];
+        for(Index j=0; j<p.cols(); ++j)
+        {
+          L.startVec(m_superStart[s]+j);
+          for(Index i=j; i<p.rows(); ++i)
+            L.insertBack(rows[i],m_superStart[s]+j) = p.coeff(i,j);
+        }
+      }
+      L.finalize();
+      return L;
+    }
+
+    // Relaxed supernodes: a supernode of width w can be extended if the ratio of explicit zeros remains lower than
+    // the following thresholds, which are the default relaxation parameters of CHOLMOD.
+    static bool acceptRelaxedSupernode(DenseIndex width, DenseIndex zeros, DenseIndex entries)
+    {
+      double ratio = double(zeros)/double(entries);
+      return zeros==0 || width<=4 || (width<=16 && ratio<0.8) || (width<=48 && ratio<0.1) || ratio<0.05;
+    }
+
+    mutable ComputationInfo m_info;
+    bool m_isInitialized;
+    bool m_factorizationIsOk;
+    bool m_analysisIsOk;
+    Index m_size;
+
+    PermutationMatrix<Dynamic,Dynamic,Index> m_P;     // the permutation
+    PermutationMatrix<Dynamic,Dynamic,Index> m_Pinv;  // the inverse permutation
+
+    IndexVector m_parent;       // elimination tree of the columns
+    IndexVector m_superStart;   // first column of each supernode
+    IndexVector m_superParent;  // supernodal elimination tree
+    IndexVector m_colToSuper;   // supernode of each column
+    IndexVector m_rowPtr;       // start of the row indices of each supernode in m_rowIdx
+    IndexVector m_rowIdx;       // sorted row indices of the supernodes, starting with their own columns
+    OffsetVector m_valuePtr;    // start of the dense panel of each supernode in m_values
+    VectorType m_values;        // column-major dense panels of the supernodes
+    VectorType m_diag;          // the diagonal coefficients (LDLT mode)
+
+    // for each supernode, the list of the descendants which update it, with the range of their rows
+    // falling into the columns of the supernode
+    IndexVector m_updatePtr, m_updateSuper, m_updateStart, m_updateEnd;
+    // the supernodes grouped by their height in the supernodal elimination tree
+    IndexVector m_levelPtr, m_levelSuper;
+    DenseIndex m_bufferSize;
+    unsigned int m_patternHash[2]; // fingerprint of the pattern of the analyzed matrix
+
+    RealScalar m_shiftOffset;
+    RealScalar m_shiftScale;
+    bool m_parallelTreeSchedule;
+};
+
+template<typename Derived>
+void SupernodalCholeskyBase<Derived>::analyzePattern(const MatrixType& a)
+{
+  eigen_assert(a.rows()==a.cols());
+  const Index size = a.rows();
+  m_size = size;
+
+  // 1 - fill reducing ordering. Note that the ordering methods compute the inverse permutation.
+  {
+    CholMatrixType C;
+    C = a.template selfadjointView<UpLo>();
+    OrderingType ordering;
+    ordering(C,m_Pinv);
+  }
+  if(m_Pinv.size()>0)
+    m_P = m_Pinv.inverse();
+  else
+  {
+    m_P.resize(size);
+    m_P.setIdentity();
+  }
+
+  // 2 - postorder the elimination tree such that the columns of the supernodes are consecutive
+  CholMatrixType ap(size,size);
+  ap.template selfadjointView<Upper>() = a.template selfadjointView<UpLo>().twistedBy(m_P);
+  internal::supernodal_elimination_tree(ap, m_parent);
+  {
+    IndexVector treeParent(size+1), post;
+    for(Index k=0; k<size; ++k)
+      treeParent[k] = m_parent[k]==-1 ? size : m_parent[k];
+    internal::treePostorder(size, treeParent, post);
+    for(Index k=0; k<size; ++k)
+      m_P.indices()[k] = post[m_P.indices()[k]];
+    m_Pinv = m_P.inverse();
+    ap.template selfadjointView<Upper>() = a.template selfadjointView<UpLo>().twistedBy(m_P);
+    internal::supernodal_elimination_tree(ap, m_parent);
+  }
+
+  // 3 - number of off-diagonal entries of each column of L, by traversing the row subtrees
+  IndexVector colCount = IndexVector::Zero(size);
+  IndexVector tags(size);
+  for(Index k=0; k<size; ++k)
+  {
+    tags[k] = k;
+    for(typename CholMatrixType::InnerIterator it(ap,k); it; ++it)
+      for(Index i=it.index(); i<k && tags[i]!=k; i=m_parent[i])
+      {
+        ++colCount[i];
+        tags[i] = k;
+      }
+  }
+
+  // 4 - detect the (relaxed) supernodes along the chains of the elimination tree
+  std::vector<Index> starts;
+  starts.push_back(0);
+  DenseIndex entries = colCount[0]+1;
+  for(Index j=0; j+1<size; ++j)
+  {
+    DenseIndex width = j+2-starts.back();
+    DenseIndex newEntries = entries + colCount[j+1]+1;
+    DenseIndex padded = width*(width+1)/2 + width*DenseIndex(colCount[j+1]);
+    if(m_parent[j]==j+1 && acceptRelaxedSupernode(width, padded-newEntries, padded))
+      entries = newEntries;
+    else
+    {
+      starts.push_back(j+1);
+      entries = colCount[j+1]+1;
+    }
+  }
+  starts.push_back(size);
+  const Index nsuper = Index(starts.size())-1;
+  m_superStart = Map<IndexVector>(&starts[0], nsuper+1);
+  m_colToSuper.resize(size);
+  m_superParent.resize(nsuper);
+  for(Index s=0; s<nsuper; ++s)
+  {
+    m_colToSuper.segment(m_superStart[s], m_superStart[s+1]-m_superStart[s]).setConstant(s);
+  }
+  for(Index s=0; s<nsuper; ++s)
+  {
+    Index p = m_parent[m_superStart[s+1]-1];
+    m_superParent[s] = p==-1 ? -1 : m_colToSuper[p];
+  }
+
+  // 5 - row structure of the supernodes: their own columns, followed by the rows of their last column
+  m_rowPtr.resize(nsuper+1);
+  m_valuePtr.resize(nsuper+1);
+  m_rowPtr[0] = 0;
+  m_valuePtr[0] = 0;
+  for(Index s=0; s<nsuper; ++s)
+  {
+    Index width = m_superStart[s+1]-m_superStart[s];
+    Index rows = width + colCount[m_superStart[s+1]-1];
+    m_rowPtr[s+1] = m_rowPtr[s] + rows;
+    m_valuePtr[s+1] = m_valuePtr[s] + DenseIndex(rows)*DenseIndex(width);
+  }
+  m_rowIdx.resize(m_rowPtr[nsuper]);
+  IndexVector pos(nsuper);
+  for(Index s=0; s<nsuper; ++s)
+  {
+    Index width = m_superStart[s+1]-m_superStart[s];
+    for(Index j=0; j<width; ++j)
+      m_rowIdx[m_rowPtr[s]+j] = m_superStart[s]+j;
+    pos[s] = m_rowPtr[s]+width;
+  }
+  for(Index k=0; k<size; ++k)
+  {
+    tags[k] = k;
+    for(typename CholMatrixType::InnerIterator it(ap,k); it; ++it)
+      for(Index i=it.index(); i<k && tags[i]!=k; i=m_parent[i])
+      {
+        tags[i] = k;
+        Index s = m_colToSuper[i];
+        if(i==m_superStart[s+1]-1)
+          m_rowIdx[pos[s]++] = k;
+      }
+  }
+
+  // 6 - the updates: the rows of a supernode K below its diagonal block are split into ranges
+  //     falling into the columns of its ancestors J, each range corresponding to an update of J by K
+  m_updatePtr.setZero(nsuper+1);
+  for(int pass=0; pass<2; ++pass)
+  {
+    if(pass==1)
+    {
+      for(Index s=0; s<nsuper; ++s)
+        m_updatePtr[s+1] += m_updatePtr[s];
+      Index count = m_updatePtr[nsuper];
+      m_updateSuper.resize(count);
+      m_updateStart.resize(count);
+      m_updateEnd.resize(count);
+      pos = m_updatePtr.head(nsuper);
+    }
+    m_bufferSize = 0;
+    for(Index k=0; k<nsuper; ++k)
+    {
+      const Index width = m_superStart[k+1]-m_superStart[k];
+      const Index rows = m_rowPtr[k+1]-m_rowPtr[k];
+      const Index* rowIdx = m_rowIdx.data()+m_rowPtr[k];
+      for(Index r=width; r<rows; )
+      {
+        Index j = m_colToSuper[rowIdx[r]];
+        Index end = r+1;
+        while(end<rows && rowIdx[end]<m_superStart[j+1])
+          ++end;
+        if(pass==0)
+          ++m_updatePtr[j+1];
+        else
+        {
+          Index u = pos[j]++;
+          m_updateSuper[u] = k;
+          m_updateStart[u] = r;
+          m_updateEnd[u] = end;
+        }
+        // the update buffer, and the scaled rows in LDLT mode
+        m_bufferSize = (std::max)(m_bufferSize, DenseIndex(rows-r)*DenseIndex(end-r) + DenseIndex(end-r)*DenseIndex(width));
+        r = end;
+      }
+    }
+  }
+
+  // 7 - levels of the supernodal elimination tree: the supernodes of a same level are independent
+  {
+    IndexVector height = IndexVector::Zero(nsuper);
+    Index maxHeight = 0;
+    for(Index s=0; s<nsuper; ++s)
+    {
+      if(m_superParent[s]!=-1)
+        height[m_superParent[s]] = (std::max)(height[m_superParent[s]], Index(height[s]+1));
+      maxHeight = (std::max)(maxHeight, Index(height[s]));
+    }
+    m_levelPtr.setZero(maxHeight+2);
+    for(Index s=0; s<nsuper; ++s)
+      ++m_levelPtr[height[s]+1];
+    for(Index l=0; l<=maxHeight; ++l)
+      m_levelPtr[l+1] += m_levelPtr[l];
+    m_levelSuper.resize(nsuper);
+    IndexVector levelPos = m_levelPtr.head(maxHeight+1);
+    for(Index s=0; s<nsuper; ++s)
+      m_levelSuper[levelPos[height[s]]++] = s;
+  }
+
+  internal::sparse_pattern_hash(a, m_patternHash);
+  m_isInitialized     = true;
+  m_info              = Success;
+  m_analysisIsOk      = true;
+  m_factorizationIsOk = false;
+}
+
+template<typename Derived>
+bool SupernodalCholeskyBase<Derived>::saveSymbolic(std::ostream& s) const
+{
+  eigen_assert(m_analysisIsOk && "You must first call analyzePattern()");
+  internal::symbolic_writer<Index> writer(s);
+  writer.writeHeader(internal::SymbolicSupernodalCholesky, UpLo, m_size, m_size, m_patternHash);
+  writer.writeVector(m_P.indices());
+  writer.writeVector(m_parent);
+  writer.writeVector(m_superStart);
+  writer.writeVector(m_rowPtr);
+  writer.writeVector(m_rowIdx);
+  writer.writeVector(m_updatePtr);
+  writer.writeVector(m_updateSuper);
+  writer.writeVector(m_updateStart);
+  writer.writeVector(m_updateEnd);
+  writer.writeVector(m_levelPtr);
+  writer.writeVector(m_levelSuper);
+  writer.write(m_bufferSize);
+  return writer.finish();
+}
+
+template<typename Derived>
+bool SupernodalCholeskyBase<Derived>::loadSymbolic(std::istream& s, const MatrixType& a)
+{
+  eigen_assert(a.rows()==a.cols());
+  const Index size = a.rows();
+  unsigned int hash[2];
+  internal::sparse_pattern_hash(a, hash);
+
+  internal::symbolic_reader<Index> reader(s);
+  PermutationMatrix<Dynamic,Dynamic,Index> P;
+  IndexVector parent, superStart, rowPtr, rowIdx, updatePtr, updateSuper, updateStart, updateEnd, levelPtr, levelSuper;
+  DenseIndex bufferSize;
+  if(!reader.readHeader(internal::SymbolicSupernodalCholesky, UpLo, size, size, hash)
+     || !reader.readVector(P.indices(), size) || P.size()!=size || !internal::is_valid_permutation(P.indices(), size)
+     || !reader.readIndices(parent, size, -1, size-1) || parent.size()!=size
+     || !reader.readIndices(superStart, size+1, 0, size) || superStart.size()<1)
+    return false;
+  const Index nsuper = superStart.size()-1;
+  if(!reader.readIndices(rowPtr, nsuper+1, 0, NumTraits<Index>::highest()) || rowPtr.size()!=nsuper+1
+     || !reader.readIndices(rowIdx, rowPtr[nsuper], 0, size-1) || rowIdx.size()!=rowPtr[nsuper]
+     || !reader.readIndices(updatePtr, nsuper+1, 0, NumTraits<Index>::highest()) || updatePtr.size()!=nsuper+1
+     || !reader.readIndices(updateSuper, updatePtr[nsuper], 0, nsuper-1) || updateSuper.size()!=updatePtr[nsuper]
+     || !reader.readVector(updateStart, updatePtr[nsuper]) || updateStart.size()!=updatePtr[nsuper]
+     || !reader.readVector(updateEnd, updatePtr[nsuper]) || updateEnd.size()!=updatePtr[nsuper]
+     || !reader.readIndices(levelPtr, nsuper+1, 0, nsuper) || levelPtr.size()<1
+     || !reader.readIndices(levelSuper, nsuper, 0, nsuper-1) || levelSuper.size()!=nsuper
+     || !reader.read(bufferSize) || bufferSize<0
+     || !reader.finish())
+    return false;
+
+  // check the consistency of the pointers, the other entries are protected by the checksum
+  if(superStart[0]!=0 || superStart[nsuper]!=size || rowPtr[0]!=0 || updatePtr[0]!=0
+     || levelPtr[0]!=0 || levelPtr[levelPtr.size()-1]!=nsuper)
+    return false;
+  for(Index k=0; k<nsuper; ++k)
+    if(superStart[k+1]<=superStart[k] || rowPtr[k+1]-rowPtr[k]<superStart[k+1]-superStart[k] || updatePtr[k+1]<updatePtr[k])
+      return false;
+  for(Index l=0; l+1<levelPtr.size(); ++l)
+    if(levelPtr[l+1]<levelPtr[l])
+      return false;
+
+  m_size = size;
+  m_P = P;
+  m_Pinv = m_P.inverse();
+  m_parent.swap(parent);
+  m_superStart.swap(superStart);
+  m_rowPtr.swap(rowPtr);
+  m_rowIdx.swap(rowIdx);
+  m_updatePtr.swap(updatePtr);
+  m_updateSuper.swap(updateSuper);
+  m_updateStart.swap(updateStart);
+  m_updateEnd.swap(updateEnd);
+  m_levelPtr.swap(levelPtr);
+  m_levelSuper.swap(levelSuper);
+  m_bufferSize = bufferSize;
+  m_patternHash[0] = hash[0];
+  m_patternHash[1] = hash[1];
+
+  // the derived quantities
+  m_colToSuper.resize(size);
+  m_superParent.resize(nsuper);
+  m_valuePtr.resize(nsuper+1);
+  m_valuePtr[0] = 0;
+  for(Index k=0; k<nsuper; ++k)
+  {
+    Index width = m_superStart[k+1]-m_superStart[k];
+    m_colToSuper.segment(m_superStart[k], width).setConstant(k);
+    m_valuePtr[k+1] = m_valuePtr[k] + DenseIndex(m_rowPtr[k+1]-m_rowPtr[k])*DenseIndex(width);
+  }
+  for(Index k=0; k<nsuper; ++k)
+  {
+    Index p = m_parent[m_superStart[k+1]-1];
+    m_superParent[k] = p==-1 ? -1 : m_colToSuper[p];
+  }
+
+  m_isInitialized     = true;
+  m_info              = Success;
+  m_analysisIsOk      = true;
+  m_factorizationIsOk = false;
+  return true;
+}
+
+template<typename Derived>
+bool SupernodalCholeskyBase<Derived>::factorizeSupernode(Index s, const CholMatrixType& ap, Index* map, Scalar* buffer)
+{
+  const Index first = m_superStart[s];
+  const Index width = m_superStart[s+1]-first;
+  const Index rows = m_rowPtr[s+1]-m_rowPtr[s];
+  const Index* rowIdx = m_rowIdx.data()+m_rowPtr[s];
+  PanelType L = panel(s);
+
+  // scatter the columns of A
+  L.setZero();
+  for(Index r=0; r<rows; ++r)
+    map[rowIdx[r]] = r;
+  for(Index j=0; j<width; ++j)
+  {
+    for(typename CholMatrixType::InnerIterator it(ap,first+j); it; ++it)
+      L.coeffRef(map[it.index()],j) = it.value();
+    L.coeffRef(j,j) = numext::real(L.coeff(j,j)) * m_shiftScale + m_shiftOffset;
+  }
+
+  // gather the updates of the descendants
+  for(Index u=m_updatePtr[s]; u<m_updatePtr[s+1]; ++u)
+  {
+    const Index k = m_updateSuper[u];
+    const Index start = m_updateStart[u];
+    const Index nr = m_rowPtr[k+1]-m_rowPtr[k]-start;
+    const Index nc = m_updateEnd[u]-start;
+    const Index* rowIdxK = m_rowIdx.data()+m_rowPtr[k]+start;
+    ConstPanelType LK = constPanel(k);
+    Map<DenseMatrixType> update(buffer, nr, nc);
+    if(DoLDLT)
+    {
+      Map<DenseMatrixType> scaled(buffer+DenseIndex(nr)*DenseIndex(nc), nc, LK.cols());
+      scaled = LK.middleRows(start,nc) * m_diag.segment(m_superStart[k],LK.cols()).asDiagonal();
+      update.noalias() = LK.middleRows(start,nr) * scaled.adjoint();
+    }
+    else
+    {
+      update.noalias() = LK.middleRows(start,nr) * LK.middleRows(start,nc).adjoint();
+    }
+    for(Index j=0; j<nc; ++j)
+    {
+      const Index col = rowIdxK[j]-first;
+      for(Index i=j; i<nr; ++i)
+        L.coeffRef(map[rowIdxK[i]],col) -= update.coeff(i,j);
+    }
+  }
+
+  // dense factorization of the diagonal block, and triangular solve of the rows below
+  PanelBlockType diagBlock(L.data(), width, width, OuterStride<>(rows));
+  PanelBlockType below(L.data()+width, rows-width, width, OuterStride<>(rows));
+  if(DoLDLT)
+  {
+    typename VectorType::SegmentReturnType d(m_diag.segment(first,width));
+    if(internal::supernodal_ldlt_inplace(diagBlock, d)>=0)
+      return false;
+    if(rows>width)
+    {
+      diagBlock.template triangularView<UnitLower>().adjoint().template solveInPlace<OnTheRight>(below);
+      below = below * d.asDiagonal().inverse();
+    }
+  }
+  else
+  {
+    if(internal::llt_inplace<Scalar,Lower>::blocked(diagBlock)>=0)
+      return false;
+    if(rows>width)
+      diagBlock.template triangularView<Lower>().adjoint().template solveInPlace<OnTheRight>(below);
+  }
+  return true;
+}
+
+template<typename Derived>
+void SupernodalCholeskyBase<Derived>::factorize_preordered(const CholMatrixType& ap)
+{
+  const Index nsuper = supernodeCount();
+  m_values.resize(m_valuePtr[nsuper]);
+  m_diag.resize(DoLDLT ? m_size : 0);
+
+  Index threads = 1;
+#ifdef EIGEN_HAS_OPENMP
+  if(m_parallelTreeSchedule && omp_get_num_threads()==1)
+    threads = nbThreads();
+#endif
+  Matrix<Index,Dynamic,Dynamic> maps(m_size, threads);
+  VectorType buffers(m_bufferSize*threads);
+  Matrix<signed char,Dynamic,1> failed = Matrix<signed char,Dynamic,1>::Zero(nsuper);
+  bool ok = true;
+
+  if(threads>1)
+    Eigen::initParallel();
+
+  for(Index l=0; ok && l+1<m_levelPtr.size(); ++l)
+  {
+    const Index begin = m_levelPtr[l];
+    const Index end = m_levelPtr[l+1];
+#ifdef EIGEN_HAS_OPENMP
+    if(threads>1 && end-begin>1)
+    {
+      // the supernodes of a level only depend on the ones of the lower levels
+      #pragma omp parallel for num_threads(threads) schedule(dynamic,1)
+      for(Index i=begin; i<end; ++i)
+      {
+        Index t = omp_get_thread_num();
+        Index s = m_levelSuper[i];
+        failed[s] = !factorizeSupernode(s, ap, maps.col(t).data(), buffers.data()+m_bufferSize*t);
+      }
+      ok = (failed.segment(0,nsuper).array()==0).all();
+      continue;
+    }
+#endif
+    for(Index i=begin; ok && i<end; ++i)
+      ok = factorizeSupernode(m_levelSuper[i], ap, maps.data(), buffers.data());
+  }
+
+  m_info = ok ? Success : NumericalIssue;
+  m_factorizationIsOk = true;
+}
+
+template<typename Derived>
+template<typename Dest>
+void SupernodalCholeskyBase<Derived>::solveInPlace(MatrixBase<Dest>& x) const
+{
+  const Index nsuper = supernodeCount();
+  DenseMatrixType tmp;
+
+  // L y = b
+  for(Index s=0; s<nsuper; ++s)
+  {
+    const Index first = m_superStart[s];
+    const Index width = m_superStart[s+1]-first;
+    const Index rows = m_rowPtr[s+1]-m_rowPtr[s];
+    const Index* rowIdx = m_rowIdx.data()+m_rowPtr[s];
+    ConstPanelBlockType diagBlock(m_values.data()+m_valuePtr[s], width, width, OuterStride<>(rows));
+    ConstPanelBlockType below(m_values.data()+m_valuePtr[s]+width, rows-width, width, OuterStride<>(rows));
+    if(DoLDLT)
+      diagBlock.template triangularView<UnitLower>().solveInPlace(x.middleRows(first,width));
+    else
+      diagBlock.template triangularView<Lower>().solveInPlace(x.middleRows(first,width));
+    if(rows>width)
+    {
+      tmp.noalias() = below * x.middleRows(first,width);
+      for(Index i=0; i<rows-width; ++i)
+        x.row(rowIdx[width+i]) -= tmp.row(i);
+    }
+  }
+
+  if(DoLDLT)
+    x = m_diag.asDiagonal().inverse() * x;
+
+  // L^* x = y
+  for(Index s=nsuper-1; s>=0; --s)
+  {
+    const Index first = m_superStart[s];
+    const Index width = m_superStart[s+1]-first;
+    const Index rows = m_rowPtr[s+1]-m_rowPtr[s];
+    const Index* rowIdx = m_rowIdx.data()+m_rowPtr[s];
+    ConstPanelBlockType diagBlock(m_values.data()+m_valuePtr[s], width, width, OuterStride<>(rows));
+    ConstPanelBlockType below(m_values.data()+m_valuePtr[s]+width, rows-width, width, OuterStride<>(rows));
+    if(rows>width)
+    {
+      tmp.resize(rows-width, x.cols());
+      for(Index i=0; i<rows-width; ++i)
+        tmp.row(i) = x.row(rowIdx[width+i]);
+      x.middleRows(first,width).noalias() -= below.adjoint() * tmp;
+    }
+    if(DoLDLT)
+      diagBlock.template triangularView<UnitLower>().adjoint().solveInPlace(x.middleRows(first,width));
+    else
+      diagBlock.template triangularView<Lower>().adjoint().solveInPlace(x.middleRows(first,width));
+  }
+}
+
+namespace internal {
+
+template<typename _MatrixType, int _UpLo, typename _Ordering> struct traits<SupernodalLLT<_MatrixType,_UpLo,_Ordering> >
+{
+  typedef _MatrixType MatrixType;
+  typedef _Ordering OrderingType;
+  enum { UpLo = _UpLo, DoLDLT = false };
+};
+
+template<typename _MatrixType, int _UpLo, typename _Ordering> struct traits<SupernodalLDLT<_MatrixType,_UpLo,_Ordering> >
+{
+  typedef _MatrixType MatrixType;
+  typedef _Ordering OrderingType;
+  enum { UpLo = _UpLo, DoLDLT = true };
+};
+
+} // end namespace internal
+
+/** \ingroup SparseCholesky_Module
+  * \class SupernodalLLT
+  * \brief A direct supernodal sparse LLT Cholesky factorization
+  *
+  * This class provides a supernodal LL^T Cholesky factorization of sparse matrices that are
+  * selfadjoint and positive definite. The factorization allows for solving A.X = B where
+  * X and B can be either dense or sparse. It is a drop-in replacement of SimplicialLLT
+  * which is much faster on matrices whose factor has large dense blocks, e.g., on 3D problems.
+  *
+  * \tparam _MatrixType the type of the sparse matrix A, it must be a SparseMatrix<>
+  * \tparam _UpLo the triangular part that will be used for the computations. It can be Lower
+  *               or Upper. Default is Lower.
+  * \tparam _Ordering The ordering method to use, either AMDOrdering<> or NaturalOrdering<>. Default is AMDOrdering<>
+  *
+  * \sa class SupernodalCholeskyBase, class SupernodalLDLT, class SimplicialLLT
+  */
+template<typename _MatrixType, int _UpLo, typename _Ordering>
+class SupernodalLLT : public SupernodalCholeskyBase<SupernodalLLT<_MatrixType,_UpLo,_Ordering> >
+{
+  public:
+    typedef _MatrixType MatrixType;
+    enum { UpLo = _UpLo };
+    typedef SupernodalCholeskyBase<SupernodalLLT> Base;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::RealScalar RealScalar;
+    typedef typename MatrixType::Index Index;
+    typedef SparseMatrix<Scalar,ColMajor,Index> CholMatrixType;
+
+    /** Default constructor */
+    SupernodalLLT() : Base() {}
+
+    /** Constructs and performs the LLT factorization of \a matrix */
+    explicit SupernodalLLT(const MatrixType& matrix) : Base()
+    {
+      Base::compute(matrix);
+    }
+
+    /** \returns a sparse copy of the lower triangular factor L, which might contain a few explicit zeros */
+    CholMatrixType matrixL() const
+    {
+      return Base::factorL();
+    }
+
+    /** \returns the determinant of the underlying matrix from the current factorization */
+    Scalar determinant() const
+    {
+      eigen_assert(Base::m_factorizationIsOk && "Supernodal LLT not factorized");
+      Scalar detL(1);
+      for(Index s=0; s<Base::supernodeCount(); ++s)
+        detL *= Base::panel(s).topRows(Base::panel(s).cols()).diagonal().prod();
+      return numext::abs2(detL);
+    }
+};
+
+/** \ingroup SparseCholesky_Module
+  * \class SupernodalLDLT
+  * \brief A direct supernodal sparse LDLT Cholesky factorization without square root
+  *
+  * This class provides a supernodal LDL^T Cholesky factorization without square root nor pivoting of sparse
+  * matrices that are selfadjoint and positive definite. The factorization allows for solving A.X = B where
+  * X and B can be either dense or sparse. It is a drop-in replacement of SimplicialLDLT
+  * which is much faster on matrices whose factor has large dense blocks, e.g., on 3D problems.
+  *
+  * \tparam _MatrixType the type of the sparse matrix A, it must be a SparseMatrix<>
+  * \tparam _UpLo the triangular part that will be used for the computations. It can be Lower
+  *               or Upper. Default is Lower.
+  * \tparam _Ordering The ordering method to use, either AMDOrdering<> or NaturalOrdering<>. Default is AMDOrdering<>
+  *
+  * \sa class SupernodalCholeskyBase, class SupernodalLLT, class SimplicialLDLT
+  */
+template<typename _MatrixType, int _UpLo, typename _Ordering>
+class SupernodalLDLT : public SupernodalCholeskyBase<SupernodalLDLT<_MatrixType,_UpLo,_Ordering> >
+{
+  public:
+    typedef _MatrixType MatrixType;
+    enum { UpLo = _UpLo };
+    typedef SupernodalCholeskyBase<SupernodalLDLT> Base;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::RealScalar RealScalar;
+    typedef typename MatrixType::Index Index;
+    typedef SparseMatrix<Scalar,ColMajor,Index> CholMatrixType;
+    typedef Matrix<Scalar,Dynamic,1> VectorType;
+
+    /** Default constructor */
+    SupernodalLDLT() : Base() {}
+
+    /** Constructs and performs the LDLT factorization of \a matrix */
+    explicit SupernodalLDLT(const MatrixType& matrix) : Base()
+    {
+      Base::compute(matrix);
+    }
+
+    /** \returns a sparse copy of the unit lower triangular factor L, which might contain a few explicit zeros */
+    CholMatrixType matrixL() const
+    {
+      return Base::factorL();
+    }
+
+    /** \returns the diagonal D */
+    const VectorType& vectorD() const
+    {
+      eigen_assert(Base::m_factorizationIsOk && "Supernodal LDLT not factorized");
+      return Base::m_diag;
+    }
+
+    /** \returns the determinant of the underlying matrix from the current factorization */
+    Scalar determinant() const
+    {
+      eigen_assert(Base::m_factorizationIsOk && "Supernodal LDLT not factorized");
+      return Base::m_diag.prod();
+    }
+};
+
+namespace internal {
+
+template<typename Derived, typename Rhs>
+struct solve_retval<SupernodalCholeskyBase<Derived>, Rhs>
+  : solve_retval_base<SupernodalCholeskyBase<Derived>, Rhs>
+{
+  typedef SupernodalCholeskyBase<Derived> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec().derived()._solve(rhs(),dst);
+  }
+};
+
+template<typename Derived, typename Rhs>
+struct sparse_solve_retval<SupernodalCholeskyBase<Derived>, Rhs>
+  : sparse_solve_retval_base<SupernodalCholeskyBase<Derived>, Rhs>
+{
+  typedef SupernodalCholeskyBase<Derived> Dec;
+  EIGEN_MAKE_SPARSE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    this->defaultEvalTo(dst);
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_SUPERNODAL_CHOLESKY_H
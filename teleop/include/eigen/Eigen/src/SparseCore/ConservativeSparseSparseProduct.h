@@ -14,107 +14,264 @@ namespace Eigen {
 
 namespace internal {
 
-template<typename Lhs, typename Rhs, typename ResultType>
-static void conservative_sparse_sparse_product_impl(const Lhs& lhs, const Rhs& rhs, ResultType& res)
+/** \internal Computes the product \a lhs * \a rhs into the compressed matrix \a res, one column after the other,
+  * using a dense accumulator of the size of a column.
+  *
+  * On several threads, the columns are split into contiguous ranges having about the same number of multiply-adds,
+  * and the product is computed in two passes: the first one counts the non zeros of each column of the result,
+  * which allows to allocate it exactly, and the second one computes the columns directly in place. Each thread
+  * uses its own accumulator. On a single thread, the counting pass is skipped and the result grows as needed.
+  *
+  * If \a sortColumns is true, the inner indices of each column of the result are sorted. Otherwise they are in an
+  * arbitrary order, which is enough when the result is then converted to the other storage order.
+  *
+  * \a Mode is 0 to compute the full product, or Lower (resp. Upper) to only compute its coefficients on and below
+  * (resp. above) the diagonal, as for a selfadjoint result. In the latter case, the inner vectors of \a lhs must
+  * be sorted.
+  *
+  * Note that innerSize/outerSize are used everywhere since we fake the storage order. */
+template<typename Lhs, typename Rhs, typename ResultType, int Mode>
+struct conservative_sparse_sparse_product_kernel
 {
   typedef typename remove_all<Lhs>::type::Scalar Scalar;
   typedef typename remove_all<Lhs>::type::Index Index;
+  typedef typename ResultType::Index ResIndex;
+  typedef typename ResultType::OuterIndex ResOuterIndex;
+  typedef typename ResultType::Scalar ResScalar;
+
+  conservative_sparse_sparse_product_kernel(const Lhs& lhs, const Rhs& rhs, ResultType& res, bool sortColumns)
+    : m_lhs(lhs), m_rhs(rhs), m_res(res), m_rows(lhs.innerSize()), m_sortColumns(sortColumns)
+  {}
 
-  // make sure to call innerSize/outerSize since we fake the storage order.
-  Index rows = lhs.innerSize();
-  Index cols = rhs.outerSize();
-  eigen_assert(lhs.outerSize() == rhs.innerSize());
-
-  std::vector<bool> mask(rows,false);
-  Matrix<Scalar,Dynamic,1> values(rows);
-  Matrix<Index,Dynamic,1>  indices(rows);
-
-  // estimate the number of non zero entries
-  // given a rhs column containing Y non zeros, we assume that the respective Y columns
-  // of the lhs differs in average of one non zeros, thus the number of non zeros for
-  // the product of a rhs column with the lhs is X+Y where X is the average number of non zero
-  // per column of the lhs.
-  // Therefore, we have nnz(lhs*rhs) = nnz(lhs) + nnz(rhs)
-  Index estimated_nnz_prod = lhs.nonZeros() + rhs.nonZeros();
-
-  res.setZero();
-  res.reserve(Index(estimated_nnz_prod));
-  // we compute each column of the result, one after the other
-  for (Index j=0; j<cols; ++j)
+  static void run(const Lhs& lhs, const Rhs& rhs, ResultType& res, bool sortColumns = true)
   {
+    eigen_assert(lhs.outerSize() == rhs.innerSize());
+    const Index cols = rhs.outerSize();
+    conservative_sparse_sparse_product_kernel kernel(lhs, rhs, res, sortColumns);
+
+    std::vector<Index> starts;
+    const Index threads = kernel.partition(starts);
+    res.setZero();
+    if(threads<=1)
+    {
+      kernel.computeGrowing();
+      return;
+    }
+
+    // symbolic pass: the number of non zeros of each column is stored in the outer index
+    res.makeCompressed();
+    ResOuterIndex* outer = res.outerIndexPtr();
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for num_threads(int(threads))
+#endif
+    for(Index t=0; t<threads; ++t)
+      kernel.countColumns(starts[t], starts[t+1]);
+    ResOuterIndex nnz = 0;
+    for(Index j=0; j<cols; ++j)
+    {
+      ResOuterIndex count = outer[j+1];
+      outer[j] = nnz;
+      nnz += count;
+    }
+    outer[cols] = nnz;
+    res.resizeNonZeros(nnz);
+
+    // numeric pass
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for num_threads(int(threads))
+#endif
+    for(Index t=0; t<threads; ++t)
+      kernel.computeColumns(starts[t], starts[t+1]);
+  }
 
-    res.startVec(j);
-    Index nnz = 0;
-    for (typename Rhs::InnerIterator rhsIt(rhs, j); rhsIt; ++rhsIt)
+  protected:
+
+    /** Splits the columns of the result into ranges of about the same number of multiply-adds
+      * and \returns the number of threads to use */
+    Index partition(std::vector<Index>& starts) const
     {
-      Scalar y = rhsIt.value();
-      Index k = rhsIt.index();
-      for (typename Lhs::InnerIterator lhsIt(lhs, k); lhsIt; ++lhsIt)
+      const Index cols = m_rhs.outerSize();
+      starts.resize(2);
+      starts[0] = 0;
+      starts[1] = cols;
+#ifdef EIGEN_HAS_OPENMP
+      // do not create nested parallel regions
+      if(nbThreads()<=1 || omp_get_num_threads()>1 || cols<2)
+        return 1;
+      const Index inner = m_lhs.outerSize();
+      Matrix<DenseIndex,Dynamic,1> lhsNnz(inner), work(cols+1);
+      for(Index k=0; k<inner; ++k)
       {
-        Index i = lhsIt.index();
-        Scalar x = lhsIt.value();
-        if(!mask[i])
-        {
-          mask[i] = true;
-          values[i] = x * y;
-          indices[nnz] = i;
-          ++nnz;
-        }
-        else
-          values[i] += x * y;
+        DenseIndex count = 0;
+        for(typename Lhs::InnerIterator it(m_lhs, k); it; ++it)
+          ++count;
+        lhsNnz[k] = count;
+      }
+      work[0] = 0;
+      for(Index j=0; j<cols; ++j)
+      {
+        DenseIndex w = 1;
+        for(typename Rhs::InnerIterator it(m_rhs, j); it; ++it)
+          w += lhsNnz[it.index()];
+        work[j+1] = work[j] + w;
       }
+      // this amount of work per thread amortizes the counting pass and the per thread accumulators
+      const DenseIndex minWorkPerThread = 50000 + m_rows;
+      Index threads = Index((std::min)(DenseIndex(nbThreads()), work[cols] / minWorkPerThread));
+      threads = (std::min)(threads, cols);
+      if(threads<=1)
+        return 1;
+      starts.resize(threads+1);
+      for(Index t=1; t<threads; ++t)
+        starts[t] = Index(std::lower_bound(work.data()+starts[t-1], work.data()+cols, (work[cols]*t)/threads) - work.data());
+      starts[threads] = cols;
+      return threads;
+#else
+      return 1;
+#endif
+    }
+
+    /** \returns the number of non zeros of \a xpr, which might be an expression without nonZeros() */
+    template<typename Xpr>
+    static DenseIndex countNonZeros(const Xpr& xpr)
+    {
+      DenseIndex nnz = 0;
+      for(Index j=0; j<xpr.outerSize(); ++j)
+        for(typename Xpr::InnerIterator it(xpr, j); it; ++it)
+          ++nnz;
+      return nnz;
     }
 
-    // unordered insertion
-    for(Index k=0; k<nnz; ++k)
+    /** \returns whether the coefficient \a i of the column \a j is computed */
+    static inline bool inTriangle(Index i, Index j)
     {
-      Index i = indices[k];
-      res.insertBackByOuterInnerUnordered(j,i) = values[i];
-      mask[i] = false;
+      return Mode==0 || (Mode==Lower && i>=j) || (Mode==Upper && i<=j);
     }
 
-#if 0
-    // alternative ordered insertion code:
-
-    Index t200 = rows/(log2(200)*1.39);
-    Index t = (rows*100)/139;
-
-    // FIXME reserve nnz non zeros
-    // FIXME implement fast sort algorithms for very small nnz
-    // if the result is sparse enough => use a quick sort
-    // otherwise => loop through the entire vector
-    // In order to avoid to perform an expensive log2 when the
-    // result is clearly very sparse we use a linear bound up to 200.
-    //if((nnz<200 && nnz<t200) || nnz * log2(nnz) < t)
-    //res.startVec(j);
-    if(true)
+    /** Accumulates the column \a j of the product into \a values, and stores its inner indices into \a indices.
+      * The accumulated coefficients are flagged with \a j in \a tags. \returns the number of non zeros. */
+    template<bool ComputeValues, typename IndexType>
+    Index accumulateColumn(Index j, Index* tags, Scalar* values, IndexType* indices) const
     {
-      if(nnz>1) std::sort(indices.data(),indices.data()+nnz);
-      for(Index k=0; k<nnz; ++k)
+      Index nnz = 0;
+      for(typename Rhs::InnerIterator rhsIt(m_rhs, j); rhsIt; ++rhsIt)
       {
-        Index i = indices[k];
-        res.insertBackByOuterInner(j,i) = values[i];
-        mask[i] = false;
+        Scalar y = rhsIt.value();
+        for(typename Lhs::InnerIterator lhsIt(m_lhs, rhsIt.index()); lhsIt; ++lhsIt)
+        {
+          Index i = lhsIt.index();
+          if(!inTriangle(i,j))
+          {
+            if(Mode==Upper) break;
+            continue;
+          }
+          if(tags[i]!=j)
+          {
+            tags[i] = j;
+            if(ComputeValues)
+            {
+              values[i] = lhsIt.value() * y;
+              indices[nnz] = IndexType(i);
+            }
+            ++nnz;
+          }
+          else if(ComputeValues)
+            values[i] += lhsIt.value() * y;
+        }
       }
+      return nnz;
     }
-    else
+
+    /** Sorts the \a nnz inner indices of the column \a j, if requested */
+    template<typename IndexType>
+    void sortColumn(Index j, Index nnz, const Index* tags, IndexType* indices) const
     {
-      // dense path
-      for(Index i=0; i<rows; ++i)
+      if(!m_sortColumns)
+        return;
+      // if the result is sparse enough, use a quick sort,
+      // otherwise loop through the entire accumulator
+      Index logNnz = 1;
+      for(Index s=nnz; s>1; s>>=1)
+        ++logNnz;
+      if(nnz*logNnz < m_rows)
+        std::sort(indices, indices+nnz);
+      else
       {
-        if(mask[i])
+        Index k = 0;
+        for(Index i=0; i<m_rows; ++i)
+          if(tags[i]==j)
+            indices[k++] = IndexType(i);
+      }
+    }
+
+    void computeGrowing() const
+    {
+      const Index cols = m_rhs.outerSize();
+      std::vector<Index> tags(m_rows, -1);
+      Matrix<Scalar,Dynamic,1> values(m_rows);
+      Matrix<Index,Dynamic,1> indices(m_rows);
+
+      // estimate the number of non zero entries
+      // given a rhs column containing Y non zeros, we assume that the respective Y columns
+      // of the lhs differs in average of one non zeros, thus the number of non zeros for
+      // the product of a rhs column with the lhs is X+Y where X is the average number of non zero
+      // per column of the lhs.
+      // Therefore, we have nnz(lhs*rhs) = nnz(lhs) + nnz(rhs)
+      m_res.reserve(ResOuterIndex(countNonZeros(m_lhs) + countNonZeros(m_rhs)));
+      for(Index j=0; j<cols; ++j)
+      {
+        m_res.startVec(j);
+        Index nnz = accumulateColumn<true>(j, &tags[0], values.data(), indices.data());
+        sortColumn(j, nnz, &tags[0], indices.data());
+        for(Index k=0; k<nnz; ++k)
         {
-          mask[i] = false;
-          res.insertBackByOuterInner(j,i) = values[i];
+          Index i = indices[k];
+          m_res.insertBackByOuterInnerUnordered(j,i) = values[i];
         }
       }
+      m_res.finalize();
     }
-#endif
 
-  }
-  res.finalize();
-}
+    void countColumns(Index start, Index end) const
+    {
+      ResOuterIndex* outer = m_res.outerIndexPtr();
+      std::vector<Index> tags(m_rows, -1);
+      for(Index j=start; j<end; ++j)
+      {
+        // temporarily stored in the next entry, which is turned into the start of the column afterwards
+        outer[j+1] = ResOuterIndex(accumulateColumn<false>(j, &tags[0], static_cast<Scalar*>(0), static_cast<ResIndex*>(0)));
+      }
+    }
 
+    void computeColumns(Index start, Index end) const
+    {
+      const ResOuterIndex* outer = m_res.outerIndexPtr();
+      std::vector<Index> tags(m_rows, -1);
+      Matrix<Scalar,Dynamic,1> values(m_rows);
+      for(Index j=start; j<end; ++j)
+      {
+        ResIndex* indices = m_res.innerIndexPtr() + outer[j];
+        ResScalar* resValues = m_res.valuePtr() + outer[j];
+        Index nnz = accumulateColumn<true>(j, &tags[0], values.data(), indices);
+        eigen_internal_assert(nnz == outer[j+1]-outer[j]);
+        sortColumn(j, nnz, &tags[0], indices);
+        for(Index k=0; k<nnz; ++k)
+          resValues[k] = values[indices[k]];
+      }
+    }
+
+    const Lhs& m_lhs;
+    const Rhs& m_rhs;
+    ResultType& m_res;
+    const Index m_rows;
+    const bool m_sortColumns;
+};
+
+template<typename Lhs, typename Rhs, typename ResultType>
+static void conservative_sparse_sparse_product_impl(const Lhs& lhs, const Rhs& rhs, ResultType& res, bool sortColumns = true)
+{
+  conservative_sparse_sparse_product_kernel<Lhs,Rhs,ResultType,0>::run(lhs, rhs, res, sortColumns);
+}
 
 } // end namespace internal
 
@@ -134,13 +291,10 @@ struct conservative_sparse_sparse_product_selector<Lhs,Rhs,ResultType,ColMajor,C
 
   static void run(const Lhs& lhs, const Rhs& rhs, ResultType& res)
   {
-    typedef SparseMatrix<typename ResultType::Scalar,RowMajor,typename ResultType::Index> RowMajorMatrix;
     typedef SparseMatrix<typename ResultType::Scalar,ColMajor,typename ResultType::Index> ColMajorMatrix;
     ColMajorMatrix resCol(lhs.rows(),rhs.cols());
     internal::conservative_sparse_sparse_product_impl<Lhs,Rhs,ColMajorMatrix>(lhs, rhs, resCol);
-    // sort the non zeros:
-    RowMajorMatrix resRow(resCol);
-    res = resRow;
+    res = resCol;
   }
 };
 
@@ -152,7 +306,7 @@ struct conservative_sparse_sparse_product_selector<Lhs,Rhs,ResultType,RowMajor,C
      typedef SparseMatrix<typename ResultType::Scalar,RowMajor,typename ResultType::Index> RowMajorMatrix;
      RowMajorMatrix rhsRow = rhs;
      RowMajorMatrix resRow(lhs.rows(), rhs.cols());
-     internal::conservative_sparse_sparse_product_impl<RowMajorMatrix,Lhs,RowMajorMatrix>(rhsRow, lhs, resRow);
+     internal::conservative_sparse_sparse_product_impl<RowMajorMatrix,Lhs,RowMajorMatrix>(rhsRow, lhs, resRow, false);
      res = resRow;
   }
 };
@@ -165,7 +319,7 @@ struct conservative_sparse_sparse_product_selector<Lhs,Rhs,ResultType,ColMajor,R
     typedef SparseMatrix<typename ResultType::Scalar,RowMajor,typename ResultType::Index> RowMajorMatrix;
     RowMajorMatrix lhsRow = lhs;
     RowMajorMatrix resRow(lhs.rows(), rhs.cols());
-    internal::conservative_sparse_sparse_product_impl<Rhs,RowMajorMatrix,RowMajorMatrix>(rhs, lhsRow, resRow);
+    internal::conservative_sparse_sparse_product_impl<Rhs,RowMajorMatrix,RowMajorMatrix>(rhs, lhsRow, resRow, false);
     res = resRow;
   }
 };
@@ -177,7 +331,7 @@ struct conservative_sparse_sparse_product_selector<Lhs,Rhs,ResultType,RowMajor,R
   {
     typedef SparseMatrix<typename ResultType::Scalar,RowMajor,typename ResultType::Index> RowMajorMatrix;
     RowMajorMatrix resRow(lhs.rows(), rhs.cols());
-    internal::conservative_sparse_sparse_product_impl<Rhs,Lhs,RowMajorMatrix>(rhs, lhs, resRow);
+    internal::conservative_sparse_sparse_product_impl<Rhs,Lhs,RowMajorMatrix>(rhs, lhs, resRow, false);
     res = resRow;
   }
 };
@@ -192,7 +346,7 @@ struct conservative_sparse_sparse_product_selector<Lhs,Rhs,ResultType,ColMajor,C
   {
     typedef SparseMatrix<typename ResultType::Scalar,ColMajor,typename ResultType::Index> ColMajorMatrix;
     ColMajorMatrix resCol(lhs.rows(), rhs.cols());
-    internal::conservative_sparse_sparse_product_impl<Lhs,Rhs,ColMajorMatrix>(lhs, rhs, resCol);
+    internal::conservative_sparse_sparse_product_impl<Lhs,Rhs,ColMajorMatrix>(lhs, rhs, resCol, false);
     res = resCol;
   }
 };
@@ -205,7 +359,7 @@ struct conservative_sparse_sparse_product_selector<Lhs,Rhs,ResultType,RowMajor,C
     typedef SparseMatrix<typename ResultType::Scalar,ColMajor,typename ResultType::Index> ColMajorMatrix;
     ColMajorMatrix lhsCol = lhs;
     ColMajorMatrix resCol(lhs.rows(), rhs.cols());
-    internal::conservative_sparse_sparse_product_impl<ColMajorMatrix,Rhs,ColMajorMatrix>(lhsCol, rhs, resCol);
+    internal::conservative_sparse_sparse_product_impl<ColMajorMatrix,Rhs,ColMajorMatrix>(lhsCol, rhs, resCol, false);
     res = resCol;
   }
 };
@@ -218,7 +372,7 @@ struct conservative_sparse_sparse_product_selector<Lhs,Rhs,ResultType,ColMajor,R
     typedef SparseMatrix<typename ResultType::Scalar,ColMajor,typename ResultType::Index> ColMajorMatrix;
     ColMajorMatrix rhsCol = rhs;
     ColMajorMatrix resCol(lhs.rows(), rhs.cols());
-    internal::conservative_sparse_sparse_product_impl<Lhs,ColMajorMatrix,ColMajorMatrix>(lhs, rhsCol, resCol);
+    internal::conservative_sparse_sparse_product_impl<Lhs,ColMajorMatrix,ColMajorMatrix>(lhs, rhsCol, resCol, false);
     res = resCol;
   }
 };
@@ -229,12 +383,9 @@ struct conservative_sparse_sparse_product_selector<Lhs,Rhs,ResultType,RowMajor,R
   static void run(const Lhs& lhs, const Rhs& rhs, ResultType& res)
   {
     typedef SparseMatrix<typename ResultType::Scalar,RowMajor,typename ResultType::Index> RowMajorMatrix;
-    typedef SparseMatrix<typename ResultType::Scalar,ColMajor,typename ResultType::Index> ColMajorMatrix;
     RowMajorMatrix resRow(lhs.rows(),rhs.cols());
     internal::conservative_sparse_sparse_product_impl<Rhs,Lhs,RowMajorMatrix>(rhs, lhs, resRow);
-    // sort the non zeros:
-    ColMajorMatrix resCol(resRow);
-    res = resCol;
+    res = resRow;
   }
 };
 
@@ -10,6 +10,12 @@
 #ifndef EIGEN_SPARSEMATRIX_H
 #define EIGEN_SPARSEMATRIX_H
 
+/** \internal Amount of cache in bytes used by the conversion of a sparse matrix to the opposite storage order.
+  * Matrices having more inner vectors than fit in this amount are converted by blocks of inner vectors. */
+#ifndef EIGEN_SPARSE_TRANSPOSE_BLOCK_BYTES
+#define EIGEN_SPARSE_TRANSPOSE_BLOCK_BYTES 1048576
+#endif
+
 namespace Eigen { 
 
 /** \ingroup SparseCore_Module
@@ -32,15 +38,20 @@ namespace Eigen {
   * \tparam _Scalar the scalar type, i.e. the type of the coefficients
   * \tparam _Options Union of bit flags controlling the storage scheme. Currently the only possibility
   *                 is ColMajor or RowMajor. The default is 0 which means column-major.
-  * \tparam _Index the type of the indices. It has to be a \b signed type (e.g., short, int, std::ptrdiff_t). Default is \c int.
+  * \tparam _Index the type of the inner indices. It has to be a \b signed type (e.g., short, int, std::ptrdiff_t). Default is \c int.
+  * \tparam _OuterIndex the type of the starting positions of the inner vectors, which bounds the number of non zeros.
+  *                  It has to be a \b signed type at least as large as \a _Index. Default is \a _Index.
+  *
+  * For instance, a SparseMatrix<double,ColMajor,int,std::ptrdiff_t> can hold more than 2^31 non zeros while
+  * keeping 32 bits inner indices, the storage cost per non zero being the one of a SparseMatrix<double>.
   *
   * This class can be extended with the help of the plugin mechanism described on the page
   * \ref TopicCustomizingEigen by defining the preprocessor symbol \c EIGEN_SPARSEMATRIX_PLUGIN.
   */
 
 namespace internal {
-template<typename _Scalar, int _Options, typename _Index>
-struct traits<SparseMatrix<_Scalar, _Options, _Index> >
+template<typename _Scalar, int _Options, typename _Index, typename _OuterIndex>
+struct traits<SparseMatrix<_Scalar, _Options, _Index, _OuterIndex> >
 {
   typedef _Scalar Scalar;
   typedef _Index Index;
@@ -57,10 +68,10 @@ struct traits<SparseMatrix<_Scalar, _Options, _Index> >
   };
 };
 
-template<typename _Scalar, int _Options, typename _Index, int DiagIndex>
-struct traits<Diagonal<const SparseMatrix<_Scalar, _Options, _Index>, DiagIndex> >
+template<typename _Scalar, int _Options, typename _Index, typename _OuterIndex, int DiagIndex>
+struct traits<Diagonal<const SparseMatrix<_Scalar, _Options, _Index, _OuterIndex>, DiagIndex> >
 {
-  typedef SparseMatrix<_Scalar, _Options, _Index> MatrixType;
+  typedef SparseMatrix<_Scalar, _Options, _Index, _OuterIndex> MatrixType;
   typedef typename nested<MatrixType>::type MatrixTypeNested;
   typedef typename remove_reference<MatrixTypeNested>::type _MatrixTypeNested;
 
@@ -81,9 +92,9 @@ struct traits<Diagonal<const SparseMatrix<_Scalar, _Options, _Index>, DiagIndex>
 
 } // end namespace internal
 
-template<typename _Scalar, int _Options, typename _Index>
+template<typename _Scalar, int _Options, typename _Index, typename _OuterIndex>
 class SparseMatrix
-  : public SparseMatrixBase<SparseMatrix<_Scalar, _Options, _Index> >
+  : public SparseMatrixBase<SparseMatrix<_Scalar, _Options, _Index, _OuterIndex> >
 {
   public:
     EIGEN_SPARSE_PUBLIC_INTERFACE(SparseMatrix)
@@ -93,17 +104,19 @@ class SparseMatrix
     typedef MappedSparseMatrix<Scalar,Flags> Map;
     using Base::IsRowMajor;
     typedef internal::CompressedStorage<Scalar,Index> Storage;
+    typedef Index StorageIndex;         // the type of the inner indices
+    typedef _OuterIndex OuterIndex;     // the type of the positions in the storage
     enum {
       Options = _Options
     };
 
   protected:
 
-    typedef SparseMatrix<Scalar,(Flags&~RowMajorBit)|(IsRowMajor?RowMajorBit:0)> TransposedSparseMatrix;
+    typedef SparseMatrix<Scalar,(Flags&~RowMajorBit)|(IsRowMajor?RowMajorBit:0),Index,OuterIndex> TransposedSparseMatrix;
 
     Index m_outerSize;
     Index m_innerSize;
-    Index* m_outerIndex;
+    OuterIndex* m_outerIndex;
     Index* m_innerNonZeros;     // optional, if null then the data is compressed
     Storage m_data;
     
@@ -146,11 +159,11 @@ class SparseMatrix
     /** \returns a const pointer to the array of the starting positions of the inner vectors.
       * This function is aimed at interoperability with other libraries.
       * \sa valuePtr(), innerIndexPtr() */
-    inline const Index* outerIndexPtr() const { return m_outerIndex; }
+    inline const OuterIndex* outerIndexPtr() const { return m_outerIndex; }
     /** \returns a non-const pointer to the array of the starting positions of the inner vectors.
       * This function is aimed at interoperability with other libraries.
       * \sa valuePtr(), innerIndexPtr() */
-    inline Index* outerIndexPtr() { return m_outerIndex; }
+    inline OuterIndex* outerIndexPtr() { return m_outerIndex; }
 
     /** \returns a const pointer to the array of the number of non zeros of the inner vectors.
       * This function is aimed at interoperability with other libraries.
@@ -174,7 +187,7 @@ class SparseMatrix
       
       const Index outer = IsRowMajor ? row : col;
       const Index inner = IsRowMajor ? col : row;
-      Index end = m_innerNonZeros ? m_outerIndex[outer] + m_innerNonZeros[outer] : m_outerIndex[outer+1];
+      OuterIndex end = m_innerNonZeros ? m_outerIndex[outer] + m_innerNonZeros[outer] : m_outerIndex[outer+1];
       return m_data.atInRange(m_outerIndex[outer], end, inner);
     }
 
@@ -193,12 +206,12 @@ class SparseMatrix
       const Index outer = IsRowMajor ? row : col;
       const Index inner = IsRowMajor ? col : row;
 
-      Index start = m_outerIndex[outer];
-      Index end = m_innerNonZeros ? m_outerIndex[outer] + m_innerNonZeros[outer] : m_outerIndex[outer+1];
+      OuterIndex start = m_outerIndex[outer];
+      OuterIndex end = m_innerNonZeros ? m_outerIndex[outer] + m_innerNonZeros[outer] : m_outerIndex[outer+1];
       eigen_assert(end>=start && "you probably called coeffRef on a non finalized matrix");
       if(end<=start)
         return insert(row,col);
-      const Index p = m_data.searchLowerIndex(start,end-1,inner);
+      const OuterIndex p = m_data.searchLowerIndex(start,end-1,inner);
       if((p<end) && (m_data.index(p)==inner))
         return m_data.value(p);
       else
@@ -237,23 +250,28 @@ class SparseMatrix
     inline void setZero()
     {
       m_data.clear();
-      memset(m_outerIndex, 0, (m_outerSize+1)*sizeof(Index));
+      memset(m_outerIndex, 0, (m_outerSize+1)*sizeof(OuterIndex));
       if(m_innerNonZeros)
         memset(m_innerNonZeros, 0, (m_outerSize)*sizeof(Index));
     }
 
     /** \returns the number of non zero coefficients */
-    inline Index nonZeros() const
+    inline OuterIndex nonZeros() const
     {
       if(m_innerNonZeros)
-        return innerNonZeros().sum();
-      return static_cast<Index>(m_data.size());
+      {
+        OuterIndex nnz = 0;
+        for(Index j=0; j<m_outerSize; ++j)
+          nnz += m_innerNonZeros[j];
+        return nnz;
+      }
+      return static_cast<OuterIndex>(m_data.size());
     }
 
     /** Preallocates \a reserveSize non zeros.
       *
       * Precondition: the matrix must be in compressed mode. */
-    inline void reserve(Index reserveSize)
+    inline void reserve(OuterIndex reserveSize)
     {
       eigen_assert(isCompressed() && "This function does not make sense in non compressed mode.");
       m_data.reserve(reserveSize);
@@ -294,45 +312,45 @@ class SparseMatrix
         m_innerNonZeros = static_cast<Index*>(std::malloc(m_outerSize * sizeof(Index)));
         if (!m_innerNonZeros) internal::throw_std_bad_alloc();
         
-        // temporarily use m_innerSizes to hold the new starting points.
-        Index* newOuterIndex = m_innerNonZeros;
-        
-        Index count = 0;
+        OuterIndex count = 0;
         for(Index j=0; j<m_outerSize; ++j)
         {
-          newOuterIndex[j] = count;
           count += reserveSizes[j] + (m_outerIndex[j+1]-m_outerIndex[j]);
           totalReserveSize += reserveSizes[j];
         }
         m_data.reserve(totalReserveSize);
-        Index previousOuterIndex = m_outerIndex[m_outerSize];
+        // the new starting points are computed backward from the end of the storage
+        OuterIndex newEnd = count;
+        OuterIndex previousOuterIndex = m_outerIndex[m_outerSize];
         for(Index j=m_outerSize-1; j>=0; --j)
         {
-          Index innerNNZ = previousOuterIndex - m_outerIndex[j];
+          Index innerNNZ = Index(previousOuterIndex - m_outerIndex[j]);
+          OuterIndex newStart = newEnd - reserveSizes[j] - innerNNZ;
           for(Index i=innerNNZ-1; i>=0; --i)
           {
-            m_data.index(newOuterIndex[j]+i) = m_data.index(m_outerIndex[j]+i);
-            m_data.value(newOuterIndex[j]+i) = m_data.value(m_outerIndex[j]+i);
+            m_data.index(newStart+i) = m_data.index(m_outerIndex[j]+i);
+            m_data.value(newStart+i) = m_data.value(m_outerIndex[j]+i);
           }
           previousOuterIndex = m_outerIndex[j];
-          m_outerIndex[j] = newOuterIndex[j];
+          m_outerIndex[j] = newStart;
           m_innerNonZeros[j] = innerNNZ;
+          newEnd = newStart;
         }
-        m_outerIndex[m_outerSize] = m_outerIndex[m_outerSize-1] + m_innerNonZeros[m_outerSize-1] + reserveSizes[m_outerSize-1];
+        m_outerIndex[m_outerSize] = count;
         
         m_data.resize(m_outerIndex[m_outerSize]);
       }
       else
       {
-        Index* newOuterIndex = static_cast<Index*>(std::malloc((m_outerSize+1)*sizeof(Index)));
+        OuterIndex* newOuterIndex = static_cast<OuterIndex*>(std::malloc((m_outerSize+1)*sizeof(OuterIndex)));
         if (!newOuterIndex) internal::throw_std_bad_alloc();
         
-        Index count = 0;
+        OuterIndex count = 0;
         for(Index j=0; j<m_outerSize; ++j)
         {
           newOuterIndex[j] = count;
-          Index alreadyReserved = (m_outerIndex[j+1]-m_outerIndex[j]) - m_innerNonZeros[j];
-          Index toReserve = std::max<Index>(reserveSizes[j], alreadyReserved);
+          OuterIndex alreadyReserved = (m_outerIndex[j+1]-m_outerIndex[j]) - m_innerNonZeros[j];
+          OuterIndex toReserve = std::max<OuterIndex>(reserveSizes[j], alreadyReserved);
           count += toReserve + m_innerNonZeros[j];
         }
         newOuterIndex[m_outerSize] = count;
@@ -340,7 +358,7 @@ class SparseMatrix
         m_data.resize(count);
         for(Index j=m_outerSize-1; j>=0; --j)
         {
-          Index offset = newOuterIndex[j] - m_outerIndex[j];
+          OuterIndex offset = newOuterIndex[j] - m_outerIndex[j];
           if(offset>0)
           {
             Index innerNNZ = m_innerNonZeros[j];
@@ -382,7 +400,7 @@ class SparseMatrix
     {
       eigen_assert(size_t(m_outerIndex[outer+1]) == m_data.size() && "Invalid ordered insertion (invalid outer index)");
       eigen_assert( (m_outerIndex[outer+1]-m_outerIndex[outer]==0 || m_data.index(m_data.size()-1)<inner) && "Invalid ordered insertion (invalid inner index)");
-      Index p = m_outerIndex[outer+1];
+      OuterIndex p = m_outerIndex[outer+1];
       ++m_outerIndex[outer+1];
       m_data.append(0, inner);
       return m_data.value(p);
@@ -392,7 +410,7 @@ class SparseMatrix
       * \warning use it only if you know what you are doing */
     inline Scalar& insertBackByOuterInnerUnordered(Index outer, Index inner)
     {
-      Index p = m_outerIndex[outer+1];
+      OuterIndex p = m_outerIndex[outer+1];
       ++m_outerIndex[outer+1];
       m_data.append(0, inner);
       return m_data.value(p);
@@ -402,7 +420,7 @@ class SparseMatrix
       * \sa insertBack, insertBackByOuterInner */
     inline void startVec(Index outer)
     {
-      eigen_assert(m_outerIndex[outer]==Index(m_data.size()) && "You must call startVec for each inner vector sequentially");
+      eigen_assert(m_outerIndex[outer]==OuterIndex(m_data.size()) && "You must call startVec for each inner vector sequentially");
       eigen_assert(m_outerIndex[outer+1]==0 && "You must call startVec for each inner vector sequentially");
       m_outerIndex[outer+1] = m_outerIndex[outer];
     }
@@ -414,7 +432,7 @@ class SparseMatrix
     {
       if(isCompressed())
       {
-        Index size = static_cast<Index>(m_data.size());
+        OuterIndex size = static_cast<OuterIndex>(m_data.size());
         Index i = m_outerSize;
         // find the last filled column
         while (i>=0 && m_outerIndex[i]==0)
@@ -433,6 +451,15 @@ class SparseMatrix
     template<typename InputIterators>
     void setFromTriplets(const InputIterators& begin, const InputIterators& end);
 
+    template<typename InputIterators,typename DupFunctor>
+    void setFromTriplets(const InputIterators& begin, const InputIterators& end, DupFunctor dup_func);
+
+    template<typename InputIterators>
+    void setValuesFromTriplets(const InputIterators& begin, const InputIterators& end);
+
+    template<typename InputIterators,typename DupFunctor>
+    void setValuesFromTriplets(const InputIterators& begin, const InputIterators& end, DupFunctor dup_func);
+
     void sumupDuplicates();
 
     //---
@@ -451,12 +478,12 @@ class SparseMatrix
       if(isCompressed())
         return;
       
-      Index oldStart = m_outerIndex[1];
+      OuterIndex oldStart = m_outerIndex[1];
       m_outerIndex[1] = m_innerNonZeros[0];
       for(Index j=1; j<m_outerSize; ++j)
       {
-        Index nextOldStart = m_outerIndex[j+1];
-        Index offset = oldStart - m_outerIndex[j];
+        OuterIndex nextOldStart = m_outerIndex[j+1];
+        OuterIndex offset = oldStart - m_outerIndex[j];
         if(offset>0)
         {
           for(Index k=0; k<m_innerNonZeros[j]; ++k)
@@ -482,7 +509,7 @@ class SparseMatrix
       m_innerNonZeros = static_cast<Index*>(std::malloc(m_outerSize * sizeof(Index)));
       for (Index i = 0; i < m_outerSize; i++)
       {
-        m_innerNonZeros[i] = m_outerIndex[i+1] - m_outerIndex[i]; 
+        m_innerNonZeros[i] = Index(m_outerIndex[i+1] - m_outerIndex[i]);
       }
     }
     
@@ -506,13 +533,13 @@ class SparseMatrix
       // TODO also implement a unit test
       makeCompressed();
 
-      Index k = 0;
+      OuterIndex k = 0;
       for(Index j=0; j<m_outerSize; ++j)
       {
-        Index previousStart = m_outerIndex[j];
+        OuterIndex previousStart = m_outerIndex[j];
         m_outerIndex[j] = k;
-        Index end = m_outerIndex[j+1];
-        for(Index i=previousStart; i<end; ++i)
+        OuterIndex end = m_outerIndex[j+1];
+        for(OuterIndex i=previousStart; i<end; ++i)
         {
           if(keep(IsRowMajor?j:m_data.index(i), IsRowMajor?m_data.index(i):j, m_data.value(i)))
           {
@@ -558,7 +585,7 @@ class SparseMatrix
         m_innerNonZeros = static_cast<Index*>(std::malloc((m_outerSize+outerChange+1) * sizeof(Index)));
         if (!m_innerNonZeros) internal::throw_std_bad_alloc();
         for(Index i = 0; i < m_outerSize; i++)
-          m_innerNonZeros[i] = m_outerIndex[i+1] - m_outerIndex[i];
+          m_innerNonZeros[i] = Index(m_outerIndex[i+1] - m_outerIndex[i]);
       }
       
       // Change the m_innerNonZeros in case of a decrease of inner size
@@ -567,7 +594,7 @@ class SparseMatrix
         for(Index i = 0; i < m_outerSize + (std::min)(outerChange, Index(0)); i++)
         {
           Index &n = m_innerNonZeros[i];
-          Index start = m_outerIndex[i];
+          OuterIndex start = m_outerIndex[i];
           while (n > 0 && m_data.index(start+n-1) >= newInnerSize) --n; 
         }
       }
@@ -578,12 +605,12 @@ class SparseMatrix
       if (outerChange == 0)
         return;
           
-      Index *newOuterIndex = static_cast<Index*>(std::realloc(m_outerIndex, (m_outerSize + outerChange + 1) * sizeof(Index)));
+      OuterIndex *newOuterIndex = static_cast<OuterIndex*>(std::realloc(m_outerIndex, (m_outerSize + outerChange + 1) * sizeof(OuterIndex)));
       if (!newOuterIndex) internal::throw_std_bad_alloc();
       m_outerIndex = newOuterIndex;
       if (outerChange > 0)
       {
-        Index last = m_outerSize == 0 ? 0 : m_outerIndex[m_outerSize];
+        OuterIndex last = m_outerSize == 0 ? 0 : m_outerIndex[m_outerSize];
         for(Index i=m_outerSize; i<m_outerSize+outerChange+1; i++)          
           m_outerIndex[i] = last; 
       }
@@ -601,7 +628,7 @@ class SparseMatrix
       if (m_outerSize != outerSize || m_outerSize==0)
       {
         std::free(m_outerIndex);
-        m_outerIndex = static_cast<Index*>(std::malloc((outerSize + 1) * sizeof(Index)));
+        m_outerIndex = static_cast<OuterIndex*>(std::malloc((outerSize + 1) * sizeof(OuterIndex)));
         if (!m_outerIndex) internal::throw_std_bad_alloc();
         
         m_outerSize = outerSize;
@@ -611,12 +638,12 @@ class SparseMatrix
         std::free(m_innerNonZeros);
         m_innerNonZeros = 0;
       }
-      memset(m_outerIndex, 0, (m_outerSize+1)*sizeof(Index));
+      memset(m_outerIndex, 0, (m_outerSize+1)*sizeof(OuterIndex));
     }
 
     /** \internal
       * Resize the nonzero vector to \a size */
-    void resizeNonZeros(Index size)
+    void resizeNonZeros(OuterIndex size)
     {
       // TODO remove this function
       m_data.resize(size);
@@ -699,7 +726,7 @@ class SparseMatrix
       this->m_data.resize(rows());
       Eigen::Map<Matrix<Index, Dynamic, 1> >(&this->m_data.index(0), rows()).setLinSpaced(0, rows()-1);
       Eigen::Map<Matrix<Scalar, Dynamic, 1> >(&this->m_data.value(0), rows()).setOnes();
-      Eigen::Map<Matrix<Index, Dynamic, 1> >(this->m_outerIndex, rows()+1).setLinSpaced(0, rows());
+      Eigen::Map<Matrix<OuterIndex, Dynamic, 1> >(this->m_outerIndex, rows()+1).setLinSpaced(0, rows());
       std::free(m_innerNonZeros);
       m_innerNonZeros = 0;
     }
@@ -714,7 +741,7 @@ class SparseMatrix
         initAssignment(other);
         if(other.isCompressed())
         {
-          memcpy(m_outerIndex, other.m_outerIndex, (m_outerSize+1)*sizeof(Index));
+          memcpy(m_outerIndex, other.m_outerIndex, (m_outerSize+1)*sizeof(OuterIndex));
           m_data = other.m_data;
         }
         else
@@ -750,14 +777,14 @@ class SparseMatrix
       EIGEN_DBG_SPARSE(
         s << "Nonzero entries:\n";
         if(m.isCompressed())
-          for (Index i=0; i<m.nonZeros(); ++i)
+          for (OuterIndex i=0; i<m.nonZeros(); ++i)
             s << "(" << m.m_data.value(i) << "," << m.m_data.index(i) << ") ";
         else
           for (Index i=0; i<m.outerSize(); ++i)
           {
-            Index p = m.m_outerIndex[i];
-            Index pe = m.m_outerIndex[i]+m.m_innerNonZeros[i];
-            Index k=p;
+            OuterIndex p = m.m_outerIndex[i];
+            OuterIndex pe = m.m_outerIndex[i]+m.m_innerNonZeros[i];
+            OuterIndex k=p;
             for (; k<pe; ++k)
               s << "(" << m.m_data.value(k) << "," << m.m_data.index(k) << ") ";
             for (; k<m.m_outerIndex[i+1]; ++k)
@@ -845,7 +872,7 @@ public:
       eigen_assert(!isCompressed());
       eigen_assert(m_innerNonZeros[outer]<=(m_outerIndex[outer+1] - m_outerIndex[outer]));
 
-      Index p = m_outerIndex[outer] + m_innerNonZeros[outer]++;
+      OuterIndex p = m_outerIndex[outer] + m_innerNonZeros[outer]++;
       m_data.index(p) = inner;
       return (m_data.value(p) = 0);
     }
@@ -854,6 +881,7 @@ private:
   static void check_template_parameters()
   {
     EIGEN_STATIC_ASSERT(NumTraits<Index>::IsSigned,THE_INDEX_TYPE_MUST_BE_A_SIGNED_TYPE);
+    EIGEN_STATIC_ASSERT(NumTraits<OuterIndex>::IsSigned && sizeof(OuterIndex)>=sizeof(Index),THE_INDEX_TYPE_MUST_BE_A_SIGNED_TYPE);
     EIGEN_STATIC_ASSERT((Options&(ColMajor|RowMajor))==Options,INVALID_MATRIX_TEMPLATE_PARAMETERS);
   }
 
@@ -868,8 +896,8 @@ private:
   };
 };
 
-template<typename Scalar, int _Options, typename _Index>
-class SparseMatrix<Scalar,_Options,_Index>::InnerIterator
+template<typename Scalar, int _Options, typename _Index, typename _OuterIndex>
+class SparseMatrix<Scalar,_Options,_Index,_OuterIndex>::InnerIterator
 {
   public:
     InnerIterator(const SparseMatrix& mat, Index outer)
@@ -897,12 +925,12 @@ class SparseMatrix<Scalar,_Options,_Index>::InnerIterator
     const Scalar* m_values;
     const Index* m_indices;
     const Index m_outer;
-    Index m_id;
-    Index m_end;
+    OuterIndex m_id;
+    OuterIndex m_end;
 };
 
-template<typename Scalar, int _Options, typename _Index>
-class SparseMatrix<Scalar,_Options,_Index>::ReverseInnerIterator
+template<typename Scalar, int _Options, typename _Index, typename _OuterIndex>
+class SparseMatrix<Scalar,_Options,_Index,_OuterIndex>::ReverseInnerIterator
 {
   public:
     ReverseInnerIterator(const SparseMatrix& mat, Index outer)
@@ -930,43 +958,350 @@ class SparseMatrix<Scalar,_Options,_Index>::ReverseInnerIterator
     const Scalar* m_values;
     const Index* m_indices;
     const Index m_outer;
-    Index m_id;
-    const Index m_start;
+    OuterIndex m_id;
+    const OuterIndex m_start;
 };
 
 namespace internal {
 
+/** \internal \returns the number of threads assembling a list of \a count triplets.
+  * Several threads are only used for large enough lists given by random access iterators,
+  * which can be split into contiguous chunks. */
+template<typename Category>
+inline DenseIndex triplets_threads(DenseIndex count, Category)
+{
+  EIGEN_UNUSED_VARIABLE(count);
+  return 1;
+}
+
+inline DenseIndex triplets_threads(DenseIndex count, std::random_access_iterator_tag)
+{
+#ifdef EIGEN_HAS_OPENMP
+  // do not create nested parallel regions
+  if(omp_get_num_threads()>1)
+    return 1;
+  const DenseIndex minTripletsPerThread = 50000;
+  return (std::max)(DenseIndex(1), (std::min)(DenseIndex(nbThreads()), count/minTripletsPerThread));
+#else
+  EIGEN_UNUSED_VARIABLE(count);
+  return 1;
+#endif
+}
+
+/** \internal \returns an iterator to the first triplet processed by the thread \a t */
+template<typename InputIterator>
+inline InputIterator triplets_chunk(const InputIterator& begin, DenseIndex count, DenseIndex threads, DenseIndex t)
+{
+  InputIterator it(begin);
+  std::advance(it, (count*t)/threads);
+  return it;
+}
+
+/** \internal Splits the inner vectors of \a mat into \a threads ranges having about the same number of non zeros */
+template<typename SparseMatrixType>
+void triplets_outer_ranges(const SparseMatrixType& mat, DenseIndex threads, std::vector<typename SparseMatrixType::Index>& starts)
+{
+  typedef typename SparseMatrixType::Index Index;
+  typedef typename SparseMatrixType::OuterIndex OuterIndex;
+  const OuterIndex* outer = mat.outerIndexPtr();
+  const DenseIndex n = mat.outerSize(), nnz = outer[n];
+  starts.resize(threads+1);
+  starts[0] = 0;
+  for(DenseIndex t=1; t<threads; ++t)
+    starts[t] = Index(std::lower_bound(outer+starts[t-1], outer+n, OuterIndex((nnz*t)/threads)) - outer);
+  starts[threads] = Index(n);
+}
+
+/** \internal Combines the duplicated entries of each inner vector in [\a first, \a last) of \a mat, and sorts them.
+  * On output, \a counts[j] is the number of entries left at the beginning of the inner vector j. */
+template<typename SparseMatrixType, typename DupFunctor>
+void triplets_collapse_and_sort(SparseMatrixType& mat, typename SparseMatrixType::Index first, typename SparseMatrixType::Index last,
+                                typename SparseMatrixType::OuterIndex* counts, DupFunctor dup_func)
+{
+  typedef typename SparseMatrixType::Scalar Scalar;
+  typedef typename SparseMatrixType::Index Index;
+  typedef typename SparseMatrixType::OuterIndex OuterIndex;
+  const OuterIndex* outer = mat.outerIndexPtr();
+  Index* inner = mat.innerIndexPtr();
+  Scalar* values = mat.valuePtr();
+  // wi[i] holds the position of the entry of inner index i in the current inner vector
+  Matrix<OuterIndex,Dynamic,1> wi(mat.innerSize());
+  wi.fill(-1);
+  std::vector<Scalar> buffer;
+  for(Index j=first; j<last; ++j)
+  {
+    const OuterIndex start = outer[j], end = outer[j+1];
+    OuterIndex count = start;
+    bool sorted = true;
+    for(OuterIndex k=start; k<end; ++k)
+    {
+      const Index i = inner[k];
+      if(wi(i)>=start)
+      {
+        values[wi(i)] = dup_func(values[wi(i)], values[k]);
+      }
+      else
+      {
+        sorted = sorted && (count==start || inner[count-1]<i);
+        values[count] = values[k];
+        inner[count] = i;
+        wi(i) = count;
+        ++count;
+      }
+    }
+    if(!sorted && count-start<=32)
+    {
+      // insertion sort, fast for short and partially sorted inner vectors
+      for(OuterIndex k=start+1; k<count; ++k)
+      {
+        const Index i = inner[k];
+        const Scalar v = values[k];
+        OuterIndex l = k;
+        for(; l>start && inner[l-1]>i; --l)
+        {
+          inner[l] = inner[l-1];
+          values[l] = values[l-1];
+        }
+        inner[l] = i;
+        values[l] = v;
+      }
+    }
+    else if(!sorted)
+    {
+      buffer.assign(values+start, values+count);
+      std::sort(inner+start, inner+count);
+      for(OuterIndex k=start; k<count; ++k)
+        values[k] = buffer[wi(inner[k])-start];
+    }
+    counts[j] = count-start;
+  }
+}
+
+template<typename InputIterator, typename SparseMatrixType, typename DupFunctor>
+void set_from_triplets(const InputIterator& begin, const InputIterator& end, SparseMatrixType& mat, DupFunctor dup_func)
+{
+  enum { IsRowMajor = SparseMatrixType::IsRowMajor };
+  typedef typename SparseMatrixType::Scalar Scalar;
+  typedef typename SparseMatrixType::Index Index;
+  typedef typename SparseMatrixType::OuterIndex OuterIndex;
+  typedef typename std::iterator_traits<InputIterator>::iterator_category Category;
+
+  // the matrix is emptied and turned into compressed mode
+  mat.resize(mat.rows(), mat.cols());
+  const DenseIndex count = std::distance(begin, end);
+  if(count==0)
+    return;
+  const Index outerSize = mat.outerSize();
+  const DenseIndex threads = triplets_threads(count, Category());
+  OuterIndex* outer = mat.outerIndexPtr();
+
+  // pass 1: count the entries of each inner vector, per chunk of triplets
+  Matrix<OuterIndex,Dynamic,Dynamic> offsets(outerSize, threads);
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for num_threads(int(threads)) schedule(static,1) if(threads>1)
+#endif
+  for(DenseIndex t=0; t<threads; ++t)
+  {
+    OuterIndex* counts = &offsets.coeffRef(0,t);
+    std::fill(counts, counts+outerSize, OuterIndex(0));
+    const InputIterator chunkEnd = triplets_chunk(begin, count, threads, t+1);
+    for(InputIterator it(triplets_chunk(begin, count, threads, t)); it!=chunkEnd; ++it)
+    {
+      eigen_assert(it->row()>=0 && it->row()<mat.rows() && it->col()>=0 && it->col()<mat.cols());
+      ++counts[IsRowMajor ? it->row() : it->col()];
+    }
+  }
+
+  // pass 2: prefix sum, the entries of a chunk are stored after the ones of the previous chunks
+  OuterIndex pos = 0;
+  for(Index j=0; j<outerSize; ++j)
+  {
+    outer[j] = pos;
+    for(DenseIndex t=0; t<threads; ++t)
+    {
+      const OuterIndex c = offsets(j,t);
+      offsets(j,t) = pos;
+      pos += c;
+    }
+  }
+  outer[outerSize] = pos;
+  mat.resizeNonZeros(pos);
+
+  // pass 3: scatter the entries, in the order of the triplets within each inner vector
+  Index* inner = mat.innerIndexPtr();
+  Scalar* values = mat.valuePtr();
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for num_threads(int(threads)) schedule(static,1) if(threads>1)
+#endif
+  for(DenseIndex t=0; t<threads; ++t)
+  {
+    OuterIndex* positions = &offsets.coeffRef(0,t);
+    const InputIterator chunkEnd = triplets_chunk(begin, count, threads, t+1);
+    for(InputIterator it(triplets_chunk(begin, count, threads, t)); it!=chunkEnd; ++it)
+    {
+      const OuterIndex p = positions[IsRowMajor ? it->row() : it->col()]++;
+      inner[p] = Index(IsRowMajor ? it->col() : it->row());
+      values[p] = it->value();
+    }
+  }
+
+  // pass 4: combine the duplicates and sort each inner vector
+  std::vector<Index> starts;
+  triplets_outer_ranges(mat, threads, starts);
+  OuterIndex* counts = offsets.data();
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for num_threads(int(threads)) schedule(static,1) if(threads>1)
+#endif
+  for(DenseIndex t=0; t<threads; ++t)
+    triplets_collapse_and_sort(mat, starts[t], starts[t+1], counts, dup_func);
+
+  // pass 5: copy the entries without the gaps left by the duplicates into an exactly sized storage
+  OuterIndex nnz = 0;
+  for(Index j=0; j<outerSize; ++j)
+    nnz += counts[j];
+  if(nnz==count)
+    return;
+  typename SparseMatrixType::Storage compacted;
+  compacted.resize(nnz);
+  pos = 0;
+  for(Index j=0; j<outerSize; ++j)
+  {
+    const OuterIndex start = outer[j];
+    outer[j] = pos;
+    std::copy(inner+start, inner+start+counts[j], &compacted.index(0)+pos);
+    std::copy(values+start, values+start+counts[j], &compacted.value(0)+pos);
+    pos += counts[j];
+  }
+  outer[outerSize] = pos;
+  mat.data().swap(compacted);
+}
+
 template<typename InputIterator, typename SparseMatrixType>
 void set_from_triplets(const InputIterator& begin, const InputIterator& end, SparseMatrixType& mat, int Options = 0)
 {
   EIGEN_UNUSED_VARIABLE(Options);
+  set_from_triplets(begin, end, mat, scalar_sum_op<typename SparseMatrixType::Scalar>());
+}
+
+/** \internal \returns the position of the entry of \a triplet in the compressed matrix \a mat, or -1 if it is not in its pattern */
+template<typename SparseMatrixType, typename Triplet>
+inline typename SparseMatrixType::OuterIndex triplet_position(const SparseMatrixType& mat, const Triplet& triplet)
+{
+  typedef typename SparseMatrixType::Index Index;
+  typedef typename SparseMatrixType::OuterIndex OuterIndex;
+  const Index j = Index(SparseMatrixType::IsRowMajor ? triplet.row() : triplet.col());
+  const Index i = Index(SparseMatrixType::IsRowMajor ? triplet.col() : triplet.row());
+  const Index* first = mat.innerIndexPtr() + mat.outerIndexPtr()[j];
+  const Index* last  = mat.innerIndexPtr() + mat.outerIndexPtr()[j+1];
+  const Index* r = std::lower_bound(first, last, i);
+  return (r!=last && *r==i) ? OuterIndex(r - mat.innerIndexPtr()) : OuterIndex(-1);
+}
+
+template<typename InputIterator, typename SparseMatrixType, typename DupFunctor>
+void set_values_from_triplets(const InputIterator& begin, const InputIterator& end, SparseMatrixType& mat, DupFunctor dup_func)
+{
   enum { IsRowMajor = SparseMatrixType::IsRowMajor };
   typedef typename SparseMatrixType::Scalar Scalar;
   typedef typename SparseMatrixType::Index Index;
-  SparseMatrix<Scalar,IsRowMajor?ColMajor:RowMajor,Index> trMat(mat.rows(),mat.cols());
+  typedef typename SparseMatrixType::OuterIndex OuterIndex;
+  typedef typename std::iterator_traits<InputIterator>::iterator_category Category;
+  eigen_assert(mat.isCompressed() && "setValuesFromTriplets requires a compressed matrix");
+
+  const DenseIndex count = std::distance(begin, end);
+  const OuterIndex nnz = mat.nonZeros();
+  Scalar* values = mat.valuePtr();
+  std::vector<char> assigned(nnz, 0);
+  const DenseIndex threads = triplets_threads(count, Category());
 
-  if(begin!=end)
+  if(threads==1)
   {
-    // pass 1: count the nnz per inner-vector
-    Matrix<Index,Dynamic,1> wi(trMat.outerSize());
-    wi.setZero();
     for(InputIterator it(begin); it!=end; ++it)
     {
       eigen_assert(it->row()>=0 && it->row()<mat.rows() && it->col()>=0 && it->col()<mat.cols());
-      wi(IsRowMajor ? it->col() : it->row())++;
+      const OuterIndex p = triplet_position(mat, *it);
+      eigen_assert(p>=0 && "setValuesFromTriplets: an entry is not in the pattern of the matrix");
+      if(p<0)
+        continue;
+      values[p] = assigned[p] ? dup_func(values[p], it->value()) : Scalar(it->value());
+      assigned[p] = 1;
+    }
+  }
+  else
+  {
+    // The triplets are dispatched to the thread owning their inner vector, preserving their order,
+    // so that each non zero is only written by one thread.
+    std::vector<Index> starts;
+    triplets_outer_ranges(mat, threads, starts);
+    Matrix<OuterIndex,Dynamic,1> positions(count);
+    Matrix<OuterIndex,Dynamic,Dynamic> buckets(threads, threads);
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for num_threads(int(threads)) schedule(static,1)
+#endif
+    for(DenseIndex t=0; t<threads; ++t)
+    {
+      buckets.col(t).setZero();
+      DenseIndex k = (count*t)/threads;
+      const InputIterator chunkEnd = triplets_chunk(begin, count, threads, t+1);
+      for(InputIterator it(triplets_chunk(begin, count, threads, t)); it!=chunkEnd; ++it, ++k)
+      {
+        eigen_assert(it->row()>=0 && it->row()<mat.rows() && it->col()>=0 && it->col()<mat.cols());
+        positions[k] = triplet_position(mat, *it);
+        eigen_assert(positions[k]>=0 && "setValuesFromTriplets: an entry is not in the pattern of the matrix");
+        if(positions[k]>=0)
+        {
+          const Index j = Index(IsRowMajor ? it->row() : it->col());
+          ++buckets(std::upper_bound(starts.begin()+1, starts.end(), j) - starts.begin() - 1, t);
+        }
+      }
+    }
+    OuterIndex pos = 0;
+    std::vector<OuterIndex> rangeStarts(threads+1);
+    for(DenseIndex r=0; r<threads; ++r)
+    {
+      rangeStarts[r] = pos;
+      for(DenseIndex t=0; t<threads; ++t)
+      {
+        const OuterIndex c = buckets(r,t);
+        buckets(r,t) = pos;
+        pos += c;
+      }
+    }
+    rangeStarts[threads] = pos;
+    Matrix<DenseIndex,Dynamic,1> order(pos);
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for num_threads(int(threads)) schedule(static,1)
+#endif
+    for(DenseIndex t=0; t<threads; ++t)
+    {
+      const DenseIndex chunkEnd = (count*(t+1))/threads;
+      for(DenseIndex k=(count*t)/threads; k<chunkEnd; ++k)
+      {
+        if(positions[k]<0)
+          continue;
+        const Index j = Index(std::upper_bound(mat.outerIndexPtr(), mat.outerIndexPtr()+mat.outerSize(), positions[k]) - mat.outerIndexPtr() - 1);
+        order[buckets(std::upper_bound(starts.begin()+1, starts.end(), j) - starts.begin() - 1, t)++] = k;
+      }
+    }
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for num_threads(int(threads)) schedule(static,1)
+#endif
+    for(DenseIndex r=0; r<threads; ++r)
+    {
+      for(OuterIndex q=rangeStarts[r]; q<rangeStarts[r+1]; ++q)
+      {
+        InputIterator it(begin);
+        std::advance(it, order[q]);
+        const OuterIndex p = positions[order[q]];
+        values[p] = assigned[p] ? dup_func(values[p], it->value()) : Scalar(it->value());
+        assigned[p] = 1;
+      }
     }
-
-    // pass 2: insert all the elements into trMat
-    trMat.reserve(wi);
-    for(InputIterator it(begin); it!=end; ++it)
-      trMat.insertBackUncompressed(it->row(),it->col()) = it->value();
-
-    // pass 3:
-    trMat.sumupDuplicates();
   }
 
-  // pass 4: transposed copy -> implicit sorting
-  mat = trMat;
+  // the non zeros without any triplet are set to zero
+  for(OuterIndex p=0; p<nnz; ++p)
+    if(!assigned[p])
+      values[p] = Scalar(0);
 }
 
 }
@@ -1005,32 +1340,85 @@ void set_from_triplets(const InputIterator& begin, const InputIterator& end, Spa
     // m is ready to go!
   * \endcode
   *
+  * The entries are directly scattered into \c *this. The temporaries are the counts of the entries of each inner
+  * vector, one column of outerSize() entries per thread, and per thread a work vector of innerSize() entries
+  * to combine the duplicates and a buffer to sort the longest inner vectors. When there are duplicates, the entries are finally copied into a new storage of
+  * the exact size. When OpenMP is enabled and the iterators are random access iterators,
+  * large lists of triplets are split into contiguous chunks assembled in parallel.
+  *
   * \warning The list of triplets is read multiple times (at least twice). Therefore, it is not recommended to define
   * an abstract iterator over a complex data-structure that would be expensive to evaluate. The triplets should rather
   * be explicitely stored into a std::vector for instance.
+  *
+  * \sa setValuesFromTriplets()
   */
-template<typename Scalar, int _Options, typename _Index>
+template<typename Scalar, int _Options, typename _Index, typename _OuterIndex>
 template<typename InputIterators>
-void SparseMatrix<Scalar,_Options,_Index>::setFromTriplets(const InputIterators& begin, const InputIterators& end)
+void SparseMatrix<Scalar,_Options,_Index,_OuterIndex>::setFromTriplets(const InputIterators& begin, const InputIterators& end)
 {
-  internal::set_from_triplets(begin, end, *this);
+  internal::set_from_triplets(begin, end, *this, internal::scalar_sum_op<Scalar>());
+}
+
+/** The same as setFromTriplets(const InputIterators&, const InputIterators&) but the duplicated entries
+  * are combined with the functor \a dup_func rather than summed up. The entries are combined in the order
+  * of the list: \c dup_func(a,b) is called with \c a the combination of the previous entries and \c b the new one.
+  * For instance, the last entry is kept with:
+  * \code
+  * struct KeepLast { double operator()(const double&, const double& b) const { return b; } };
+  * m.setFromTriplets(tripletList.begin(), tripletList.end(), KeepLast());
+  * \endcode
+  */
+template<typename Scalar, int _Options, typename _Index, typename _OuterIndex>
+template<typename InputIterators,typename DupFunctor>
+void SparseMatrix<Scalar,_Options,_Index,_OuterIndex>::setFromTriplets(const InputIterators& begin, const InputIterators& end, DupFunctor dup_func)
+{
+  internal::set_from_triplets(begin, end, *this, dup_func);
+}
+
+/** Refills the values of \c *this from the list of \em triplets defined by the iterator range \a begin - \a end,
+  * keeping its sparsity pattern. This is meant for matrices assembled repeatedly with the same structure, as in
+  * non linear or time dependent problems: the list is only read once in the sequential case, the only temporary
+  * is a flag per non zero, and the index arrays are left untouched, so that a symbolic factorization of \c *this
+  * remains valid.
+  *
+  * The matrix must be in compressed mode, and all the triplets must be in its pattern: the other ones are
+  * ignored and trigger an assertion. The duplicated entries are summed up, and the non zeros of \c *this
+  * without any triplet are set to zero. When OpenMP is enabled, large lists of triplets given by random access
+  * iterators are processed in parallel.
+  *
+  * \sa setFromTriplets()
+  */
+template<typename Scalar, int _Options, typename _Index, typename _OuterIndex>
+template<typename InputIterators>
+void SparseMatrix<Scalar,_Options,_Index,_OuterIndex>::setValuesFromTriplets(const InputIterators& begin, const InputIterators& end)
+{
+  internal::set_values_from_triplets(begin, end, *this, internal::scalar_sum_op<Scalar>());
+}
+
+/** The same as setValuesFromTriplets(const InputIterators&, const InputIterators&) but the duplicated entries
+  * are combined with the functor \a dup_func, as in setFromTriplets(const InputIterators&, const InputIterators&, DupFunctor). */
+template<typename Scalar, int _Options, typename _Index, typename _OuterIndex>
+template<typename InputIterators,typename DupFunctor>
+void SparseMatrix<Scalar,_Options,_Index,_OuterIndex>::setValuesFromTriplets(const InputIterators& begin, const InputIterators& end, DupFunctor dup_func)
+{
+  internal::set_values_from_triplets(begin, end, *this, dup_func);
 }
 
 /** \internal */
-template<typename Scalar, int _Options, typename _Index>
-void SparseMatrix<Scalar,_Options,_Index>::sumupDuplicates()
+template<typename Scalar, int _Options, typename _Index, typename _OuterIndex>
+void SparseMatrix<Scalar,_Options,_Index,_OuterIndex>::sumupDuplicates()
 {
   eigen_assert(!isCompressed());
   // TODO, in practice we should be able to use m_innerNonZeros for that task
-  Matrix<Index,Dynamic,1> wi(innerSize());
+  Matrix<OuterIndex,Dynamic,1> wi(innerSize());
   wi.fill(-1);
-  Index count = 0;
+  OuterIndex count = 0;
   // for each inner-vector, wi[inner_index] will hold the position of first element into the index/value buffers
   for(Index j=0; j<outerSize(); ++j)
   {
-    Index start   = count;
-    Index oldEnd  = m_outerIndex[j]+m_innerNonZeros[j];
-    for(Index k=m_outerIndex[j]; k<oldEnd; ++k)
+    OuterIndex start   = count;
+    OuterIndex oldEnd  = m_outerIndex[j]+m_innerNonZeros[j];
+    for(OuterIndex k=m_outerIndex[j]; k<oldEnd; ++k)
     {
       Index i = m_data.index(k);
       if(wi(i)>=start)
@@ -1056,9 +1444,116 @@ void SparseMatrix<Scalar,_Options,_Index>::sumupDuplicates()
   m_data.resize(m_outerIndex[m_outerSize]);
 }
 
-template<typename Scalar, int _Options, typename _Index>
+namespace internal {
+
+/** \internal Splits the outer vectors of \a src into \a starts ranges having about the same number of non zeros,
+  * which are copied on several threads into a matrix of the opposite storage order.
+  * A single range is used for small matrices, and when the outer index of \a src is not directly available.
+  * \returns the number of ranges */
+template<typename SrcType>
+DenseIndex sparse_transpose_ranges(const SrcType& src, std::vector<DenseIndex>& starts)
+{
+  const DenseIndex n = src.outerSize();
+  DenseIndex threads = 1;
+#ifdef EIGEN_HAS_OPENMP
+  typedef typename sparse_outer_index<SrcType>::type StorageIndex;
+  const StorageIndex* outer = sparse_outer_index_ptr(src);
+  const DenseIndex nnz = outer==0 ? 0 : DenseIndex(outer[n]) - DenseIndex(outer[0]);
+  // do not create nested parallel regions
+  if(outer!=0 && omp_get_num_threads()==1)
+  {
+    const DenseIndex minNonZerosPerThread = 100000;
+    threads = (std::max)(DenseIndex(1), (std::min)(DenseIndex(nbThreads()), nnz/minNonZerosPerThread));
+  }
+  starts.resize(threads+1);
+  starts[0] = 0;
+  for(DenseIndex t=1; t<threads; ++t)
+    starts[t] = std::lower_bound(outer+starts[t-1], outer+n, StorageIndex(DenseIndex(outer[0]) + (nnz*t)/threads)) - outer;
+#else
+  starts.resize(2);
+  starts[0] = 0;
+#endif
+  starts[threads] = n;
+  return threads;
+}
+
+/** \internal \returns the log2 of the number of consecutive inner vectors of \a dest gathered in a bucket
+  * when copying \a nnz entries into it, or -1 if the entries are directly scattered.
+  * Scattering the entries writes to the ends of all the inner vectors at once, about two cache lines each,
+  * which is fine as long as they fit in a fraction of the last level cache. Otherwise, the inner vectors are
+  * filled by buckets whose ends fit in EIGEN_SPARSE_TRANSPOSE_BLOCK_BYTES. */
+template<typename DestType>
+int sparse_transpose_bucket_shift(const DestType& dest, DenseIndex nnz)
+{
+  const DenseIndex outerSize = dest.outerSize();
+  const DenseIndex bytesPerNonZero = sizeof(typename DestType::Scalar) + sizeof(typename DestType::Index);
+  const DenseIndex cacheBytes = EIGEN_SPARSE_TRANSPOSE_BLOCK_BYTES;
+  const DenseIndex bytesPerVector = 128;
+  // at most 1024 buckets are filled at once, so that their ends stay in the L1 cache
+  const DenseIndex maxBuckets = 1024;
+  if(outerSize*bytesPerVector <= (std::max)(cacheBytes, DenseIndex(l2CacheSize()/8)) || nnz*bytesPerNonZero <= 4*cacheBytes)
+    return -1;
+  int shift = 0;
+  while((DenseIndex(2)<<shift)*bytesPerVector <= cacheBytes || ((outerSize-1)>>shift) >= maxBuckets)
+    ++shift;
+  return shift;
+}
+
+/** \internal Copies the outer vectors [\a first, \a last) of \a src into \a dest, which has the opposite storage order.
+  * The entries of the inner vector i of \a dest are stored starting at \a positions[i], which is updated.
+  * \a bucketStarts[b] is the position in \a buffer of the first entry going to the b-th bucket of \a shift.
+  *
+  * When \a shift is not negative, the entries are first gathered in a temporary buffer by buckets of
+  * 2^shift consecutive inner vectors of \a dest, like in one pass of a radix sort, and then copied to
+  * their final position one bucket at a time. Each pass thus writes to a small region of memory at once,
+  * rather than scattering every entry anywhere into \a dest. */
+template<typename SrcType, typename DestType>
+void sparse_transpose_scatter(const SrcType& src, DenseIndex first, DenseIndex last, DestType& dest,
+                              typename DestType::OuterIndex* positions, int shift,
+                              typename DestType::OuterIndex* bucketStarts)
+{
+  typedef typename DestType::Scalar Scalar;
+  typedef typename DestType::Index Index;
+  typedef typename DestType::OuterIndex OuterIndex;
+  Index* inner = dest.innerIndexPtr();
+  Scalar* values = dest.valuePtr();
+  if(shift<0)
+  {
+    for(DenseIndex j=first; j<last; ++j)
+      for(typename SrcType::InnerIterator it(src, j); it; ++it)
+      {
+        const OuterIndex p = positions[it.index()]++;
+        inner[p] = Index(j);
+        values[p] = it.value();
+      }
+    return;
+  }
+
+  const DenseIndex buckets = ((dest.outerSize()-1)>>shift) + 1;
+  const DenseIndex size = bucketStarts[buckets];
+  Matrix<Index,Dynamic,1> bufferOuter(size), bufferInner(size);
+  Matrix<Scalar,Dynamic,1> bufferValues(size);
+  for(DenseIndex j=first; j<last; ++j)
+    for(typename SrcType::InnerIterator it(src, j); it; ++it)
+    {
+      const OuterIndex q = bucketStarts[it.index()>>shift]++;
+      bufferOuter.coeffRef(q) = Index(it.index());
+      bufferInner.coeffRef(q) = Index(j);
+      bufferValues.coeffRef(q) = it.value();
+    }
+  for(DenseIndex q=0; q<size; ++q)
+  {
+    const OuterIndex p = positions[bufferOuter.coeff(q)]++;
+    inner[p] = bufferInner.coeff(q);
+    values[p] = bufferValues.coeff(q);
+  }
+}
+
+} // end namespace internal
+
+template<typename Scalar, int _Options, typename _Index, typename _OuterIndex>
 template<typename OtherDerived>
-EIGEN_DONT_INLINE SparseMatrix<Scalar,_Options,_Index>& SparseMatrix<Scalar,_Options,_Index>::operator=(const SparseMatrixBase<OtherDerived>& other)
+EIGEN_DONT_INLINE SparseMatrix<Scalar,_Options,_Index,_OuterIndex>& SparseMatrix<Scalar,_Options,_Index,_OuterIndex>::operator=(const SparseMatrixBase<OtherDerived>& other)
 {
   EIGEN_STATIC_ASSERT((internal::is_same<Scalar, typename OtherDerived::Scalar>::value),
         YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
@@ -1067,45 +1562,64 @@ EIGEN_DONT_INLINE SparseMatrix<Scalar,_Options,_Index>& SparseMatrix<Scalar,_Opt
   if (needToTranspose)
   {
     // two passes algorithm:
-    //  1 - compute the number of coeffs per dest inner vector
-    //  2 - do the actual copy/eval
+    //  1 - compute the number of coeffs per dest inner vector, for each range of outer vectors of the source
+    //  2 - do the actual copy/eval, the coeffs of a range following the ones of the previous ranges
     // Since each coeff of the rhs has to be evaluated twice, let's evaluate it if needed
     typedef typename internal::nested<OtherDerived,2>::type OtherCopy;
     typedef typename internal::remove_all<OtherCopy>::type _OtherCopy;
     OtherCopy otherCopy(other.derived());
 
     SparseMatrix dest(other.rows(),other.cols());
-    Eigen::Map<Matrix<Index, Dynamic, 1> > (dest.m_outerIndex,dest.outerSize()).setZero();
+    std::vector<DenseIndex> starts;
+    const DenseIndex threads = internal::sparse_transpose_ranges(otherCopy, starts);
+    const Index outerSize = dest.outerSize();
+    Matrix<OuterIndex,Dynamic,Dynamic> positions(outerSize, threads);
 
     // pass 1
     // FIXME the above copy could be merged with that pass
-    for (Index j=0; j<otherCopy.outerSize(); ++j)
-      for (typename _OtherCopy::InnerIterator it(otherCopy, j); it; ++it)
-        ++dest.m_outerIndex[it.index()];
-
-    // prefix sum
-    Index count = 0;
-    Matrix<Index,Dynamic,1> positions(dest.outerSize());
-    for (Index j=0; j<dest.outerSize(); ++j)
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for num_threads(int(threads)) schedule(static,1) if(threads>1)
+#endif
+    for(DenseIndex t=0; t<threads; ++t)
     {
-      Index tmp = dest.m_outerIndex[j];
-      dest.m_outerIndex[j] = count;
-      positions[j] = count;
-      count += tmp;
+      OuterIndex* counts = &positions.coeffRef(0,t);
+      std::fill(counts, counts+outerSize, OuterIndex(0));
+      for(DenseIndex j=starts[t]; j<starts[t+1]; ++j)
+        for (typename _OtherCopy::InnerIterator it(otherCopy, j); it; ++it)
+          ++counts[it.index()];
     }
-    dest.m_outerIndex[dest.outerSize()] = count;
-    // alloc
-    dest.m_data.resize(count);
-    // pass 2
-    for (Index j=0; j<otherCopy.outerSize(); ++j)
+
+    // prefix sum, with the sizes of the buckets of the cache blocked copy
+    DenseIndex nnz = positions.sum();
+    const int shift = internal::sparse_transpose_bucket_shift(dest, nnz);
+    Matrix<OuterIndex,Dynamic,Dynamic> bucketStarts;
+    if(shift>=0)
+      bucketStarts.setZero(((outerSize-1)>>shift)+2, threads);
+    OuterIndex count = 0;
+    for (Index j=0; j<outerSize; ++j)
     {
-      for (typename _OtherCopy::InnerIterator it(otherCopy, j); it; ++it)
+      dest.m_outerIndex[j] = count;
+      for(DenseIndex t=0; t<threads; ++t)
       {
-        Index pos = positions[it.index()]++;
-        dest.m_data.index(pos) = j;
-        dest.m_data.value(pos) = it.value();
+        OuterIndex tmp = positions(j,t);
+        positions(j,t) = count;
+        count += tmp;
+        if(shift>=0)
+          bucketStarts((j>>shift)+1,t) += tmp;
       }
     }
+    dest.m_outerIndex[outerSize] = count;
+    for(DenseIndex b=1; b<bucketStarts.rows(); ++b)
+      bucketStarts.row(b) += bucketStarts.row(b-1);
+    // alloc
+    dest.m_data.resize(count);
+    // pass 2
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for num_threads(int(threads)) schedule(static,1) if(threads>1)
+#endif
+    for(DenseIndex t=0; t<threads; ++t)
+      internal::sparse_transpose_scatter(otherCopy, starts[t], starts[t+1], dest, &positions.coeffRef(0,t),
+                                         shift, shift>=0 ? &bucketStarts.coeffRef(0,t) : 0);
     this->swap(dest);
     return *this;
   }
@@ -1118,15 +1632,15 @@ EIGEN_DONT_INLINE SparseMatrix<Scalar,_Options,_Index>& SparseMatrix<Scalar,_Opt
   }
 }
 
-template<typename _Scalar, int _Options, typename _Index>
-EIGEN_DONT_INLINE typename SparseMatrix<_Scalar,_Options,_Index>::Scalar& SparseMatrix<_Scalar,_Options,_Index>::insertUncompressed(Index row, Index col)
+template<typename _Scalar, int _Options, typename _Index, typename _OuterIndex>
+EIGEN_DONT_INLINE typename SparseMatrix<_Scalar,_Options,_Index,_OuterIndex>::Scalar& SparseMatrix<_Scalar,_Options,_Index,_OuterIndex>::insertUncompressed(Index row, Index col)
 {
   eigen_assert(!isCompressed());
 
   const Index outer = IsRowMajor ? row : col;
   const Index inner = IsRowMajor ? col : row;
 
-  Index room = m_outerIndex[outer+1] - m_outerIndex[outer];
+  OuterIndex room = m_outerIndex[outer+1] - m_outerIndex[outer];
   Index innerNNZ = m_innerNonZeros[outer];
   if(innerNNZ>=room)
   {
@@ -1134,8 +1648,8 @@ EIGEN_DONT_INLINE typename SparseMatrix<_Scalar,_Options,_Index>::Scalar& Sparse
     reserve(SingletonVector(outer,std::max<Index>(2,innerNNZ)));
   }
 
-  Index startId = m_outerIndex[outer];
-  Index p = startId + m_innerNonZeros[outer];
+  OuterIndex startId = m_outerIndex[outer];
+  OuterIndex p = startId + m_innerNonZeros[outer];
   while ( (p > startId) && (m_data.index(p-1) > inner) )
   {
     m_data.index(p) = m_data.index(p-1);
@@ -1150,8 +1664,8 @@ EIGEN_DONT_INLINE typename SparseMatrix<_Scalar,_Options,_Index>::Scalar& Sparse
   return (m_data.value(p) = 0);
 }
 
-template<typename _Scalar, int _Options, typename _Index>
-EIGEN_DONT_INLINE typename SparseMatrix<_Scalar,_Options,_Index>::Scalar& SparseMatrix<_Scalar,_Options,_Index>::insertCompressed(Index row, Index col)
+template<typename _Scalar, int _Options, typename _Index, typename _OuterIndex>
+EIGEN_DONT_INLINE typename SparseMatrix<_Scalar,_Options,_Index,_OuterIndex>::Scalar& SparseMatrix<_Scalar,_Options,_Index,_OuterIndex>::insertCompressed(Index row, Index col)
 {
   eigen_assert(isCompressed());
 
@@ -1164,7 +1678,7 @@ EIGEN_DONT_INLINE typename SparseMatrix<_Scalar,_Options,_Index>::Scalar& Sparse
     // we start a new inner vector
     while (previousOuter>=0 && m_outerIndex[previousOuter]==0)
     {
-      m_outerIndex[previousOuter] = static_cast<Index>(m_data.size());
+      m_outerIndex[previousOuter] = static_cast<OuterIndex>(m_data.size());
       --previousOuter;
     }
     m_outerIndex[outer+1] = m_outerIndex[outer];
@@ -1219,12 +1733,12 @@ EIGEN_DONT_INLINE typename SparseMatrix<_Scalar,_Options,_Index>::Scalar& Sparse
         m_outerIndex[k++]++;
       p = 0;
       --k;
-      k = m_outerIndex[k]-1;
-      while (k>0)
+      OuterIndex q = m_outerIndex[k]-1;
+      while (q>0)
       {
-        m_data.index(k) = m_data.index(k-1);
-        m_data.value(k) = m_data.value(k-1);
-        k--;
+        m_data.index(q) = m_data.index(q-1);
+        m_data.value(q) = m_data.value(q-1);
+        q--;
       }
     }
     else
@@ -1236,8 +1750,8 @@ EIGEN_DONT_INLINE typename SparseMatrix<_Scalar,_Options,_Index>::Scalar& Sparse
         m_outerIndex[j++]++;
       --j;
       // shift data of last vecs:
-      Index k = m_outerIndex[j]-1;
-      while (k>=Index(p))
+      OuterIndex k = m_outerIndex[j]-1;
+      while (k>=OuterIndex(p))
       {
         m_data.index(k) = m_data.index(k-1);
         m_data.value(k) = m_data.value(k-1);
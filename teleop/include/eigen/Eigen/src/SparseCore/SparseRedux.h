@@ -24,9 +24,9 @@ SparseMatrixBase<Derived>::sum() const
   return res;
 }
 
-template<typename _Scalar, int _Options, typename _Index>
-typename internal::traits<SparseMatrix<_Scalar,_Options,_Index> >::Scalar
-SparseMatrix<_Scalar,_Options,_Index>::sum() const
+template<typename _Scalar, int _Options, typename _Index, typename _OuterIndex>
+typename internal::traits<SparseMatrix<_Scalar,_Options,_Index,_OuterIndex> >::Scalar
+SparseMatrix<_Scalar,_Options,_Index,_OuterIndex>::sum() const
 {
   eigen_assert(rows()>0 && cols()>0 && "you are using a non initialized matrix");
   return Matrix<Scalar,1,Dynamic>::Map(&m_data.value(0), m_data.size()).sum();
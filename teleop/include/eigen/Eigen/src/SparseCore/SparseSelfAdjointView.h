@@ -38,11 +38,11 @@ template<typename MatrixType, unsigned int UpLo>
 struct traits<SparseSelfAdjointView<MatrixType,UpLo> > : traits<MatrixType> {
 };
 
-template<int SrcUpLo,int DstUpLo,typename MatrixType,int DestOrder>
-void permute_symm_to_symm(const MatrixType& mat, SparseMatrix<typename MatrixType::Scalar,DestOrder,typename MatrixType::Index>& _dest, const typename MatrixType::Index* perm = 0);
+template<int SrcUpLo,int DstUpLo,typename MatrixType,int DestOrder,typename DestOuterIndex>
+void permute_symm_to_symm(const MatrixType& mat, SparseMatrix<typename MatrixType::Scalar,DestOrder,typename MatrixType::Index,DestOuterIndex>& _dest, const typename MatrixType::Index* perm = 0);
 
-template<int UpLo,typename MatrixType,int DestOrder>
-void permute_symm_to_fullsymm(const MatrixType& mat, SparseMatrix<typename MatrixType::Scalar,DestOrder,typename MatrixType::Index>& _dest, const typename MatrixType::Index* perm = 0);
+template<int UpLo,typename MatrixType,int DestOrder,typename DestOuterIndex>
+void permute_symm_to_fullsymm(const MatrixType& mat, SparseMatrix<typename MatrixType::Scalar,DestOrder,typename MatrixType::Index,DestOuterIndex>& _dest, const typename MatrixType::Index* perm = 0);
 
 }
 
@@ -115,13 +115,14 @@ template<typename MatrixType, unsigned int UpLo> class SparseSelfAdjointView
       * \returns a reference to \c *this
       *
       * To perform \f$ this = this + \alpha ( u^* u ) \f$ you can simply
-      * call this function with u.adjoint().
+      * call this function with u.adjoint(). This is the recommended way to form normal equations \f$ J^* J \f$:
+      * only the triangular part \c UpLo of the product is computed, on several threads if OpenMP is enabled.
       */
     template<typename DerivedU>
     SparseSelfAdjointView& rankUpdate(const SparseMatrixBase<DerivedU>& u, const Scalar& alpha = Scalar(1));
     
     /** \internal triggered by sparse_matrix = SparseSelfadjointView; */
-    template<typename DestScalar,int StorageOrder> void evalTo(SparseMatrix<DestScalar,StorageOrder,Index>& _dest) const
+    template<typename DestScalar,int StorageOrder,typename DestOuterIndex> void evalTo(SparseMatrix<DestScalar,StorageOrder,Index,DestOuterIndex>& _dest) const
     {
       internal::permute_symm_to_fullsymm<UpLo>(m_matrix, _dest);
     }
@@ -194,16 +195,63 @@ SparseSelfAdjointView<Derived, UpLo> SparseMatrixBase<Derived>::selfadjointView(
 * Implementation of SparseSelfAdjointView methods
 ***************************************************************************/
 
+namespace internal {
+
+// the operand Xpr of a product, evaluated into a PlainMatrix only if its storage order differs
+template<typename Xpr, typename PlainMatrix,
+         bool NeedCopy = (int(traits<Xpr>::Flags)&RowMajorBit) != (int(traits<PlainMatrix>::Flags)&RowMajorBit)>
+struct sparse_rank_update_operand { typedef PlainMatrix type; };
+
+template<typename Xpr, typename PlainMatrix>
+struct sparse_rank_update_operand<Xpr,PlainMatrix,false> { typedef Xpr type; };
+
+// computes the triangular part of u u^*: its outer vectors are the outer vectors of u (resp. u^*) times u^* (resp. u)
+// if it is column (resp. row) major. InnerUpLo is the triangular part in terms of inner and outer indices.
+template<bool IsRowMajor, int InnerUpLo>
+struct sparse_rank_update_product
+{
+  template<typename U, typename UAdjoint, typename Dest>
+  static void run(const U& u, const UAdjoint& uAdjoint, Dest& dest)
+  {
+    conservative_sparse_sparse_product_kernel<U,UAdjoint,Dest,InnerUpLo>::run(u, uAdjoint, dest);
+  }
+};
+
+template<int InnerUpLo>
+struct sparse_rank_update_product<true,InnerUpLo>
+{
+  template<typename U, typename UAdjoint, typename Dest>
+  static void run(const U& u, const UAdjoint& uAdjoint, Dest& dest)
+  {
+    conservative_sparse_sparse_product_kernel<UAdjoint,U,Dest,InnerUpLo>::run(uAdjoint, u, dest);
+  }
+};
+
+} // end namespace internal
+
 template<typename MatrixType, unsigned int UpLo>
 template<typename DerivedU>
 SparseSelfAdjointView<MatrixType,UpLo>&
 SparseSelfAdjointView<MatrixType,UpLo>::rankUpdate(const SparseMatrixBase<DerivedU>& u, const Scalar& alpha)
 {
-  SparseMatrix<Scalar,MatrixType::Flags&RowMajorBit?RowMajor:ColMajor> tmp = u * u.adjoint();
+  typedef SparseMatrix<Scalar,MatrixType::Flags&RowMajorBit?RowMajor:ColMajor> TmpMatrix;
+  typedef typename SparseMatrixBase<DerivedU>::AdjointReturnType UAdjointXpr;
+  typedef typename internal::sparse_rank_update_operand<DerivedU,TmpMatrix>::type UOperand;
+  typedef typename internal::sparse_rank_update_operand<UAdjointXpr,TmpMatrix>::type UAdjointOperand;
+  enum {
+    IsRowMajor = (MatrixType::Flags&RowMajorBit) ? 1 : 0,
+    InnerUpLo = IsRowMajor ? (int(UpLo)==int(Lower) ? int(Upper) : int(Lower)) : int(UpLo)
+  };
+  // only the triangular part UpLo of u u^* is computed, which saves half of the work and of the temporary,
+  // and u and u^* are only copied if they do not have the storage order of the result
+  const UOperand& uOperand(u.derived());
+  const UAdjointOperand& uAdjointOperand(u.adjoint());
+  TmpMatrix tmp(u.rows(), u.rows());
+  internal::sparse_rank_update_product<IsRowMajor,InnerUpLo>::run(uOperand, uAdjointOperand, tmp);
   if(alpha==Scalar(0))
-    m_matrix.const_cast_derived() = tmp.template triangularView<UpLo>();
+    m_matrix.const_cast_derived() = tmp;
   else
-    m_matrix.const_cast_derived() += alpha * tmp.template triangularView<UpLo>();
+    m_matrix.const_cast_derived() += alpha * tmp;
 
   return *this;
 }
@@ -310,13 +358,13 @@ template<typename MatrixType, int UpLo>
 struct traits<SparseSymmetricPermutationProduct<MatrixType,UpLo> > : traits<MatrixType> {
 };
 
-template<int UpLo,typename MatrixType,int DestOrder>
-void permute_symm_to_fullsymm(const MatrixType& mat, SparseMatrix<typename MatrixType::Scalar,DestOrder,typename MatrixType::Index>& _dest, const typename MatrixType::Index* perm)
+template<int UpLo,typename MatrixType,int DestOrder,typename DestOuterIndex>
+void permute_symm_to_fullsymm(const MatrixType& mat, SparseMatrix<typename MatrixType::Scalar,DestOrder,typename MatrixType::Index,DestOuterIndex>& _dest, const typename MatrixType::Index* perm)
 {
   typedef typename MatrixType::Index Index;
   typedef typename MatrixType::Scalar Scalar;
-  typedef SparseMatrix<Scalar,DestOrder,Index> Dest;
-  typedef Matrix<Index,Dynamic,1> VectorI;
+  typedef SparseMatrix<Scalar,DestOrder,Index,DestOuterIndex> Dest;
+  typedef Matrix<DestOuterIndex,Dynamic,1> VectorI;
   
   Dest& dest(_dest.derived());
   enum {
@@ -348,7 +396,7 @@ void permute_symm_to_fullsymm(const MatrixType& mat, SparseMatrix<typename Matri
       }
     }
   }
-  Index nnz = count.sum();
+  DestOuterIndex nnz = count.sum();
   
   // reserve space
   dest.resizeNonZeros(nnz);
@@ -372,13 +420,13 @@ void permute_symm_to_fullsymm(const MatrixType& mat, SparseMatrix<typename Matri
       
       if(UpLo==(Upper|Lower))
       {
-        Index k = count[StorageOrderMatch ? jp : ip]++;
+        DestOuterIndex k = count[StorageOrderMatch ? jp : ip]++;
         dest.innerIndexPtr()[k] = StorageOrderMatch ? ip : jp;
         dest.valuePtr()[k] = it.value();
       }
       else if(r==c)
       {
-        Index k = count[ip]++;
+        DestOuterIndex k = count[ip]++;
         dest.innerIndexPtr()[k] = ip;
         dest.valuePtr()[k] = it.value();
       }
@@ -386,7 +434,7 @@ void permute_symm_to_fullsymm(const MatrixType& mat, SparseMatrix<typename Matri
       {
         if(!StorageOrderMatch)
           std::swap(ip,jp);
-        Index k = count[jp]++;
+        DestOuterIndex k = count[jp]++;
         dest.innerIndexPtr()[k] = ip;
         dest.valuePtr()[k] = it.value();
         k = count[ip]++;
@@ -397,13 +445,13 @@ void permute_symm_to_fullsymm(const MatrixType& mat, SparseMatrix<typename Matri
   }
 }
 
-template<int _SrcUpLo,int _DstUpLo,typename MatrixType,int DstOrder>
-void permute_symm_to_symm(const MatrixType& mat, SparseMatrix<typename MatrixType::Scalar,DstOrder,typename MatrixType::Index>& _dest, const typename MatrixType::Index* perm)
+template<int _SrcUpLo,int _DstUpLo,typename MatrixType,int DstOrder,typename DestOuterIndex>
+void permute_symm_to_symm(const MatrixType& mat, SparseMatrix<typename MatrixType::Scalar,DstOrder,typename MatrixType::Index,DestOuterIndex>& _dest, const typename MatrixType::Index* perm)
 {
   typedef typename MatrixType::Index Index;
   typedef typename MatrixType::Scalar Scalar;
-  SparseMatrix<Scalar,DstOrder,Index>& dest(_dest.derived());
-  typedef Matrix<Index,Dynamic,1> VectorI;
+  SparseMatrix<Scalar,DstOrder,Index,DestOuterIndex>& dest(_dest.derived());
+  typedef Matrix<DestOuterIndex,Dynamic,1> VectorI;
   enum {
     SrcOrder = MatrixType::IsRowMajor ? RowMajor : ColMajor,
     StorageOrderMatch = int(SrcOrder) == int(DstOrder),
@@ -447,7 +495,7 @@ void permute_symm_to_symm(const MatrixType& mat, SparseMatrix<typename MatrixTyp
       Index jp = perm ? perm[j] : j;
       Index ip = perm? perm[i] : i;
       
-      Index k = count[int(DstUpLo)==int(Lower) ? (std::min)(ip,jp) : (std::max)(ip,jp)]++;
+      DestOuterIndex k = count[int(DstUpLo)==int(Lower) ? (std::min)(ip,jp) : (std::max)(ip,jp)]++;
       dest.innerIndexPtr()[k] = int(DstUpLo)==int(Lower) ? (std::max)(ip,jp) : (std::min)(ip,jp);
       
       if(!StorageOrderMatch) std::swap(ip,jp);
@@ -482,11 +530,11 @@ class SparseSymmetricPermutationProduct
     inline Index rows() const { return m_matrix.rows(); }
     inline Index cols() const { return m_matrix.cols(); }
     
-    template<typename DestScalar, int Options, typename DstIndex>
-    void evalTo(SparseMatrix<DestScalar,Options,DstIndex>& _dest) const
+    template<typename DestScalar, int Options, typename DstIndex, typename DstOuterIndex>
+    void evalTo(SparseMatrix<DestScalar,Options,DstIndex,DstOuterIndex>& _dest) const
     {
 //       internal::permute_symm_to_fullsymm<UpLo>(m_matrix,_dest,m_perm.indices().data());
-      SparseMatrix<DestScalar,(Options&RowMajor)==RowMajor ? ColMajor : RowMajor, DstIndex> tmp;
+      SparseMatrix<DestScalar,(Options&RowMajor)==RowMajor ? ColMajor : RowMajor, DstIndex, DstOuterIndex> tmp;
       internal::permute_symm_to_fullsymm<UpLo>(m_matrix,tmp,m_perm.indices().data());
       _dest = tmp;
     }
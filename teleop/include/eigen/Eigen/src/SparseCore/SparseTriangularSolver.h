@@ -0,0 +1,445 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SPARSE_TRIANGULAR_SOLVER_H
+#define EIGEN_SPARSE_TRIANGULAR_SOLVER_H
+
+/** \internal Minimal number of multiply-adds of a level of SparseTriangularSolver
+  * (summed over the columns of the right hand side) for this level to be solved by several threads. */
+#ifndef EIGEN_PARALLEL_TRSV_THRESHOLD
+#define EIGEN_PARALLEL_TRSV_THRESHOLD 8192
+#endif
+
+namespace Eigen {
+
+/** \ingroup SparseCore_Module
+  * \class SparseTriangularSolver
+  *
+  * \brief Solver for sparse triangular systems reusing an analysis of the sparsity pattern
+  *
+  * \tparam _MatrixType the type of the sparse triangular matrix, a SparseMatrix<> of any storage order
+  * \tparam _Mode either Lower or Upper, possibly combined with UnitDiag
+  *
+  * This class solves \f$ T x = b \f$ for the triangular part of a sparse matrix \f$ T \f$ like
+  * SparseTriangularView::solveInPlace() does, but first analyzes the pattern of \f$ T \f$ to:
+  *  - sort the unknowns into levels: the unknowns of a level only depend on the ones of the
+  *    previous levels and are solved in parallel, when the level is large enough and OpenMP is enabled;
+  *  - detect the supernodes, i.e., the sets of consecutive rows sharing the same pattern outside
+  *    of a dense diagonal triangle, as in the factors of Cholesky and LU decompositions.
+  *    They are solved with dense matrix kernels when there are several right hand sides.
+  *
+  * The analysis only depends on the pattern, and is reused by all the solves with matrices of the
+  * same pattern, e.g., by preconditioners applied at each iteration or updated with new values:
+  * \code
+  * SparseTriangularSolver<SparseMatrix<double>, Lower> solver;
+  * solver.analyzePattern(L);
+  * for(...)
+  *   x = solver.solve(L, b);
+  * \endcode
+  * The entries of the other triangular part are ignored. The values of each row are read in place
+  * when the strictly triangular part of the row is stored contiguously, as in row-major matrices.
+  * Otherwise, e.g., for column-major matrices, they are first copied in row order at each solve.
+  * The analysis costs a few solves and pays off for repeated solves with several threads
+  * or several right hand sides. A single right hand side without OpenMP, or from a parallel region,
+  * is solved as by SparseTriangularView::solveInPlace().
+  *
+  * \sa SparseTriangularView::solve(), setNbThreads()
+  */
+template<typename _MatrixType, int _Mode>
+class SparseTriangularSolver
+{
+  public:
+    typedef _MatrixType MatrixType;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::Index Index;
+    typedef Matrix<Index,Dynamic,1> IndexVector;
+    enum {
+      Mode = _Mode,
+      IsLower = (Mode & Lower) == Lower,
+      UnitDiagonal = (Mode & UnitDiag) == UnitDiag,
+      IsRowMajor = MatrixType::IsRowMajor,
+      MinSupernodeSize = 8,
+      MaxSupernodeSize = 128
+    };
+
+    SparseTriangularSolver() : m_size(0), m_isInitialized(false), m_supernodes(0), m_contiguousRows(true) {}
+
+    /** Analyzes the pattern of \a mat, see analyzePattern() */
+    explicit SparseTriangularSolver(const MatrixType& mat)
+      : m_size(0), m_isInitialized(false), m_supernodes(0), m_contiguousRows(true)
+    {
+      analyzePattern(mat);
+    }
+
+    /** Computes the levels and the supernodes of the triangular part of \a mat.
+      * Unless the mode includes UnitDiag, all the diagonal entries of \a mat must be stored. */
+    void analyzePattern(const MatrixType& mat);
+
+    /** Solves in place \f$ T x = b \f$ with \a other as \f$ b \f$, \a mat being a matrix of the analyzed pattern */
+    template<typename OtherDerived>
+    void solveInPlace(const MatrixType& mat, MatrixBase<OtherDerived>& other) const;
+
+    /** \returns the solution of \f$ T x = b \f$, \a mat being a matrix of the analyzed pattern */
+    template<typename OtherDerived>
+    typename internal::plain_matrix_type_column_major<OtherDerived>::type
+    solve(const MatrixType& mat, const MatrixBase<OtherDerived>& other) const
+    {
+      typename internal::plain_matrix_type_column_major<OtherDerived>::type res(other);
+      solveInPlace(mat, res);
+      return res;
+    }
+
+    Index rows() const { return m_size; }
+    Index cols() const { return m_size; }
+
+    /** \returns the number of levels, i.e., the length of the critical path of the solve */
+    Index levels() const { return m_isInitialized ? Index(m_levelPtr.size()-1) : 0; }
+
+    /** \returns the number of supernodes, made of at least \c MinSupernodeSize rows */
+    Index supernodes() const { return m_supernodes; }
+
+  protected:
+    // the rows are numbered in the order of the substitution, i.e., backward for upper triangular matrices
+    inline Index original(Index k) const { return IsLower ? k : m_size-1-k; }
+
+    bool isSupernodeRow(Index first, Index k) const;
+
+    // values and column indices of the strictly triangular part of the row k,
+    // read in place in the matrix or, otherwise, copied in row order
+    inline const Scalar* rowValues(const MatrixType& mat, const Scalar* rowOrdered, Index k) const
+    {
+      return m_contiguousRows ? mat.valuePtr() + m_rowStart(k) : rowOrdered + m_rowPtr(k);
+    }
+    inline const Index* rowCols(const MatrixType& mat, Index k) const
+    {
+      return m_contiguousRows ? mat.innerIndexPtr() + m_rowStart(k) : m_cols.data() + m_rowPtr(k);
+    }
+
+    template<typename Dest> void solveNode(const MatrixType& mat, const Scalar* rowOrdered, Index s, Dest& x) const;
+    template<typename Dest> void solveRow(const MatrixType& mat, const Scalar* rowOrdered, Index k, Dest& x) const;
+    template<typename Dest> void solveSupernode(const MatrixType& mat, const Scalar* rowOrdered, Index first, Index end, Dest& x) const;
+
+    Index m_size;
+    bool m_isInitialized;
+    Index m_supernodes;
+    // whether the strictly triangular part of each row is stored contiguously in the analyzed matrix
+    bool m_contiguousRows;
+    // strictly triangular part, by rows in substitution order, each row in storage order:
+    // column indices and positions of the values in the analyzed matrix,
+    // or only the position of the first value of each row when the rows are contiguous
+    IndexVector m_rowPtr;
+    IndexVector m_cols;
+    IndexVector m_pos;
+    IndexVector m_rowStart;
+    IndexVector m_diagPos;
+    // the nodes are ranges of consecutive rows [m_nodePtr[i], m_nodePtr[i+1])
+    IndexVector m_nodePtr;
+    // the nodes of the level l are m_levelNodes[m_levelPtr[l]] ... m_levelNodes[m_levelPtr[l+1]-1]
+    IndexVector m_levelPtr;
+    IndexVector m_levelNodes;
+    IndexVector m_levelWork;
+};
+
+template<typename _MatrixType, int _Mode>
+void SparseTriangularSolver<_MatrixType,_Mode>::analyzePattern(const MatrixType& mat)
+{
+  eigen_assert(mat.rows()==mat.cols() && "SparseTriangularSolver: the matrix must be square");
+  const Index n = mat.rows();
+  const Index* outer = mat.outerIndexPtr();
+  const Index* inner = mat.innerIndexPtr();
+  const Index* innerNonZeros = mat.innerNonZeroPtr();
+  m_size = n;
+
+  // 1 - row structure of the strictly triangular part, in substitution order
+  m_rowPtr.setZero(n+1);
+  m_diagPos.setConstant(n, -1);
+  for(Index j=0; j<n; ++j)
+  {
+    const Index end = innerNonZeros ? outer[j]+innerNonZeros[j] : outer[j+1];
+    for(Index p=outer[j]; p<end; ++p)
+    {
+      const Index i = IsRowMajor ? j : inner[p], c = IsRowMajor ? inner[p] : j;
+      if(i==c)
+        m_diagPos(original(i)) = p;
+      else if(IsLower ? c<i : c>i)
+        ++m_rowPtr(original(i)+1);
+    }
+  }
+  for(Index k=0; k<n; ++k)
+    m_rowPtr(k+1) += m_rowPtr(k);
+  m_cols.resize(m_rowPtr(n));
+  m_pos.resize(m_rowPtr(n));
+  {
+    IndexVector fill = m_rowPtr.head(n);
+    for(Index j=0; j<n; ++j)
+    {
+      const Index end = innerNonZeros ? outer[j]+innerNonZeros[j] : outer[j+1];
+      for(Index p=outer[j]; p<end; ++p)
+      {
+        const Index i = IsRowMajor ? j : inner[p], c = IsRowMajor ? inner[p] : j;
+        if(i!=c && (IsLower ? c<i : c>i))
+        {
+          const Index q = fill(original(i))++;
+          m_cols(q) = c;
+          m_pos(q) = p;
+        }
+      }
+    }
+  }
+  // the inner indices of column-major matrices are row indices
+  m_contiguousRows = IsRowMajor;
+  for(Index k=0; k<n && m_contiguousRows; ++k)
+    for(Index q=m_rowPtr(k)+1; q<m_rowPtr(k+1); ++q)
+      if(m_pos(q)!=m_pos(q-1)+1)
+      {
+        m_contiguousRows = false;
+        break;
+      }
+  eigen_assert((UnitDiagonal || (m_diagPos.array()>=0).all()) && "SparseTriangularSolver: missing diagonal entries");
+
+  // 2 - supernodes
+  std::vector<Index> nodePtr;
+  nodePtr.reserve(n+1);
+  m_supernodes = 0;
+  for(Index k=0; k<n; )
+  {
+    Index end = k+1;
+    while(end<n && end-k<MaxSupernodeSize && isSupernodeRow(k, end))
+      ++end;
+    if(end-k<MinSupernodeSize)
+      end = k+1;
+    else
+      ++m_supernodes;
+    nodePtr.push_back(k);
+    k = end;
+  }
+  nodePtr.push_back(n);
+  const Index nodes = Index(nodePtr.size())-1;
+  m_nodePtr = Map<IndexVector>(&nodePtr[0], nodes+1);
+
+  // 3 - levels: a node comes after all the nodes it depends on.
+  // The off-diagonal pattern of a supernode is the one of its first row.
+  IndexVector rowNode(n), nodeLevel(nodes);
+  Index levels = 0;
+  for(Index s=0; s<nodes; ++s)
+  {
+    const Index first = m_nodePtr(s);
+    rowNode.segment(first, m_nodePtr(s+1)-first).setConstant(s);
+    Index level = 0;
+    for(Index q=m_rowPtr(first); q<m_rowPtr(first+1); ++q)
+      level = (std::max)(level, nodeLevel(rowNode(original(m_cols(q))))+1);
+    nodeLevel(s) = level;
+    levels = (std::max)(levels, level+1);
+  }
+  m_levelPtr.setZero(levels+1);
+  m_levelWork.setZero(levels);
+  for(Index s=0; s<nodes; ++s)
+  {
+    ++m_levelPtr(nodeLevel(s)+1);
+    m_levelWork(nodeLevel(s)) += m_rowPtr(m_nodePtr(s+1)) - m_rowPtr(m_nodePtr(s)) + m_nodePtr(s+1) - m_nodePtr(s);
+  }
+  for(Index l=0; l<levels; ++l)
+    m_levelPtr(l+1) += m_levelPtr(l);
+  m_levelNodes.resize(nodes);
+  {
+    IndexVector fill = m_levelPtr.head(levels);
+    for(Index s=0; s<nodes; ++s)
+      m_levelNodes(fill(nodeLevel(s))++) = s;
+  }
+  // the column indices and values are read in place from now on
+  if(m_contiguousRows)
+  {
+    m_rowStart.setZero(n);
+    for(Index k=0; k<n; ++k)
+      if(m_rowPtr(k)<m_rowPtr(k+1))
+        m_rowStart(k) = m_pos(m_rowPtr(k));
+    m_cols.resize(0);
+    m_pos.resize(0);
+  }
+  else
+    m_rowStart.resize(0);
+  m_isInitialized = true;
+}
+
+/** \internal \returns whether the row \a k extends the supernode starting at the row \a first:
+  * its pattern must be the one of the row \a first and all the rows from \a first to \a k-1,
+  * in increasing column order. The latter come last in lower triangular matrices, first otherwise. */
+template<typename _MatrixType, int _Mode>
+bool SparseTriangularSolver<_MatrixType,_Mode>::isSupernodeRow(Index first, Index k) const
+{
+  const Index common = m_rowPtr(first+1) - m_rowPtr(first), block = k - first;
+  if(m_rowPtr(k+1) - m_rowPtr(k) != common + block)
+    return false;
+  const Index* cols = m_cols.data() + m_rowPtr(k);
+  const Index* firstCols = m_cols.data() + m_rowPtr(first);
+  const Index commonStart = IsLower ? 0 : block, blockStart = IsLower ? common : 0;
+  for(Index q=0; q<common; ++q)
+    if(cols[commonStart+q]!=firstCols[q])
+      return false;
+  for(Index q=0; q<block; ++q)
+    if(cols[blockStart+q]!=original(IsLower ? first+q : k-1-q))
+      return false;
+  return true;
+}
+template<typename _MatrixType, int _Mode>
+template<typename Dest>
+inline void SparseTriangularSolver<_MatrixType,_Mode>::solveNode(const MatrixType& mat, const Scalar* rowOrdered, Index s, Dest& x) const
+{
+  // with a single right hand side, the dense kernels do not pay off the copies of the supernodes
+  if(x.cols()>1 && m_nodePtr(s+1)-m_nodePtr(s)>1)
+    solveSupernode(mat, rowOrdered, m_nodePtr(s), m_nodePtr(s+1), x);
+  else
+    for(Index k=m_nodePtr(s); k<m_nodePtr(s+1); ++k)
+      solveRow(mat, rowOrdered, k, x);
+}
+
+template<typename _MatrixType, int _Mode>
+template<typename Dest>
+void SparseTriangularSolver<_MatrixType,_Mode>::solveRow(const MatrixType& mat, const Scalar* rowOrdered, Index k, Dest& x) const
+{
+  const Index i = original(k);
+  const Index size = m_rowPtr(k+1) - m_rowPtr(k);
+  const Index* cols = rowCols(mat, k);
+  const Scalar* vals = rowValues(mat, rowOrdered, k);
+  for(Index col=0; col<x.cols(); ++col)
+  {
+    Scalar tmp = x.coeff(i,col);
+    for(Index q=0; q<size; ++q)
+      tmp -= vals[q] * x.coeff(cols[q],col);
+    if(!UnitDiagonal)
+      tmp /= mat.valuePtr()[m_diagPos(k)];
+    x.coeffRef(i,col) = tmp;
+  }
+}
+
+/** \internal Solves the rows \a first to \a end-1 of a supernode: the contributions of the common columns
+  * are gathered into a dense matrix product, and the remaining dense triangular system is solved in place. */
+template<typename _MatrixType, int _Mode>
+template<typename Dest>
+void SparseTriangularSolver<_MatrixType,_Mode>::solveSupernode(const MatrixType& mat, const Scalar* rowOrdered, Index first, Index end, Dest& x) const
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  const Index size = end - first, common = m_rowPtr(first+1) - m_rowPtr(first), nrhs = x.cols();
+  const Index* commonCols = rowCols(mat, first);
+
+  DenseMatrix res(size, nrhs);
+  for(Index col=0; col<nrhs; ++col)
+    for(Index t=0; t<size; ++t)
+      res(t,col) = x.coeff(original(first+t),col);
+
+  if(common>0)
+  {
+    DenseMatrix lhs(size, common), xc(common, nrhs);
+    for(Index col=0; col<nrhs; ++col)
+      for(Index q=0; q<common; ++q)
+        xc(q,col) = x.coeff(commonCols[q],col);
+    for(Index t=0; t<size; ++t)
+    {
+      const Scalar* vals = rowValues(mat, rowOrdered, first+t) + (IsLower ? 0 : t);
+      for(Index q=0; q<common; ++q)
+        lhs(t,q) = vals[q];
+    }
+    res.noalias() -= lhs * xc;
+  }
+
+  DenseMatrix tri(size, size);
+  for(Index t=0; t<size; ++t)
+  {
+    // the columns of the diagonal block are in increasing order, i.e., backward for upper triangular matrices
+    const Scalar* vals = rowValues(mat, rowOrdered, first+t) + (IsLower ? common : 0);
+    for(Index u=0; u<t; ++u)
+      tri(t,u) = vals[IsLower ? u : t-1-u];
+    if(!UnitDiagonal)
+      tri(t,t) = mat.valuePtr()[m_diagPos(first+t)];
+  }
+  if(UnitDiagonal)
+    tri.template triangularView<UnitLower>().solveInPlace(res);
+  else
+    tri.template triangularView<Lower>().solveInPlace(res);
+
+  for(Index col=0; col<nrhs; ++col)
+    for(Index t=0; t<size; ++t)
+      x.coeffRef(original(first+t),col) = res(t,col);
+}
+
+template<typename _MatrixType, int _Mode>
+template<typename OtherDerived>
+void SparseTriangularSolver<_MatrixType,_Mode>::solveInPlace(const MatrixType& mat, MatrixBase<OtherDerived>& other) const
+{
+  eigen_assert(m_isInitialized && "SparseTriangularSolver: the pattern has not been analyzed");
+  eigen_assert(mat.rows()==m_size && mat.cols()==m_size && other.rows()==m_size);
+  eigen_assert(mat.nonZeros()>=m_rowPtr(m_size) && "SparseTriangularSolver: the pattern of the matrix has changed");
+
+  Index maxThreads = 1;
+#ifdef EIGEN_HAS_OPENMP
+  // do not create nested parallel regions
+  if(omp_get_num_threads()==1)
+    maxThreads = nbThreads();
+#endif
+  // a single substitution in storage order is faster
+  if(maxThreads==1 && other.cols()==1)
+  {
+    mat.template triangularView<Mode>().solveInPlace(other);
+    return;
+  }
+
+  enum { copy = internal::traits<OtherDerived>::Flags & RowMajorBit };
+
+  typedef typename internal::conditional<copy,
+    typename internal::plain_matrix_type_column_major<OtherDerived>::type, OtherDerived&>::type OtherCopy;
+  OtherCopy otherCopy(other.derived());
+  typedef typename internal::remove_reference<OtherCopy>::type Dest;
+  Dest& x = otherCopy;
+  const Index nrhs = x.cols();
+
+  Matrix<Scalar,Dynamic,1> rowOrderedValues;
+  if(!m_contiguousRows)
+  {
+    const Scalar* values = mat.valuePtr();
+    const Index nnz = m_pos.size();
+    rowOrderedValues.resize(nnz);
+    const Index threads = (std::max)(Index(1), (std::min)(maxThreads, nnz/Index(EIGEN_PARALLEL_TRSV_THRESHOLD)));
+    EIGEN_UNUSED_VARIABLE(threads);
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for num_threads(int(threads)) schedule(static) if(threads>1)
+#endif
+    for(Index q=0; q<nnz; ++q)
+      rowOrderedValues(q) = values[m_pos(q)];
+  }
+  const Scalar* rowOrdered = m_contiguousRows ? 0 : rowOrderedValues.data();
+
+  if(maxThreads==1)
+  {
+    // the nodes are solved in their original order for a better locality
+    const Index nodes = Index(m_nodePtr.size())-1;
+    for(Index s=0; s<nodes; ++s)
+      solveNode(mat, rowOrdered, s, x);
+  }
+  else
+  {
+    const Index levels = Index(m_levelPtr.size())-1;
+    for(Index l=0; l<levels; ++l)
+    {
+      const Index begin = m_levelPtr(l), end = m_levelPtr(l+1);
+      const Index threads = (std::max)(Index(1), (std::min)((std::min)(maxThreads, end-begin),
+                                                           m_levelWork(l)*nrhs/Index(EIGEN_PARALLEL_TRSV_THRESHOLD)));
+      EIGEN_UNUSED_VARIABLE(threads);
+#ifdef EIGEN_HAS_OPENMP
+      #pragma omp parallel for num_threads(int(threads)) schedule(dynamic,16) if(threads>1)
+#endif
+      for(Index p=begin; p<end; ++p)
+        solveNode(mat, rowOrdered, m_levelNodes(p), x);
+    }
+  }
+
+  if (copy)
+    other = otherCopy;
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_SPARSE_TRIANGULAR_SOLVER_H
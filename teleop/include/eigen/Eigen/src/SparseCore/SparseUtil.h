@@ -67,7 +67,7 @@ const int InnerRandomAccessPattern  = 0x2 | CoherentAccessPattern;
 const int OuterRandomAccessPattern  = 0x4 | CoherentAccessPattern;
 const int RandomAccessPattern       = 0x8 | OuterRandomAccessPattern | InnerRandomAccessPattern;
 
-template<typename _Scalar, int _Flags = 0, typename _Index = int>  class SparseMatrix;
+template<typename _Scalar, int _Flags = 0, typename _Index = int, typename _OuterIndex = _Index>  class SparseMatrix;
 template<typename _Scalar, int _Flags = 0, typename _Index = int>  class DynamicSparseMatrix;
 template<typename _Scalar, int _Flags = 0, typename _Index = int>  class SparseVector;
 template<typename _Scalar, int _Flags = 0, typename _Index = int>  class MappedSparseMatrix;
@@ -134,6 +134,38 @@ template<typename T> struct plain_matrix_type<T,Sparse>
     typedef SparseMatrix<_Scalar, _Options, _Index> type;
 };
 
+/** \internal the type of the entries of the outer index array of \a Derived */
+template<typename Derived> struct sparse_outer_index
+{
+  typedef typename Derived::Index type;
+};
+
+template<typename Scalar, int Options, typename Index, typename OuterIndex>
+struct sparse_outer_index<SparseMatrix<Scalar,Options,Index,OuterIndex> >
+{
+  typedef OuterIndex type;
+};
+
+template<typename MatrixType> struct sparse_outer_index<Transpose<MatrixType> >
+  : sparse_outer_index<typename remove_all<MatrixType>::type>
+{};
+
+/** \internal \returns a pointer to the outer index array of \a mat if it is directly available, and 0 otherwise */
+template<typename Derived>
+inline const typename sparse_outer_index<Derived>::type* sparse_outer_index_ptr(const SparseMatrixBase<Derived>&) { return 0; }
+
+template<typename Scalar, int Options, typename Index, typename OuterIndex>
+inline const OuterIndex* sparse_outer_index_ptr(const SparseMatrix<Scalar,Options,Index,OuterIndex>& mat) { return mat.outerIndexPtr(); }
+
+template<typename Scalar, int Options, typename Index>
+inline const Index* sparse_outer_index_ptr(const MappedSparseMatrix<Scalar,Options,Index>& mat) { return mat.outerIndexPtr(); }
+
+template<typename MatrixType>
+inline const typename sparse_outer_index<Transpose<MatrixType> >::type* sparse_outer_index_ptr(const Transpose<MatrixType>& mat)
+{
+  return sparse_outer_index_ptr(mat.nestedExpression());
+}
+
 } // end namespace internal
 
 /** \ingroup SparseCore_Module
@@ -34,6 +34,10 @@ template <typename MatrixLType, typename MatrixUType> struct SparseLUMatrixURetu
   * enable a better optimization from the compiler. For best performance, 
   * you should compile it with NDEBUG flag to avoid the numerous bounds checking on vectors. 
   * 
+  * When OpenMP is enabled, the dense updates of the panels by the large supernodes are performed on
+  * Eigen::nbThreads() threads, the rows of the supernodes being split over the threads. The symbolic
+  * steps and the pivoting remain sequential, such that the factors do not depend on the number of threads.
+  * 
   * An important parameter of this class is the ordering method. It is used to reorder the columns 
   * (and eventually the rows) of the matrix to reduce the number of new elements that are created during 
   * numerical factorization. The cheapest method available is COLAMD. 
@@ -104,6 +108,8 @@ class SparseLU : public internal::SparseLUImpl<typename _MatrixType::Scalar, typ
     void analyzePattern (const MatrixType& matrix);
     void factorize (const MatrixType& matrix);
     void simplicialfactorize(const MatrixType& matrix);
+    bool saveSymbolic(std::ostream& s) const;
+    bool loadSymbolic(std::istream& s, const MatrixType& matrix);
     
     /**
       * Compute the symbolic and numeric factorization of the input sparse matrix.
@@ -392,6 +398,7 @@ class SparseLU : public internal::SparseLUImpl<typename _MatrixType::Scalar, typ
     RealScalar m_diagpivotthresh; // Specifies the threshold used for a diagonal entry to be an acceptable pivot
     Index m_nnzL, m_nnzU; // Nonzeros in L and U factors
     Index m_detPermR, m_detPermC; // Determinants of the permutation matrices
+    unsigned int m_patternHash[2]; // Fingerprint of the pattern of the analyzed matrix
   private:
     // Disable copy constructor 
     SparseLU (const SparseLU& );
@@ -470,7 +477,67 @@ void SparseLU<MatrixType, OrderingType>::analyzePattern(const MatrixType& mat)
     
   } // end postordering 
   
+  internal::sparse_pattern_hash(mat, m_patternHash);
+  m_analysisIsOk = true; 
+}
+
+/**
+ * Writes the symbolic analysis, i.e., the column permutation and the column elimination tree,
+ * to the binary stream \a s. The result can be given to loadSymbolic() to skip the analysis
+ * of matrices having the same sparsity pattern, and in particular the computation of the ordering.
+ * 
+ * The format is compact but not portable across machines having different integer representations.
+ * 
+ * \returns whether the writing succeeded
+ * \sa loadSymbolic(), analyzePattern()
+ */
+template <typename MatrixType, typename OrderingType>
+bool SparseLU<MatrixType, OrderingType>::saveSymbolic(std::ostream& s) const
+{
+  eigen_assert(m_analysisIsOk && "analyzePattern() should be called first"); 
+  internal::symbolic_writer<Index> writer(s);
+  writer.writeHeader(internal::SymbolicSparseLU, 0, m_mat.rows(), m_mat.cols(), m_patternHash);
+  writer.writeVector(m_perm_c.indices());
+  writer.writeVector(m_etree);
+  return writer.finish();
+}
+
+/**
+ * Loads a symbolic analysis saved by saveSymbolic() from the binary stream \a s, instead of
+ * calling analyzePattern(\a mat).
+ * 
+ * \returns false, leaving the current state unchanged, if the stream is invalid, or if it has not been
+ * computed from a matrix having the same dimensions and sparsity pattern as \a mat.
+ * 
+ * \sa saveSymbolic(), analyzePattern()
+ */
+template <typename MatrixType, typename OrderingType>
+bool SparseLU<MatrixType, OrderingType>::loadSymbolic(std::istream& s, const MatrixType& mat)
+{
+  unsigned int hash[2];
+  internal::sparse_pattern_hash(mat, hash);
+  
+  const Index n = mat.cols();
+  internal::symbolic_reader<Index> reader(s);
+  PermutationType perm_c;
+  IndexVector etree;
+  if(!reader.readHeader(internal::SymbolicSparseLU, 0, mat.rows(), n, hash)
+     || !reader.readVector(perm_c.indices(), n) || !internal::is_valid_permutation(perm_c.indices(), n)
+     || !reader.readVector(etree, n+1) || etree.size()<n
+     || !reader.finish())
+    return false;
+  // The supernode detection assumes that the etree is postordered
+  for (Index i = 0; i < n; ++i)
+    if (etree(i) <= i || etree(i) > n) return false;
+  
+  m_perm_c = perm_c;
+  m_etree.swap(etree);
+  m_mat = mat; 
+  m_patternHash[0] = hash[0];
+  m_patternHash[1] = hash[1];
   m_analysisIsOk = true; 
+  m_factorizationIsOk = false;
+  return true;
 }
 
 // Functions needed by the numerical factorization phase
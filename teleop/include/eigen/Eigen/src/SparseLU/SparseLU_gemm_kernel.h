@@ -23,7 +23,7 @@ namespace internal {
   */
 template<typename Scalar,typename Index>
 EIGEN_DONT_INLINE
-void sparselu_gemm(Index m, Index n, Index d, const Scalar* A, Index lda, const Scalar* B, Index ldb, Scalar* C, Index ldc)
+void sparselu_gemm_kernel(Index m, Index n, Index d, const Scalar* A, Index lda, const Scalar* B, Index ldb, Scalar* C, Index ldc)
 {
   using namespace Eigen::internal;
   
@@ -272,6 +272,46 @@ void sparselu_gemm(Index m, Index n, Index d, const Scalar* A, Index lda, const
 }
 #undef KMADD
 
+/** \internal
+  * Computes C += A * B with the same requirements as sparselu_gemm_kernel.
+  *
+  * When OpenMP is enabled and the product is large enough, the rows of A and C are split
+  * into contiguous ranges processed by different threads. Since the ranges start on
+  * aligned rows, each coefficient of C is computed by the very same sequence of operations
+  * as in the sequential case, such that the result does not depend on the number of threads.
+  */
+template<typename Scalar,typename Index>
+void sparselu_gemm(Index m, Index n, Index d, const Scalar* A, Index lda, const Scalar* B, Index ldb, Scalar* C, Index ldc)
+{
+#ifdef EIGEN_HAS_OPENMP
+  enum {
+    PacketSize = packet_traits<Scalar>::size,
+    RowStep = 8*PacketSize,              // granularity of the row ranges
+    MinWorkPerThread = 65536             // minimal number of multiply-adds per thread
+  };
+  Index threads = 1;
+  if(omp_get_num_threads()==1)
+  {
+    DenseIndex work = DenseIndex(m)*DenseIndex(n)*DenseIndex(d);
+    threads = (std::min)(Index(nbThreads()), Index((std::min)(work/MinWorkPerThread, DenseIndex(m/RowStep))));
+  }
+  if(threads>1)
+  {
+    Index i0 = internal::first_aligned(A,m);
+    Index rowsPerThread = ((m-i0)/threads/RowStep)*RowStep;
+    #pragma omp parallel for num_threads(threads) schedule(static,1)
+    for(Index t=0; t<threads; ++t)
+    {
+      Index start = t==0 ? 0 : i0+t*rowsPerThread;
+      Index end = t+1==threads ? m : i0+(t+1)*rowsPerThread;
+      sparselu_gemm_kernel<Scalar>(end-start, n, d, A+start, lda, B, ldb, C+start, ldc);
+    }
+    return;
+  }
+#endif
+  sparselu_gemm_kernel<Scalar>(m, n, d, A, lda, B, ldb, C, ldc);
+}
+
 } // namespace internal
 
 } // namespace Eigen
@@ -0,0 +1,239 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SPARSE_SYMBOLIC_IO_H
+#define EIGEN_SPARSE_SYMBOLIC_IO_H
+
+#include <istream>
+#include <ostream>
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal Kinds of symbolic analysis which can be saved by the sparse solvers */
+enum {
+  SymbolicSparseLU = 1,
+  SymbolicSimplicialCholesky = 2,
+  SymbolicSupernodalCholesky = 3
+};
+
+/** \internal Two lanes of the FNV-1a hash function, giving a 64 bits fingerprint with 32 bits arithmetic only */
+class symbolic_hasher
+{
+  public:
+    symbolic_hasher() { m_hash[0] = 2166136261u; m_hash[1] = 3735928559u; }
+
+    void addBytes(const void* data, std::size_t size)
+    {
+      const unsigned char* bytes = static_cast<const unsigned char*>(data);
+      for(std::size_t i=0; i<size; ++i)
+      {
+        m_hash[0] = (m_hash[0] ^ bytes[i]) * 16777619u;
+        m_hash[1] = (m_hash[1] ^ bytes[i]) * 1540483477u;
+      }
+    }
+
+    /** adds the 32 low bits of \a value, such that the result does not depend on the index type */
+    template<typename Index>
+    void addIndex(Index value)
+    {
+      unsigned int v = static_cast<unsigned int>(value);
+      unsigned char bytes[4] = { static_cast<unsigned char>(v), static_cast<unsigned char>(v>>8),
+                                 static_cast<unsigned char>(v>>16), static_cast<unsigned char>(v>>24) };
+      addBytes(bytes, 4);
+    }
+
+    unsigned int value(int i) const { return m_hash[i]; }
+
+  protected:
+    unsigned int m_hash[2];
+};
+
+/** \internal Computes a fingerprint of the dimensions and of the sparsity pattern of \a mat.
+  * The numerical values are ignored, while the explicit zeros are part of the pattern. */
+template<typename MatrixType>
+void sparse_pattern_hash(const MatrixType& mat, unsigned int hash[2])
+{
+  symbolic_hasher hasher;
+  hasher.addIndex(mat.rows());
+  hasher.addIndex(mat.cols());
+  hasher.addIndex(int(MatrixType::IsRowMajor));
+  for(typename MatrixType::Index j=0; j<mat.outerSize(); ++j)
+  {
+    typename MatrixType::Index count = 0;
+    for(typename MatrixType::InnerIterator it(mat,j); it; ++it, ++count)
+      hasher.addIndex(it.index());
+    hasher.addIndex(count);
+  }
+  hash[0] = hasher.value(0);
+  hash[1] = hasher.value(1);
+}
+
+/** \internal Writes the symbolic analysis of a sparse solver to a binary stream.
+  *
+  * The stream starts with a header identifying the kind of analysis, the machine representation of
+  * the integers, and the fingerprint of the pattern of the analyzed matrix. It ends with a checksum
+  * of its whole content.
+  */
+template<typename Index>
+class symbolic_writer
+{
+  public:
+    symbolic_writer(std::ostream& s) : m_stream(s) {}
+
+    void writeHeader(int kind, int flags, Index rows, Index cols, const unsigned int hash[2])
+    {
+      m_stream.write("EIGENSYM", 8);
+      write(int(0x01020304)); // endianness
+      write(int(1));          // version
+      write(int(sizeof(Index)));
+      write(int(sizeof(DenseIndex)));
+      write(kind);
+      write(flags);
+      write(rows);
+      write(cols);
+      write(hash[0]);
+      write(hash[1]);
+    }
+
+    template<typename T>
+    void write(const T& value)
+    {
+      m_hasher.addBytes(&value, sizeof(T));
+      m_stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename VectorType>
+    void writeVector(const VectorType& vec)
+    {
+      typedef typename VectorType::Scalar T;
+      write(DenseIndex(vec.size()));
+      if(vec.size()==0)
+        return;
+      m_hasher.addBytes(vec.data(), sizeof(T)*vec.size());
+      m_stream.write(reinterpret_cast<const char*>(vec.data()), sizeof(T)*vec.size());
+    }
+
+    /** writes the checksum, and \returns whether all the writings succeeded */
+    bool finish()
+    {
+      unsigned int checksum[2] = { m_hasher.value(0), m_hasher.value(1) };
+      m_stream.write(reinterpret_cast<const char*>(checksum), sizeof(checksum));
+      return m_stream.good();
+    }
+
+  protected:
+    std::ostream& m_stream;
+    symbolic_hasher m_hasher;
+};
+
+/** \internal Reads a symbolic analysis written by symbolic_writer.
+  * All the reading functions return false if the stream is invalid or does not match the expectations. */
+template<typename Index>
+class symbolic_reader
+{
+  public:
+    symbolic_reader(std::istream& s) : m_stream(s) {}
+
+    bool readHeader(int kind, int flags, Index rows, Index cols, const unsigned int hash[2])
+    {
+      char magic[8];
+      m_stream.read(magic, 8);
+      if(!m_stream.good() || std::string(magic,8)!="EIGENSYM")
+        return false;
+      int endianness, version, indexSize, denseIndexSize, fileKind, fileFlags;
+      Index fileRows, fileCols;
+      unsigned int fileHash[2];
+      return read(endianness) && endianness==0x01020304
+          && read(version) && version==1
+          && read(indexSize) && indexSize==int(sizeof(Index))
+          && read(denseIndexSize) && denseIndexSize==int(sizeof(DenseIndex))
+          && read(fileKind) && fileKind==kind
+          && read(fileFlags) && fileFlags==flags
+          && read(fileRows) && fileRows==rows
+          && read(fileCols) && fileCols==cols
+          && read(fileHash[0]) && fileHash[0]==hash[0]
+          && read(fileHash[1]) && fileHash[1]==hash[1];
+    }
+
+    template<typename T>
+    bool read(T& value)
+    {
+      m_stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+      if(!m_stream.good())
+        return false;
+      m_hasher.addBytes(&value, sizeof(T));
+      return true;
+    }
+
+    /** reads a vector of at most \a maxSize entries */
+    template<typename VectorType>
+    bool readVector(VectorType& vec, DenseIndex maxSize)
+    {
+      typedef typename VectorType::Scalar T;
+      DenseIndex size;
+      if(!read(size) || size<0 || size>maxSize)
+        return false;
+      vec.resize(size);
+      if(size==0)
+        return true;
+      m_stream.read(reinterpret_cast<char*>(vec.data()), sizeof(T)*size);
+      if(!m_stream.good())
+        return false;
+      m_hasher.addBytes(vec.data(), sizeof(T)*size);
+      return true;
+    }
+
+    /** reads a vector whose entries must be in the range [\a lowest, \a highest] */
+    template<typename VectorType>
+    bool readIndices(VectorType& vec, DenseIndex maxSize, typename VectorType::Scalar lowest, typename VectorType::Scalar highest)
+    {
+      if(!readVector(vec, maxSize))
+        return false;
+      for(DenseIndex i=0; i<vec.size(); ++i)
+        if(vec[i]<lowest || vec[i]>highest)
+          return false;
+      return true;
+    }
+
+    /** \returns whether the checksum matches the content which has been read */
+    bool finish()
+    {
+      unsigned int checksum[2];
+      m_stream.read(reinterpret_cast<char*>(checksum), sizeof(checksum));
+      return !m_stream.fail() && checksum[0]==m_hasher.value(0) && checksum[1]==m_hasher.value(1);
+    }
+
+  protected:
+    std::istream& m_stream;
+    symbolic_hasher m_hasher;
+};
+
+/** \internal \returns whether \a perm is a permutation of size \a size, or empty */
+template<typename IndicesType>
+bool is_valid_permutation(const IndicesType& perm, DenseIndex size)
+{
+  if(perm.size()==0)
+    return true;
+  if(perm.size()!=size)
+    return false;
+  std::vector<bool> seen(size,false);
+  for(DenseIndex i=0; i<size; ++i)
+  {
+    if(perm[i]<0 || perm[i]>=size || seen[perm[i]])
+      return false;
+    seen[perm[i]] = true;
+  }
+  return true;
+}
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_SPARSE_SYMBOLIC_IO_H
@@ -7,6 +7,7 @@
 //  -DREPEAT=100
 //  -DTRIES=10
 //  -DSCALAR=double
+//  -fopenmp (the large LLT are factorized by tiles on nbThreads() threads)
 
 #include <iostream>
 
@@ -23,7 +24,11 @@ using namespace Eigen;
 #define TRIES 10
 #endif
 
-typedef float Scalar;
+#ifndef SCALAR
+#define SCALAR float
+#endif
+
+typedef SCALAR Scalar;
 
 template <typename MatrixType>
 __attribute__ ((noinline)) void benchLLT(const MatrixType& m)
@@ -31,14 +36,14 @@ __attribute__ ((noinline)) void benchLLT(const MatrixType& m)
   int rows = m.rows();
   int cols = m.cols();
 
-  int cost = 0;
+  double cost = 0;
   for (int j=0; j<rows; ++j)
   {
-    int r = std::max(rows - j -1,0);
+    double r = std::max(rows - j -1,0);
     cost += 2*(r*j+r+j);
   }
 
-  int repeats = (REPEAT*1000)/(rows*rows);
+  int repeats = std::max((REPEAT*1000)/(rows*rows),1);
 
   typedef typename MatrixType::Scalar Scalar;
   typedef Matrix<Scalar, MatrixType::RowsAtCompileTime, MatrixType::RowsAtCompileTime> SquareMatrixType;
@@ -119,7 +124,8 @@ __attribute__ ((noinline)) void benchLLT(const MatrixType& m)
 
 int main(int argc, char* argv[])
 {
-  const int dynsizes[] = {4,6,8,16,24,32,49,64,128,256,512,900,0};
+  const int dynsizes[] = {4,6,8,16,24,32,49,64,128,256,512,900,1024,2048,0};
+  std::cout << "threads: " << nbThreads() << "\n";
   std::cout << "size            no sqrt                           standard";
 //   #ifdef BENCH_GSL
 //   std::cout << "       GSL (standard + double + ATLAS)  ";
@@ -0,0 +1,68 @@
+// g++ bench_algebraic_multigrid.cpp -I .. -O3 -DNDEBUG -lrt && ./a.out
+// g++ bench_algebraic_multigrid.cpp -I .. -O3 -DNDEBUG -DMAXSIZE=2048 -lrt && ./a.out
+
+// Solves 2D Poisson problems on grids of increasing size with ConjugateGradient, preconditioned by
+// AlgebraicMultigridPreconditioner and by DiagonalPreconditioner, and reports the number of iterations,
+// the setup and the solve times. The last column is the time of a refactorization reusing the aggregates.
+
+#include <iostream>
+#include <Eigen/Sparse>
+#include <unsupported/Eigen/IterativeSolvers>
+#include <bench/BenchTimer.h>
+
+using namespace std;
+using namespace Eigen;
+
+#ifndef MAXSIZE
+#define MAXSIZE 1024
+#endif
+
+typedef SparseMatrix<double> SpMat;
+
+int main()
+{
+  cout << "unknowns\tAMG its\tlevels\tsetup\tsolve\tJacobi its\tsolve\trefactorize\n";
+  for(int size=32; size<=MAXSIZE; size*=2)
+  {
+    const int n = size*size;
+    std::vector<Triplet<double> > triplets;
+    for(int i=0; i<size; ++i)
+      for(int j=0; j<size; ++j)
+      {
+        const int k = i*size+j;
+        triplets.push_back(Triplet<double>(k, k, 4));
+        if(i>0)      triplets.push_back(Triplet<double>(k, k-size, -1));
+        if(i<size-1) triplets.push_back(Triplet<double>(k, k+size, -1));
+        if(j>0)      triplets.push_back(Triplet<double>(k, k-1, -1));
+        if(j<size-1) triplets.push_back(Triplet<double>(k, k+1, -1));
+      }
+    SpMat A(n, n);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    VectorXd b = VectorXd::Random(n), x(n);
+
+    BenchTimer tSetup, tSolve, tJacobi, tRefactorize;
+    ConjugateGradient<SpMat, Lower|Upper, AlgebraicMultigridPreconditioner<double> > amg;
+    amg.setTolerance(1e-8);
+    tSetup.start();
+    amg.compute(A);
+    tSetup.stop();
+    tSolve.start();
+    x = amg.solve(b);
+    tSolve.stop();
+    tRefactorize.start();
+    amg.factorize(A);
+    tRefactorize.stop();
+
+    ConjugateGradient<SpMat, Lower|Upper, DiagonalPreconditioner<double> > jacobi;
+    jacobi.setTolerance(1e-8);
+    jacobi.setMaxIterations(10*size);
+    tJacobi.start();
+    x = jacobi.compute(A).solve(b);
+    tJacobi.stop();
+
+    cout << n << "\t\t" << amg.iterations() << "\t" << amg.preconditioner().levels() << "\t"
+         << tSetup.value() << "\t" << tSolve.value() << "\t"
+         << jacobi.iterations() << "\t\t" << tJacobi.value() << "\t" << tRefactorize.value() << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,139 @@
+// g++ bench_batched.cpp -I .. -O3 -DNDEBUG -lrt && ./a.out
+// g++ bench_batched.cpp -I .. -O3 -DNDEBUG -lrt -DSCALAR=float -DSIZE=4 && ./a.out
+
+// Compares the batched operations of the BatchedMatrix module with a loop over fixed-size matrices
+
+#include <iostream>
+#include <vector>
+#include <Eigen/Core>
+#include <Eigen/LU>
+#include <Eigen/Cholesky>
+#include <Eigen/StdVector>
+#include <unsupported/Eigen/BatchedMatrix>
+#include <bench/BenchTimer.h>
+
+using namespace std;
+using namespace Eigen;
+
+#ifndef SCALAR
+#define SCALAR double
+#endif
+
+#ifndef SIZE
+#define SIZE 3
+#endif
+
+#ifndef COUNT
+#define COUNT 100000
+#endif
+
+#ifndef REPEAT
+#define REPEAT 10
+#endif
+
+#ifndef TRIES
+#define TRIES 4
+#endif
+
+typedef SCALAR Scalar;
+typedef Matrix<Scalar,SIZE,SIZE> Mat;
+typedef Matrix<Scalar,SIZE,1> Vec;
+typedef std::vector<Mat,aligned_allocator<Mat> > MatList;
+typedef std::vector<Vec,aligned_allocator<Vec> > VecList;
+typedef BatchedMatrix<Scalar,SIZE,SIZE> BatchedMat;
+typedef BatchedMatrix<Scalar,SIZE,1> BatchedVec;
+typedef BatchedPartialPivLU<Scalar,SIZE> BatchedLU;
+typedef BatchedLLT<Scalar,SIZE> BatchedCholesky;
+
+void report(const char* name, const BenchTimer& loop, const BenchTimer& batched)
+{
+  std::cout << name << "\t" << loop.best(REAL_TIMER) << "\t" << batched.best(REAL_TIMER)
+            << "\t" << loop.best(REAL_TIMER)/batched.best(REAL_TIMER) << "\n";
+}
+
+// the loops are kept in non inlined functions so that the compiler cannot hoist them out of the benchmark
+EIGEN_DONT_INLINE void loopProduct(const MatList& a, const MatList& b, MatList& c)
+{
+  for(size_t k=0; k<a.size(); ++k) c[k].noalias() = a[k]*b[k];
+}
+
+EIGEN_DONT_INLINE void loopMatVec(const MatList& a, const VecList& v, VecList& x)
+{
+  for(size_t k=0; k<a.size(); ++k) x[k].noalias() = a[k]*v[k];
+}
+
+EIGEN_DONT_INLINE void loopLuSolve(const MatList& a, const VecList& v, VecList& x)
+{
+  for(size_t k=0; k<a.size(); ++k) x[k] = a[k].partialPivLu().solve(v[k]);
+}
+
+EIGEN_DONT_INLINE void loopLltSolve(const MatList& a, const VecList& v, VecList& x)
+{
+  for(size_t k=0; k<a.size(); ++k) x[k] = a[k].llt().solve(v[k]);
+}
+
+EIGEN_DONT_INLINE void loopInverse(const MatList& a, MatList& c)
+{
+  for(size_t k=0; k<a.size(); ++k) c[k] = a[k].inverse();
+}
+
+EIGEN_DONT_INLINE void loopDeterminant(const MatList& a, Matrix<Scalar,Dynamic,1>& det)
+{
+  for(size_t k=0; k<a.size(); ++k) det(k) = a[k].determinant();
+}
+
+EIGEN_DONT_INLINE void batchedDeterminantInto(const BatchedMat& a, Matrix<Scalar,Dynamic,1>& det)
+{
+  det = batchedDeterminant(a);
+}
+
+int main()
+{
+  const int n = COUNT;
+  MatList a(n), b(n), c(n);
+  VecList v(n), x(n);
+  BatchedMat ba(n), bb(n), bc(n);
+  BatchedVec bv(n), bx(n);
+  Matrix<Scalar,Dynamic,1> det(n);
+  for(int k=0; k<n; ++k)
+  {
+    Mat m = Mat::Random();
+    a[k] = m*m.transpose() + Mat::Identity();
+    b[k].setRandom();
+    v[k].setRandom();
+    ba.setMatrix(k, a[k]);
+    bb.setMatrix(k, b[k]);
+    bv.setMatrix(k, v[k]);
+  }
+
+  std::cout << "batch of " << n << " " << SIZE << "x" << SIZE << " matrices, " << SimdInstructionSetsInUse() << "\n";
+  std::cout << "op\tloop\tbatched\tspeedup\n";
+
+  BenchTimer tl, tb;
+
+  BENCH(tl, TRIES, REPEAT, loopProduct(a, b, c));
+  BENCH(tb, TRIES, REPEAT, batchedProduct(ba, bb, bc));
+  report("product", tl, tb);
+
+  BENCH(tl, TRIES, REPEAT, loopMatVec(a, v, x));
+  BENCH(tb, TRIES, REPEAT, batchedProduct(ba, bv, bx));
+  report("matvec", tl, tb);
+
+  BENCH(tl, TRIES, REPEAT, loopLuSolve(a, v, x));
+  BENCH(tb, TRIES, REPEAT, BatchedLU(ba).solve(bv, bx));
+  report("lu solve", tl, tb);
+
+  BENCH(tl, TRIES, REPEAT, loopLltSolve(a, v, x));
+  BENCH(tb, TRIES, REPEAT, BatchedCholesky(ba).solve(bv, bx));
+  report("llt solve", tl, tb);
+
+  BENCH(tl, TRIES, REPEAT, loopInverse(a, c));
+  BENCH(tb, TRIES, REPEAT, batchedInverse(ba, bc));
+  report("inverse", tl, tb);
+
+  BENCH(tl, TRIES, REPEAT, loopDeterminant(a, det));
+  BENCH(tb, TRIES, REPEAT, batchedDeterminantInto(ba, det));
+  report("determinant", tl, tb);
+
+  return 0;
+}
@@ -0,0 +1,37 @@
+// g++ bench_minmax_index.cpp -I .. -O3 -DNDEBUG -lrt && ./a.out
+// g++ bench_minmax_index.cpp -I .. -O3 -DNDEBUG -DSCALAR=double -lrt && ./a.out
+
+// Compares minCoeff(&index) and maxCoeff(&index), which use packets on large vectors,
+// with the scalar min_coeff_visitor / max_coeff_visitor, and with minCoeff() without index.
+
+#include <iostream>
+#include <Eigen/Core>
+#include <bench/BenchTimer.h>
+
+using namespace std;
+using namespace Eigen;
+
+#ifndef SCALAR
+#define SCALAR float
+#endif
+
+typedef Matrix<SCALAR,Dynamic,1> Vec;
+
+int main()
+{
+  cout << "size     visitor (ms)  minCoeff(&i) (ms)  minCoeff() (ms)\n";
+  for(int size=1000; size<=10000000; size*=10)
+  {
+    Vec v = Vec::Random(size);
+    const int rep = 100000000/size;
+    DenseIndex i1 = 0, i2 = 0;
+    SCALAR s = 0;
+    BenchTimer tvisitor, tindex, tvalue;
+    BENCH(tvisitor, 5, rep, { internal::min_coeff_visitor<Vec> visitor; v.visit(visitor); i1 += visitor.row; });
+    BENCH(tindex,   5, rep, { DenseIndex i; s += v.minCoeff(&i); i2 += i; });
+    BENCH(tvalue,   5, rep, s += v.minCoeff());
+    cout << size << "\t" << 1e3*tvisitor.best()/rep << "\t" << 1e3*tindex.best()/rep << "\t" << 1e3*tvalue.best()/rep
+         << "\t(" << (i1==i2 ? "ok" : "MISMATCH") << " " << s << ")\n";
+  }
+  return 0;
+}
@@ -0,0 +1,94 @@
+// g++ bench_mixed_precision.cpp -I .. -O3 -DNDEBUG -lrt && ./a.out
+// g++ bench_mixed_precision.cpp -I .. -O3 -DNDEBUG -mavx -DMAXSIZE=4096 -lrt && ./a.out
+
+// Compares the double precision PartialPivLU, LDLT, SimplicialLDLT and SupernodalLDLT solvers with their
+// MixedPrecisionSolver counterparts, which factorize in single precision and refine the solution in double precision. For each
+// problem, it reports the time of the factorization and of one solve, the speedup, the number of refinement
+// steps, and the normwise backward errors, such that the speedups are compared at equal accuracy.
+
+#include <iostream>
+#include <Eigen/Dense>
+#include <Eigen/SparseCholesky>
+#include <unsupported/Eigen/IterativeSolvers>
+#include <bench/BenchTimer.h>
+
+using namespace std;
+using namespace Eigen;
+
+#ifndef MAXSIZE
+#define MAXSIZE 2048
+#endif
+
+#ifndef TRIES
+#define TRIES 2
+#endif
+
+template<typename MatrixType, typename VectorType>
+double backward_error(const MatrixType& A, const VectorType& x, const VectorType& b)
+{
+  return (b - A*x).template lpNorm<Infinity>()
+       / ((A.cwiseAbs() * VectorXd::Ones(A.cols())).maxCoeff() * x.template lpNorm<Infinity>());
+}
+
+template<typename Decomposition, typename MatrixType>
+void run(const char* name, const MatrixType& A)
+{
+  VectorXd b = VectorXd::Random(A.rows()), x(A.rows());
+  BenchTimer tDouble, tMixed;
+  double errDouble = 0, errMixed = 0;
+  int steps = 0;
+  bool low = true;
+  for(int k=0; k<TRIES; ++k)
+  {
+    tDouble.start();
+    Decomposition dec(A);
+    x = dec.solve(b);
+    tDouble.stop();
+    errDouble = backward_error(A, x, b);
+
+    tMixed.start();
+    MixedPrecisionSolver<Decomposition> mixed(A);
+    x = mixed.solve(b);
+    tMixed.stop();
+    errMixed = backward_error(A, x, b);
+    steps = mixed.iterations();
+    low = mixed.usesLowPrecision();
+  }
+  cout << name << "\t" << A.rows() << "\t" << tDouble.best() << "\t" << tMixed.best() << "\t"
+       << tDouble.best()/tMixed.best() << "\t" << steps << (low ? "" : " (fallback)") << "\t"
+       << errDouble << "\t" << errMixed << "\n";
+}
+
+int main()
+{
+  cout << "solver\t\tsize\tdouble\tmixed\tspeedup\tsteps\tdouble bwd err\tmixed bwd err\n";
+  for(int size=256; size<=MAXSIZE; size*=2)
+  {
+    MatrixXd A = MatrixXd::Random(size,size);
+    run<PartialPivLU<MatrixXd> >("PartialPivLU", A);
+    MatrixXd S = A * A.transpose() + MatrixXd::Identity(size,size);
+    run<LDLT<MatrixXd> >("LDLT\t", S);
+  }
+
+  // 2D Poisson problems
+  for(int size=128; size<=MAXSIZE/2; size*=2)
+  {
+    const int n = size*size;
+    std::vector<Triplet<double> > triplets;
+    for(int i=0; i<size; ++i)
+      for(int j=0; j<size; ++j)
+      {
+        const int k = i*size+j;
+        triplets.push_back(Triplet<double>(k, k, 4));
+        if(i>0)      triplets.push_back(Triplet<double>(k, k-size, -1));
+        if(i<size-1) triplets.push_back(Triplet<double>(k, k+size, -1));
+        if(j>0)      triplets.push_back(Triplet<double>(k, k-1, -1));
+        if(j<size-1) triplets.push_back(Triplet<double>(k, k+1, -1));
+      }
+    SparseMatrix<double> A(n, n);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    run<SimplicialLDLT<SparseMatrix<double> > >("SimplicialLDLT", A);
+    run<SupernodalLDLT<SparseMatrix<double> > >("SupernodalLDLT", A);
+  }
+  return 0;
+}
@@ -0,0 +1,53 @@
+// g++ bench_partial_piv_lu.cpp -I .. -O3 -DNDEBUG -lrt && ./a.out
+// g++ bench_partial_piv_lu.cpp -I .. -O3 -DNDEBUG -fopenmp -DMAXSIZE=8192 -lrt && ./a.out
+
+// Reports the GFLOPS of PartialPivLU on square matrices of increasing size, for 1 to nbThreads() threads
+// (powers of two), such that the scaling of the blocked factorization with its look-ahead can be measured.
+
+#include <iostream>
+#include <Eigen/Dense>
+#include <bench/BenchTimer.h>
+
+using namespace std;
+using namespace Eigen;
+
+#ifndef MAXSIZE
+#define MAXSIZE 4096
+#endif
+
+#ifndef TRIES
+#define TRIES 3
+#endif
+
+#ifndef SCALAR
+#define SCALAR double
+#endif
+
+typedef Matrix<SCALAR,Dynamic,Dynamic> MatrixType;
+
+int main()
+{
+  const int maxThreads = nbThreads();
+  cout << "size";
+  for(int threads=1; threads<=maxThreads; threads*=2)
+    cout << "\t" << threads << " thr";
+  cout << "\t(GFLOPS)\n";
+
+  for(int size=128; size<=MAXSIZE; size*=2)
+  {
+    MatrixType A = MatrixType::Random(size,size);
+    PartialPivLU<MatrixType> lu(size);
+    const int repeat = (std::max)(1, int(1e8/(double(size)*size*size)));
+    cout << size;
+    for(int threads=1; threads<=maxThreads; threads*=2)
+    {
+      setNbThreads(threads);
+      BenchTimer timer;
+      BENCH(timer, TRIES, repeat, lu.compute(A));
+      cout << "\t" << 2./3.*double(size)*size*size * repeat / timer.best() * 1e-9;
+    }
+    cout << "\n";
+  }
+  setNbThreads(maxThreads);
+  return 0;
+}
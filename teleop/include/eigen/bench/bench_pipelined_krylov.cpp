@@ -0,0 +1,82 @@
+// g++ bench_pipelined_krylov.cpp -I .. -O3 -DNDEBUG -lrt && ./a.out
+// g++ bench_pipelined_krylov.cpp -I .. -O3 -DNDEBUG -fopenmp -DMAXSIZE=2048 -lrt && OMP_NUM_THREADS=8 ./a.out
+
+// Solves 2D Poisson problems of increasing size with ConjugateGradient and PipelinedConjugateGradient, and a
+// convection-diffusion problem with GMRES and LowSyncGMRES, all preconditioned by the diagonal, and reports
+// the number of iterations and the time per iteration of each solver.
+
+#include <iostream>
+#include <Eigen/Sparse>
+#include <unsupported/Eigen/IterativeSolvers>
+#include <bench/BenchTimer.h>
+
+using namespace std;
+using namespace Eigen;
+
+#ifndef MAXSIZE
+#define MAXSIZE 1024
+#endif
+
+typedef SparseMatrix<double,RowMajor> SpMat;
+
+// 5-point finite difference discretization of -laplacian(u) + c.grad(u) on a size x size grid
+void convection_diffusion_2d(int size, double c, SpMat& A)
+{
+  std::vector<Triplet<double> > triplets;
+  for(int i=0; i<size; ++i)
+    for(int j=0; j<size; ++j)
+    {
+      const int k = i*size+j;
+      triplets.push_back(Triplet<double>(k, k, 4));
+      if(i>0)      triplets.push_back(Triplet<double>(k, k-size, -1));
+      if(i<size-1) triplets.push_back(Triplet<double>(k, k+size, -1));
+      if(j>0)      triplets.push_back(Triplet<double>(k, k-1, -1-c));
+      if(j<size-1) triplets.push_back(Triplet<double>(k, k+1, -1+c));
+    }
+  A.resize(size*size, size*size);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+}
+
+template<typename Solver>
+void run(Solver& solver, const SpMat& A, const VectorXd& b, int maxIters)
+{
+  BenchTimer timer;
+  VectorXd x(b.size());
+  solver.setTolerance(1e-8);
+  solver.setMaxIterations(maxIters);
+  solver.compute(A);
+  timer.start();
+  x = solver.solve(b);
+  timer.stop();
+  cout << "\t" << solver.iterations() << "\t" << 1e3*timer.value()/(std::max)(solver.iterations(),1);
+}
+
+int main()
+{
+  cout << "threads: " << nbThreads() << "\n";
+  cout << "unknowns\tCG its\tms/it\tpipelined its\tms/it\tGMRES its\tms/it\tlow sync its\tms/it\n";
+  for(int size=64; size<=MAXSIZE; size*=2)
+  {
+    const int n = size*size;
+    SpMat A;
+    VectorXd b = VectorXd::Random(n);
+    cout << n << "\t";
+
+    convection_diffusion_2d(size, 0, A);
+    ConjugateGradient<SpMat, Lower|Upper> cg;
+    PipelinedConjugateGradient<SpMat, Lower|Upper> pcg;
+    run(cg, A, b, 4*size);
+    cout << "\t";
+    run(pcg, A, b, 4*size);
+
+    convection_diffusion_2d(size, 0.3, A);
+    GMRES<SpMat> gmres;
+    LowSyncGMRES<SpMat> lsgmres;
+    cout << "\t";
+    run(gmres, A, b, 4*size);
+    cout << "\t";
+    run(lsgmres, A, b, 4*size);
+    cout << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,45 @@
+// g++ bench_redux_accuracy.cpp -I .. -O3 -DNDEBUG -lrt && ./a.out
+// g++ bench_redux_accuracy.cpp -I .. -O3 -DNDEBUG -fopenmp -lrt && OMP_NUM_THREADS=4 ./a.out
+
+// Measures the speed of sum(), squaredNorm() and dot() on float vectors, and the growth of their
+// rounding errors with the size of the vectors, relative to a sum computed in double precision.
+// See also bench_sum.cpp which repeatedly sums a vector in a loop.
+
+#include <iostream>
+#include <Eigen/Core>
+#include <bench/BenchTimer.h>
+
+using namespace std;
+using namespace Eigen;
+
+#ifndef SCALAR
+#define SCALAR float
+#endif
+
+typedef Matrix<SCALAR,Dynamic,1> Vec;
+
+int main()
+{
+  cout << "size        sum err     sqnorm err  dot err     sum (ms)  sqnorm (ms)  dot (ms)\n";
+  for(int size=1000; size<=10000000; size*=10)
+  {
+    Vec u = (Vec::Random(size) + Vec::Ones(size)) / SCALAR(2), v = Vec::Random(size);
+    VectorXd ud = u.cast<double>(), vd = v.cast<double>();
+    double refSum = ud.sum(), refNorm = ud.squaredNorm(), refDot = ud.dot(vd), scaleDot = ud.cwiseProduct(vd).cwiseAbs().sum();
+
+    const int rep = 100000000/size;
+    SCALAR s = 0, n = 0, d = 0;
+    BenchTimer tsum, tnorm, tdot;
+    BENCH(tsum,  5, rep, s += u.sum());
+    BENCH(tnorm, 5, rep, n += u.squaredNorm());
+    BENCH(tdot,  5, rep, d += u.dot(v));
+
+    cout << size << "\t"
+         << std::abs(double(u.sum())-refSum)/refSum << "\t"
+         << std::abs(double(u.squaredNorm())-refNorm)/refNorm << "\t"
+         << std::abs(double(u.dot(v))-refDot)/scaleDot << "\t"
+         << 1e3*tsum.best()/rep << "\t" << 1e3*tnorm.best()/rep << "\t" << 1e3*tdot.best()/rep
+         << "\t(" << s+n+d << ")\n";
+  }
+  return 0;
+}
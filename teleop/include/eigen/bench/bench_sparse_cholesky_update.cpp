@@ -0,0 +1,74 @@
+// g++ bench_sparse_cholesky_update.cpp -I .. -O3 -DNDEBUG -lrt && ./a.out
+// g++ bench_sparse_cholesky_update.cpp -I .. -O3 -DNDEBUG -DSIZE=100 -DRANK=4 -lrt && ./a.out
+
+// Compares SimplicialLLT::rankUpdate() with a full refactorization, for the incremental updates of
+// an estimation problem: a 2D Laplacian on a SIZE x SIZE grid receives new constraints between RANK pairs
+// of random nodes, i.e., rank-RANK updates W W^T introducing new fill-in, which are then removed again.
+
+#include <iostream>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <bench/BenchTimer.h>
+
+using namespace std;
+using namespace Eigen;
+
+#ifndef SIZE
+#define SIZE 300
+#endif
+
+#ifndef RANK
+#define RANK 1
+#endif
+
+typedef SparseMatrix<double> SpMat;
+
+int main()
+{
+  const int n = SIZE*SIZE;
+  std::vector<Triplet<double> > triplets;
+  for(int i=0; i<SIZE; ++i)
+    for(int j=0; j<SIZE; ++j)
+    {
+      const int k = i*SIZE+j;
+      triplets.push_back(Triplet<double>(k, k, 4));
+      if(i>0) triplets.push_back(Triplet<double>(k, k-SIZE, -1));
+      if(j>0) triplets.push_back(Triplet<double>(k, k-1, -1));
+    }
+  SpMat A(n, n);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+
+  // loop closures between random nodes
+  SpMat W(n, RANK);
+  for(int k=0; k<RANK; ++k)
+  {
+    int i = internal::random<int>(0,n-1), j = internal::random<int>(0,n-1);
+    if(i==j) j = (i+1)%n;
+    W.insert(i,k) = 1;
+    W.insert(j,k) = -1;
+  }
+  SpMat A2 = A;
+  A2 += SpMat(W * W.transpose());
+  A2 = A2.triangularView<Lower>();
+
+  SimplicialLLT<SpMat> llt(A), ref;
+  VectorXd b = VectorXd::Random(n);
+
+  BenchTimer tcompute, tfactorize, tupdate, tdowndate;
+  BENCH(tcompute,   5, 1, ref.compute(A2));
+  BENCH(tfactorize, 5, 1, ref.factorize(A2));
+  for(int k=0; k<5; ++k)
+  {
+    tupdate.start();   llt.rankUpdate(W,  1); tupdate.stop();
+    tdowndate.start(); llt.rankUpdate(W, -1); tdowndate.stop();
+  }
+  llt.rankUpdate(W, 1);
+  VectorXd x1 = ref.solve(b), x2 = llt.solve(b);
+
+  cout << "n = " << n << ", nnz(L) = " << SpMat(ref.matrixL()).nonZeros() << ", rank " << RANK << "\n";
+  cout << "compute:      " << tcompute.best()*1e3 << " ms\n";
+  cout << "factorize:    " << tfactorize.best()*1e3 << " ms\n";
+  cout << "rankUpdate:   " << tupdate.best()*1e3 << " ms  (error " << (x1-x2).norm()/x1.norm() << ")\n";
+  cout << "downdate:     " << tdowndate.best()*1e3 << " ms\n";
+  return 0;
+}
@@ -0,0 +1,88 @@
+// g++ bench_sparse_index_types.cpp -I .. -O3 -DNDEBUG -lrt && ./a.out
+// g++ bench_sparse_index_types.cpp -I .. -O3 -DNDEBUG -DSIZE=50 -lrt && ./a.out
+
+// Memory footprint and sparse matrix - vector product speed of the same matrix, a 27 points stencil on a
+// SIZE^3 grid, stored with various index types: 32 bits indices, 64 bits indices, 32 bits inner indices with
+// 64 bits outer positions (the layout needed beyond 2^31 nonzeros), and delta compressed inner indices.
+
+#include <iostream>
+#include <Eigen/Sparse>
+#include <unsupported/Eigen/SparseExtra>
+#include <bench/BenchTimer.h>
+
+using namespace std;
+using namespace Eigen;
+
+#ifndef SIZE
+#define SIZE 80
+#endif
+
+#ifndef REPEAT
+#define REPEAT 10
+#endif
+
+typedef SparseMatrix<double,ColMajor,int> SpMatInt;
+typedef SparseMatrix<double,ColMajor,long> SpMatLong;
+typedef SparseMatrix<double,ColMajor,int,long> SpMatIntLong;
+typedef DeltaCompressedSparseMatrix<double,ColMajor,int,long> DeltaMat;
+
+template<typename SpMat>
+std::size_t index_bytes(const SpMat& A)
+{
+  return std::size_t(A.outerSize()+1)*sizeof(typename SpMat::OuterIndex) + std::size_t(A.nonZeros())*sizeof(typename SpMat::Index);
+}
+
+template<typename MatType>
+void bench_spmv(const char* name, const MatType& A, std::size_t indexBytes, const VectorXd& x)
+{
+  VectorXd y(A.rows());
+  BenchTimer t;
+  BENCH(t, 5, REPEAT, y.noalias() = A * x);
+  std::size_t valueBytes = std::size_t(A.nonZeros())*sizeof(double);
+  cout << name << "\tindex: " << double(indexBytes)/1024/1024 << " MB"
+       << "\ttotal: " << double(indexBytes+valueBytes)/1024/1024 << " MB"
+       << "\tSpMV: " << t.best()/REPEAT*1000 << " ms"
+       << "\t(" << y.sum() << ")\n";
+}
+
+int main()
+{
+  const int n = SIZE*SIZE*SIZE;
+  std::vector<Triplet<double> > triplets;
+  triplets.reserve(27*n);
+  for(int i=0; i<SIZE; ++i)
+    for(int j=0; j<SIZE; ++j)
+      for(int k=0; k<SIZE; ++k)
+      {
+        int id = (i*SIZE+j)*SIZE+k;
+        for(int di=-1; di<=1; ++di)
+          for(int dj=-1; dj<=1; ++dj)
+            for(int dk=-1; dk<=1; ++dk)
+            {
+              int ni = i+di, nj = j+dj, nk = k+dk;
+              if(ni<0 || nj<0 || nk<0 || ni>=SIZE || nj>=SIZE || nk>=SIZE)
+                continue;
+              double v = (di==0 && dj==0 && dk==0) ? 26.0 : -1.0;
+              triplets.push_back(Triplet<double>(id, (ni*SIZE+nj)*SIZE+nk, v));
+            }
+      }
+
+  SpMatInt A;
+  A.resize(n,n);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+  triplets.clear();
+  SpMatLong A64(A);
+  SpMatIntLong A3264(A);
+  DeltaMat Ad(A);
+
+  cout << "n = " << n << ", nnz = " << A.nonZeros() << "\n";
+  cout << "delta stream: " << double(Ad.indexBytes() - 2*std::size_t(n+1)*sizeof(long))/A.nonZeros() << " bytes per nonzero\n";
+
+  VectorXd x = VectorXd::Random(n);
+  bench_spmv("int      ", A, index_bytes(A), x);
+  bench_spmv("long     ", A64, index_bytes(A64), x);
+  bench_spmv("int/long ", A3264, index_bytes(A3264), x);
+  bench_spmv("delta    ", Ad, Ad.indexBytes(), x);
+
+  return 0;
+}
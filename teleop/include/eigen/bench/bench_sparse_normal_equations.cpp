@@ -0,0 +1,59 @@
+// g++ bench_sparse_normal_equations.cpp -I .. -O3 -DNDEBUG -fopenmp -lrt && OMP_NUM_THREADS=4 ./a.out
+// g++ bench_sparse_normal_equations.cpp -I .. -O3 -DNDEBUG -DROWS=400000 -DCOLS=20000 -lrt && ./a.out
+
+// Forms the normal equations J^T J of a least squares problem whose Jacobian J has ROWS residuals of
+// NNZ_PER_ROW random parameters each, plus a few dense rows, as with shared calibration parameters.
+// Compares the full sparse * sparse product with the selfadjoint rank update computing only the lower part.
+
+#include <iostream>
+#include <Eigen/Sparse>
+#include <bench/BenchTimer.h>
+
+using namespace std;
+using namespace Eigen;
+
+#ifndef ROWS
+#define ROWS 200000
+#endif
+
+#ifndef COLS
+#define COLS 10000
+#endif
+
+#ifndef NNZ_PER_ROW
+#define NNZ_PER_ROW 6
+#endif
+
+typedef SparseMatrix<double> SpMat;
+
+int main()
+{
+  std::vector<Triplet<double> > triplets;
+  for(int i=0; i<ROWS; ++i)
+  {
+    // residuals involve parameters close to each other, and one of the 20 shared parameters
+    int base = internal::random<int>(0,COLS-1-40);
+    for(int k=0; k<NNZ_PER_ROW-1; ++k)
+      triplets.push_back(Triplet<double>(i, base+internal::random<int>(0,40), internal::random<double>()));
+    triplets.push_back(Triplet<double>(i, COLS-1-internal::random<int>(0,19), internal::random<double>()));
+  }
+  SpMat J(ROWS,COLS);
+  J.setFromTriplets(triplets.begin(), triplets.end());
+  cout << "J: " << ROWS << " x " << COLS << ", nnz = " << J.nonZeros() << ", threads = " << nbThreads() << "\n";
+
+  BenchTimer tFull, tLower, tFullSeq, tLowerSeq;
+  SpMat N, L(COLS,COLS);
+  BENCH(tFull, 5, 1, N = J.transpose() * J);
+  BENCH(tLower, 5, 1, L.setZero(); L.selfadjointView<Lower>().rankUpdate(J.transpose()));
+  int threads = nbThreads();
+  setNbThreads(1);
+  BENCH(tFullSeq, 5, 1, N = J.transpose() * J);
+  BENCH(tLowerSeq, 5, 1, L.setZero(); L.selfadjointView<Lower>().rankUpdate(J.transpose()));
+  setNbThreads(threads);
+
+  cout << "nnz(J^T J) = " << N.nonZeros() << ", nnz(lower) = " << L.nonZeros() << "\n";
+  cout << "J^T J                  " << tFull.best()*1000 << " ms\t(1 thread: " << tFullSeq.best()*1000 << " ms)\n";
+  cout << "rankUpdate<Lower>(J^T) " << tLower.best()*1000 << " ms\t(1 thread: " << tLowerSeq.best()*1000 << " ms)\n";
+
+  return 0;
+}
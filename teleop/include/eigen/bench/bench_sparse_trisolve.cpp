@@ -0,0 +1,58 @@
+// g++ bench_sparse_trisolve.cpp -I .. -O3 -DNDEBUG -fopenmp -lrt && ./a.out
+// g++ bench_sparse_trisolve.cpp -I .. -O3 -DNDEBUG -fopenmp -DSIZE=200 -DNRHS=8 -lrt && ./a.out
+
+// Compares the substitution of SparseTriangularView::solve() with the level scheduled,
+// supernodal SparseTriangularSolver on the Cholesky factor of a 2D Laplacian on a SIZE x SIZE grid,
+// for NRHS right hand sides, using all the OpenMP threads.
+
+#include <iostream>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <bench/BenchTimer.h>
+
+using namespace std;
+using namespace Eigen;
+
+#ifndef SIZE
+#define SIZE 300
+#endif
+
+#ifndef NRHS
+#define NRHS 1
+#endif
+
+typedef SparseMatrix<double> SpMat;
+
+int main()
+{
+  const int n = SIZE*SIZE;
+  std::vector<Triplet<double> > triplets;
+  for(int i=0; i<SIZE; ++i)
+    for(int j=0; j<SIZE; ++j)
+    {
+      const int k = i*SIZE+j;
+      triplets.push_back(Triplet<double>(k, k, 4));
+      if(i>0) triplets.push_back(Triplet<double>(k, k-SIZE, -1));
+      if(j>0) triplets.push_back(Triplet<double>(k, k-1, -1));
+    }
+  SpMat A(n, n);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+
+  // only the lower triangular part is used
+  SimplicialLLT<SpMat> llt(A);
+  SpMat L = llt.matrixL();
+  MatrixXd b = MatrixXd::Random(n, NRHS), x1, x2;
+
+  BenchTimer tanalyze, tview, tsolver;
+  SparseTriangularSolver<SpMat,Lower> solver;
+  BENCH(tanalyze, 5, 1, solver.analyzePattern(L));
+  BENCH(tview,    5, 1, x1 = L.triangularView<Lower>().solve(b));
+  BENCH(tsolver,  5, 1, x2 = solver.solve(L, b));
+
+  cout << "n = " << n << ", nnz(L) = " << L.nonZeros() << ", " << solver.levels() << " levels, "
+       << solver.supernodes() << " supernodes, " << nbThreads() << " threads\n";
+  cout << "analysis:              " << tanalyze.best()*1e3 << " ms\n";
+  cout << "triangularView solve:  " << tview.best()*1e3 << " ms\n";
+  cout << "SparseTriangularSolver " << tsolver.best()*1e3 << " ms  (error " << (x1-x2).norm()/x1.norm() << ")\n";
+  return 0;
+}
@@ -0,0 +1,68 @@
+// g++ bench_tsqr.cpp -I .. -O3 -DNDEBUG -lrt && ./a.out
+// g++ bench_tsqr.cpp -I .. -O3 -DNDEBUG -fopenmp -DMAXROWS=4000000 -lrt && OMP_NUM_THREADS=8 ./a.out
+
+// Solves tall and skinny least-squares problems with HouseholderQR and TallSkinnyQR, reporting the time of
+// the factorization and of one solve and the residual of the normal equations, and then reports the GFLOPS
+// of HouseholderQR on square matrices.
+
+#include <iostream>
+#include <Eigen/Dense>
+#include <bench/BenchTimer.h>
+
+using namespace std;
+using namespace Eigen;
+
+#ifndef MAXROWS
+#define MAXROWS 1000000
+#endif
+
+#ifndef MAXSIZE
+#define MAXSIZE 2048
+#endif
+
+#ifndef TRIES
+#define TRIES 3
+#endif
+
+template<typename Decomposition>
+void run(const MatrixXd& A, const VectorXd& b)
+{
+  BenchTimer tFactor, tSolve;
+  VectorXd x;
+  for(int k=0; k<TRIES; ++k)
+  {
+    tFactor.start();
+    Decomposition dec(A);
+    tFactor.stop();
+    tSolve.start();
+    x = dec.solve(b);
+    tSolve.stop();
+  }
+  cout << "\t" << tFactor.best() << "\t" << tSolve.best() << "\t" << (A.transpose()*(A*x-b)).norm()/(A.norm()*b.norm());
+}
+
+int main()
+{
+  cout << "threads: " << nbThreads() << "\n";
+  cout << "rows\tcols\tHouseholderQR\tsolve\terror\tTallSkinnyQR\tsolve\terror\n";
+  for(int rows=10000; rows<=MAXROWS; rows*=10)
+    for(int cols=10; cols<=50; cols+=20)
+    {
+      MatrixXd A = MatrixXd::Random(rows,cols);
+      VectorXd b = VectorXd::Random(rows);
+      cout << rows << "\t" << cols;
+      run<HouseholderQR<MatrixXd> >(A, b);
+      run<TallSkinnyQR<MatrixXd> >(A, b);
+      cout << "\n";
+    }
+
+  cout << "size\tHouseholderQR GFLOPS\n";
+  for(int size=256; size<=MAXSIZE; size*=2)
+  {
+    MatrixXd A = MatrixXd::Random(size,size);
+    BenchTimer timer;
+    BENCH(timer, TRIES, 1, HouseholderQR<MatrixXd> qr(A));
+    cout << size << "\t" << 4./3.*double(size)*size*size / timer.best() * 1e-9 << "\n";
+  }
+  return 0;
+}
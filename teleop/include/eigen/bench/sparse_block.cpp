@@ -0,0 +1,86 @@
+// g++ sparse_block.cpp -I .. -O3 -DNDEBUG -lrt && ./a.out
+
+// Compares the memory footprint, the matrix-vector product and the Cholesky factorization
+// of a BlockSparseMatrix and of a scalar SparseMatrix, on the Hessian of a random pose graph
+// made of 6x6 blocks, as found in SLAM and bundle adjustment problems. The number of poses
+// is set with -DNBPOSES=n.
+
+#include <iostream>
+#include <vector>
+#include <Eigen/Sparse>
+#include <unsupported/Eigen/SparseExtra>
+#include <bench/BenchTimer.h>
+
+using namespace std;
+using namespace Eigen;
+
+#ifndef NBTRIES
+#define NBTRIES 3
+#endif
+
+#ifndef REPEAT
+#define REPEAT 20
+#endif
+
+#ifndef NBPOSES
+#define NBPOSES 5000
+#endif
+
+enum { BS = 6 };
+typedef Matrix<double,BS,BS> Block6;
+typedef BlockSparseMatrix<double,BS> BlockMat;
+typedef SparseMatrix<double> SpMat;
+typedef SparseMatrix<double,RowMajor> RowSpMat;
+
+// odometry edges between consecutive poses plus a few loop closures
+void pose_graph(int poses, BlockMat& A)
+{
+  std::vector<BlockTriplet<double,BS> > triplets;
+  for(int i=0; i<poses; ++i)
+  {
+    Block6 d = Block6::Random();
+    triplets.push_back(BlockTriplet<double,BS>(i,i,d*d.transpose() + 40*Block6::Identity()));
+    int closures = (i%10==0) ? 3 : 0;
+    for(int k=0; k<=closures; ++k)
+    {
+      int j = k==0 ? i+1 : internal::random<int>(0,poses-1);
+      if(j==i || j>=poses) continue;
+      Block6 b = Block6::Random();
+      triplets.push_back(BlockTriplet<double,BS>(i,j,b));
+      triplets.push_back(BlockTriplet<double,BS>(j,i,b.transpose()));
+    }
+  }
+  A.resize(poses,poses);
+  A.setFromBlockTriplets(triplets.begin(), triplets.end());
+}
+
+int main()
+{
+  BlockMat A;
+  pose_graph(NBPOSES, A);
+  SpMat sA = A.toSparseMatrix();
+  RowSpMat rA = sA;
+  VectorXd x = VectorXd::Random(A.cols()), y(A.rows());
+
+  cout << "size: " << A.rows() << ", blocks: " << A.nonZeroBlocks() << ", nnz: " << A.nonZeros() << "\n";
+  cout << "memory (MB):  block " << double(A.nonZeros()*sizeof(double) + (A.nonZeroBlocks()+A.blockRows()+1)*sizeof(int))/1e6
+       << "   scalar " << double(sA.nonZeros()*(sizeof(double)+sizeof(int)) + (sA.cols()+1)*sizeof(int))/1e6 << "\n";
+
+  BenchTimer tblock, tcol, trow;
+  BENCH(tblock, NBTRIES, REPEAT, y.noalias() = A*x);
+  BENCH(tcol,   NBTRIES, REPEAT, y.noalias() = sA*x);
+  BENCH(trow,   NBTRIES, REPEAT, y.noalias() = rA*x);
+  cout << "SpMV:         block " << tblock.best() << "   col-major " << tcol.best() << "   row-major " << trow.best() << "\n";
+
+  BenchTimer tbllt, tsllt;
+  BlockSparseLLT<BlockMat> bllt;
+  bllt.analyzePattern(A);
+  BENCH(tbllt, NBTRIES, 1, bllt.factorize(A));
+  SimplicialLLT<SpMat> sllt;
+  sllt.analyzePattern(sA);
+  BENCH(tsllt, NBTRIES, 1, sllt.factorize(sA));
+  cout << "LLT:          block " << tbllt.best() << "   scalar " << tsllt.best() << "\n";
+  cout << "residuals:    block " << (sA*bllt.solve(x) - x).norm() / x.norm()
+       << "   scalar " << (sA*sllt.solve(x) - x).norm() / x.norm() << "\n";
+  return 0;
+}
@@ -0,0 +1,105 @@
+// g++ sparse_io.cpp -I .. -O3 -DNDEBUG -fopenmp -lrt && ./a.out
+// g++ sparse_io.cpp -I .. -O3 -DNDEBUG -fopenmp -lrt && ./a.out matrix.mtx
+
+// Compares the time needed to load a sparse matrix from a Matrix Market file, with the line by line
+// iostream parser, with loadMarket(), with loadBinary(), and by mapping the binary file.
+// Without argument, a random matrix is generated and saved first.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <Eigen/Sparse>
+#include <unsupported/Eigen/SparseExtra>
+#include <bench/BenchTimer.h>
+
+using namespace std;
+using namespace Eigen;
+
+typedef SparseMatrix<double> SpMat;
+
+#ifndef NBTRIES
+#define NBTRIES 3
+#endif
+
+#ifndef SIZE
+#define SIZE 500000
+#endif
+
+#ifndef NNZ_PER_COL
+#define NNZ_PER_COL 10
+#endif
+
+// the iostream based parser loadMarket() used to rely on
+bool loadMarketStream(SpMat& mat, const std::string& filename)
+{
+  std::ifstream input(filename.c_str(),std::ios::in);
+  if(!input)
+    return false;
+  char buffer[2048];
+  bool readsizes = false;
+  std::vector<Triplet<double,int> > elements;
+  int M(-1), N(-1), NNZ(-1);
+  while(input.getline(buffer, 2048))
+  {
+    if(buffer[0]=='%')
+      continue;
+    std::stringstream line(buffer);
+    if(!readsizes)
+    {
+      line >> M >> N >> NNZ;
+      readsizes = M>0 && N>0 && NNZ>0;
+      mat.resize(M,N);
+    }
+    else
+    {
+      int i(-1), j(-1);
+      double value;
+      if(internal::GetMarketLine(line, M, N, i, j, value))
+        elements.push_back(Triplet<double,int>(i,j,value));
+    }
+  }
+  mat.setFromTriplets(elements.begin(), elements.end());
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  std::string mtx = argc>1 ? argv[1] : "sparse_io_bench.mtx";
+  std::string bin = "sparse_io_bench.bin";
+  if(argc<=1)
+  {
+    std::vector<Triplet<double,int> > triplets;
+    for(int j=0; j<SIZE; ++j)
+      for(int k=0; k<NNZ_PER_COL; ++k)
+        triplets.push_back(Triplet<double,int>(internal::random<int>(0,SIZE-1), j, internal::random<double>()));
+    SpMat A(SIZE,SIZE);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    saveMarket(A, mtx);
+  }
+
+  SpMat A;
+  BenchTimer tstream, tmarket, tbinary, tmap;
+  BENCH(tstream, NBTRIES, 1, loadMarketStream(A, mtx));
+  BENCH(tmarket, NBTRIES, 1, loadMarket(A, mtx));
+  saveBinary(A, bin);
+  BENCH(tbinary, NBTRIES, 1, loadBinary(A, bin));
+  double sum = 0;
+  for(int t=0; t<NBTRIES; ++t)
+  {
+    tmap.start();
+    MappedBinarySparseMatrix<double> mA(bin);
+    sum += Map<const VectorXd>(mA.valuePtr(), mA.nonZeros()).sum();
+    tmap.stop();
+  }
+
+  cout << "size: " << A.rows() << "x" << A.cols() << ", nnz: " << A.nonZeros() << ", threads: " << nbThreads() << "\n";
+  cout << "iostream     " << tstream.best() << "\n";
+  cout << "loadMarket   " << tmarket.best() << "\n";
+  cout << "loadBinary   " << tbinary.best() << "\n";
+  cout << "mapped+sum   " << tmap.best() << "   (" << sum << ")\n";
+
+  if(argc<=1)
+    std::remove(mtx.c_str());
+  std::remove(bin.c_str());
+  return 0;
+}
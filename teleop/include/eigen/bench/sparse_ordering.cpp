@@ -0,0 +1,121 @@
+// g++ sparse_ordering.cpp -I .. -O3 -DNDEBUG -lrt && ./a.out
+// g++ sparse_ordering.cpp -I .. -O3 -DNDEBUG -lrt && ./a.out matrix1.mtx matrix2.mtx
+
+// Compares the fill-in, the number of operations and the timings of the sparse Cholesky
+// factorization with the AMD and the nested dissection orderings, on 2D/3D meshes or
+// on symmetric matrices given in the Matrix Market format.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <Eigen/Sparse>
+#include <unsupported/Eigen/SparseExtra>
+#include <bench/BenchTimer.h>
+
+using namespace std;
+using namespace Eigen;
+
+typedef SparseMatrix<double> SpMat;
+
+#ifndef NBTRIES
+#define NBTRIES 3
+#endif
+
+void grid_laplacian(int nx, int ny, int nz, SpMat& A)
+{
+  std::vector<Triplet<double> > triplets;
+  for(int k=0; k<nz; ++k)
+    for(int j=0; j<ny; ++j)
+      for(int i=0; i<nx; ++i)
+      {
+        int id = i + nx*(j + ny*k);
+        triplets.push_back(Triplet<double>(id,id,6.5));
+        if(i>0)    triplets.push_back(Triplet<double>(id,id-1,-1));
+        if(i<nx-1) triplets.push_back(Triplet<double>(id,id+1,-1));
+        if(j>0)    triplets.push_back(Triplet<double>(id,id-nx,-1));
+        if(j<ny-1) triplets.push_back(Triplet<double>(id,id+nx,-1));
+        if(k>0)    triplets.push_back(Triplet<double>(id,id-nx*ny,-1));
+        if(k<nz-1) triplets.push_back(Triplet<double>(id,id+nx*ny,-1));
+      }
+  A.resize(nx*ny*nz,nx*ny*nz);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+}
+
+template<typename Ordering>
+void bench_ordering(const char* name, const SpMat& A)
+{
+  BenchTimer tord, tfact;
+  typename Ordering::PermutationType perm;
+  for(int t=0; t<NBTRIES; ++t)
+  {
+    Ordering ordering;
+    tord.start();
+    ordering(A.selfadjointView<Lower>(), perm);
+    tord.stop();
+  }
+
+  SimplicialLLT<SpMat, Lower, Ordering> llt;
+  llt.analyzePattern(A);
+  for(int t=0; t<NBTRIES; ++t)
+  {
+    tfact.start();
+    llt.factorize(A);
+    tfact.stop();
+  }
+  if(llt.info()!=Success)
+  {
+    cout << name << " failed\n";
+    return;
+  }
+
+  SpMat L = llt.matrixL();
+  double flops = 0;
+  for(int j=0; j<L.cols(); ++j)
+  {
+    double c = L.col(j).nonZeros();
+    flops += c*c;
+  }
+  cout << "  " << name << "\tnnz(L) = " << L.nonZeros() << "\tflops = " << flops
+       << "\tordering: " << tord.best() << "s\tfactorization: " << tfact.best() << "s\n";
+}
+
+void bench_matrix(const string& title, const SpMat& A)
+{
+  cout << title << " (" << A.rows() << " rows, " << A.nonZeros() << " non zeros)\n";
+  bench_ordering<AMDOrdering<int> >("AMD", A);
+  bench_ordering<NestedDissectionOrdering<int> >("ND ", A);
+}
+
+int main(int argc, char* argv[])
+{
+  if(argc>1)
+  {
+    for(int i=1; i<argc; ++i)
+    {
+      SpMat A;
+      if(!loadMarket(A, argv[i]))
+      {
+        cout << "cannot read " << argv[i] << "\n";
+        continue;
+      }
+      bench_matrix(argv[i], A);
+    }
+    return 0;
+  }
+
+  int sizes2d[] = { 100, 200, 400 };
+  int sizes3d[] = { 15, 25, 35 };
+  for(int k=0; k<3; ++k)
+  {
+    SpMat A;
+    grid_laplacian(sizes2d[k], sizes2d[k], 1, A);
+    bench_matrix("2D grid", A);
+  }
+  for(int k=0; k<3; ++k)
+  {
+    SpMat A;
+    grid_laplacian(sizes3d[k], sizes3d[k], sizes3d[k], A);
+    bench_matrix("3D grid", A);
+  }
+  return 0;
+}
@@ -1,5 +1,6 @@
 
 //g++ -O3 -g0 -DNDEBUG  sparse_transpose.cpp -I.. -I/home/gael/Coding/LinearAlgebra/mtl4/ -DDENSITY=0.005 -DSIZE=10000 && ./a.out
+// -DNNZPERCOL=20 -DSIZE=1000000 for large matrices having a fixed number of non zeros per column
 // -DNOGMM -DNOMTL
 // -DCSPARSE -I /home/gael/Coding/LinearAlgebra/CSparse/Include/ /home/gael/Coding/LinearAlgebra/CSparse/Lib/libcsparse.a
 
@@ -42,9 +43,20 @@ int main(int argc, char *argv[])
   EigenSparseMatrix sm1(rows,cols), sm3(rows,cols);
 
   BenchTimer timer;
+  #ifdef NNZPERCOL
+  for (float density = float(NNZPERCOL)/rows; density>=float(NNZPERCOL)/rows; density*=0.5)
+  {
+    std::vector<Triplet<Scalar> > triplets;
+    triplets.reserve(NNZPERCOL*cols);
+    for (int j=0; j<cols; ++j)
+      for (int k=0; k<NNZPERCOL; ++k)
+        triplets.push_back(Triplet<Scalar>(internal::random<int>(0,rows-1), j, internal::random<Scalar>()));
+    sm1.setFromTriplets(triplets.begin(), triplets.end());
+  #else
   for (float density = DENSITY; density>=MINDENSITY; density*=0.5)
   {
     fillMatrix(density, rows, cols, sm1);
+  #endif
 
     // dense matrices
     #ifdef DENSEMATRIX
@@ -56,7 +68,7 @@ int main(int argc, char *argv[])
     }
     #endif
 
-    std::cout << "Non zeros: " << sm1.nonZeros()/float(sm1.rows()*sm1.cols())*100 << "%\n";
+    std::cout << "Non zeros: " << sm1.nonZeros()/(float(sm1.rows())*sm1.cols())*100 << "%\n";
 
     // eigen sparse matrices
     {
@@ -64,6 +76,13 @@ int main(int argc, char *argv[])
       std::cout << "  Eigen:\t" << timer.value() << endl;
     }
 
+    // eigen storage order conversion
+    {
+      SparseMatrix<Scalar,RowMajor> smr(rows,cols);
+      BENCH(for (int k=0; k<REPEAT; ++k) smr = sm1;)
+      std::cout << "  Eigen CSC->CSR:\t" << timer.value() << endl;
+    }
+
     // CSparse
     #ifdef CSPARSE
     {
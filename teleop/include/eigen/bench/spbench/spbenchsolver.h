@@ -61,10 +61,12 @@
 #define EIGEN_GMRES 70
 #define EIGEN_GMRES_ILUT 71
 #define EIGEN_SIMPLICIAL_LDLT  80
+#define EIGEN_SUPERNODAL_LDLT  85
 #define EIGEN_CHOLMOD_LDLT  90
 #define EIGEN_PASTIX_LDLT  100
 #define EIGEN_PARDISO_LDLT  110
 #define EIGEN_SIMPLICIAL_LLT  120
+#define EIGEN_SUPERNODAL_LLT  125
 #define EIGEN_CHOLMOD_SUPERNODAL_LLT  130
 #define EIGEN_CHOLMOD_SIMPLICIAL_LLT  140
 #define EIGEN_PASTIX_LLT  150
@@ -189,6 +191,16 @@ void printStatheader(std::ofstream& out)
   out << "   <PACKAGE> EIGEN </PACKAGE> \n"; 
   out << "  </SOLVER> \n"; 
   
+  out <<"  <SOLVER ID='" << EIGEN_SUPERNODAL_LDLT << "'>\n"; 
+  out << "   <TYPE> LDLT_SUPERNODAL </TYPE> \n";
+  out << "   <PACKAGE> EIGEN </PACKAGE> \n"; 
+  out << "  </SOLVER> \n"; 
+  
+  out <<"  <SOLVER ID='" << EIGEN_SUPERNODAL_LLT << "'>\n"; 
+  out << "   <TYPE> LLT_SUPERNODAL </TYPE> \n";
+  out << "   <PACKAGE> EIGEN </PACKAGE> \n"; 
+  out << "  </SOLVER> \n"; 
+  
   out <<"  <SOLVER ID='" << EIGEN_CG << "'>\n"; 
   out << "   <TYPE> CG </TYPE> \n";
   out << "   <PACKAGE> EIGEN </PACKAGE> \n"; 
@@ -392,6 +404,12 @@ void SelectSolvers(const SparseMatrix<Scalar>&A, unsigned int sym, Matrix<Scalar
       SimplicialLDLT<SpMat, Lower> solver;
       call_directsolver(solver, EIGEN_SIMPLICIAL_LDLT, A, b, refX,statFile); 
     }
+    {
+      cout << "\nSolving with Supernodal LDLT ... \n"; 
+      SupernodalLDLT<SpMat, Lower> solver;
+      solver.setParallelTreeSchedule(true);
+      call_directsolver(solver, EIGEN_SUPERNODAL_LDLT, A, b, refX,statFile); 
+    }
     
     // CHOLMOD
     #ifdef EIGEN_CHOLMOD_SUPPORT
@@ -432,6 +450,12 @@ void SelectSolvers(const SparseMatrix<Scalar>&A, unsigned int sym, Matrix<Scalar
       SimplicialLLT<SpMat, Lower> solver; 
       call_directsolver(solver,EIGEN_SIMPLICIAL_LLT, A, b, refX,statFile); 
     }
+    {
+      cout << "\nSolving with SUPERNODAL LLT ... \n"; 
+      SupernodalLLT<SpMat, Lower> solver; 
+      solver.setParallelTreeSchedule(true);
+      call_directsolver(solver,EIGEN_SUPERNODAL_LLT, A, b, refX,statFile); 
+    }
     
     // CHOLMOD
     #ifdef EIGEN_CHOLMOD_SUPPORT
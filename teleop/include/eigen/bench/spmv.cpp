@@ -1,6 +1,9 @@
 
 //g++-4.4 -DNOMTL  -Wl,-rpath /usr/local/lib/oski -L /usr/local/lib/oski/ -l oski -l oski_util -l oski_util_Tid  -DOSKI -I ~/Coding/LinearAlgebra/mtl4/  spmv.cpp  -I .. -O2 -DNDEBUG -lrt  -lm -l oski_mat_CSC_Tid  -loskilt && ./a.out r200000 c200000 n100 t1 p1
 
+// Strong scaling of the multithreaded row-major products:
+// g++ -DNOGMM -DNOMTL -DNOUBLAS -fopenmp spmv.cpp -I .. -O2 -DNDEBUG -lrt && ./a.out r200000 c200000 n40
+
 #define SCALAR double
 
 #include <iostream>
@@ -113,6 +116,32 @@ int main(int argc, char *argv[])
       std::cout << t.value()/repeats << endl;
     }
 
+    // strong scaling of the multithreaded row-major products
+    #ifdef EIGEN_HAS_OPENMP
+    {
+      SparseMatrix<Scalar,RowMajor> rm(sm);
+      DenseMatrix dm = DenseMatrix::Random(cols,8), dres = DenseMatrix::Zero(rows,8);
+      int maxThreads = Eigen::nbThreads();
+      double seqVec = 0, seqMat = 0;
+      std::cout << "threads     spmv\t\tspeedup\tspmm(8)\t\tspeedup\n";
+      for(int threads=1; threads<=maxThreads; threads = (threads*2>maxThreads && threads<maxThreads) ? maxThreads : threads*2)
+      {
+        Eigen::setNbThreads(threads);
+        SPMV_BENCH(res.noalias() += rm * dv; )
+        double vec = t.value()/repeats;
+        SPMV_BENCH(dres.noalias() += rm * dm; )
+        double mat = t.value()/repeats;
+        if(threads==1)
+        {
+          seqVec = vec;
+          seqMat = mat;
+        }
+        std::cout << threads << "           " << vec << "\t" << seqVec/vec << "\t" << mat << "\t" << seqMat/mat << endl;
+      }
+      Eigen::setNbThreads(maxThreads);
+    }
+    #endif
+
     // CSparse
     #ifdef CSPARSE
     {
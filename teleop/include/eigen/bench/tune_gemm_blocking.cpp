@@ -0,0 +1,81 @@
+// g++ tune_gemm_blocking.cpp -I .. -O2 -DNDEBUG -lrt && ./a.out f gemm_blocking.txt s384 t3
+// g++ tune_gemm_blocking.cpp -I .. -O2 -DNDEBUG -lrt -fopenmp && OMP_NUM_THREADS=2 ./a.out
+
+// Tunes (or reloads from the cache file) the blocking sizes of the matrix products,
+// and reports the speedup of the tuned blocking over the cache size heuristic
+// on the representative products and on a range of square products.
+
+#include <iostream>
+#include <string>
+#include <Eigen/Core>
+#include <unsupported/Eigen/ProductTuner>
+#include <bench/BenchTimer.h>
+
+using namespace std;
+using namespace Eigen;
+
+#ifndef SCALAR
+#define SCALAR double
+#endif
+
+typedef SCALAR Scalar;
+typedef Matrix<Scalar,Dynamic,Dynamic> Mat;
+
+double bench_product(int m, int n, int k, int tries, int repeats)
+{
+  Mat a = Mat::Random(m,k), b = Mat::Random(k,n), c(m,n);
+  BenchTimer t;
+  BENCH(t, tries, repeats, c.noalias() = a*b);
+  return t.best(REAL_TIMER)/repeats;
+}
+
+int main(int argc, char ** argv)
+{
+  std::string filename = "gemm_blocking.txt";
+  int size = 384;
+  int tries = 3;
+  for(int i=1; i<argc; ++i)
+  {
+    if(argv[i][0]=='f' && i+1<argc)
+      filename = argv[++i];
+    else if(argv[i][0]=='s')
+      size = atoi(argv[i]+1);
+    else if(argv[i][0]=='t')
+      tries = atoi(argv[i]+1);
+    else
+    {
+      std::cout << argv[0] << " f <cache file> s<tuning size> t<nb tries>\n";
+      return 1;
+    }
+  }
+
+  GemmBlockingTuner tuner(size, tries);
+  double t0 = internal::tuner_wall_time();
+  if(tuner.load(filename) && tuner.isTuned<Scalar>())
+  {
+    std::cout << "Loaded tuned blocking sizes from " << filename << " in "
+              << (internal::tuner_wall_time()-t0)*1e3 << "ms\n";
+  }
+  else
+  {
+    tuner.tune<Scalar>();
+    std::cout << "Tuned blocking sizes in " << internal::tuner_wall_time()-t0 << "s\n";
+    if(!tuner.save(filename))
+      std::cerr << "Warning, cannot write " << filename << "\n";
+  }
+  std::cout << internal::tuned_blocking_signature() << "\n";
+  tuner.report(std::cout);
+
+  std::cout << "\nsize\theuristic\ttuned\tspeedup\n";
+  for(int s=64; s<=1024; s*=2)
+  {
+    int repeats = std::max(1, (1<<22) / (s*s*s/16+1));
+    GemmBlockingTuner::reset();
+    double th = bench_product(s, s, s, tries, repeats);
+    tuner.apply();
+    double tt = bench_product(s, s, s, tries, repeats);
+    std::cout << s << "\t" << th << "\t" << tt << "\t" << th/tt << "\n";
+  }
+
+  return 0;
+}
@@ -354,6 +354,62 @@ template<typename MatrixType> void cholesky_definiteness(const MatrixType& m)
   }
 }
 
+template<typename MatrixType> void cholesky_blocked(const MatrixType& m)
+{
+  /* this test covers the tiled LLT and the blocked LDLT of large matrices
+  */
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  Index size = m.rows();
+
+  MatrixType a = MatrixType::Random(size,size);
+  MatrixType symm = a * a.adjoint() + MatrixType::Identity(size,size);
+  MatrixType b = MatrixType::Random(size,3);
+
+  const int threads = nbThreads();
+  for(int t=1; t<=4; t*=4)
+  {
+    setNbThreads(t);
+    LLT<MatrixType,Lower> chollo(symm);
+    VERIFY_IS_EQUAL(chollo.info(), Success);
+    VERIFY_IS_APPROX(symm, chollo.reconstructedMatrix());
+    VERIFY_IS_APPROX(symm * chollo.solve(b), b);
+    LLT<MatrixType,Upper> cholup(symm);
+    VERIFY_IS_APPROX(symm, cholup.reconstructedMatrix());
+
+    // a non positive pivot in the last tiles
+    MatrixType indef = symm;
+    indef.diagonal().tail(size/3).array() -= RealScalar(1e4*size);
+    chollo.compute(indef);
+    VERIFY_IS_EQUAL(chollo.info(), NumericalIssue);
+  }
+  setNbThreads(threads);
+
+  // the blocked LDLT has the same pivots as the unblocked one
+  MatrixType indef = symm;
+  indef.diagonal().head(size/2) *= RealScalar(-1);
+  MatrixType lu = indef;
+  Transpositions<Dynamic> tr(size);
+  Matrix<Scalar,Dynamic,1> temp(size);
+  internal::SignMatrix sign = internal::ZeroSign;
+  internal::ldlt_inplace<Lower>::unblocked(lu, tr, temp, sign);
+  LDLT<MatrixType,Lower> ldltlo(indef);
+  VERIFY(ldltlo.transpositionsP().indices() == tr.indices());
+  VERIFY_IS_APPROX(ldltlo.matrixLDLT(), lu);
+  VERIFY(!ldltlo.isPositive() && !ldltlo.isNegative());
+  VERIFY_IS_APPROX(indef, ldltlo.reconstructedMatrix());
+  VERIFY_IS_APPROX(indef * ldltlo.solve(b), b);
+  LDLT<MatrixType,Upper> ldltup(indef);
+  VERIFY_IS_APPROX(indef, ldltup.reconstructedMatrix());
+
+  // a semidefinite matrix of rank size/2
+  MatrixType c = MatrixType::Random(size,size/2);
+  MatrixType semi = c * c.adjoint();
+  LDLT<MatrixType,Lower> ldltsemi(semi);
+  VERIFY_IS_APPROX(semi, ldltsemi.reconstructedMatrix());
+}
+
 template<typename MatrixType> void cholesky_verify_assert()
 {
   MatrixType tmp;
@@ -388,6 +444,9 @@ void test_cholesky()
     CALL_SUBTEST_2( cholesky(MatrixXd(s,s)) );
     s = internal::random<int>(1,EIGEN_TEST_MAX_SIZE/2);
     CALL_SUBTEST_6( cholesky_cplx(MatrixXcd(s,s)) );
+    s = internal::random<int>(300,600);
+    CALL_SUBTEST_10( cholesky_blocked(MatrixXd(s,s)) );
+    CALL_SUBTEST_10( cholesky_blocked(MatrixXcd(s/2,s/2)) );
   }
 
   CALL_SUBTEST_4( cholesky_verify_assert<Matrix3f>() );
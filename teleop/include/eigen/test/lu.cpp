@@ -146,6 +146,32 @@ template<typename MatrixType> void lu_partial_piv()
   VERIFY_IS_APPROX(m1, plu.reconstructedMatrix());
 }
 
+template<typename MatrixType> void lu_partial_piv_blocked()
+{
+  /* this test covers the recursive panel factorization and the look-ahead of PartialPivLU.h
+  */
+  typedef typename MatrixType::Index Index;
+  Index size = internal::random<Index>(300,700);
+
+  MatrixType m1 = MatrixType::Random(size, size), m2 = MatrixType::Random(size, 2);
+  // a few zero columns in the first panels make rank deficient panels
+  MatrixType m3 = m1;
+  m3.col(internal::random<Index>(0,size/8)).setZero();
+
+  const int threads = nbThreads();
+  for(int t=1; t<=4; t*=4)
+  {
+    setNbThreads(t);
+    PartialPivLU<MatrixType> plu(m1);
+    VERIFY_IS_APPROX(m1, plu.reconstructedMatrix());
+    VERIFY_IS_APPROX(m1 * plu.solve(m2), m2);
+
+    PartialPivLU<MatrixType> plu3(m3);
+    VERIFY_IS_APPROX(m3, plu3.reconstructedMatrix());
+  }
+  setNbThreads(threads);
+}
+
 template<typename MatrixType> void lu_verify_assert()
 {
   MatrixType tmp;
@@ -203,6 +229,9 @@ void test_lu()
 
     CALL_SUBTEST_7(( lu_non_invertible<Matrix<float,Dynamic,16> >() ));
 
+    CALL_SUBTEST_8( lu_partial_piv_blocked<MatrixXd>() );
+    CALL_SUBTEST_8(( lu_partial_piv_blocked<Matrix<double,Dynamic,Dynamic,RowMajor> >() ));
+
     // Test problem size constructors
     CALL_SUBTEST_9( PartialPivLU<MatrixXf>(10) );
     CALL_SUBTEST_9( FullPivLU<MatrixXf>(10, 20); );
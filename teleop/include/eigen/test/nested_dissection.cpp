@@ -0,0 +1,154 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "sparse_solver.h"
+#include <Eigen/SparseLU>
+
+// Laplacian on a nx*ny*nz grid, made of several disconnected copies
+template<typename T> void grid_laplacian(int nx, int ny, int nz, int copies, SparseMatrix<T>& A)
+{
+  std::vector<Triplet<T> > triplets;
+  const int size = nx*ny*nz;
+  for(int c=0; c<copies; ++c)
+    for(int k=0; k<nz; ++k)
+      for(int j=0; j<ny; ++j)
+        for(int i=0; i<nx; ++i)
+        {
+          int id = c*size + i + nx*(j + ny*k);
+          triplets.push_back(Triplet<T>(id,id,T(6.5)));
+          if(i>0)    triplets.push_back(Triplet<T>(id,id-1,T(-1)));
+          if(i<nx-1) triplets.push_back(Triplet<T>(id,id+1,T(-1)));
+          if(j>0)    triplets.push_back(Triplet<T>(id,id-nx,T(-1)));
+          if(j<ny-1) triplets.push_back(Triplet<T>(id,id+nx,T(-1)));
+          if(k>0)    triplets.push_back(Triplet<T>(id,id-nx*ny,T(-1)));
+          if(k<nz-1) triplets.push_back(Triplet<T>(id,id+nx*ny,T(-1)));
+        }
+  A.resize(copies*size,copies*size);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+}
+
+template<typename Ordering>
+void check_separator_tree(const Ordering& ordering, const SparseMatrix<double>& A, const typename Ordering::PermutationType& perm)
+{
+  typedef typename Ordering::PermutationType PermutationType;
+  typedef typename Ordering::IndexVector IndexVector;
+  const int n = A.rows();
+  const IndexVector& parent = ordering.nodeParent();
+  const IndexVector& start = ordering.nodeStart();
+  const IndexVector& sep = ordering.nodeSeparator();
+  const IndexVector& end = ordering.nodeEnd();
+  const int nbNodes = parent.size();
+  VERIFY(nbNodes>0);
+
+  // the nodes are in postorder, and own a partition of the new ordering
+  VectorXi owner = VectorXi::Constant(n,-1);
+  for(int k=0; k<nbNodes; ++k)
+  {
+    VERIFY(parent(k)==-1 || parent(k)>k);
+    VERIFY(start(k)<=sep(k) && sep(k)<=end(k));
+    if(parent(k)>=0)
+      VERIFY(start(parent(k))<=start(k) && end(k)<=sep(parent(k)));
+    for(int i=sep(k); i<end(k); ++i)
+    {
+      VERIFY(owner(i)==-1);
+      owner(i) = k;
+    }
+  }
+  VERIFY((owner.array()>=0).all());
+
+  // independent subtrees are not connected: an entry always links a node to one of its ancestors
+  PermutationType P = perm.inverse();
+  SparseMatrix<double> PAPt;
+  PAPt = A.twistedBy(P);
+  for(int j=0; j<n; ++j)
+    for(SparseMatrix<double>::InnerIterator it(PAPt,j); it; ++it)
+    {
+      int lo = (std::min)(owner(it.index()), owner(j)), hi = (std::max)(owner(it.index()), owner(j));
+      while(lo!=hi && lo>=0) lo = parent(lo);
+      VERIFY(lo==hi);
+    }
+}
+
+template<typename Solver> int factor_fill(const SparseMatrix<double>& A)
+{
+  Solver solver(A);
+  VERIFY(solver.info()==Success);
+  SparseMatrix<double> L = solver.matrixL();
+  return L.nonZeros();
+}
+
+void test_nested_dissection_structured()
+{
+  typedef SparseMatrix<double> SpMat;
+  typedef NestedDissectionOrdering<int>::PermutationType PermutationType;
+
+  // valid permutations, including disconnected graphs and the recursion down to tiny leaves
+  for(int leaf=1; leaf<=256; leaf *= 4)
+  {
+    SpMat A;
+    grid_laplacian<double>(internal::random<int>(3,12), internal::random<int>(3,12), internal::random<int>(1,6), internal::random<int>(1,3), A);
+    NestedDissectionOrdering<int> nd;
+    nd.setLeafSize(leaf);
+    PermutationType perm;
+    nd(A, perm);
+    VERIFY(internal::is_valid_permutation(perm.indices(), A.rows()));
+    check_separator_tree(nd, A, perm);
+
+    // the unsymmetric and the selfadjoint entry points agree
+    PermutationType perm2;
+    nd(A.selfadjointView<Lower>(), perm2);
+    VERIFY_IS_EQUAL(perm.indices(), perm2.indices());
+  }
+
+  // on meshes, the fill-in is lower than the one of the natural ordering, and close to the one of AMD
+  // (nested dissection only becomes better than AMD on 3D meshes larger than these ones, see bench/sparse_ordering.cpp)
+  SpMat A2d, A3d;
+  grid_laplacian<double>(60, 60, 1, 1, A2d);
+  grid_laplacian<double>(16, 16, 16, 1, A3d);
+  typedef SimplicialLLT<SpMat, Lower, NestedDissectionOrdering<int> > NDSolver;
+  typedef SimplicialLLT<SpMat, Lower, NaturalOrdering<int> > NaturalSolver;
+  int nd2d = factor_fill<NDSolver>(A2d);
+  int nd3d = factor_fill<NDSolver>(A3d);
+  VERIFY(nd2d < factor_fill<NaturalSolver>(A2d)/2);
+  VERIFY(nd3d < factor_fill<NaturalSolver>(A3d)/2);
+#ifndef EIGEN_MPL2_ONLY
+  typedef SimplicialLLT<SpMat, Lower, AMDOrdering<int> > AMDSolver;
+  VERIFY(nd2d < 1.3*factor_fill<AMDSolver>(A2d));
+  VERIFY(nd3d < 1.4*factor_fill<AMDSolver>(A3d));
+#endif
+
+  // solving with the ordering, and its separator tree once given to a parallel supernodal factorization
+  VectorXd b = VectorXd::Random(A3d.rows());
+  SupernodalLLT<SpMat, Lower, NestedDissectionOrdering<int> > llt;
+  llt.setParallelTreeSchedule(true);
+  llt.compute(A3d);
+  VERIFY(llt.info()==Success);
+  VERIFY_IS_APPROX(A3d*llt.solve(b), b);
+  SparseLU<SpMat, NestedDissectionOrdering<int> > lu(A3d);
+  VERIFY(lu.info()==Success);
+  VERIFY_IS_APPROX(A3d*lu.solve(b), b);
+}
+
+template<typename T> void test_nested_dissection_T()
+{
+  SimplicialLDLT<SparseMatrix<T>, Lower, NestedDissectionOrdering<int> > ldlt_colmajor_lower_nd;
+  SimplicialLLT<SparseMatrix<T>, Upper, NestedDissectionOrdering<int> > llt_colmajor_upper_nd;
+  SupernodalLLT<SparseMatrix<T>, Lower, NestedDissectionOrdering<int> > supernodal_llt_lower_nd;
+  SparseLU<SparseMatrix<T>, NestedDissectionOrdering<int> > sparselu_nd;
+
+  check_sparse_spd_solving(ldlt_colmajor_lower_nd);
+  check_sparse_spd_solving(llt_colmajor_upper_nd);
+  check_sparse_spd_solving(supernodal_llt_lower_nd);
+  check_sparse_square_solving(sparselu_nd);
+}
+
+void test_nested_dissection()
+{
+  CALL_SUBTEST_1(test_nested_dissection_T<double>());
+  CALL_SUBTEST_2(test_nested_dissection_T<std::complex<double> >());
+  CALL_SUBTEST_3(test_nested_dissection_structured());
+}
@@ -301,6 +301,23 @@ template<typename Scalar> void packetmath_notcomplex()
     ref[i] = data1[0]+Scalar(i);
   internal::pstore(data2, internal::plset(data1[0]));
   VERIFY(areApprox(ref, data2, PacketSize) && "internal::plset");
+
+  for (int i=0; i<PacketSize; i+=2)
+    data1[i+PacketSize] = data1[i];
+  Packet a = internal::pload<Packet>(data1);
+  Packet b = internal::pload<Packet>(data1+PacketSize);
+  for (int i=0; i<PacketSize; ++i)
+    ref[i] = data1[i]<data1[i+PacketSize] ? data1[i] : data1[i+PacketSize];
+  internal::pstore(data2, internal::pselect(internal::pcmp_lt(a,b), a, b));
+  VERIFY(areApprox(ref, data2, PacketSize) && "internal::pcmp_lt");
+  for (int i=0; i<PacketSize; ++i)
+    ref[i] = data1[i]<=data1[i+PacketSize] ? Scalar(1) : Scalar(2);
+  internal::pstore(data2, internal::pselect(internal::pcmp_le(a,b), internal::pset1<Packet>(Scalar(1)), internal::pset1<Packet>(Scalar(2))));
+  VERIFY(areApprox(ref, data2, PacketSize) && "internal::pcmp_le");
+  for (int i=0; i<PacketSize; ++i)
+    ref[i] = data1[i]==data1[i+PacketSize] ? Scalar(1) : Scalar(2);
+  internal::pstore(data2, internal::pselect(internal::pcmp_eq(a,b), internal::pset1<Packet>(Scalar(1)), internal::pset1<Packet>(Scalar(2))));
+  VERIFY(areApprox(ref, data2, PacketSize) && "internal::pcmp_eq");
 }
 
 template<typename Scalar,bool ConjLhs,bool ConjRhs> void test_conj_helper(Scalar* data1, Scalar* data2, Scalar* ref, Scalar* pval)
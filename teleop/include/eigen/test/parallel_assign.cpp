@@ -0,0 +1,87 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// small threshold so that the parallel path is also taken by small objects
+#define EIGEN_PARALLEL_ASSIGN_THRESHOLD 16
+#include "main.h"
+
+template<typename MatrixType> void parallel_assign(const MatrixType& m)
+{
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::Scalar Scalar;
+  const Index rows = m.rows(), cols = m.cols();
+  const Scalar s = internal::random<Scalar>();
+
+  MatrixType m1 = MatrixType::Random(rows,cols), m2 = MatrixType::Random(rows,cols), m3;
+  MatrixType ref = m1 * s + m2;
+
+  // assignment, with a resize of the destination
+  m3.parallel() = m1 * s + m2;
+  VERIFY_IS_EQUAL(m3.rows(), rows);
+  VERIFY_IS_EQUAL(m3.cols(), cols);
+  VERIFY_IS_APPROX(m3, ref);
+
+  // compound assignments
+  m3.parallel() += m1;
+  VERIFY_IS_APPROX(m3, ref + m1);
+  m3.parallel() -= m2 * s;
+  VERIFY_IS_APPROX(m3, ref + m1 - m2 * s);
+
+  // the destination itself may appear coefficient-wise in the source
+  m3 = ref;
+  m3.parallel() = m3 * s - m1;
+  VERIFY_IS_APPROX(m3, ref * s - m1);
+
+  // block and map destinations
+  if(rows>1 && cols>1)
+  {
+    const Index r = internal::random<Index>(0,rows-2), c = internal::random<Index>(0,cols-2);
+    const Index br = internal::random<Index>(1,rows-r), bc = internal::random<Index>(1,cols-c);
+    m3 = ref;
+    m3.block(r,c,br,bc).parallel() = m1.block(r,c,br,bc) - m2.block(r,c,br,bc);
+    MatrixType ref3 = ref;
+    ref3.block(r,c,br,bc) = m1.block(r,c,br,bc) - m2.block(r,c,br,bc);
+    VERIFY_IS_APPROX(m3, ref3);
+  }
+  m3 = ref;
+  Map<MatrixType> map(m3.data(), rows, cols);
+  map.parallel() += m1;
+  VERIFY_IS_APPROX(m3, ref + m1);
+}
+
+template<typename MatrixType> void parallel_assign_product(const MatrixType& m)
+{
+  typedef typename MatrixType::Index Index;
+  const Index rows = m.rows(), cols = m.cols();
+  MatrixType a = MatrixType::Random(rows,rows), b = MatrixType::Random(rows,cols), c = MatrixType::Random(rows,cols);
+
+  // products are evaluated before being assigned, even when they alias
+  MatrixType ref = a * b;
+  c.parallel() = a * b;
+  VERIFY_IS_APPROX(c, ref);
+  ref = c + a * c;
+  c.parallel() += a * c;
+  VERIFY_IS_APPROX(c, ref);
+}
+
+void test_parallel_assign()
+{
+  int threads = nbThreads();
+  setNbThreads(4);
+  for(int i = 0; i < g_repeat; i++) {
+    int r = internal::random<int>(1,300), c = internal::random<int>(1,300);
+    CALL_SUBTEST_1( parallel_assign(MatrixXd(r, c)) );
+    CALL_SUBTEST_1( parallel_assign(MatrixXd(r, internal::random<int>(1,3))) );
+    CALL_SUBTEST_1( parallel_assign(VectorXd(internal::random<int>(1,20000))) );
+    CALL_SUBTEST_2( parallel_assign(Matrix<float,Dynamic,Dynamic,RowMajor>(r, c)) );
+    CALL_SUBTEST_2( parallel_assign(RowVectorXf(internal::random<int>(1,20000))) );
+    CALL_SUBTEST_3( parallel_assign(ArrayXXcf(r, c)) );
+    CALL_SUBTEST_3( parallel_assign(Array<int,Dynamic,Dynamic>(internal::random<int>(1,3), c)) );
+    CALL_SUBTEST_4( parallel_assign_product(MatrixXd(internal::random<int>(1,100), internal::random<int>(1,100))) );
+  }
+  setNbThreads(threads);
+}
@@ -30,6 +30,32 @@ template<typename MatrixType> void qr(const MatrixType& m)
   VERIFY_IS_APPROX(a, qrOfA.householderQ() * r);
 }
 
+template<typename MatrixType> void qr_blocked()
+{
+  /* this test covers the look-ahead of the blocked HouseholderQR
+  */
+  typedef typename MatrixType::Index Index;
+  Index rows = internal::random<Index>(300,500);
+  Index cols = internal::random<Index>(256,rows);
+
+  MatrixType a = MatrixType::Random(rows,cols), b = MatrixType::Random(rows,2);
+  HouseholderQR<MatrixType> ref(a);
+
+  const int threads = nbThreads();
+  for(int t=1; t<=4; t*=4)
+  {
+    setNbThreads(t);
+    HouseholderQR<MatrixType> qr(a);
+    MatrixType r = qr.matrixQR().template triangularView<Upper>();
+    VERIFY_IS_APPROX(a, qr.householderQ() * r);
+    VERIFY_IS_APPROX(qr.matrixQR(), ref.matrixQR());
+    // least-squares solution
+    MatrixType x = qr.solve(b);
+    VERIFY_IS_APPROX(a.adjoint() * (a * x), a.adjoint() * b);
+  }
+  setNbThreads(threads);
+}
+
 template<typename MatrixType, int Cols2> void qr_fixedsize()
 {
   enum { Rows = MatrixType::RowsAtCompileTime, Cols = MatrixType::ColsAtCompileTime };
@@ -122,6 +148,9 @@ void test_qr()
   CALL_SUBTEST_7(qr_verify_assert<MatrixXcf>());
   CALL_SUBTEST_8(qr_verify_assert<MatrixXcd>());
 
+  CALL_SUBTEST_13(qr_blocked<MatrixXd>());
+  CALL_SUBTEST_13(qr_blocked<MatrixXcd>());
+
   // Test problem size constructors
   CALL_SUBTEST_12(HouseholderQR<MatrixXf>(10, 20));
 }
@@ -0,0 +1,77 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <Eigen/QR>
+
+template<typename MatrixType> void qr_tallskinny(typename MatrixType::Index blockRows)
+{
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+
+  Index cols = MatrixType::ColsAtCompileTime==Dynamic ? internal::random<Index>(1,20) : Index(MatrixType::ColsAtCompileTime);
+  Index rows = internal::random<Index>(cols,2000);
+
+  MatrixType a = MatrixType::Random(rows,cols);
+  DenseMatrix b = DenseMatrix::Random(rows,internal::random<Index>(1,3));
+
+  TallSkinnyQR<MatrixType> qr;
+  qr.setBlockRows(blockRows).compute(a);
+  VERIFY(qr.blockRows() >= cols);
+  VERIFY(qr.blocks() >= 1 && qr.blocks()*qr.blockRows() <= rows);
+
+  // R^* R = A^* A, and R matches the one of HouseholderQR up to the signs of its rows
+  DenseMatrix r = qr.matrixR();
+  VERIFY_IS_APPROX(r.adjoint() * r, a.adjoint() * a);
+  VERIFY(r.isUpperTriangular());
+  HouseholderQR<MatrixType> ref(a);
+  DenseMatrix refR = ref.matrixQR().topRows(cols).template triangularView<Upper>();
+  VERIFY_IS_APPROX(r.cwiseAbs(), refR.cwiseAbs());
+
+  // least-squares solution
+  DenseMatrix x = qr.solve(b);
+  VERIFY_IS_APPROX(x, ref.solve(b));
+  VERIFY_IS_APPROX(a.adjoint() * (a * x), a.adjoint() * b);
+
+  // a consistent system
+  DenseMatrix x0 = DenseMatrix::Random(cols, 2);
+  DenseMatrix b0 = a * x0;
+  VERIFY_IS_APPROX(qr.solve(b0), x0);
+
+  // the results do not depend on the number of threads
+  const int threads = nbThreads();
+  setNbThreads(4);
+  TallSkinnyQR<MatrixType> qr4;
+  qr4.setBlockRows(blockRows).compute(a);
+  VERIFY_IS_EQUAL(qr4.matrixR(), qr.matrixR());
+  VERIFY_IS_APPROX(qr4.solve(b), x);
+  setNbThreads(threads);
+}
+
+template<typename MatrixType> void qr_tallskinny_verify_assert()
+{
+  MatrixType tmp;
+
+  TallSkinnyQR<MatrixType> qr;
+  VERIFY_RAISES_ASSERT(qr.matrixR())
+  VERIFY_RAISES_ASSERT(qr.solve(tmp))
+  VERIFY_RAISES_ASSERT(qr.blocks())
+}
+
+void test_qr_tallskinny()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( qr_tallskinny<MatrixXd>(0) );
+    CALL_SUBTEST_1( qr_tallskinny<MatrixXd>(internal::random<int>(1,300)) );
+    CALL_SUBTEST_2( qr_tallskinny<MatrixXcf>(internal::random<int>(1,300)) );
+    CALL_SUBTEST_3(( qr_tallskinny<Matrix<double,Dynamic,4> >(internal::random<int>(1,300)) ));
+    CALL_SUBTEST_4(( qr_tallskinny<Matrix<float,Dynamic,Dynamic,RowMajor> >(internal::random<int>(1,300)) ));
+  }
+
+  CALL_SUBTEST_1( qr_tallskinny_verify_assert<MatrixXd>() );
+}
@@ -7,6 +7,8 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+// small threshold so that the parallel reductions are also tested on small vectors
+#define EIGEN_PARALLEL_REDUX_THRESHOLD 4096
 #include "main.h"
 
 template<typename MatrixType> void matrixRedux(const MatrixType& m)
@@ -137,6 +139,34 @@ template<typename VectorType> void vectorRedux(const VectorType& w)
   VERIFY_RAISES_ASSERT(v.head(0).maxCoeff());
 }
 
+template<typename VectorType> void largeVectorRedux(int size)
+{
+  typedef typename VectorType::Scalar Scalar;
+  typedef Matrix<double,Dynamic,1> VectorXd;
+  VectorType u = (VectorType::Random(size) + VectorType::Constant(size, Scalar(1))) / Scalar(2);
+  VectorType v = VectorType::Random(size);
+  const VectorXd ud = u.template cast<double>(), vd = v.template cast<double>();
+
+  // the pairwise summation keeps the rounding errors much smaller than size*epsilon
+  Scalar prec = Scalar(64) * NumTraits<Scalar>::epsilon();
+  VERIFY(std::abs(double(u.sum()) - ud.sum()) <= prec * ud.sum());
+  VERIFY(std::abs(double(u.squaredNorm()) - ud.squaredNorm()) <= prec * ud.squaredNorm());
+  VERIFY(std::abs(double(u.dot(v)) - ud.dot(vd)) <= prec * ud.cwiseProduct(vd).cwiseAbs().sum());
+  const int offset = internal::random<int>(1,3);
+  VERIFY(std::abs(double(u.tail(size-offset).sum()) - ud.tail(size-offset).sum()) <= prec * ud.sum());
+  VERIFY_IS_EQUAL(u.maxCoeff(), Scalar(ud.maxCoeff()));
+
+  // the result does not depend on the number of threads
+  int threads = nbThreads();
+  setNbThreads(1);
+  Scalar sum1 = u.sum(), dot1 = u.dot(v), min1 = v.minCoeff();
+  setNbThreads(4);
+  VERIFY_IS_EQUAL(u.sum(), sum1);
+  VERIFY_IS_EQUAL(u.dot(v), dot1);
+  VERIFY_IS_EQUAL(v.minCoeff(), min1);
+  setNbThreads(threads);
+}
+
 void test_redux()
 {
   // the max size cannot be too large, otherwise reduxion operations obviously generate large errors.
@@ -164,4 +194,8 @@ void test_redux()
     CALL_SUBTEST_8( vectorRedux(VectorXf(internal::random<int>(1,maxsize))) );
     CALL_SUBTEST_8( vectorRedux(ArrayXf(internal::random<int>(1,maxsize))) );
   }
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_9( largeVectorRedux<VectorXf>(internal::random<int>(1000,1000000)) );
+    CALL_SUBTEST_9( largeVectorRedux<VectorXd>(internal::random<int>(1000,100000)) );
+  }
 }
@@ -9,6 +9,84 @@
 
 #include "sparse_solver.h"
 
+template<typename Solver> bool is_simplicial_llt(const Solver&) { return false; }
+template<typename MatrixType, int UpLo, typename Ordering>
+bool is_simplicial_llt(const SimplicialLLT<MatrixType,UpLo,Ordering>&) { return true; }
+
+template<typename Solver> void check_simplicial_rank_update(Solver& solver)
+{
+  typedef typename Solver::MatrixType Mat;
+  typedef typename Mat::Scalar Scalar;
+  typedef typename Mat::RealScalar RealScalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  typedef Matrix<Scalar,Dynamic,1> DenseVector;
+
+  for (int i = 0; i < g_repeat; i++) {
+    Mat A, halfA;
+    DenseMatrix dA;
+    int size = generate_sparse_spd_problem(solver, A, halfA, dA, 100);
+    int rank = internal::random<int>(1,4);
+    Mat W(size, rank);
+    DenseMatrix dW(size, rank);
+    initSparse<Scalar>((std::max)(4./size, 0.05), dW, W);
+    DenseVector b = DenseVector::Random(size);
+    RealScalar sigma = internal::random<RealScalar>(0.5,2);
+
+    // update, which generally introduces new nonzeros in L
+    solver.compute(halfA);
+    VERIFY(solver.info() == Success);
+    solver.rankUpdate(W, sigma);
+    VERIFY(solver.info() == Success);
+    DenseMatrix dA2 = dA + sigma * dW * dW.adjoint();
+    DenseVector x = solver.solve(b);
+    VERIFY_IS_APPROX(dA2 * x, b);
+    if(size <= 30)
+      VERIFY_IS_APPROX(solver.determinant(), dA2.determinant());
+
+    // downdate back to A, with a dense w
+    solver.rankUpdate(dW, -sigma);
+    VERIFY(solver.info() == Success);
+    x = solver.solve(b);
+    VERIFY_IS_APPROX(dA * x, b);
+
+    // a new decomposition of A forgets the fill-in of the previous updates, and
+    // rank-1 updates applied one at a time match the rank-k update
+    solver.compute(halfA);
+    VERIFY(solver.info() == Success);
+    Mat A2 = A;
+    A2 += sigma * (W * W.adjoint());
+    for(int k = 0; k < rank; ++k)
+      solver.rankUpdate(dW.col(k), sigma);
+    VERIFY(solver.info() == Success);
+    x = solver.solve(b);
+    VERIFY_IS_APPROX(dA2 * x, b);
+
+    // a new symbolic decomposition is required after fill-in
+    solver.analyzePattern(A2);
+    solver.factorize(A2);
+    VERIFY(solver.info() == Success);
+    x = solver.solve(b);
+    VERIFY_IS_APPROX(dA2 * x, b);
+
+    // downdating to a matrix which is not positive definite fails for LLT, while the LDLT
+    // factorizations of such an indefinite, but nonsingular, matrix remain valid
+    if(!NumTraits<Scalar>::IsComplex)
+    {
+      DenseMatrix e = DenseMatrix::Zero(size, 1);
+      e(0,0) = Scalar(2 * sqrt(numext::real(dA2(0,0))));
+      solver.rankUpdate(e, -1);
+      if(is_simplicial_llt(solver))
+        VERIFY(solver.info() == NumericalIssue);
+      else
+      {
+        VERIFY(solver.info() == Success);
+        x = solver.solve(b);
+        VERIFY_IS_APPROX((dA2 - e * e.adjoint()) * x, b);
+      }
+    }
+  }
+}
+
 template<typename T> void test_simplicial_cholesky_T()
 {
   SimplicialCholesky<SparseMatrix<T>, Lower> chol_colmajor_lower_amd;
@@ -36,6 +114,17 @@ template<typename T> void test_simplicial_cholesky_T()
   
   check_sparse_spd_solving(ldlt_colmajor_lower_nat);
   check_sparse_spd_solving(ldlt_colmajor_upper_nat);
+
+  check_sparse_spd_symbolic_io(chol_colmajor_lower_amd);
+  check_sparse_spd_symbolic_io(llt_colmajor_upper_amd);
+  check_sparse_spd_symbolic_io(ldlt_colmajor_lower_amd);
+  check_sparse_spd_symbolic_io(ldlt_colmajor_upper_nat);
+
+  check_simplicial_rank_update(llt_colmajor_lower_amd);
+  check_simplicial_rank_update(llt_colmajor_upper_amd);
+  check_simplicial_rank_update(ldlt_colmajor_lower_amd);
+  check_simplicial_rank_update(ldlt_colmajor_upper_nat);
+  check_simplicial_rank_update(chol_colmajor_lower_amd);
 }
 
 void test_simplicial_cholesky()
@@ -10,6 +10,160 @@
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
 #include "sparse.h"
+#include <list>
+
+template<typename Scalar> struct keep_last_op
+{
+  Scalar operator()(const Scalar&, const Scalar& b) const { return b; }
+};
+
+// checks the structure of a matrix assembled from triplets, the duplicate functor, the reuse of the pattern,
+// and the assembly from a list which is not random access
+template<typename SparseMatrixType, typename TripletType>
+void check_triplets_assembly(const SparseMatrixType& m, const std::vector<TripletType>& triplets)
+{
+  typedef typename SparseMatrixType::Scalar Scalar;
+  typedef typename SparseMatrixType::Index Index;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  const Index rows = m.rows(), cols = m.cols();
+
+  // compressed, sorted, without duplicates
+  VERIFY(m.isCompressed());
+  Matrix<int,Dynamic,Dynamic> entries = Matrix<int,Dynamic,Dynamic>::Zero(rows,cols);
+  for(std::size_t k=0; k<triplets.size(); ++k)
+    entries(triplets[k].row(), triplets[k].col()) = 1;
+  VERIFY_IS_EQUAL(Index(m.nonZeros()), Index(entries.sum()));
+  for(Index j=0; j<m.outerSize(); ++j)
+    for(Index k=m.outerIndexPtr()[j]+1; k<m.outerIndexPtr()[j+1]; ++k)
+      VERIFY(m.innerIndexPtr()[k-1] < m.innerIndexPtr()[k]);
+
+  // duplicate functor
+  DenseMatrix refLast = DenseMatrix::Zero(rows,cols);
+  for(std::size_t k=0; k<triplets.size(); ++k)
+    refLast(triplets[k].row(), triplets[k].col()) = triplets[k].value();
+  SparseMatrixType m2(rows,cols);
+  m2.setFromTriplets(triplets.begin(), triplets.end(), keep_last_op<Scalar>());
+  VERIFY_IS_APPROX(m2, refLast);
+  VERIFY_IS_EQUAL(m2.nonZeros(), m.nonZeros());
+
+  // reuse of the pattern with new values, a subset of the entries and in another order
+  std::vector<TripletType> triplets2;
+  DenseMatrix refMat2 = DenseMatrix::Zero(rows,cols);
+  for(std::size_t k=0; k<triplets.size(); ++k)
+  {
+    if(internal::random<int>(0,3)==0)
+      continue;
+    Scalar v = internal::random<Scalar>();
+    triplets2.push_back(TripletType(triplets[k].row(), triplets[k].col(), v));
+    refMat2(triplets[k].row(), triplets[k].col()) += v;
+  }
+  std::reverse(triplets2.begin(), triplets2.end());
+  m2 = m;
+  m2.setValuesFromTriplets(triplets2.begin(), triplets2.end());
+  VERIFY_IS_APPROX(m2, refMat2);
+  VERIFY_IS_EQUAL(m2.nonZeros(), m.nonZeros());
+  VERIFY(std::equal(m2.innerIndexPtr(), m2.innerIndexPtr()+m2.nonZeros(), m.innerIndexPtr()));
+  DenseMatrix refLast2 = DenseMatrix::Zero(rows,cols);
+  for(std::size_t k=0; k<triplets2.size(); ++k)
+    refLast2(triplets2[k].row(), triplets2[k].col()) = triplets2[k].value();
+  m2.setValuesFromTriplets(triplets2.begin(), triplets2.end(), keep_last_op<Scalar>());
+  VERIFY_IS_APPROX(m2, refLast2);
+
+  // input iterators which are not random access
+  std::list<TripletType> list(triplets.begin(), triplets.end());
+  m2.setFromTriplets(list.begin(), list.end());
+  VERIFY_IS_APPROX(m2, m);
+  m2.setValuesFromTriplets(list.begin(), list.end(), keep_last_op<Scalar>());
+  VERIFY_IS_APPROX(m2, refLast);
+}
+
+// compares the compressed arrays of two matrices, without converting them to dense matrices
+template<typename SparseMatrixType> bool same_compressed_matrices(const SparseMatrixType& a, const SparseMatrixType& b)
+{
+  typedef typename SparseMatrixType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,1> DenseVector;
+  return a.isCompressed() && b.isCompressed() && a.nonZeros()==b.nonZeros()
+      && std::equal(a.outerIndexPtr(), a.outerIndexPtr()+a.outerSize()+1, b.outerIndexPtr())
+      && std::equal(a.innerIndexPtr(), a.innerIndexPtr()+a.nonZeros(), b.innerIndexPtr())
+      && Map<const DenseVector>(a.valuePtr(), a.nonZeros()).isApprox(Map<const DenseVector>(b.valuePtr(), b.nonZeros()));
+}
+
+// large assembly, on several threads when OpenMP is enabled
+template<typename SparseMatrixType> void sparse_triplets_parallel(typename SparseMatrixType::Index size)
+{
+  typedef typename SparseMatrixType::Scalar Scalar;
+  typedef typename SparseMatrixType::Index Index;
+  typedef Triplet<Scalar,Index> TripletType;
+  std::vector<TripletType> triplets;
+  SparseMatrixType ref(size,size);
+  for(int k=0; k<20*size; ++k)
+    triplets.push_back(TripletType(internal::random<Index>(0,size-1), internal::random<Index>(0,size-1), internal::random<Scalar>()));
+  // reference assembled sequentially
+  std::list<TripletType> list(triplets.begin(), triplets.end());
+  ref.setFromTriplets(list.begin(), list.end());
+
+  int threads = nbThreads();
+  setNbThreads(4);
+  SparseMatrixType m(size,size);
+  m.setFromTriplets(triplets.begin(), triplets.end());
+  VERIFY(same_compressed_matrices(m, ref));
+
+  SparseMatrixType ref2(size,size), m2 = m;
+  ref2.setFromTriplets(list.begin(), list.end(), keep_last_op<Scalar>());
+  m2.setFromTriplets(triplets.begin(), triplets.end(), keep_last_op<Scalar>());
+  VERIFY(same_compressed_matrices(m2, ref2));
+  m2 = m;
+  m2.setValuesFromTriplets(triplets.begin(), triplets.end(), keep_last_op<Scalar>());
+  VERIFY(same_compressed_matrices(m2, ref2));
+  m2.setValuesFromTriplets(triplets.begin(), triplets.end());
+  VERIFY(same_compressed_matrices(m2, ref));
+  setNbThreads(threads);
+}
+
+// large storage order conversions, on several threads when OpenMP is enabled, and by blocks of inner vectors
+template<typename SparseMatrixType> void sparse_transpose_parallel(typename SparseMatrixType::Index size)
+{
+  typedef typename SparseMatrixType::Scalar Scalar;
+  typedef typename SparseMatrixType::Index Index;
+  typedef typename SparseMatrixType::OuterIndex OuterIndex;
+  typedef SparseMatrix<Scalar,SparseMatrixType::IsRowMajor ? ColMajor : RowMajor,Index,OuterIndex> OtherOrderType;
+  typedef Triplet<Scalar,Index> TripletType;
+  std::vector<TripletType> triplets;
+  for(int k=0; k<40*size; ++k)
+    triplets.push_back(TripletType(internal::random<Index>(0,size-1), internal::random<Index>(0,size/2), internal::random<Scalar>()));
+  SparseMatrixType m(size,size/2+1);
+  m.setFromTriplets(triplets.begin(), triplets.end());
+  OtherOrderType ref(size,size/2+1);
+  ref.setFromTriplets(triplets.begin(), triplets.end());
+
+  int threads = nbThreads();
+  std::ptrdiff_t l1 = l1CacheSize(), l2 = l2CacheSize();
+  for(int k=0; k<2; ++k)
+  {
+    // small caches, such that the inner vectors are filled by buckets
+    if(k==1)
+      setCpuCacheSizes(l1, 64*1024);
+    setNbThreads(1);
+    OtherOrderType m1(m);
+    VERIFY(same_compressed_matrices(m1, ref));
+    setNbThreads(4);
+    OtherOrderType m2(m);
+    VERIFY(same_compressed_matrices(m2, ref));
+    m1 = m2.transpose();
+    VERIFY(same_compressed_matrices(m1, OtherOrderType(ref.transpose())));
+    // from a non compressed matrix
+    SparseMatrixType m3(m);
+    m3.uncompress();
+    m3.coeffRef(0,0) += Scalar(1);
+    m2 = m3;
+    m1 = ref;
+    m1.coeffRef(0,0) += Scalar(1);
+    m1.makeCompressed();
+    VERIFY(same_compressed_matrices(m2, m1));
+  }
+  setCpuCacheSizes(l1, l2);
+  setNbThreads(threads);
+}
 
 template<typename SparseMatrixType> void sparse_basic(const SparseMatrixType& ref)
 {
@@ -431,6 +585,7 @@ template<typename SparseMatrixType> void sparse_basic(const SparseMatrixType& re
     SparseMatrixType m(rows,cols);
     m.setFromTriplets(triplets.begin(), triplets.end());
     VERIFY_IS_APPROX(m, refMat);
+    check_triplets_assembly(m, triplets);
   }
 
   // test triangularView
@@ -561,6 +716,14 @@ void test_sparse_basic()
     CALL_SUBTEST_1(( sparse_basic(SparseMatrix<double,RowMajor,long int>(s, s)) ));
     
     CALL_SUBTEST_1(( sparse_basic(SparseMatrix<double,ColMajor,short int>(short(s), short(s))) ));
+    CALL_SUBTEST_3(( sparse_triplets_parallel<SparseMatrix<double> >(20000) ));
+    CALL_SUBTEST_3(( sparse_triplets_parallel<SparseMatrix<std::complex<float>,RowMajor,long int> >(5000) ));
+    CALL_SUBTEST_3(( sparse_triplets_parallel<SparseMatrix<double,ColMajor,int,long int> >(20000) ));
     CALL_SUBTEST_1(( sparse_basic(SparseMatrix<double,RowMajor,short int>(short(s), short(s))) ));
+    CALL_SUBTEST_1(( sparse_basic(SparseMatrix<double,ColMajor,int,long int>(s, s)) ));
+    CALL_SUBTEST_1(( sparse_basic(SparseMatrix<double,RowMajor,short int,int>(short(s), short(s))) ));
+    CALL_SUBTEST_4(( sparse_transpose_parallel<SparseMatrix<double> >(20000) ));
+    CALL_SUBTEST_4(( sparse_transpose_parallel<SparseMatrix<std::complex<double>,RowMajor,long int> >(20000) ));
+    CALL_SUBTEST_4(( sparse_transpose_parallel<SparseMatrix<float,ColMajor,int,long int> >(20000) ));
   }
 }
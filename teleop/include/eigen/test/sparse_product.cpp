@@ -213,10 +213,128 @@ template<typename SparseMatrixType> void sparse_product()
     // sparse * sparse selfadjointview
     VERIFY_IS_APPROX(mSres = mS * mLo.template selfadjointView<Lower>(),
                      refX = refS * refLo.template selfadjointView<Lower>());
+
+    // rank updates, computing only one triangular part
+    DenseMatrix refMat2 = DenseMatrix::Zero(rows, depth);
+    SparseMatrixType m2(rows, depth);
+    initSparse<Scalar>(density, refMat2, m2);
+    SparseMatrixType mN(depth, depth);
+    mN.template selfadjointView<Lower>().rankUpdate(m2.adjoint());
+    DenseMatrix refN = refMat2.adjoint() * refMat2, refTri = refN.template triangularView<Lower>();
+    VERIFY_IS_APPROX(DenseMatrix(mN), refTri);
+    mSres = mLo;
+    mSres.template selfadjointView<Lower>().rankUpdate(mS, s1);
+    refTri = (refLo + s1 * refS * refS.adjoint()).template triangularView<Lower>();
+    VERIFY_IS_APPROX(DenseMatrix(mSres), refTri);
+    mSres = mUp;
+    mSres.template selfadjointView<Upper>().rankUpdate(m2, s1);
+    refTri = (refUp + s1 * refMat2 * refMat2.adjoint()).template triangularView<Upper>();
+    VERIFY_IS_APPROX(DenseMatrix(mSres), refTri);
   }
   
 }
 
+// Large products with an irregular pattern, which are split over several threads when OpenMP is enabled
+template<typename Scalar> void sparse_dense_product_large()
+{
+  typedef SparseMatrix<Scalar,RowMajor> RowSpMat;
+  typedef SparseMatrix<Scalar,ColMajor> ColSpMat;
+  typedef typename RowSpMat::Index Index;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  typedef Matrix<Scalar,Dynamic,Dynamic,RowMajor> RowDenseMatrix;
+  typedef Matrix<Scalar,Dynamic,1> DenseVector;
+
+  const Index rows = internal::random<Index>(2000,4000);
+  const Index cols = internal::random<Index>(1000,3000);
+  std::vector<Triplet<Scalar> > triplets;
+  for(Index i=0; i<rows; ++i)
+  {
+    // a few dense rows unbalance a uniform splitting of the rows
+    Index nnz = (i%97==0) ? cols/2 : internal::random<Index>(0,30);
+    for(Index k=0; k<nnz; ++k)
+      triplets.push_back(Triplet<Scalar>(i, internal::random<Index>(0,cols-1), internal::random<Scalar>()));
+  }
+  RowSpMat rm(rows,cols);
+  rm.setFromTriplets(triplets.begin(), triplets.end());
+  // the products by column-major matrices are sequential, and serve as reference
+  ColSpMat cm(rm);
+
+  DenseVector x = DenseVector::Random(cols), y = DenseVector::Random(rows), res(rows);
+  DenseMatrix X = DenseMatrix::Random(cols,3), Res(rows,3);
+  RowDenseMatrix Xr = X;
+
+  VERIFY_IS_APPROX(res = rm*x, cm*x);
+  VERIFY_IS_APPROX(Res = rm*X, cm*X);
+  VERIFY_IS_APPROX(Res = rm*Xr, cm*X);
+  VERIFY_IS_APPROX(x = cm.transpose()*y, rm.transpose()*y);
+  VERIFY_IS_APPROX(x.transpose() = y.transpose()*cm, (rm.transpose()*y).transpose());
+  MappedSparseMatrix<Scalar,RowMajor> mapped(rows, cols, rm.nonZeros(), rm.outerIndexPtr(), rm.innerIndexPtr(), rm.valuePtr());
+  VERIFY_IS_APPROX(res = mapped*x, cm*x);
+
+  // the rows are computed independently, hence the result does not depend on the number of threads
+  int threads = nbThreads();
+  setNbThreads(1);
+  DenseVector seq = rm*x;
+  DenseMatrix Seq = rm*X, SeqR = rm*Xr;
+  setNbThreads(threads);
+  VERIFY_IS_EQUAL(res = rm*x, seq);
+  VERIFY_IS_EQUAL(Res = rm*X, Seq);
+  VERIFY_IS_EQUAL(Res = rm*Xr, SeqR);
+}
+
+// Large sparse * sparse products, whose columns are split over several threads when OpenMP is enabled
+template<typename Scalar> void sparse_sparse_product_large()
+{
+  typedef SparseMatrix<Scalar,ColMajor> SpMat;
+  typedef SparseMatrix<Scalar,RowMajor> RowSpMat;
+  typedef typename SpMat::Index Index;
+
+  const Index rows = internal::random<Index>(2000,4000);
+  const Index cols = internal::random<Index>(500,1500);
+  std::vector<Triplet<Scalar> > triplets;
+  for(Index i=0; i<rows; ++i)
+  {
+    // a few dense rows make the columns of J^* J irregular
+    Index nnz = (i%131==0) ? cols/3 : internal::random<Index>(1,8);
+    for(Index k=0; k<nnz; ++k)
+      triplets.push_back(Triplet<Scalar>(i, internal::random<Index>(0,cols-1), internal::random<Scalar>()));
+  }
+  SpMat J(rows,cols);
+  J.setFromTriplets(triplets.begin(), triplets.end());
+  RowSpMat Jr(J);
+
+  SpMat N = J.adjoint() * J, N2;
+  RowSpMat Nr = Jr.adjoint() * Jr;
+  VERIFY_IS_APPROX(SpMat(Nr), N);
+  // the columns of the result are sorted
+  for(Index j=0; j<N.outerSize(); ++j)
+    for(Index p=N.outerIndexPtr()[j]+1; p<N.outerIndexPtr()[j+1]; ++p)
+      VERIFY(N.innerIndexPtr()[p-1] < N.innerIndexPtr()[p]);
+
+  // normal equations, with symmetry
+  SpMat L(cols,cols), U(cols,cols);
+  RowSpMat Lr(cols,cols);
+  L.template selfadjointView<Lower>().rankUpdate(J.adjoint());
+  U.template selfadjointView<Upper>().rankUpdate(J.adjoint());
+  Lr.template selfadjointView<Lower>().rankUpdate(Jr.adjoint());
+  N2 = N.template triangularView<Lower>();
+  VERIFY_IS_APPROX(L, N2);
+  VERIFY_IS_APPROX(SpMat(Lr), N2);
+  N2 = N.template triangularView<Upper>();
+  VERIFY_IS_APPROX(U, N2);
+
+  // the columns are computed independently, hence the result does not depend on the number of threads
+  int threads = nbThreads();
+  setNbThreads(1);
+  SpMat seq = J * J.adjoint(), seqL(cols,cols);
+  seqL.template selfadjointView<Lower>().rankUpdate(J.adjoint());
+  setNbThreads(threads);
+  SpMat par = J * J.adjoint();
+  VERIFY_IS_EQUAL(par.nonZeros(), seq.nonZeros());
+  VERIFY((par - seq).norm() == 0);
+  VERIFY((L - seqL).norm() == 0);
+}
+
 // New test for Bug in SparseTimeDenseProduct
 template<typename SparseMatrixType, typename DenseMatrixType> void sparse_product_regression_test()
 {
@@ -248,5 +366,9 @@ void test_sparse_product()
     CALL_SUBTEST_2( (sparse_product<SparseMatrix<std::complex<double>, RowMajor > >()) );
     CALL_SUBTEST_3( (sparse_product<SparseMatrix<float,ColMajor,long int> >()) );
     CALL_SUBTEST_4( (sparse_product_regression_test<SparseMatrix<double,RowMajor>, Matrix<double, Dynamic, Dynamic, RowMajor> >()) );
+    CALL_SUBTEST_5( (sparse_dense_product_large<double>()) );
+    CALL_SUBTEST_5( (sparse_dense_product_large<float>()) );
+    CALL_SUBTEST_5( (sparse_sparse_product_large<double>()) );
+    CALL_SUBTEST_5( (sparse_sparse_product_large<std::complex<double> >()) );
   }
 }
@@ -9,6 +9,7 @@
 
 #include "sparse.h"
 #include <Eigen/SparseCore>
+#include <sstream>
 
 template<typename Solver, typename Rhs, typename DenseMat, typename DenseRhs>
 void check_sparse_solving(Solver& solver, const typename Solver::MatrixType& A, const Rhs& b, const DenseMat& dA, const DenseRhs& db)
@@ -393,3 +394,110 @@ template<typename Solver> void check_sparse_square_abs_determinant(Solver& solve
   }
 }
 
+
+struct prune_entry {
+  int m_row, m_col;
+  prune_entry(int row, int col) : m_row(row), m_col(col) {}
+  template<class Scalar>
+  bool operator()(int row, int col, const Scalar&) const {
+    return row != m_row || col != m_col;
+  }
+};
+
+template<typename Solver, typename Rhs>
+void check_sparse_symbolic_io(Solver& solver, const typename Solver::MatrixType& A, const Rhs& b)
+{
+  typedef typename Solver::MatrixType Mat;
+  typedef typename Mat::Scalar Scalar;
+
+  std::stringstream stream;
+  solver.analyzePattern(A);
+  VERIFY(solver.saveSymbolic(stream));
+  const std::string data = stream.str();
+
+  // a loaded symbolic decomposition yields the very same factorization
+  {
+    Solver loaded;
+    std::stringstream in(data);
+    VERIFY(loaded.loadSymbolic(in, A));
+    solver.factorize(A);
+    loaded.factorize(A);
+    VERIFY(loaded.info()==solver.info());
+    if(solver.info()==Success)
+    {
+      Rhs x = solver.solve(b), y = loaded.solve(b);
+      VERIFY_IS_EQUAL(y, x);
+    }
+  }
+
+  // the numerical values do not matter
+  {
+    Mat A2 = A;
+    A2 *= Scalar(2);
+    Solver loaded;
+    std::stringstream in(data);
+    VERIFY(loaded.loadSymbolic(in, A2));
+  }
+
+  // a different pattern is rejected
+  for(int j=A.outerSize()-1; j>=0; --j)
+  {
+    typename Mat::InnerIterator it(A,j);
+    if(it && it.row()!=it.col())
+    {
+      Mat A2 = A;
+      A2.prune(prune_entry(it.row(),it.col()));
+      Solver loaded;
+      std::stringstream in(data);
+      VERIFY(!loaded.loadSymbolic(in, A2));
+      break;
+    }
+  }
+
+  // corrupted and truncated streams are rejected
+  {
+    std::string corrupted = data;
+    corrupted[corrupted.size()-9] ^= 1; // the last byte before the checksum
+    Solver loaded;
+    std::stringstream in(corrupted);
+    VERIFY(!loaded.loadSymbolic(in, A));
+  }
+  {
+    Solver loaded;
+    std::stringstream in(data.substr(0, data.size()-1));
+    VERIFY(!loaded.loadSymbolic(in, A));
+  }
+}
+
+template<typename Solver> void check_sparse_spd_symbolic_io(Solver& solver)
+{
+  typedef typename Solver::MatrixType Mat;
+  typedef typename Mat::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,1> DenseVector;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+
+  for (int i = 0; i < g_repeat; i++) {
+    Mat A, halfA;
+    DenseMatrix dA;
+    int size = generate_sparse_spd_problem(solver, A, halfA, dA);
+    DenseVector b = DenseVector::Random(size);
+    check_sparse_symbolic_io(solver, A, b);
+  }
+}
+
+template<typename Solver> void check_sparse_square_symbolic_io(Solver& solver)
+{
+  typedef typename Solver::MatrixType Mat;
+  typedef typename Mat::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,1> DenseVector;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+
+  for (int i = 0; i < g_repeat; i++) {
+    Mat A;
+    DenseMatrix dA;
+    int size = generate_sparse_square_problem(solver, A, dA);
+    A.makeCompressed();
+    DenseVector b = DenseVector::Random(size);
+    check_sparse_symbolic_io(solver, A, b);
+  }
+}
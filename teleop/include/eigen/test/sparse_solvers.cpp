@@ -7,6 +7,8 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+// solve all the levels in parallel
+#define EIGEN_PARALLEL_TRSV_THRESHOLD 1
 #include "sparse.h"
 
 template<typename Scalar> void
@@ -101,6 +103,93 @@ template<typename Scalar> void sparse_solvers(int rows, int cols)
   }
 }
 
+template<typename SparseMatrixType, int Mode, typename DenseMatrix>
+void check_sparse_triangular_solver(const SparseMatrixType& m, const DenseMatrix& refMat)
+{
+  typedef typename DenseMatrix::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic,RowMajor> RowDenseMatrix;
+  const int rows = refMat.rows();
+  DenseMatrix b = DenseMatrix::Random(rows, internal::random<int>(1,4));
+  SparseTriangularSolver<SparseMatrixType,Mode> solver(m);
+  VERIFY_IS_EQUAL(solver.rows(), rows);
+  VERIFY_IS_APPROX(solver.solve(m, b), refMat.template triangularView<Mode>().solve(b));
+  RowDenseMatrix x = b;
+  solver.solveInPlace(m, x);
+  VERIFY_IS_APPROX(DenseMatrix(x), refMat.template triangularView<Mode>().solve(b));
+  // new values, same pattern
+  SparseMatrixType m2 = m;
+  solver.analyzePattern(m2);
+  for(int j=0; j<m2.outerSize(); ++j)
+    for(typename SparseMatrixType::InnerIterator it(m2, j); it; ++it)
+      it.valueRef() *= Scalar(0.5);
+  VERIFY_IS_APPROX(solver.solve(m2, b.col(0)), DenseMatrix(refMat * Scalar(0.5)).template triangularView<Mode>().solve(b.col(0)));
+}
+
+template<typename Scalar, int Options> void sparse_triangular_solver(int size)
+{
+  typedef SparseMatrix<Scalar,Options> SparseMatrixType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  double density = (std::max)(8./(size*size), 0.01);
+  SparseMatrixType m(size, size);
+  DenseMatrix refMat = DenseMatrix::Zero(size, size);
+
+  initSparse<Scalar>(density, refMat, m, ForceNonZeroDiag|MakeLowerTriangular);
+  check_sparse_triangular_solver<SparseMatrixType,Lower>(m, refMat);
+  check_sparse_triangular_solver<SparseMatrixType,UnitLower>(m, refMat);
+  initSparse<Scalar>(density, refMat, m, ForceNonZeroDiag|MakeUpperTriangular);
+  check_sparse_triangular_solver<SparseMatrixType,Upper>(m, refMat);
+  check_sparse_triangular_solver<SparseMatrixType,UnitUpper>(m, refMat);
+
+  // the other triangular part is ignored
+  initSparse<Scalar>(density, refMat, m, ForceNonZeroDiag);
+  check_sparse_triangular_solver<SparseMatrixType,Lower>(m, refMat);
+  check_sparse_triangular_solver<SparseMatrixType,Upper>(m, refMat);
+
+  // a diagonal matrix has a single level
+  {
+    SparseMatrixType d(size, size);
+    d.setIdentity();
+    SparseTriangularSolver<SparseMatrixType,Lower> solver(d);
+    VERIFY_IS_EQUAL(solver.levels(), 1);
+    VERIFY_IS_EQUAL(solver.supernodes(), 0);
+  }
+
+  // supernodes: two dense diagonal blocks, the rows of the second one sharing a few more columns
+  {
+    const int n = size + 40;
+    DenseMatrix refL = DenseMatrix::Zero(n, n);
+    for(int j=0; j<n; ++j)
+      refL(j,j) = internal::random<Scalar>() + Scalar(2);
+    for(int k=0; k<2; ++k)
+    {
+      const int first = k==0 ? 0 : size + 20;
+      for(int r=first; r<first+20; ++r)
+      {
+        for(int c=first; c<r; ++c)
+          refL(r,c) = internal::random<Scalar>();
+        if(k==1)
+          for(int c=0; c<size; c+=3)
+            refL(r,c) = internal::random<Scalar>();
+      }
+    }
+    for(int r=20; r<size+20; ++r)
+      if(internal::random<int>(0,3)==0)
+        refL(r,internal::random<int>(0,r-1)) = internal::random<Scalar>();
+    SparseMatrixType L = refL.sparseView();
+    SparseTriangularSolver<SparseMatrixType,Lower> solver(L);
+    VERIFY(solver.supernodes()>=2);
+    check_sparse_triangular_solver<SparseMatrixType,Lower>(L, refL);
+    check_sparse_triangular_solver<SparseMatrixType,UnitLower>(L, refL);
+    // same supernodes, solved backward
+    DenseMatrix refU = refL.reverse();
+    SparseMatrixType U = refU.sparseView();
+    SparseTriangularSolver<SparseMatrixType,Upper> upperSolver(U);
+    VERIFY(upperSolver.supernodes()>=2);
+    check_sparse_triangular_solver<SparseMatrixType,Upper>(U, refU);
+    check_sparse_triangular_solver<SparseMatrixType,UnitUpper>(U, refU);
+  }
+}
+
 void test_sparse_solvers()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -108,5 +197,12 @@ void test_sparse_solvers()
     int s = internal::random<int>(1,300);
     CALL_SUBTEST_2(sparse_solvers<std::complex<double> >(s,s) );
     CALL_SUBTEST_1(sparse_solvers<double>(s,s) );
+    CALL_SUBTEST_3(( sparse_triangular_solver<double,ColMajor>(s) ));
+    CALL_SUBTEST_3(( sparse_triangular_solver<double,RowMajor>(s) ));
+    CALL_SUBTEST_4(( sparse_triangular_solver<std::complex<double>,ColMajor>(s) ));
   }
+  // the levels are solved by several threads
+  CALL_SUBTEST_3( setNbThreads(4) );
+  CALL_SUBTEST_3(( sparse_triangular_solver<double,ColMajor>(internal::random<int>(100,300)) ));
+  CALL_SUBTEST_3(( sparse_triangular_solver<double,RowMajor>(internal::random<int>(100,300)) ));
 }
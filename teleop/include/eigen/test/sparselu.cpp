@@ -50,6 +50,53 @@ template<typename T> void test_sparselu_T()
   
   check_sparse_square_determinant(sparselu_colamd);
   check_sparse_square_determinant(sparselu_amd);
+  
+  check_sparse_square_symbolic_io(sparselu_colamd);
+  check_sparse_square_symbolic_io(sparselu_natural);
+}
+
+// The supernodal updates are split over the threads, this must not change the factors
+template<typename T> void test_sparselu_threads()
+{
+  typedef SparseMatrix<T,ColMajor> SpMat;
+  typedef Matrix<T,Dynamic,1> DenseVector;
+  // nonsymmetric 3D convection-diffusion problem, whose factors have large supernodes
+  const int n = internal::random<int>(12,16);
+  const int size = n*n*n;
+  std::vector<Triplet<T> > triplets;
+  for(int k=0; k<n; ++k)
+    for(int j=0; j<n; ++j)
+      for(int i=0; i<n; ++i)
+      {
+        int id = i + n*(j + n*k);
+        triplets.push_back(Triplet<T>(id,id,T(6)+internal::random<T>()));
+        if(i>0)   triplets.push_back(Triplet<T>(id,id-1,T(-1.2)));
+        if(i<n-1) triplets.push_back(Triplet<T>(id,id+1,T(-0.8)));
+        if(j>0)   triplets.push_back(Triplet<T>(id,id-n,T(-1.1)));
+        if(j<n-1) triplets.push_back(Triplet<T>(id,id+n,T(-0.9)));
+        if(k>0)   triplets.push_back(Triplet<T>(id,id-n*n,T(-1)));
+        if(k<n-1) triplets.push_back(Triplet<T>(id,id+n*n,T(-1)));
+      }
+  SpMat A(size,size);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+  A.makeCompressed();
+  DenseVector b = DenseVector::Random(size);
+
+  int threads = Eigen::nbThreads();
+  Eigen::setNbThreads(1);
+  SparseLU<SpMat> lu1(A);
+  VERIFY(lu1.info()==Success);
+  DenseVector x1 = lu1.solve(b);
+  VERIFY_IS_APPROX(A*x1, b);
+
+  Eigen::setNbThreads(4);
+  SparseLU<SpMat> lu4(A);
+  VERIFY(lu4.info()==Success);
+  DenseVector x4 = lu4.solve(b);
+  Eigen::setNbThreads(threads);
+
+  VERIFY_IS_EQUAL(x4, x1);
+  VERIFY_IS_EQUAL(lu4.rowsPermutation().indices(), lu1.rowsPermutation().indices());
 }
 
 void test_sparselu()
@@ -58,4 +105,5 @@ void test_sparselu()
   CALL_SUBTEST_2(test_sparselu_T<double>());
   CALL_SUBTEST_3(test_sparselu_T<std::complex<float> >()); 
   CALL_SUBTEST_4(test_sparselu_T<std::complex<double> >());
+  CALL_SUBTEST_5(test_sparselu_threads<double>());
 }
@@ -0,0 +1,122 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "sparse_solver.h"
+
+// 3D Laplacian on a n^3 grid, whose factor has large supernodes
+template<typename T> void laplacian_3d(int n, SparseMatrix<T>& A)
+{
+  std::vector<Triplet<T> > triplets;
+  const int size = n*n*n;
+  for(int k=0; k<n; ++k)
+    for(int j=0; j<n; ++j)
+      for(int i=0; i<n; ++i)
+      {
+        int id = i + n*(j + n*k);
+        triplets.push_back(Triplet<T>(id,id,T(6.5)));
+        if(i>0)   triplets.push_back(Triplet<T>(id,id-1,T(-1)));
+        if(i<n-1) triplets.push_back(Triplet<T>(id,id+1,T(-1)));
+        if(j>0)   triplets.push_back(Triplet<T>(id,id-n,T(-1)));
+        if(j<n-1) triplets.push_back(Triplet<T>(id,id+n,T(-1)));
+        if(k>0)   triplets.push_back(Triplet<T>(id,id-n*n,T(-1)));
+        if(k<n-1) triplets.push_back(Triplet<T>(id,id+n*n,T(-1)));
+      }
+  A.resize(size,size);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+}
+
+template<typename T> void test_supernodal_cholesky_structured()
+{
+  typedef SparseMatrix<T> SpMat;
+  typedef Matrix<T,Dynamic,Dynamic> DenseMat;
+  SpMat A;
+  laplacian_3d(internal::random<int>(8,14), A);
+  DenseMat b = DenseMat::Random(A.rows(),3);
+
+  SimplicialLDLT<SpMat> ref(A);
+  DenseMat refx = ref.solve(b);
+
+  SupernodalLLT<SpMat> llt(A);
+  VERIFY(llt.info()==Success);
+  VERIFY(llt.supernodeCount() < A.rows()/2);
+  DenseMat x = llt.solve(b);
+  VERIFY_IS_APPROX(x, refx);
+  VERIFY_IS_APPROX(A*x, b);
+  SpMat L = llt.matrixL();
+  SpMat LLt = L*L.adjoint();
+  SpMat PAPt;
+  PAPt = A.twistedBy(llt.permutationP());
+  VERIFY_IS_APPROX(DenseMat(LLt), DenseMat(PAPt));
+
+  SupernodalLDLT<SpMat> ldlt(A);
+  VERIFY(ldlt.info()==Success);
+  x = ldlt.solve(b);
+  VERIFY_IS_APPROX(x, refx);
+
+  // the parallel tree schedule yields the very same factor
+  SupernodalLLT<SpMat> pllt;
+  pllt.setParallelTreeSchedule(true);
+  pllt.compute(A);
+  VERIFY(pllt.info()==Success);
+  VERIFY_IS_EQUAL(pllt.solve(b), llt.solve(b));
+
+  SupernodalLDLT<SpMat> pldlt;
+  pldlt.setParallelTreeSchedule(true);
+  pldlt.analyzePattern(A);
+  pldlt.factorize(A);
+  VERIFY(pldlt.info()==Success);
+  VERIFY_IS_EQUAL(pldlt.vectorD(), ldlt.vectorD());
+
+  // shifted factorization
+  llt.setShift(1).compute(A);
+  SpMat I(A.rows(),A.cols());
+  I.setIdentity();
+  SpMat B = A + I;
+  VERIFY_IS_APPROX(B*llt.solve(b), b);
+
+  // not positive definite
+  SpMat N = -A;
+  llt.setShift(0).compute(N);
+  VERIFY(llt.info()==NumericalIssue);
+}
+
+template<typename T> void test_supernodal_cholesky_T()
+{
+  SupernodalLLT<SparseMatrix<T>, Lower> llt_colmajor_lower_amd;
+  SupernodalLLT<SparseMatrix<T>, Upper> llt_colmajor_upper_amd;
+  SupernodalLDLT<SparseMatrix<T>, Lower> ldlt_colmajor_lower_amd;
+  SupernodalLDLT<SparseMatrix<T>, Upper> ldlt_colmajor_upper_amd;
+  SupernodalLLT<SparseMatrix<T>, Lower, NaturalOrdering<int> > llt_colmajor_lower_nat;
+  SupernodalLDLT<SparseMatrix<T>, Upper, NaturalOrdering<int> > ldlt_colmajor_upper_nat;
+  SupernodalLDLT<SparseMatrix<T>, Lower> ldlt_colmajor_lower_par;
+  ldlt_colmajor_lower_par.setParallelTreeSchedule(true);
+
+  check_sparse_spd_solving(llt_colmajor_lower_amd);
+  check_sparse_spd_solving(llt_colmajor_upper_amd);
+  check_sparse_spd_solving(ldlt_colmajor_lower_amd);
+  check_sparse_spd_solving(ldlt_colmajor_upper_amd);
+  check_sparse_spd_solving(ldlt_colmajor_lower_par);
+
+  check_sparse_spd_determinant(llt_colmajor_lower_amd);
+  check_sparse_spd_determinant(llt_colmajor_upper_amd);
+  check_sparse_spd_determinant(ldlt_colmajor_lower_amd);
+  check_sparse_spd_determinant(ldlt_colmajor_upper_amd);
+
+  check_sparse_spd_solving(llt_colmajor_lower_nat);
+  check_sparse_spd_solving(ldlt_colmajor_upper_nat);
+
+  check_sparse_spd_symbolic_io(llt_colmajor_lower_amd);
+  check_sparse_spd_symbolic_io(ldlt_colmajor_upper_amd);
+
+  test_supernodal_cholesky_structured<T>();
+}
+
+void test_supernodal_cholesky()
+{
+  CALL_SUBTEST_1(test_supernodal_cholesky_T<double>());
+  CALL_SUBTEST_2(test_supernodal_cholesky_T<std::complex<double> >());
+}
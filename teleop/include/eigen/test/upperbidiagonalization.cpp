@@ -29,6 +29,26 @@ template<typename MatrixType> void upperbidiag(const MatrixType& m)
   VERIFY_IS_APPROX(a.adjoint(),d);
 }
 
+template<typename MatrixType> void upperbidiag_blocked(const MatrixType& m)
+{
+  typedef typename MatrixType::RealScalar RealScalar;
+  const typename MatrixType::Index rows = m.rows();
+  const typename MatrixType::Index cols = m.cols();
+
+  // large enough for several panels of the blocked reduction
+  MatrixType a = MatrixType::Random(rows,cols);
+  internal::UpperBidiagonalization<MatrixType> ubd(a), ubd_unblocked;
+  ubd_unblocked.computeUnblocked(a);
+  Matrix<RealScalar,Dynamic,Dynamic> b = ubd.bidiagonal().toDenseMatrix(), c = ubd_unblocked.bidiagonal().toDenseMatrix();
+  VERIFY_IS_APPROX(b, c);
+  VERIFY_IS_APPROX(ubd.householder(), ubd_unblocked.householder());
+
+  MatrixType d = MatrixType::Zero(rows, cols);
+  d.topRows(cols) = b.template cast<typename MatrixType::Scalar>();
+  MatrixType e = ubd.householderU() * d * ubd.householderV().adjoint();
+  VERIFY_IS_APPROX(a,e);
+}
+
 void test_upperbidiagonalization()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -40,4 +60,7 @@ void test_upperbidiagonalization()
    CALL_SUBTEST_6( upperbidiag(Matrix<float,5,5>()) );
    CALL_SUBTEST_7( upperbidiag(Matrix<double,4,3>()) );
   }
+  CALL_SUBTEST_8( upperbidiag_blocked(MatrixXd(internal::random<int>(120,300), internal::random<int>(80,120))) );
+  CALL_SUBTEST_9( upperbidiag_blocked(MatrixXcf(internal::random<int>(100,150), internal::random<int>(60,100))) );
+  CALL_SUBTEST_10( upperbidiag_blocked(Matrix<double,Dynamic,Dynamic,RowMajor>(100,100)) );
 }
@@ -110,6 +110,87 @@ template<typename VectorType> void vectorVisitor(const VectorType& w)
   VERIFY(eigen_maxidx == (std::min)(idx0,idx2));
 }
 
+// large objects, for which the min and max coefficients are searched with packets
+template<typename MatrixType> void largeVisitor(const MatrixType& m)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::Index Index;
+  const Index rows = m.rows(), cols = m.cols();
+  MatrixType v = MatrixType::Random(rows,cols);
+  // few distinct values, so that the extrema are reached several times
+  if(internal::random<bool>() && NumTraits<Scalar>::IsInteger)
+    v /= Scalar(1<<24);
+  else if(internal::random<bool>())
+    v = (v * Scalar(8)).template cast<int>().template cast<Scalar>();
+
+  // the first occurrence in the column-major order, whatever the storage order
+  Index minrow = 0, mincol = 0, maxrow = 0, maxcol = 0;
+  Scalar minc = v(0,0), maxc = v(0,0);
+  for(Index j = 0; j < cols; ++j)
+    for(Index i = 0; i < rows; ++i)
+    {
+      if(v(i,j) < minc) { minc = v(i,j); minrow = i; mincol = j; }
+      if(v(i,j) > maxc) { maxc = v(i,j); maxrow = i; maxcol = j; }
+    }
+  Index r, c;
+  VERIFY_IS_EQUAL(v.minCoeff(&r,&c), minc);
+  VERIFY_IS_EQUAL(r, minrow);
+  VERIFY_IS_EQUAL(c, mincol);
+  VERIFY_IS_EQUAL(v.maxCoeff(&r,&c), maxc);
+  VERIFY_IS_EQUAL(r, maxrow);
+  VERIFY_IS_EQUAL(c, maxcol);
+  VERIFY_IS_EQUAL((v*Scalar(1)).minCoeff(&r,&c), minc);
+  VERIFY_IS_EQUAL(r, minrow);
+  VERIFY_IS_EQUAL(c, mincol);
+
+  // the result is the first occurrence, also within the unaligned head and tail of a vector
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  VectorType w = Map<VectorType>(v.data(), v.size());
+  const Index size = w.size(), offset = internal::random<Index>(0,3);
+  const Index i0 = internal::random<Index>(offset,size-1), i1 = internal::random<Index>(offset,size-1);
+  w(i0) = w(i1) = minc - Scalar(1);
+  Index idx;
+  VERIFY_IS_EQUAL(w.segment(offset, size-offset).minCoeff(&idx), minc - Scalar(1));
+  VERIFY_IS_EQUAL(idx, (std::min)(i0,i1) - offset);
+  w(i0) = w(i1) = maxc + Scalar(1);
+  VERIFY_IS_EQUAL(w.segment(offset, size-offset).maxCoeff(&idx), maxc + Scalar(1));
+  VERIFY_IS_EQUAL(idx, (std::min)(i0,i1) - offset);
+  w(size-1) = maxc + Scalar(2);
+  VERIFY_IS_EQUAL(w.maxCoeff(&idx), maxc + Scalar(2));
+  VERIFY_IS_EQUAL(idx, size-1);
+  w(0) = minc - Scalar(2);
+  VERIFY_IS_EQUAL((-w).maxCoeff(&idx), -(minc - Scalar(2)));
+  VERIFY_IS_EQUAL(idx, 0);
+}
+
+// with NaNs, the result is the one of the scalar visitors
+template<typename VectorType> void largeVisitorNaN(const VectorType& w)
+{
+  typedef typename VectorType::Scalar Scalar;
+  typedef typename VectorType::Index Index;
+  const Index size = w.size();
+  VectorType v = VectorType::Random(size);
+  const Scalar nan = std::numeric_limits<Scalar>::quiet_NaN();
+  v(internal::random<Index>(0,size-1)) = nan;
+  if(internal::random<bool>())
+    v(0) = nan;
+
+  Index minidx = 0, maxidx = 0;
+  Scalar minc = v(0), maxc = v(0);
+  for(Index i = 1; i < size; ++i)
+  {
+    if(v(i) < minc) { minc = v(i); minidx = i; }
+    if(v(i) > maxc) { maxc = v(i); maxidx = i; }
+  }
+  Index idx;
+  const Scalar resMin = v.minCoeff(&idx);
+  VERIFY_IS_EQUAL(idx, minidx);
+  VERIFY((resMin!=resMin && minc!=minc) || resMin==minc);
+  const Scalar resMax = v.maxCoeff(&idx);
+  VERIFY_IS_EQUAL(idx, maxidx);
+  VERIFY((resMax!=resMax && maxc!=maxc) || resMax==maxc);
+}
+
 void test_visitor()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -127,4 +208,14 @@ void test_visitor()
     CALL_SUBTEST_9( vectorVisitor(RowVectorXd(10)) );
     CALL_SUBTEST_10( vectorVisitor(VectorXf(33)) );
   }
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_11( largeVisitor(VectorXf(internal::random<int>(256,20000))) );
+    CALL_SUBTEST_11( largeVisitor(MatrixXf(internal::random<int>(1,300), internal::random<int>(1,300))) );
+    CALL_SUBTEST_12( largeVisitor(RowVectorXd(internal::random<int>(128,20000))) );
+    CALL_SUBTEST_12( largeVisitor(Matrix<double,Dynamic,Dynamic,RowMajor>(internal::random<int>(1,300), internal::random<int>(1,300))) );
+    CALL_SUBTEST_13( largeVisitor(VectorXi(internal::random<int>(256,20000))) );
+    CALL_SUBTEST_11( largeVisitorNaN(VectorXf(1024)) );
+    CALL_SUBTEST_11( largeVisitorNaN(VectorXf(internal::random<int>(256,20000))) );
+    CALL_SUBTEST_12( largeVisitorNaN(VectorXd(internal::random<int>(128,20000))) );
+  }
 }
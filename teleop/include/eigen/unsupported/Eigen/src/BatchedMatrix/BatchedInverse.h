@@ -0,0 +1,153 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BATCHED_INVERSE_H
+#define EIGEN_BATCHED_INVERSE_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal Generic sizes go through the batched LU decomposition */
+template<typename Scalar, int Size>
+struct batched_inverse_impl
+{
+  typedef BatchedMatrix<Scalar,Size,Size> BatchedMatrixType;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+
+  static void inverse(const BatchedMatrixType& a, BatchedMatrixType& inv)
+  {
+    BatchedPartialPivLU<Scalar,Size>(a).inverse(inv);
+  }
+
+  static VectorType determinant(const BatchedMatrixType& a)
+  {
+    return BatchedPartialPivLU<Scalar,Size>(a).determinant();
+  }
+};
+
+/** \internal 2x2 matrices use the closed form formulas */
+template<typename Scalar>
+struct batched_inverse_impl<Scalar,2>
+{
+  typedef BatchedMatrix<Scalar,2,2> BatchedMatrixType;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef typename packet_traits<Scalar>::type Packet;
+  enum { PacketSize = packet_traits<Scalar>::size };
+
+  static void inverse(const BatchedMatrixType& a, BatchedMatrixType& inv)
+  {
+    inv.resize(a.count());
+    for(DenseIndex p=0; p<a.stride(); p+=PacketSize)
+    {
+      Packet m[4], r[4];
+      batched_load(a, p, m);
+      Packet invdet = pdiv(pset1<Packet>(Scalar(1)), psub(pmul(m[0],m[3]), pmul(m[2],m[1])));
+      r[0] = pmul(m[3], invdet);
+      r[1] = pnegate(pmul(m[1], invdet));
+      r[2] = pnegate(pmul(m[2], invdet));
+      r[3] = pmul(m[0], invdet);
+      batched_store(inv, p, r);
+    }
+  }
+
+  static VectorType determinant(const BatchedMatrixType& a)
+  {
+    VectorType det(a.stride());
+    for(DenseIndex p=0; p<a.stride(); p+=PacketSize)
+    {
+      Packet m[4];
+      batched_load(a, p, m);
+      pstore(det.data()+p, psub(pmul(m[0],m[3]), pmul(m[2],m[1])));
+    }
+    det.conservativeResize(a.count());
+    return det;
+  }
+};
+
+/** \internal 3x3 matrices use the cofactors */
+template<typename Scalar>
+struct batched_inverse_impl<Scalar,3>
+{
+  typedef BatchedMatrix<Scalar,3,3> BatchedMatrixType;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef typename packet_traits<Scalar>::type Packet;
+  enum { PacketSize = packet_traits<Scalar>::size };
+
+  // m is stored in column-major order: m[i+3*j] = m(i,j)
+  static EIGEN_STRONG_INLINE Packet cofactor(const Packet* m, int i, int j)
+  {
+    int i1 = (i+1)%3, i2 = (i+2)%3, j1 = (j+1)%3, j2 = (j+2)%3;
+    return psub(pmul(m[i1+3*j1], m[i2+3*j2]), pmul(m[i1+3*j2], m[i2+3*j1]));
+  }
+
+  static void inverse(const BatchedMatrixType& a, BatchedMatrixType& inv)
+  {
+    inv.resize(a.count());
+    for(DenseIndex p=0; p<a.stride(); p+=PacketSize)
+    {
+      Packet m[9], c[9], r[9];
+      batched_load(a, p, m);
+      for(int j=0; j<3; ++j)
+        for(int i=0; i<3; ++i)
+          c[i+3*j] = cofactor(m, i, j);
+      Packet det = padd(padd(pmul(m[0],c[0]), pmul(m[3],c[3])), pmul(m[6],c[6]));
+      Packet invdet = pdiv(pset1<Packet>(Scalar(1)), det);
+      // the inverse is the transposed cofactor matrix divided by the determinant
+      for(int j=0; j<3; ++j)
+        for(int i=0; i<3; ++i)
+          r[i+3*j] = pmul(c[j+3*i], invdet);
+      batched_store(inv, p, r);
+    }
+  }
+
+  static VectorType determinant(const BatchedMatrixType& a)
+  {
+    VectorType det(a.stride());
+    for(DenseIndex p=0; p<a.stride(); p+=PacketSize)
+    {
+      Packet m[9];
+      batched_load(a, p, m);
+      Packet d = padd(padd(pmul(m[0],cofactor(m,0,0)), pmul(m[3],cofactor(m,0,1))), pmul(m[6],cofactor(m,0,2)));
+      pstore(det.data()+p, d);
+    }
+    det.conservativeResize(a.count());
+    return det;
+  }
+};
+
+} // end namespace internal
+
+/** \ingroup BatchedMatrix_Module
+  *
+  * Computes the inverses of all the matrices of \a a into \a inv, which must not alias \a a.
+  * The 2x2 and 3x3 matrices are inverted with the closed form formulas (without pivoting, as Matrix::inverse()),
+  * larger matrices through a BatchedPartialPivLU decomposition.
+  */
+template<typename Scalar, int Size>
+void batchedInverse(const BatchedMatrix<Scalar,Size,Size>& a, BatchedMatrix<Scalar,Size,Size>& inv)
+{
+  eigen_assert((void*)&a!=(void*)&inv && "aliasing is not supported by batchedInverse");
+  internal::batched_inverse_impl<Scalar,Size>::inverse(a, inv);
+}
+
+/** \ingroup BatchedMatrix_Module
+  *
+  * \returns the determinants of all the matrices of \a a
+  * The 2x2 and 3x3 determinants are computed with the closed form formulas, the larger ones
+  * through a BatchedPartialPivLU decomposition.
+  */
+template<typename Scalar, int Size>
+Matrix<Scalar,Dynamic,1> batchedDeterminant(const BatchedMatrix<Scalar,Size,Size>& a)
+{
+  return internal::batched_inverse_impl<Scalar,Size>::determinant(a);
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_BATCHED_INVERSE_H
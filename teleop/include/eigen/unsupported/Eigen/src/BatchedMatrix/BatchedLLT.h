@@ -0,0 +1,197 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BATCHED_LLT_H
+#define EIGEN_BATCHED_LLT_H
+
+namespace Eigen {
+
+/** \ingroup BatchedMatrix_Module
+  *
+  * \class BatchedLLT
+  *
+  * \brief Cholesky decompositions of a batch of symmetric positive definite matrices
+  *
+  * \tparam _Scalar the scalar type, which must be a real floating point type
+  * \tparam _Size the size of the matrices
+  *
+  * This class computes the decompositions A = LL^T of all the matrices of a BatchedMatrix, one matrix
+  * per SIMD lane. Only the lower triangular part of the matrices is referenced.
+  *
+  * \sa class LLT, class BatchedMatrix
+  */
+template<typename _Scalar, int _Size>
+class BatchedLLT
+{
+  public:
+    typedef _Scalar Scalar;
+    typedef DenseIndex Index;
+    typedef typename internal::packet_traits<Scalar>::type Packet;
+    typedef BatchedMatrix<Scalar,_Size,_Size> BatchedMatrixType;
+    typedef Matrix<Scalar,Dynamic,1> VectorType;
+    enum { PacketSize = internal::packet_traits<Scalar>::size };
+
+    BatchedLLT() : m_isInitialized(false), m_info(Success) {}
+
+    explicit BatchedLLT(const BatchedMatrixType& matrices) : m_isInitialized(false), m_info(Success)
+    {
+      compute(matrices);
+    }
+
+    /** Computes the Cholesky decompositions of all the matrices of \a matrices */
+    BatchedLLT& compute(const BatchedMatrixType& matrices)
+    {
+      EIGEN_STATIC_ASSERT(!NumTraits<Scalar>::IsComplex, NUMERIC_TYPE_MUST_BE_REAL);
+      using namespace internal;
+      m_matrix.resize(matrices.count());
+      const Index stride = m_matrix.stride();
+      VectorType failed(stride);
+      const Packet zero = pset1<Packet>(Scalar(0));
+      const Packet one = pset1<Packet>(Scalar(1));
+      for(Index p=0; p<stride; p+=PacketSize)
+      {
+        Packet a[_Size*_Size];
+        batched_load(matrices, p, a);
+        Packet bad = zero;
+        for(int k=0; k<_Size; ++k)
+        {
+          Packet d = a[k+k*_Size];
+          for(int j=0; j<k; ++j)
+            d = psub(d, pmul(a[k+j*_Size], a[k+j*_Size]));
+          bad = pselect(pcmp_le(d, zero), one, bad);
+          d = batched_sqrt<Scalar,Packet>::run(d);
+          a[k+k*_Size] = d;
+          Packet inv = pdiv(one, d);
+          for(int r=k+1; r<_Size; ++r)
+          {
+            Packet x = a[r+k*_Size];
+            for(int j=0; j<k; ++j)
+              x = psub(x, pmul(a[r+j*_Size], a[k+j*_Size]));
+            a[r+k*_Size] = pmul(x, inv);
+            a[k+r*_Size] = zero;
+          }
+        }
+        batched_store(m_matrix, p, a);
+        pstore(failed.data()+p, bad);
+      }
+      m_info = (failed.head(m_matrix.count()).array()!=Scalar(0)).any() ? NumericalIssue : Success;
+      m_isInitialized = true;
+      return *this;
+    }
+
+    /** Solves the systems \c A[k] \c x[k] = \c b[k] for all the matrices of the batch.
+      * \a x is resized to the number of matrices, and can alias \a b. */
+    template<int Cols>
+    void solve(const BatchedMatrix<Scalar,_Size,Cols>& b, BatchedMatrix<Scalar,_Size,Cols>& x) const
+    {
+      using namespace internal;
+      eigen_assert(m_isInitialized && "BatchedLLT is not initialized.");
+      eigen_assert(b.count()==m_matrix.count());
+      x.resize(b.count());
+      const Index stride = m_matrix.stride();
+      for(Index p=0; p<stride; p+=PacketSize)
+      {
+        Packet rhs[_Size*Cols];
+        batched_load(b, p, rhs);
+        solveInPlace<Cols>(p, rhs);
+        batched_store(x, p, rhs);
+      }
+    }
+
+    /** Computes the inverses of all the matrices of the batch into \a inv */
+    void inverse(BatchedMatrixType& inv) const
+    {
+      using namespace internal;
+      eigen_assert(m_isInitialized && "BatchedLLT is not initialized.");
+      inv.resize(m_matrix.count());
+      const Index stride = m_matrix.stride();
+      for(Index p=0; p<stride; p+=PacketSize)
+      {
+        Packet rhs[_Size*_Size];
+        for(int j=0; j<_Size; ++j)
+          for(int i=0; i<_Size; ++i)
+            rhs[i+j*_Size] = pset1<Packet>(i==j ? Scalar(1) : Scalar(0));
+        solveInPlace<_Size>(p, rhs);
+        batched_store(inv, p, rhs);
+      }
+    }
+
+    /** \returns the determinants of all the matrices of the batch */
+    VectorType determinant() const
+    {
+      using namespace internal;
+      eigen_assert(m_isInitialized && "BatchedLLT is not initialized.");
+      const Index stride = m_matrix.stride();
+      VectorType det(stride);
+      for(Index p=0; p<stride; p+=PacketSize)
+      {
+        Packet d = pload<Packet>(m_matrix.coeffData(0,0)+p);
+        for(int k=1; k<_Size; ++k)
+          d = pmul(d, pload<Packet>(m_matrix.coeffData(k,k)+p));
+        pstore(det.data()+p, pmul(d,d));
+      }
+      det.conservativeResize(m_matrix.count());
+      return det;
+    }
+
+    /** \returns the lower triangular factors L of the matrices, their strictly upper parts being zero */
+    const BatchedMatrixType& matrixL() const
+    {
+      eigen_assert(m_isInitialized && "BatchedLLT is not initialized.");
+      return m_matrix;
+    }
+
+    /** \returns \c Success if all the matrices are positive definite, and \c NumericalIssue otherwise */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "BatchedLLT is not initialized.");
+      return m_info;
+    }
+
+    Index count() const { return m_matrix.count(); }
+
+  protected:
+
+    template<int Cols>
+    void solveInPlace(Index p, Packet* rhs) const
+    {
+      using namespace internal;
+      Packet l[_Size*_Size];
+      batched_load(m_matrix, p, l);
+      Packet invDiag[_Size];
+      for(int k=0; k<_Size; ++k)
+        invDiag[k] = pdiv(pset1<Packet>(Scalar(1)), l[k+k*_Size]);
+
+      for(int c=0; c<Cols; ++c)
+      {
+        Packet* x = rhs + c*_Size;
+        // L y = b
+        for(int k=0; k<_Size; ++k)
+        {
+          x[k] = pmul(x[k], invDiag[k]);
+          for(int r=k+1; r<_Size; ++r)
+            x[r] = psub(x[r], pmul(l[r+k*_Size], x[k]));
+        }
+        // L^T x = y
+        for(int k=_Size-1; k>=0; --k)
+        {
+          for(int r=k+1; r<_Size; ++r)
+            x[k] = psub(x[k], pmul(l[r+k*_Size], x[r]));
+          x[k] = pmul(x[k], invDiag[k]);
+        }
+      }
+    }
+
+    BatchedMatrixType m_matrix;
+    bool m_isInitialized;
+    ComputationInfo m_info;
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_BATCHED_LLT_H
@@ -0,0 +1,241 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BATCHED_MATRIX_H
+#define EIGEN_BATCHED_MATRIX_H
+
+namespace Eigen {
+
+/** \ingroup BatchedMatrix_Module
+  *
+  * \class BatchedMatrix
+  *
+  * \brief A batch of independent fixed-size matrices stored in structure-of-arrays layout
+  *
+  * \tparam _Scalar the scalar type of the matrices
+  * \tparam _Rows the number of rows of each matrix
+  * \tparam _Cols the number of columns of each matrix
+  *
+  * The coefficient (i,j) of all the matrices of the batch is stored contiguously, and the number
+  * of stored matrices is rounded up to a multiple of the packet size. Therefore, the batched
+  * algorithms of this module load the coefficient (i,j) of \c PacketSize consecutive matrices
+  * with a single aligned packet load, and process one matrix per SIMD lane. This is much more efficient
+  * than vectorizing within each matrix for sizes like 3x3 which do not fill the packets.
+  *
+  * The padding matrices are initialized to zero, and never accessed by the accessors of this class.
+  *
+  * \sa batchedProduct(), batchedInverse(), batchedDeterminant(), class BatchedPartialPivLU, class BatchedLLT
+  */
+template<typename _Scalar, int _Rows, int _Cols>
+class BatchedMatrix
+{
+  public:
+    typedef _Scalar Scalar;
+    typedef DenseIndex Index;
+    typedef typename internal::packet_traits<Scalar>::type Packet;
+    enum {
+      RowsAtCompileTime = _Rows,
+      ColsAtCompileTime = _Cols,
+      SizeAtCompileTime = _Rows*_Cols,
+      PacketSize = internal::packet_traits<Scalar>::size
+    };
+    typedef Matrix<Scalar,_Rows,_Cols> MatrixType;
+    typedef Matrix<Scalar,Dynamic,SizeAtCompileTime> StorageType;
+    typedef Map<Matrix<Scalar,Dynamic,1>,Aligned> CoeffsReturnType;
+    typedef Map<const Matrix<Scalar,Dynamic,1>,Aligned> ConstCoeffsReturnType;
+
+    /** Default constructor, the batch is empty */
+    BatchedMatrix() : m_count(0)
+    {
+      EIGEN_STATIC_ASSERT(_Rows>0 && _Cols>0, THIS_METHOD_IS_ONLY_FOR_MATRICES_OF_A_SPECIFIC_SIZE);
+    }
+
+    /** Constructs a batch of \a count zero matrices */
+    explicit BatchedMatrix(Index count) : m_count(0)
+    {
+      EIGEN_STATIC_ASSERT(_Rows>0 && _Cols>0, THIS_METHOD_IS_ONLY_FOR_MATRICES_OF_A_SPECIFIC_SIZE);
+      resize(count);
+    }
+
+    /** Resizes the batch to \a count matrices. The coefficients are set to zero if the size changes. */
+    void resize(Index count)
+    {
+      eigen_assert(count>=0);
+      if(count==m_count)
+        return;
+      m_count = count;
+      m_storage.setZero(alignedCount(count), SizeAtCompileTime);
+    }
+
+    /** \returns the number of matrices of the batch */
+    Index count() const { return m_count; }
+    /** \returns the number of rows of each matrix */
+    Index rows() const { return _Rows; }
+    /** \returns the number of columns of each matrix */
+    Index cols() const { return _Cols; }
+    /** \returns the distance between the arrays of two consecutive coefficients, i.e., the padded number of matrices */
+    Index stride() const { return m_storage.rows(); }
+
+    /** \returns a pointer to the aligned array storing the coefficient (\a i,\a j) of all the matrices */
+    Scalar* coeffData(Index i, Index j)
+    {
+      eigen_assert(i>=0 && i<_Rows && j>=0 && j<_Cols);
+      return m_storage.data() + (i+j*_Rows)*stride();
+    }
+    const Scalar* coeffData(Index i, Index j) const
+    {
+      eigen_assert(i>=0 && i<_Rows && j>=0 && j<_Cols);
+      return m_storage.data() + (i+j*_Rows)*stride();
+    }
+
+    /** \returns a vector expression of the coefficient (\a i,\a j) of all the matrices */
+    CoeffsReturnType coeffs(Index i, Index j) { return CoeffsReturnType(coeffData(i,j), m_count); }
+    ConstCoeffsReturnType coeffs(Index i, Index j) const { return ConstCoeffsReturnType(coeffData(i,j), m_count); }
+
+    /** \returns a copy of the \a k-th matrix of the batch */
+    MatrixType matrix(Index k) const
+    {
+      eigen_assert(k>=0 && k<m_count);
+      MatrixType res;
+      for(Index j=0; j<_Cols; ++j)
+        for(Index i=0; i<_Rows; ++i)
+          res.coeffRef(i,j) = m_storage.coeff(k, i+j*_Rows);
+      return res;
+    }
+
+    /** Sets the \a k-th matrix of the batch to \a mat */
+    template<typename OtherDerived>
+    void setMatrix(Index k, const MatrixBase<OtherDerived>& mat)
+    {
+      eigen_assert(k>=0 && k<m_count && mat.rows()==_Rows && mat.cols()==_Cols);
+      for(Index j=0; j<_Cols; ++j)
+        for(Index i=0; i<_Rows; ++i)
+          m_storage.coeffRef(k, i+j*_Rows) = mat.coeff(i,j);
+    }
+
+    /** Sets all the matrices of the batch to zero */
+    void setZero() { m_storage.setZero(); }
+
+    /** Sets all the matrices of the batch to random matrices (the padding matrices are left to zero) */
+    void setRandom()
+    {
+      m_storage.topRows(m_count).setRandom();
+    }
+
+    /** Sets all the matrices of the batch to the identity (including the padding matrices) */
+    void setIdentity()
+    {
+      m_storage.setZero();
+      for(Index i=0; i<(std::min)(Index(_Rows),Index(_Cols)); ++i)
+        m_storage.col(i+i*_Rows).setOnes();
+    }
+
+    /** \returns a pointer to the first coefficient of the underlying storage */
+    Scalar* data() { return m_storage.data(); }
+    const Scalar* data() const { return m_storage.data(); }
+
+    /** \returns the underlying storage: the \a k-th row stores the \a k-th matrix in column-major order */
+    const StorageType& storage() const { return m_storage; }
+
+  protected:
+
+    static Index alignedCount(Index count)
+    {
+      return ((count+PacketSize-1)/PacketSize)*PacketSize;
+    }
+
+    StorageType m_storage;
+    Index m_count;
+};
+
+namespace internal {
+
+/** \internal loads the coefficients of the matrices \a offset ... \a offset+PacketSize-1 of \a batch into \a packets */
+template<typename Scalar, int Rows, int Cols, typename Packet>
+EIGEN_STRONG_INLINE void batched_load(const BatchedMatrix<Scalar,Rows,Cols>& batch, DenseIndex offset, Packet* packets)
+{
+  const Scalar* data = batch.data() + offset;
+  const DenseIndex stride = batch.stride();
+  for(int k=0; k<Rows*Cols; ++k)
+    packets[k] = pload<Packet>(data + k*stride);
+}
+
+/** \internal stores \a packets to the matrices \a offset ... \a offset+PacketSize-1 of \a batch */
+template<typename Scalar, int Rows, int Cols, typename Packet>
+EIGEN_STRONG_INLINE void batched_store(BatchedMatrix<Scalar,Rows,Cols>& batch, DenseIndex offset, const Packet* packets)
+{
+  Scalar* data = batch.data() + offset;
+  const DenseIndex stride = batch.stride();
+  for(int k=0; k<Rows*Cols; ++k)
+    pstore(data + k*stride, packets[k]);
+}
+
+/** \internal \returns the square root of \a a, coefficient per coefficient if there is no vectorized square root */
+template<typename Scalar, typename Packet, bool HasSqrt = bool(packet_traits<Scalar>::HasSqrt) || int(packet_traits<Scalar>::size)==1>
+struct batched_sqrt
+{
+  static EIGEN_STRONG_INLINE Packet run(const Packet& a) { return psqrt(a); }
+};
+
+template<typename Scalar, typename Packet>
+struct batched_sqrt<Scalar,Packet,false>
+{
+  static EIGEN_STRONG_INLINE Packet run(const Packet& a)
+  {
+    using std::sqrt;
+    EIGEN_ALIGN16 Scalar tmp[packet_traits<Scalar>::size];
+    pstore(tmp, a);
+    for(int i=0; i<packet_traits<Scalar>::size; ++i)
+      tmp[i] = sqrt(tmp[i]);
+    return pload<Packet>(tmp);
+  }
+};
+
+} // end namespace internal
+
+/** \ingroup BatchedMatrix_Module
+  *
+  * Computes the products \c dst[k] = \c lhs[k] * \c rhs[k] for all the matrices of the batches.
+  * \a dst is resized to the number of matrices of \a lhs and \a rhs, and must not alias \a lhs or \a rhs.
+  */
+template<typename Scalar, int Rows, int Depth, int Cols>
+void batchedProduct(const BatchedMatrix<Scalar,Rows,Depth>& lhs, const BatchedMatrix<Scalar,Depth,Cols>& rhs,
+                    BatchedMatrix<Scalar,Rows,Cols>& dst)
+{
+  typedef typename internal::packet_traits<Scalar>::type Packet;
+  enum { PacketSize = internal::packet_traits<Scalar>::size };
+  eigen_assert(lhs.count()==rhs.count());
+  eigen_assert((void*)&dst!=(void*)&lhs && (void*)&dst!=(void*)&rhs && "aliasing is not supported by batchedProduct");
+
+  dst.resize(lhs.count());
+  const DenseIndex stride = dst.stride();
+  const Scalar* lhsData = lhs.data();
+  Scalar* dstData = dst.data();
+  for(DenseIndex p=0; p<stride; p+=PacketSize)
+  {
+    Packet b[Depth*Cols];
+    internal::batched_load(rhs, p, b);
+    for(int i=0; i<Rows; ++i)
+    {
+      Packet a[Depth];
+      for(int k=0; k<Depth; ++k)
+        a[k] = internal::pload<Packet>(lhsData + (i+k*Rows)*stride + p);
+      for(int j=0; j<Cols; ++j)
+      {
+        Packet acc = internal::pmul(a[0], b[j*Depth]);
+        for(int k=1; k<Depth; ++k)
+          acc = internal::pmadd(a[k], b[k+j*Depth], acc);
+        internal::pstore(dstData + (i+j*Rows)*stride + p, acc);
+      }
+    }
+  }
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_BATCHED_MATRIX_H
@@ -0,0 +1,226 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BATCHED_PARTIALPIVLU_H
+#define EIGEN_BATCHED_PARTIALPIVLU_H
+
+namespace Eigen {
+
+/** \ingroup BatchedMatrix_Module
+  *
+  * \class BatchedPartialPivLU
+  *
+  * \brief LU decompositions with partial pivoting of a batch of square matrices
+  *
+  * \tparam _Scalar the scalar type, which must be a real floating point type
+  * \tparam _Size the size of the matrices
+  *
+  * This class computes the decompositions PA = LU of all the matrices of a BatchedMatrix, one matrix
+  * per SIMD lane. The pivot search and the row interchanges are performed independently for each lane
+  * with packet comparisons and blends, so that the results match the ones of PartialPivLU.
+  *
+  * \sa class PartialPivLU, class BatchedMatrix
+  */
+template<typename _Scalar, int _Size>
+class BatchedPartialPivLU
+{
+  public:
+    typedef _Scalar Scalar;
+    typedef DenseIndex Index;
+    typedef typename internal::packet_traits<Scalar>::type Packet;
+    typedef BatchedMatrix<Scalar,_Size,_Size> BatchedMatrixType;
+    typedef BatchedMatrix<Scalar,_Size,1> TranspositionsType;
+    typedef Matrix<Scalar,Dynamic,1> VectorType;
+    enum { PacketSize = internal::packet_traits<Scalar>::size };
+
+    BatchedPartialPivLU() : m_isInitialized(false) {}
+
+    explicit BatchedPartialPivLU(const BatchedMatrixType& matrices) : m_isInitialized(false)
+    {
+      compute(matrices);
+    }
+
+    /** Computes the LU decompositions of all the matrices of \a matrices */
+    BatchedPartialPivLU& compute(const BatchedMatrixType& matrices)
+    {
+      EIGEN_STATIC_ASSERT(!NumTraits<Scalar>::IsComplex, NUMERIC_TYPE_MUST_BE_REAL);
+      using namespace internal;
+      m_lu.resize(matrices.count());
+      m_transpositions.resize(matrices.count());
+      const Index stride = m_lu.stride();
+      for(Index p=0; p<stride; p+=PacketSize)
+      {
+        Packet a[_Size*_Size];
+        batched_load(matrices, p, a);
+        for(int k=0; k<_Size; ++k)
+        {
+          // search the pivot of each lane
+          Packet best = pabs(a[k+k*_Size]);
+          Packet pivot = pset1<Packet>(Scalar(k));
+          for(int r=k+1; r<_Size; ++r)
+          {
+            Packet v = pabs(a[r+k*_Size]);
+            Packet m = pcmp_lt(best, v);
+            best = pselect(m, v, best);
+            pivot = pselect(m, pset1<Packet>(Scalar(r)), pivot);
+          }
+          pstore(m_transpositions.coeffData(k,0)+p, pivot);
+
+          // interchange the rows in the lanes where the pivot is not on the diagonal
+          for(int r=k+1; r<_Size; ++r)
+          {
+            Packet m = pcmp_eq(pivot, pset1<Packet>(Scalar(r)));
+            for(int c=0; c<_Size; ++c)
+            {
+              Packet ak = a[k+c*_Size];
+              a[k+c*_Size] = pselect(m, a[r+c*_Size], ak);
+              a[r+c*_Size] = pselect(m, ak, a[r+c*_Size]);
+            }
+          }
+
+          // update the trailing submatrix
+          Packet inv = pdiv(pset1<Packet>(Scalar(1)), a[k+k*_Size]);
+          for(int r=k+1; r<_Size; ++r)
+          {
+            Packet l = pmul(a[r+k*_Size], inv);
+            a[r+k*_Size] = l;
+            for(int c=k+1; c<_Size; ++c)
+              a[r+c*_Size] = psub(a[r+c*_Size], pmul(l, a[k+c*_Size]));
+          }
+        }
+        batched_store(m_lu, p, a);
+      }
+      m_isInitialized = true;
+      return *this;
+    }
+
+    /** Solves the systems \c A[k] \c x[k] = \c b[k] for all the matrices of the batch.
+      * \a x is resized to the number of matrices, and can alias \a b. */
+    template<int Cols>
+    void solve(const BatchedMatrix<Scalar,_Size,Cols>& b, BatchedMatrix<Scalar,_Size,Cols>& x) const
+    {
+      using namespace internal;
+      eigen_assert(m_isInitialized && "BatchedPartialPivLU is not initialized.");
+      eigen_assert(b.count()==m_lu.count());
+      x.resize(b.count());
+      const Index stride = m_lu.stride();
+      for(Index p=0; p<stride; p+=PacketSize)
+      {
+        Packet rhs[_Size*Cols];
+        batched_load(b, p, rhs);
+        solveInPlace<Cols>(p, rhs);
+        batched_store(x, p, rhs);
+      }
+    }
+
+    /** Computes the inverses of all the matrices of the batch into \a inv */
+    void inverse(BatchedMatrixType& inv) const
+    {
+      using namespace internal;
+      eigen_assert(m_isInitialized && "BatchedPartialPivLU is not initialized.");
+      inv.resize(m_lu.count());
+      const Index stride = m_lu.stride();
+      for(Index p=0; p<stride; p+=PacketSize)
+      {
+        Packet rhs[_Size*_Size];
+        for(int j=0; j<_Size; ++j)
+          for(int i=0; i<_Size; ++i)
+            rhs[i+j*_Size] = pset1<Packet>(i==j ? Scalar(1) : Scalar(0));
+        solveInPlace<_Size>(p, rhs);
+        batched_store(inv, p, rhs);
+      }
+    }
+
+    /** \returns the determinants of all the matrices of the batch */
+    VectorType determinant() const
+    {
+      using namespace internal;
+      eigen_assert(m_isInitialized && "BatchedPartialPivLU is not initialized.");
+      const Index stride = m_lu.stride();
+      VectorType det(stride);
+      for(Index p=0; p<stride; p+=PacketSize)
+      {
+        Packet d = pload<Packet>(m_lu.coeffData(0,0)+p);
+        for(int k=1; k<_Size; ++k)
+          d = pmul(d, pload<Packet>(m_lu.coeffData(k,k)+p));
+        for(int k=0; k<_Size; ++k)
+          d = pselect(pcmp_eq(pload<Packet>(m_transpositions.coeffData(k,0)+p), pset1<Packet>(Scalar(k))), d, pnegate(d));
+        pstore(det.data()+p, d);
+      }
+      det.conservativeResize(m_lu.count());
+      return det;
+    }
+
+    /** \returns the LU factors of the matrices, stored as in PartialPivLU::matrixLU() */
+    const BatchedMatrixType& matrixLU() const
+    {
+      eigen_assert(m_isInitialized && "BatchedPartialPivLU is not initialized.");
+      return m_lu;
+    }
+
+    /** \returns the row transpositions: at step \c k the row \c k has been interchanged with the row \c transpositions()[k] */
+    const TranspositionsType& transpositions() const
+    {
+      eigen_assert(m_isInitialized && "BatchedPartialPivLU is not initialized.");
+      return m_transpositions;
+    }
+
+    Index count() const { return m_lu.count(); }
+
+  protected:
+
+    template<int Cols>
+    void solveInPlace(Index p, Packet* rhs) const
+    {
+      using namespace internal;
+      Packet lu[_Size*_Size];
+      batched_load(m_lu, p, lu);
+
+      // apply the row interchanges
+      for(int k=0; k<_Size; ++k)
+      {
+        Packet pivot = pload<Packet>(m_transpositions.coeffData(k,0)+p);
+        for(int r=k+1; r<_Size; ++r)
+        {
+          Packet m = pcmp_eq(pivot, pset1<Packet>(Scalar(r)));
+          for(int c=0; c<Cols; ++c)
+          {
+            Packet bk = rhs[k+c*_Size];
+            rhs[k+c*_Size] = pselect(m, rhs[r+c*_Size], bk);
+            rhs[r+c*_Size] = pselect(m, bk, rhs[r+c*_Size]);
+          }
+        }
+      }
+
+      // forward substitution with the unit lower triangular factor
+      for(int k=0; k<_Size; ++k)
+        for(int r=k+1; r<_Size; ++r)
+          for(int c=0; c<Cols; ++c)
+            rhs[r+c*_Size] = psub(rhs[r+c*_Size], pmul(lu[r+k*_Size], rhs[k+c*_Size]));
+
+      // backward substitution with the upper triangular factor
+      for(int k=_Size-1; k>=0; --k)
+      {
+        Packet inv = pdiv(pset1<Packet>(Scalar(1)), lu[k+k*_Size]);
+        for(int c=0; c<Cols; ++c)
+        {
+          rhs[k+c*_Size] = pmul(rhs[k+c*_Size], inv);
+          for(int r=0; r<k; ++r)
+            rhs[r+c*_Size] = psub(rhs[r+c*_Size], pmul(lu[r+k*_Size], rhs[k+c*_Size]));
+        }
+      }
+    }
+
+    BatchedMatrixType m_lu;
+    TranspositionsType m_transpositions;
+    bool m_isInitialized;
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_BATCHED_PARTIALPIVLU_H
@@ -0,0 +1,418 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_ALGEBRAIC_MULTIGRID_H
+#define EIGEN_ALGEBRAIC_MULTIGRID_H
+
+#include <vector>
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal Copies the triangular part \a UpLo of \a mat into the full selfadjoint matrix \a dst */
+template<int UpLo> struct amg_full_matrix
+{
+  template<typename MatType, typename DestType>
+  static void run(const MatType& mat, DestType& dst) { dst = mat.template selfadjointView<UpLo>(); }
+};
+
+template<> struct amg_full_matrix<Lower|Upper>
+{
+  template<typename MatType, typename DestType>
+  static void run(const MatType& mat, DestType& dst) { dst = mat; }
+};
+
+} // end namespace internal
+
+/** \ingroup IterativeSolvers_Module
+  * \brief A smoothed aggregation algebraic multigrid preconditioner
+  *
+  * This class approximately solves for A.x = b by one V-cycle of a smoothed aggregation
+  * algebraic multigrid method. Its setup builds a hierarchy of coarser and coarser operators:
+  *  - the unknowns of a level are grouped into aggregates of strongly connected unknowns,
+  *    where i and j are strongly connected if \f$ |a_{ij}| \geq \theta \sqrt{|a_{ii} a_{jj}|} \f$,
+  *  - the piecewise constant tentative prolongator defined by the aggregates is smoothed by one step
+  *    of damped Jacobi, \f$ P = (I - \omega D^{-1} A) P_0 \f$,
+  *  - the coarse operator is the Galerkin product \f$ P^* A P \f$.
+  * The coarsening stops when the operator is small enough, which is then factorized by SparseLU.
+  * The V-cycle uses damped Jacobi as a smoother, and is symmetric such that this preconditioner can
+  * be used with ConjugateGradient as well as BiCGSTAB. It is well suited for Poisson like problems,
+  * for which the number of iterations stays about constant when the problem size grows.
+  *
+  * The aggregates and the tentative prolongators are computed by analyzePattern(), and reused by factorize(),
+  * which only recomputes the numerical values of the hierarchy. Solving a sequence of problems sharing the same
+  * pattern thus only requires to call factorize() for each new matrix:
+  * \code
+  * ConjugateGradient<SparseMatrix<double>, Lower|Upper, AlgebraicMultigridPreconditioner<double> > cg;
+  * cg.analyzePattern(A);
+  * for(...)
+  * {
+  *   cg.factorize(A);
+  *   x = cg.solve(b);
+  * }
+  * \endcode
+  *
+  * \tparam _Scalar the type of the scalar.
+  * \tparam _UpLo the triangular part of the matrix to reference: Lower or Upper if only one triangular part
+  *               of a selfadjoint matrix is stored, or Lower|Upper (the default) if the whole matrix is stored.
+  *               It does not have to match the _UpLo parameter of ConjugateGradient.
+  *
+  * \sa class DiagonalPreconditioner, class IncompleteCholesky, class ConjugateGradient, class BiCGSTAB
+  */
+template <typename _Scalar, int _UpLo = Lower|Upper>
+class AlgebraicMultigridPreconditioner : internal::noncopyable
+{
+  public:
+    typedef _Scalar Scalar;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    typedef SparseMatrix<Scalar,ColMajor> MatrixType;
+    typedef typename MatrixType::Index Index;
+    typedef Matrix<Scalar,Dynamic,1> Vector;
+    typedef Matrix<RealScalar,Dynamic,1> RealVector;
+    typedef Matrix<Index,Dynamic,1> IndexVector;
+    enum { UpLo = _UpLo };
+
+  protected:
+    struct Level
+    {
+      MatrixType A;           // the operator of this level
+      MatrixType P0;          // the tentative prolongator to the next level
+      MatrixType P;           // the smoothed prolongator to the next level
+      MatrixType R;           // the restriction P^*
+      Vector invDiag;         // omega / a_ii for the Jacobi smoother
+    };
+
+  public:
+
+    AlgebraicMultigridPreconditioner()
+      : m_threshold(0.08), m_maxCoarseSize(500), m_maxLevels(10), m_smoothingSteps(1),
+        m_analysisIsOk(false), m_factorizationIsOk(false), m_info(Success)
+    {}
+
+    template<typename MatType>
+    AlgebraicMultigridPreconditioner(const MatType& mat)
+      : m_threshold(0.08), m_maxCoarseSize(500), m_maxLevels(10), m_smoothingSteps(1),
+        m_analysisIsOk(false), m_factorizationIsOk(false), m_info(Success)
+    {
+      compute(mat);
+    }
+
+    Index rows() const { return m_levels.empty() ? 0 : m_levels[0].A.rows(); }
+    Index cols() const { return m_levels.empty() ? 0 : m_levels[0].A.cols(); }
+
+    /** \brief Reports whether previous computation was successful.
+      *
+      * \returns \c Success if computation was succesful,
+      *          \c NumericalIssue if the coarsest operator is singular.
+      */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_analysisIsOk && "AlgebraicMultigridPreconditioner is not initialized.");
+      return m_info;
+    }
+
+    /** Sets the threshold \f$ \theta \f$ of the strength of connection on the finest level (default is 0.08).
+      * It is halved on each coarser level. Larger values lead to smaller aggregates. */
+    void setStrengthThreshold(const RealScalar& threshold) { m_threshold = threshold; }
+
+    /** Sets the size below which an operator is not coarsened anymore but factorized (default is 500). */
+    void setMaxCoarseSize(Index size) { m_maxCoarseSize = size; }
+
+    /** Sets the maximal number of levels of the hierarchy, including the finest one (default is 10). */
+    void setMaxLevels(int levels) { m_maxLevels = levels; }
+
+    /** Sets the number of Jacobi sweeps before and after each coarse correction (default is 1). */
+    void setSmoothingSteps(int steps) { m_smoothingSteps = steps; }
+
+    /** \returns the number of levels of the hierarchy, including the finest one */
+    int levels() const { return int(m_levels.size()); }
+
+    /** \returns the operator complexity, i.e., the sum of the number of non zeros of the operators
+      * of all the levels divided by the number of non zeros of the finest one */
+    RealScalar operatorComplexity() const
+    {
+      if(m_levels.empty() || m_levels[0].A.nonZeros()==0)
+        return RealScalar(1);
+      Index nnz = 0;
+      for(std::size_t l=0; l<m_levels.size(); ++l)
+        nnz += m_levels[l].A.nonZeros();
+      return RealScalar(nnz) / RealScalar(m_levels[0].A.nonZeros());
+    }
+
+    /** Computes the aggregates and the tentative prolongators of the hierarchy of \a mat.
+      * They only depend on the structure and the magnitude of the entries of \a mat,
+      * and are reused by the subsequent calls to factorize(). */
+    template<typename MatType>
+    AlgebraicMultigridPreconditioner& analyzePattern(const MatType& mat)
+    {
+      m_levels.clear();
+      m_levels.push_back(Level());
+      internal::amg_full_matrix<UpLo>::run(mat, m_levels[0].A);
+      m_levels[0].A.makeCompressed();
+      RealScalar threshold = m_threshold;
+      while(true)
+      {
+        Level& level = m_levels.back();
+        const Index n = level.A.cols();
+        if(n<=m_maxCoarseSize || int(m_levels.size())>=m_maxLevels)
+          break;
+        IndexVector aggregates;
+        const Index nc = aggregate(level.A, threshold, aggregates);
+        if(nc==0 || nc>=n)
+          break;
+        tentativeProlongator(aggregates, nc, level.P0);
+        Level coarse;
+        smoothLevel(level);
+        galerkinProduct(level, coarse.A);
+        m_levels.push_back(coarse);
+        threshold /= RealScalar(2);
+      }
+      m_coarseSolver.analyzePattern(m_levels.back().A);
+      m_analysisIsOk = true;
+      m_factorizationIsOk = false;
+      return *this;
+    }
+
+    /** Computes the numerical values of the hierarchy of \a mat, reusing the aggregates computed by analyzePattern().
+      * \a mat must have the same sparsity pattern as the matrix given to analyzePattern(). */
+    template<typename MatType>
+    AlgebraicMultigridPreconditioner& factorize(const MatType& mat)
+    {
+      eigen_assert(m_analysisIsOk && "analyzePattern() should be called first");
+      internal::amg_full_matrix<UpLo>::run(mat, m_levels[0].A);
+      m_levels[0].A.makeCompressed();
+      for(std::size_t l=0; l+1<m_levels.size(); ++l)
+      {
+        smoothLevel(m_levels[l]);
+        galerkinProduct(m_levels[l], m_levels[l+1].A);
+      }
+      m_coarseSolver.factorize(m_levels.back().A);
+      m_info = m_coarseSolver.info();
+      m_factorizationIsOk = true;
+      return *this;
+    }
+
+    template<typename MatType>
+    AlgebraicMultigridPreconditioner& compute(const MatType& mat)
+    {
+      analyzePattern(mat);
+      if(m_levels.size()==1)
+        return factorize(mat);
+      // the hierarchy has just been computed from mat, only the coarsest operator remains to be factorized
+      m_coarseSolver.factorize(m_levels.back().A);
+      m_info = m_coarseSolver.info();
+      m_factorizationIsOk = true;
+      return *this;
+    }
+
+    template<typename Rhs, typename Dest>
+    void _solve(const Rhs& b, Dest& x) const
+    {
+      Vector bj, xj;
+      for(Index j=0; j<b.cols(); ++j)
+      {
+        bj = b.col(j);
+        vcycle(0, bj, xj);
+        x.col(j) = xj;
+      }
+    }
+
+    template<typename Rhs> inline const internal::solve_retval<AlgebraicMultigridPreconditioner, Rhs>
+    solve(const MatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_factorizationIsOk && "AlgebraicMultigridPreconditioner is not initialized.");
+      eigen_assert(cols()==b.rows()
+                && "AlgebraicMultigridPreconditioner::solve(): invalid number of rows of the right hand side matrix b");
+      return internal::solve_retval<AlgebraicMultigridPreconditioner, Rhs>(*this, b.derived());
+    }
+
+  protected:
+
+    /** \internal Groups the unknowns of \a A into aggregates of strongly connected unknowns:
+      *  1 - an unknown whose strong neighbors are all free forms a new aggregate with them,
+      *  2 - the remaining unknowns join an aggregate of the first phase they are strongly connected to,
+      *  3 - the still remaining unknowns form new aggregates with their free strong neighbors.
+      * \returns the number of aggregates, \a aggregates[i] being the aggregate of the unknown i */
+    static Index aggregate(const MatrixType& A, const RealScalar& threshold, IndexVector& aggregates)
+    {
+      using std::abs;
+      const Index n = A.cols();
+      const Index* outer = A.outerIndexPtr();
+      const Index* inner = A.innerIndexPtr();
+      const Scalar* values = A.valuePtr();
+      RealVector diag(n);
+      for(Index j=0; j<n; ++j)
+        diag(j) = abs(A.coeff(j,j));
+
+      // strong(k) tells whether the k-th entry of A is a strong off-diagonal connection
+      Matrix<bool,Dynamic,1> strong(A.nonZeros());
+      const RealScalar threshold2 = threshold * threshold;
+      for(Index j=0; j<n; ++j)
+        for(Index k=outer[j]; k<outer[j+1]; ++k)
+          strong(k) = inner[k]!=j && numext::abs2(values[k]) >= threshold2 * diag(inner[k]) * diag(j);
+
+      aggregates.setConstant(n, -1);
+      Index nc = 0;
+      // phase 1
+      for(Index j=0; j<n; ++j)
+      {
+        if(aggregates(j)>=0)
+          continue;
+        bool isFree = true;
+        for(Index k=outer[j]; k<outer[j+1] && isFree; ++k)
+          isFree = !strong(k) || aggregates(inner[k])<0;
+        if(!isFree)
+          continue;
+        aggregates(j) = nc;
+        for(Index k=outer[j]; k<outer[j+1]; ++k)
+          if(strong(k))
+            aggregates(inner[k]) = nc;
+        ++nc;
+      }
+      // phase 2
+      IndexVector firstPhase = aggregates;
+      for(Index j=0; j<n; ++j)
+      {
+        if(aggregates(j)>=0)
+          continue;
+        for(Index k=outer[j]; k<outer[j+1]; ++k)
+          if(strong(k) && firstPhase(inner[k])>=0)
+          {
+            aggregates(j) = firstPhase(inner[k]);
+            break;
+          }
+      }
+      // phase 3
+      for(Index j=0; j<n; ++j)
+      {
+        if(aggregates(j)>=0)
+          continue;
+        aggregates(j) = nc;
+        for(Index k=outer[j]; k<outer[j+1]; ++k)
+          if(strong(k) && aggregates(inner[k])<0)
+            aggregates(inner[k]) = nc;
+        ++nc;
+      }
+      return nc;
+    }
+
+    /** \internal Builds the piecewise constant prolongator of \a aggregates, having orthonormal columns */
+    static void tentativeProlongator(const IndexVector& aggregates, Index nc, MatrixType& P0)
+    {
+      using std::sqrt;
+      const Index n = aggregates.size();
+      IndexVector sizes = IndexVector::Zero(nc);
+      for(Index i=0; i<n; ++i)
+        ++sizes(aggregates(i));
+      typedef Triplet<Scalar,Index> TripletType;
+      std::vector<TripletType> triplets;
+      triplets.reserve(n);
+      for(Index i=0; i<n; ++i)
+        triplets.push_back(TripletType(i, aggregates(i), Scalar(RealScalar(1)/sqrt(RealScalar(sizes(aggregates(i)))))));
+      P0.resize(n, nc);
+      P0.setFromTriplets(triplets.begin(), triplets.end());
+    }
+
+    /** \internal Computes the Jacobi smoother and the smoothed prolongator of \a level.
+      * The damping factor is 4/3 over an upper bound of the spectral radius of \f$ D^{-1} A \f$. */
+    static void smoothLevel(Level& level)
+    {
+      using std::abs;
+      const MatrixType& A = level.A;
+      const Index n = A.cols();
+      RealVector rowSums = RealVector::Zero(n);
+      Vector diag = Vector::Zero(n);
+      for(Index j=0; j<n; ++j)
+        for(typename MatrixType::InnerIterator it(A,j); it; ++it)
+        {
+          rowSums(it.index()) += abs(it.value());
+          if(it.index()==j)
+            diag(j) = it.value();
+        }
+      RealScalar rho(0);
+      level.invDiag.resize(n);
+      for(Index i=0; i<n; ++i)
+      {
+        // the unknowns having a zero diagonal entry are left untouched by the smoother
+        if(diag(i)==Scalar(0))
+        {
+          level.invDiag(i) = Scalar(0);
+          continue;
+        }
+        level.invDiag(i) = Scalar(1)/diag(i);
+        rho = (std::max)(rho, rowSums(i)/abs(diag(i)));
+      }
+      if(rho>RealScalar(0))
+        level.invDiag *= RealScalar(4)/(RealScalar(3)*rho);
+      if(level.P0.cols()>0)
+      {
+        MatrixType AP0 = A * level.P0;
+        level.P = level.P0 - level.invDiag.asDiagonal() * AP0;
+      }
+    }
+
+    /** \internal Computes the restriction of \a level and the coarse operator \a Ac = R A P */
+    static void galerkinProduct(Level& level, MatrixType& Ac)
+    {
+      level.R = level.P.adjoint();
+      MatrixType AP = level.A * level.P;
+      Ac = level.R * AP;
+      Ac.makeCompressed();
+    }
+
+    /** \internal Applies one V-cycle from the level \a l to \a b, starting from a zero initial guess */
+    void vcycle(std::size_t l, const Vector& b, Vector& x) const
+    {
+      if(l+1==m_levels.size())
+      {
+        x = m_coarseSolver.solve(b);
+        return;
+      }
+      const Level& level = m_levels[l];
+      x = level.invDiag.cwiseProduct(b);
+      for(int k=1; k<m_smoothingSteps; ++k)
+        x += level.invDiag.cwiseProduct(b - level.A * x);
+      Vector bc = level.R * (b - level.A * x);
+      Vector xc;
+      vcycle(l+1, bc, xc);
+      x += level.P * xc;
+      for(int k=0; k<m_smoothingSteps; ++k)
+        x += level.invDiag.cwiseProduct(b - level.A * x);
+    }
+
+    std::vector<Level> m_levels;
+    SparseLU<MatrixType> m_coarseSolver;
+    RealScalar m_threshold;
+    Index m_maxCoarseSize;
+    int m_maxLevels;
+    int m_smoothingSteps;
+    bool m_analysisIsOk;
+    bool m_factorizationIsOk;
+    ComputationInfo m_info;
+};
+
+namespace internal {
+
+template<typename _Scalar, int _UpLo, typename Rhs>
+struct solve_retval<AlgebraicMultigridPreconditioner<_Scalar,_UpLo>, Rhs>
+  : solve_retval_base<AlgebraicMultigridPreconditioner<_Scalar,_UpLo>, Rhs>
+{
+  typedef AlgebraicMultigridPreconditioner<_Scalar,_UpLo> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec()._solve(rhs(),dst);
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_ALGEBRAIC_MULTIGRID_H
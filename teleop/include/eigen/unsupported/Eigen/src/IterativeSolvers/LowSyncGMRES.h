@@ -0,0 +1,380 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_LOWSYNC_GMRES_H
+#define EIGEN_LOWSYNC_GMRES_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal Computes \a h = V.leftCols(k)^* V.col(k-1) in a single pass over the k first columns of \a V,
+  * i.e., the dot products of the column k-1 with the previous ones, followed by its squared norm.
+  * The rows are split over several threads for large vectors, each thread reducing its own partial products. */
+template<typename BasisType, typename VectorType>
+void lowsync_gmres_project(const BasisType& V, DenseIndex k, VectorType& h)
+{
+  const DenseIndex size = V.rows();
+  const DenseIndex threads = parallel_assign_threads(size*k);
+  if(threads==1)
+  {
+    h.noalias() = V.leftCols(k).adjoint() * V.col(k-1);
+    return;
+  }
+  Matrix<typename VectorType::Scalar,Dynamic,Dynamic> partial(k, threads);
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for num_threads(int(threads)) schedule(static,1)
+#endif
+  for(DenseIndex t=0; t<threads; ++t)
+  {
+    const DenseIndex start = (size*t)/threads, len = (size*(t+1))/threads - start;
+    partial.col(t).noalias() = V.block(start,0,len,k).adjoint() * V.col(k-1).segment(start,len);
+  }
+  h = partial.rowwise().sum();
+}
+
+/** \internal Computes V.col(k) = (V.col(k) - V.leftCols(k) h) / \a norm in a single pass over the k+1 first columns of \a V */
+template<typename BasisType, typename VectorType>
+void lowsync_gmres_orthogonalize(BasisType& V, DenseIndex k, const VectorType& h, const typename VectorType::RealScalar& norm)
+{
+  typedef typename VectorType::RealScalar RealScalar;
+  const DenseIndex size = V.rows();
+  const DenseIndex threads = parallel_assign_threads(size*(k+1));
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for num_threads(int(threads)) schedule(static,1) if(threads>1)
+#endif
+  for(DenseIndex t=0; t<threads; ++t)
+  {
+    const DenseIndex start = (size*t)/threads, len = (size*(t+1))/threads - start;
+    V.col(k).segment(start,len).noalias() -= V.block(start,0,len,k) * h;
+    if(norm != RealScalar(1))
+      V.col(k).segment(start,len) /= norm;
+  }
+}
+
+/**
+ * Generalized Minimal Residual Algorithm with a low synchronization Arnoldi process.
+ *
+ * The Krylov basis of the right preconditioned operator A M^-1 is orthogonalized by classical Gram-Schmidt.
+ * The projections on the previous basis vectors and the norm of the new vector are obtained together by a single
+ * product of the basis by this vector, i.e., by a single reduction, the norm of the orthogonalized vector following
+ * from Pythagoras' theorem. The new vector is then orthogonalized and normalized in a single pass. When the
+ * orthogonalization cancels more than half of the norm of the vector, which is when the classical Gram-Schmidt process
+ * loses orthogonality, it is repeated once (CGS2). With right preconditioning, the estimated residual is the one of
+ * the unpreconditioned system, and the true residual is checked at each restart.
+ *
+ * Parameters:
+ *  \param mat       matrix of linear system of equations
+ *  \param Rhs       right hand side vector of linear system of equations
+ *  \param x         on input: initial guess, on output: solution
+ *  \param precond   preconditioner used
+ *  \param iters     on input: maximum number of iterations to perform
+ *                   on output: number of iterations performed
+ *  \param restart   number of iterations for a restart
+ *  \param tol_error on input: relative residual tolerance
+ *                   on output: relative residual achieved
+ *  \param flexible  whether the preconditioned basis vectors are stored and used for the update of x
+ *                   (flexible GMRES), which is required when the preconditioner is not exactly linear,
+ *                   e.g., when it works in a lower precision
+ *
+ * References:
+ *
+ * Saad, Y.
+ * Iterative Methods for Sparse Linear Systems.
+ * Society for Industrial and Applied Mathematics, Philadelphia, 2003.
+ *
+ * Swirydowicz, K., Langou, J., Ananthan, S., Yang, U. and Thomas, S.
+ * Low synchronization Gram-Schmidt and generalized minimal residual algorithms.
+ * Numer. Linear Algebra Appl. 28(2), 2021.
+ */
+template<typename MatrixType, typename Rhs, typename Dest, typename Preconditioner>
+bool lowsync_gmres(const MatrixType & mat, const Rhs & rhs, Dest & x, const Preconditioner & precond,
+                   int &iters, const int &restart, typename Dest::RealScalar & tol_error, bool flexible = false)
+{
+  using std::sqrt;
+  using std::abs;
+
+  typedef typename Dest::RealScalar RealScalar;
+  typedef typename Dest::Scalar Scalar;
+  typedef Matrix < Scalar, Dynamic, 1 > VectorType;
+  typedef Matrix < Scalar, Dynamic, Dynamic > FMatrixType;
+
+  const RealScalar tol = tol_error;
+  const int maxIters = iters;
+  iters = 0;
+
+  const int n = mat.rows();
+  const int m = (std::max)(1, (std::min)(restart, n));
+
+  const RealScalar rhsNorm = rhs.norm();
+  if(rhsNorm == RealScalar(0))
+  {
+    x.setZero();
+    tol_error = 0;
+    return true;
+  }
+
+  FMatrixType V(n, m + 1);              // Krylov basis
+  FMatrixType Z(n, flexible ? m : 0);   // preconditioned basis of the flexible variant
+  FMatrixType H = FMatrixType::Zero(m + 1, m); // Hessenberg matrix
+  VectorType g(m + 1), h(m + 1), h2(m + 1), t(n);
+  std::vector < JacobiRotation < Scalar > > G(m);
+
+  while(true)
+  {
+    V.col(0) = rhs - mat * x;
+    const RealScalar beta = V.col(0).norm();
+    tol_error = beta / rhsNorm;
+    if(tol_error <= tol || iters >= maxIters)
+      return true;
+    V.col(0) /= beta;
+    g.setZero();
+    g(0) = beta;
+    H.setZero();
+
+    int k = 0;
+    bool breakdown = false;
+    while(k < m && iters < maxIters)
+    {
+      // new basis vector w = A M^-1 v_k
+      t = precond.solve(V.col(k));
+      if(flexible)
+        Z.col(k) = t;
+      V.col(k + 1).noalias() = mat * t;
+      ++iters;
+
+      // dot products with the previous basis vectors and squared norm, in a single pass
+      lowsync_gmres_project(V, k + 2, h);
+      const RealScalar wNorm2 = numext::real(h(k + 1));
+      RealScalar hNorm2 = wNorm2 - h.head(k + 1).squaredNorm();
+      if(hNorm2 <= RealScalar(0.5) * wNorm2)
+      {
+        // severe cancellation: orthogonalize twice, and compute the norm explicitly
+        lowsync_gmres_orthogonalize(V, k + 1, h.head(k + 1), RealScalar(1));
+        h2.head(k + 1).noalias() = V.leftCols(k + 1).adjoint() * V.col(k + 1);
+        lowsync_gmres_orthogonalize(V, k + 1, h2.head(k + 1), RealScalar(1));
+        h.head(k + 1) += h2.head(k + 1);
+        hNorm2 = V.col(k + 1).squaredNorm();
+        if(hNorm2 > RealScalar(0))
+          V.col(k + 1) /= sqrt(hNorm2);
+      }
+      else
+        lowsync_gmres_orthogonalize(V, k + 1, h.head(k + 1), sqrt(hNorm2));
+      const RealScalar hNorm = sqrt((std::max)(hNorm2, RealScalar(0)));
+
+      // apply the previous Givens rotations to the new column of H, and eliminate its subdiagonal entry
+      H.col(k).head(k + 1) = h.head(k + 1);
+      H(k + 1, k) = hNorm;
+      for(int i = 0; i < k; ++i)
+        H.col(k).applyOnTheLeft(i, i + 1, G[i].adjoint());
+      G[k].makeGivens(H(k, k), H(k + 1, k));
+      H.col(k).applyOnTheLeft(k, k + 1, G[k].adjoint());
+      g.applyOnTheLeft(k, k + 1, G[k].adjoint());
+      ++k;
+
+      breakdown = hNorm == RealScalar(0) || H(k - 1, k - 1) == Scalar(0);
+      if(breakdown || abs(g(k)) <= tol * rhsNorm)
+        break;
+    }
+
+    // x += M^-1 V y, where H y = g, discarding the last basis vector if H is singular
+    const bool singular = breakdown && H(k - 1, k - 1) == Scalar(0);
+    if(singular)
+      --k;
+    if(k > 0)
+    {
+      VectorType y = g.head(k);
+      H.topLeftCorner(k, k).template triangularView < Eigen::Upper > ().solveInPlace(y);
+      if(flexible)
+        x.noalias() += Z.leftCols(k) * y;
+      else
+      {
+        t.noalias() = V.leftCols(k) * y;
+        x += precond.solve(t);
+      }
+    }
+
+    if(singular)
+    {
+      tol_error = (rhs - mat * x).norm() / rhsNorm;
+      return false;
+    }
+  }
+}
+
+}
+
+template< typename _MatrixType,
+          typename _Preconditioner = DiagonalPreconditioner<typename _MatrixType::Scalar> >
+class LowSyncGMRES;
+
+namespace internal {
+
+template< typename _MatrixType, typename _Preconditioner>
+struct traits<LowSyncGMRES<_MatrixType,_Preconditioner> >
+{
+  typedef _MatrixType MatrixType;
+  typedef _Preconditioner Preconditioner;
+};
+
+}
+
+/** \ingroup IterativeSolvers_Module
+  * \brief A GMRES solver for sparse square problems, with one synchronization point per iteration
+  *
+  * This class solves for A.x = b sparse linear problems using a generalized minimal residual method,
+  * like GMRES and with the same API. Instead of Householder reflections, which apply each basis vector
+  * one after the other, the Krylov basis is orthogonalized by classical Gram-Schmidt: all the dot products
+  * and the norm of the new vector are computed by a single product with the basis, and the vector is then
+  * orthogonalized and normalized in a single pass. A second orthogonalization is performed only when
+  * a severe cancellation is detected. Each iteration thus reads the basis about twice, instead of
+  * four times per basis vector for GMRES, and has a single reduction, which is multithreaded for large problems.
+  *
+  * The problem is right preconditioned, such that the tolerance applies to the relative residual
+  * \f$ |b-Ax|/|b| \f$ of the original problem, as for ConjugateGradient and BiCGSTAB.
+  *
+  * \tparam _MatrixType the type of the sparse matrix A, can be a dense or a sparse matrix.
+  * \tparam _Preconditioner the type of the preconditioner. Default is DiagonalPreconditioner
+  *
+  * The maximal number of iterations and tolerance value can be controlled via the setMaxIterations()
+  * and setTolerance() methods. The defaults are the size of the problem for the maximal number of iterations
+  * and NumTraits<Scalar>::epsilon() for the tolerance.
+  *
+  * \code
+  * LowSyncGMRES<SparseMatrix<double> > solver(A);
+  * solver.set_restart(50);
+  * x = solver.solve(b);
+  * std::cout << "#iterations:     " << solver.iterations() << std::endl;
+  * std::cout << "estimated error: " << solver.error()      << std::endl;
+  * \endcode
+  *
+  * By default the iterations start with x=0 as an initial guess of the solution.
+  * One can control the start using the solveWithGuess() method.
+  *
+  * \sa class GMRES, class PipelinedConjugateGradient
+  */
+template< typename _MatrixType, typename _Preconditioner>
+class LowSyncGMRES : public IterativeSolverBase<LowSyncGMRES<_MatrixType,_Preconditioner> >
+{
+  typedef IterativeSolverBase<LowSyncGMRES> Base;
+  using Base::mp_matrix;
+  using Base::m_error;
+  using Base::m_iterations;
+  using Base::m_info;
+  using Base::m_isInitialized;
+
+private:
+  int m_restart;
+
+public:
+  typedef _MatrixType MatrixType;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef _Preconditioner Preconditioner;
+
+public:
+
+  /** Default constructor. */
+  LowSyncGMRES() : Base(), m_restart(30) {}
+
+  /** Initialize the solver with matrix \a A for further \c Ax=b solving.
+    *
+    * This constructor is a shortcut for the default constructor followed
+    * by a call to compute().
+    *
+    * \warning this class stores a reference to the matrix A as well as some
+    * precomputed values that depend on it. Therefore, if \a A is changed
+    * this class becomes invalid. Call compute() to update it with the new
+    * matrix A, or modify a copy of A.
+    */
+  template<typename MatrixDerived>
+  explicit LowSyncGMRES(const EigenBase<MatrixDerived>& A) : Base(A.derived()), m_restart(30) {}
+
+  ~LowSyncGMRES() {}
+
+  /** Get the number of iterations after that a restart is performed.
+    */
+  int get_restart() { return m_restart; }
+
+  /** Set the number of iterations after that a restart is performed.
+    *  \param restart   number of iterations for a restart, default is 30.
+    */
+  void set_restart(const int restart) { m_restart=restart; }
+
+  /** \returns the solution x of \f$ A x = b \f$ using the current decomposition of A
+    * \a x0 as an initial solution.
+    *
+    * \sa compute()
+    */
+  template<typename Rhs,typename Guess>
+  inline const internal::solve_retval_with_guess<LowSyncGMRES, Rhs, Guess>
+  solveWithGuess(const MatrixBase<Rhs>& b, const Guess& x0) const
+  {
+    eigen_assert(m_isInitialized && "LowSyncGMRES is not initialized.");
+    eigen_assert(Base::rows()==b.rows()
+              && "LowSyncGMRES::solve(): invalid number of rows of the right hand side matrix b");
+    return internal::solve_retval_with_guess
+            <LowSyncGMRES, Rhs, Guess>(*this, b.derived(), x0);
+  }
+
+  /** \internal */
+  template<typename Rhs,typename Dest>
+  void _solveWithGuess(const Rhs& b, Dest& x) const
+  {
+    bool failed = false;
+    RealScalar error(0);
+    for(int j=0; j<b.cols(); ++j)
+    {
+      m_iterations = Base::maxIterations();
+      m_error = Base::m_tolerance;
+
+      typename Dest::ColXpr xj(x,j);
+      if(!internal::lowsync_gmres(*mp_matrix, b.col(j), xj, Base::m_preconditioner, m_iterations, m_restart, m_error))
+        failed = true;
+      error = (std::max)(error, m_error);
+    }
+    m_error = error;
+    m_info = failed ? NumericalIssue
+           : m_error <= Base::m_tolerance ? Success
+           : NoConvergence;
+    m_isInitialized = true;
+  }
+
+  /** \internal */
+  template<typename Rhs,typename Dest>
+  void _solve(const Rhs& b, Dest& x) const
+  {
+    x.setZero();
+    _solveWithGuess(b,x);
+  }
+
+protected:
+
+};
+
+
+namespace internal {
+
+template<typename _MatrixType, typename _Preconditioner, typename Rhs>
+struct solve_retval<LowSyncGMRES<_MatrixType, _Preconditioner>, Rhs>
+  : solve_retval_base<LowSyncGMRES<_MatrixType, _Preconditioner>, Rhs>
+{
+  typedef LowSyncGMRES<_MatrixType, _Preconditioner> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec()._solve(rhs(),dst);
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_LOWSYNC_GMRES_H
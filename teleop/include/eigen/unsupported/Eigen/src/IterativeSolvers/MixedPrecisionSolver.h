@@ -0,0 +1,378 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_MIXED_PRECISION_SOLVER_H
+#define EIGEN_MIXED_PRECISION_SOLVER_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal The scalar type of the factorization of a MixedPrecisionSolver working on \a Scalar */
+template<typename Scalar> struct mixed_precision_low_scalar { typedef Scalar type; };
+template<> struct mixed_precision_low_scalar<double> { typedef float type; };
+template<> struct mixed_precision_low_scalar<long double> { typedef double type; };
+template<> struct mixed_precision_low_scalar<std::complex<double> > { typedef std::complex<float> type; };
+
+/** \internal Rebinds the scalar type of a matrix type to \a NewScalar */
+template<typename MatrixType, typename NewScalar> struct mixed_precision_rebind_matrix;
+
+template<typename S, int Rows, int Cols, int Options, int MaxRows, int MaxCols, typename NewScalar>
+struct mixed_precision_rebind_matrix<Matrix<S,Rows,Cols,Options,MaxRows,MaxCols>, NewScalar>
+{ typedef Matrix<NewScalar,Rows,Cols,Options,MaxRows,MaxCols> type; };
+
+template<typename S, int Options, typename Index, typename OuterIndex, typename NewScalar>
+struct mixed_precision_rebind_matrix<SparseMatrix<S,Options,Index,OuterIndex>, NewScalar>
+{ typedef SparseMatrix<NewScalar,Options,Index,OuterIndex> type; };
+
+/** \internal Rebinds the scalar type of the matrix type of a decomposition to \a NewScalar */
+template<typename Decomposition, typename NewScalar> struct mixed_precision_rebind;
+
+// PartialPivLU, FullPivLU, HouseholderQR...
+template<template<typename> class Decomposition, typename MatrixType, typename NewScalar>
+struct mixed_precision_rebind<Decomposition<MatrixType>, NewScalar>
+{ typedef Decomposition<typename mixed_precision_rebind_matrix<MatrixType,NewScalar>::type> type; };
+
+// LLT, LDLT
+template<template<typename,int> class Decomposition, typename MatrixType, int UpLo, typename NewScalar>
+struct mixed_precision_rebind<Decomposition<MatrixType,UpLo>, NewScalar>
+{ typedef Decomposition<typename mixed_precision_rebind_matrix<MatrixType,NewScalar>::type, UpLo> type; };
+
+// SimplicialLLT, SimplicialLDLT
+template<template<typename,int,typename> class Decomposition, typename MatrixType, int UpLo, typename Ordering, typename NewScalar>
+struct mixed_precision_rebind<Decomposition<MatrixType,UpLo,Ordering>, NewScalar>
+{ typedef Decomposition<typename mixed_precision_rebind_matrix<MatrixType,NewScalar>::type, UpLo, Ordering> type; };
+
+// SparseLU
+template<template<typename,typename> class Decomposition, typename MatrixType, typename Ordering, typename NewScalar>
+struct mixed_precision_rebind<Decomposition<MatrixType,Ordering>, NewScalar>
+{ typedef Decomposition<typename mixed_precision_rebind_matrix<MatrixType,NewScalar>::type, Ordering> type; };
+
+/** \internal \returns the info() of the decomposition \a dec, or Success for the decompositions which cannot fail */
+template<typename Decomposition>
+ComputationInfo mixed_precision_info(const Decomposition& dec) { return dec.info(); }
+template<typename MatrixType>
+ComputationInfo mixed_precision_info(const PartialPivLU<MatrixType>&) { return Success; }
+template<typename MatrixType>
+ComputationInfo mixed_precision_info(const FullPivLU<MatrixType>&) { return Success; }
+template<typename MatrixType>
+ComputationInfo mixed_precision_info(const HouseholderQR<MatrixType>&) { return Success; }
+template<typename MatrixType>
+ComputationInfo mixed_precision_info(const FullPivHouseholderQR<MatrixType>&) { return Success; }
+
+/** \internal Solves in high precision with a low precision decomposition, the right hand side being scaled
+  * to avoid the underflows of the small residuals. This is the preconditioner of the GMRES refinement. */
+template<typename LowDecomposition, typename Scalar>
+class mixed_precision_low_solve
+{
+  public:
+    typedef Matrix<Scalar,Dynamic,1> VectorType;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    typedef typename LowDecomposition::MatrixType::Scalar LowScalar;
+    typedef Matrix<LowScalar,Dynamic,1> LowVectorType;
+
+    mixed_precision_low_solve(const LowDecomposition& dec) : m_dec(dec) {}
+
+    template<typename Rhs>
+    VectorType solve(const Rhs& b) const
+    {
+      const RealScalar scale = b.cwiseAbs().maxCoeff();
+      if(scale == RealScalar(0))
+        return VectorType::Zero(b.size());
+      LowVectorType lowB = (b / scale).template cast<LowScalar>();
+      LowVectorType lowX = m_dec.solve(lowB);
+      return lowX.template cast<Scalar>() * scale;
+    }
+
+  protected:
+    const LowDecomposition& m_dec;
+};
+
+} // end namespace internal
+
+/** \ingroup IterativeSolvers_Module
+  * \brief Mixed precision iterative refinement for dense and sparse direct solvers
+  *
+  * This class solves for A.x = b with the direct solver \a _Decomposition, e.g., PartialPivLU<MatrixXd>,
+  * LDLT<MatrixXd> or SimplicialLDLT<SparseMatrix<double> >, while factorizing A in single precision.
+  * This makes the factorization about twice as fast and halves its storage. The accuracy of the double
+  * precision solver is recovered by iterative refinement: the residual b - A x is computed in double precision,
+  * and the correction is solved with the single precision factors, until the normwise backward error
+  * \f$ \|b - A x\|_\infty / (\|A\|_\infty \|x\|_\infty) \f$ reaches the tolerance, and then as long as
+  * the residual is halved by each step, such that the accuracy matches the one of the double precision solver.
+  *
+  * The refinement converges when the condition number of A is well below the inverse of the single precision
+  * epsilon. When it stagnates, the correction equation is solved by GMRES preconditioned by the single precision
+  * factors (GMRES-IR), which handles much more ill-conditioned matrices. When this stagnates too, or when the
+  * matrix cannot be represented or factorized in single precision, A is factorized by \a _Decomposition in double
+  * precision, and the following solves use this factorization. usesLowPrecision() tells which factorization is used.
+  * \code
+  * MixedPrecisionSolver<PartialPivLU<MatrixXd> > solver(A);
+  * x = solver.solve(b);
+  * \endcode
+  *
+  * \tparam _Decomposition the double precision direct solver. The single precision factorization is the
+  *                        same decomposition with the matrix type rebound to the lower precision scalar type.
+  *
+  * \warning this class stores a reference to the matrix A, which is needed for the residuals, and therefore
+  * has to be stored entirely, even for the solvers of selfadjoint matrices. If \a A is changed, call compute() again.
+  *
+  * \sa class PartialPivLU, class LDLT, class SimplicialLDLT, class LowSyncGMRES
+  */
+template<typename _Decomposition>
+class MixedPrecisionSolver : internal::noncopyable
+{
+  public:
+    typedef _Decomposition Decomposition;
+    typedef typename Decomposition::MatrixType MatrixType;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    typedef typename MatrixType::Index Index;
+    typedef typename internal::mixed_precision_low_scalar<Scalar>::type LowScalar;
+    typedef typename NumTraits<LowScalar>::Real LowRealScalar;
+    typedef typename internal::mixed_precision_rebind<Decomposition,LowScalar>::type LowDecomposition;
+    typedef Matrix<Scalar,Dynamic,1> VectorType;
+    typedef Matrix<RealScalar,Dynamic,1> RealVectorType;
+
+    MixedPrecisionSolver()
+      : mp_matrix(0), m_tolerance(-1), m_maxIterations(30), m_gmresRefinement(true), m_isInitialized(false)
+    {}
+
+    explicit MixedPrecisionSolver(const MatrixType& A)
+      : mp_matrix(0), m_tolerance(-1), m_maxIterations(30), m_gmresRefinement(true), m_isInitialized(false)
+    {
+      compute(A);
+    }
+
+    /** Factorizes \a A in low precision if it can be represented in low precision, and in high precision otherwise. */
+    MixedPrecisionSolver& compute(const MatrixType& A)
+    {
+      mp_matrix = &A;
+      m_normA = (A.cwiseAbs() * RealVectorType::Ones(A.cols())).maxCoeff();
+      m_lowPrecision = m_normA <= RealScalar(NumTraits<LowRealScalar>::highest());
+      if(m_lowPrecision)
+      {
+        m_low.compute(A.template cast<LowScalar>());
+        m_lowPrecision = internal::mixed_precision_info(m_low) == Success;
+      }
+      if(m_lowPrecision)
+        m_info = Success;
+      else
+      {
+        m_high.compute(A);
+        m_info = internal::mixed_precision_info(m_high);
+      }
+      m_iterations = 0;
+      m_error = 0;
+      m_isInitialized = true;
+      return *this;
+    }
+
+    Index rows() const { return mp_matrix ? mp_matrix->rows() : 0; }
+    Index cols() const { return mp_matrix ? mp_matrix->cols() : 0; }
+
+    /** \returns \c Success if the factorization and the last solve succeeded, \c NumericalIssue if the
+      * high precision factorization failed, and \c NoConvergence if the refinement did not reach the tolerance. */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "MixedPrecisionSolver is not initialized.");
+      return m_info;
+    }
+
+    /** \returns the tolerance on the normwise backward error, by default the square root of the size of the
+      * matrix times the machine epsilon */
+    RealScalar tolerance() const
+    {
+      using std::sqrt;
+      return m_tolerance < RealScalar(0) ? sqrt(RealScalar(cols())) * NumTraits<RealScalar>::epsilon() : m_tolerance;
+    }
+
+    /** Sets the tolerance on the normwise backward error. */
+    MixedPrecisionSolver& setTolerance(const RealScalar& tolerance)
+    {
+      m_tolerance = tolerance;
+      return *this;
+    }
+
+    /** \returns the max number of refinement steps (default is 30) */
+    int maxIterations() const { return m_maxIterations; }
+
+    /** Sets the max number of refinement steps. */
+    MixedPrecisionSolver& setMaxIterations(int maxIters)
+    {
+      m_maxIterations = maxIters;
+      return *this;
+    }
+
+    /** Enables or disables the GMRES refinement when the classical refinement stagnates (enabled by default).
+      * When it is disabled, the high precision factorization is computed as soon as the classical refinement stagnates. */
+    MixedPrecisionSolver& setGmresRefinement(bool enable)
+    {
+      m_gmresRefinement = enable;
+      return *this;
+    }
+
+    /** \returns whether the solves use the low precision factorization, or the high precision one. */
+    bool usesLowPrecision() const { return m_lowPrecision; }
+
+    /** \returns the number of solves with the low precision factorization performed by the last solve,
+      * including the iterations of GMRES (the largest over the columns of the right hand side) */
+    int iterations() const { return m_iterations; }
+
+    /** \returns the normwise backward error of the last solve (the largest over the columns of the right hand side) */
+    RealScalar error() const { return m_error; }
+
+    /** \returns the low precision decomposition */
+    const LowDecomposition& lowPrecisionDecomposition() const { return m_low; }
+
+    /** \returns the solution x of \f$ A x = b \f$ */
+    template<typename Rhs> inline const internal::solve_retval<MixedPrecisionSolver, Rhs>
+    solve(const MatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_isInitialized && "MixedPrecisionSolver is not initialized.");
+      eigen_assert(rows()==b.rows()
+                && "MixedPrecisionSolver::solve(): invalid number of rows of the right hand side matrix b");
+      return internal::solve_retval<MixedPrecisionSolver, Rhs>(*this, b.derived());
+    }
+
+    /** \internal */
+    template<typename Rhs, typename Dest>
+    void _solve(const Rhs& b, Dest& x) const
+    {
+      m_iterations = 0;
+      m_error = 0;
+      m_info = m_lowPrecision ? Success : internal::mixed_precision_info(m_high);
+      VectorType bj, xj;
+      for(Index j=0; j<b.cols(); ++j)
+      {
+        bj = b.col(j);
+        int iters = 0;
+        RealScalar error(0);
+        if(!(m_lowPrecision && refine(bj, xj, iters, error)))
+        {
+          if(m_lowPrecision)
+          {
+            // the refinement stagnated: factorize in high precision
+            m_high.compute(*mp_matrix);
+            m_lowPrecision = false;
+            m_info = internal::mixed_precision_info(m_high);
+          }
+          xj = m_high.solve(bj);
+          error = backwardError(bj, xj);
+        }
+        x.col(j) = xj;
+        m_iterations = (std::max)(m_iterations, iters);
+        m_error = (std::max)(m_error, error);
+      }
+      if(m_info == Success && !(m_error <= tolerance()))
+        m_info = NoConvergence;
+    }
+
+  protected:
+
+    RealScalar backwardError(const VectorType& b, const VectorType& x) const
+    {
+      const RealScalar xNorm = x.template lpNorm<Infinity>();
+      if(xNorm == RealScalar(0))
+        return b.template lpNorm<Infinity>() == RealScalar(0) ? RealScalar(0) : NumTraits<RealScalar>::highest();
+      return (b - *mp_matrix * x).template lpNorm<Infinity>() / (m_normA * xNorm);
+    }
+
+    /** \internal Refines the low precision solution of \a b, first by the classical refinement and then
+      * by GMRES. Once the tolerance is reached, the refinement goes on as long as it halves the residual,
+      * and the best solution is kept. \returns false if the tolerance could not be reached. */
+    bool refine(const VectorType& b, VectorType& x, int& iters, RealScalar& error) const
+    {
+      internal::mixed_precision_low_solve<LowDecomposition,Scalar> lowSolve(m_low);
+      const RealScalar tol = tolerance();
+      const int restart = 30;
+      x = lowSolve.solve(b);
+      iters = 1;
+      VectorType r(b.size()), d(b.size()), xBest;
+      bool gmres = false, converged = false;
+      RealScalar previousNorm = NumTraits<RealScalar>::highest(), bestError(0);
+      for(int k=0; k<=m_maxIterations; ++k)
+      {
+        r.noalias() = b - *mp_matrix * x;
+        const RealScalar rNorm = r.template lpNorm<Infinity>();
+        const RealScalar xNorm = x.template lpNorm<Infinity>();
+        error = xNorm == RealScalar(0) ? (rNorm == RealScalar(0) ? RealScalar(0) : NumTraits<RealScalar>::highest())
+                                       : rNorm / (m_normA * xNorm);
+        if(!(rNorm <= NumTraits<RealScalar>::highest()))
+          break;
+        if(rNorm < previousNorm)
+        {
+          xBest = x;
+          bestError = error;
+        }
+        converged = converged || error <= tol;
+        // the residual has to be at least halved by each step
+        if(rNorm == RealScalar(0) || k == m_maxIterations || !(rNorm <= RealScalar(0.5) * previousNorm))
+        {
+          if(converged || k == m_maxIterations || gmres || !m_gmresRefinement)
+            break;
+          gmres = true;
+        }
+        previousNorm = (std::min)(rNorm, previousNorm);
+        if(gmres)
+        {
+          // solve the correction equation to a moderate accuracy by GMRES, preconditioned by the low precision factors
+          d.setZero();
+          int gmresIters = 2 * restart;
+          RealScalar gmresTol = RealScalar(NumTraits<LowRealScalar>::dummy_precision());
+          internal::lowsync_gmres(*mp_matrix, r, d, lowSolve, gmresIters, restart, gmresTol, true);
+          iters += gmresIters;
+        }
+        else
+        {
+          d = lowSolve.solve(r);
+          ++iters;
+        }
+        x += d;
+      }
+      if(xBest.size() > 0)
+      {
+        x.swap(xBest);
+        error = bestError;
+      }
+      return converged;
+    }
+
+    const MatrixType* mp_matrix;
+    LowDecomposition m_low;
+    mutable Decomposition m_high;
+    RealScalar m_normA;
+    RealScalar m_tolerance;
+    int m_maxIterations;
+    bool m_gmresRefinement;
+    mutable bool m_lowPrecision;
+    mutable int m_iterations;
+    mutable RealScalar m_error;
+    mutable ComputationInfo m_info;
+    bool m_isInitialized;
+};
+
+namespace internal {
+
+template<typename _Decomposition, typename Rhs>
+struct solve_retval<MixedPrecisionSolver<_Decomposition>, Rhs>
+  : solve_retval_base<MixedPrecisionSolver<_Decomposition>, Rhs>
+{
+  typedef MixedPrecisionSolver<_Decomposition> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec()._solve(rhs(),dst);
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_MIXED_PRECISION_SOLVER_H
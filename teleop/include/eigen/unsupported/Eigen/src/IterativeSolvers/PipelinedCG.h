@@ -0,0 +1,350 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_PIPELINED_CG_H
+#define EIGEN_PIPELINED_CG_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal Performs the vector updates of one pipelined CG iteration:
+  * \code
+  * z = n + beta z;  q = m + beta q;  s = w + beta s;  p = u + beta p;
+  * x += alpha p;    r -= alpha s;    u -= alpha q;    w -= alpha z;
+  * \endcode
+  * and computes the reductions of the next iteration, \a gamma = (r,u), \a delta = (u,w) and
+  * \a residualNorm2 = (r,r), in a single pass: the vectors are processed by blocks which stay in cache
+  * between the statements. The coefficients are split over several threads for large vectors. */
+template<typename Dest, typename VectorType>
+void pipelined_cg_update(Dest& x, VectorType& r, VectorType& u, VectorType& w,
+                         const VectorType& m, const VectorType& n,
+                         VectorType& z, VectorType& q, VectorType& s, VectorType& p,
+                         const typename VectorType::Scalar& alpha, const typename VectorType::Scalar& beta,
+                         typename VectorType::RealScalar& gamma, typename VectorType::RealScalar& delta,
+                         typename VectorType::RealScalar& residualNorm2)
+{
+  typedef typename VectorType::RealScalar RealScalar;
+  const DenseIndex size = r.size();
+  const DenseIndex blockSize = 1024;
+  const DenseIndex threads = parallel_assign_threads(size);
+  Matrix<RealScalar,3,Dynamic> partial(3, threads);
+
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for num_threads(int(threads)) schedule(static,1) if(threads>1)
+#endif
+  for(DenseIndex t=0; t<threads; ++t)
+  {
+    const DenseIndex start = (size*t)/threads, end = (size*(t+1))/threads;
+    RealScalar g(0), d(0), rn2(0);
+    for(DenseIndex i=start; i<end; i+=blockSize)
+    {
+      const DenseIndex len = (std::min)(blockSize, end-i);
+      z.segment(i,len) = n.segment(i,len) + beta * z.segment(i,len);
+      q.segment(i,len) = m.segment(i,len) + beta * q.segment(i,len);
+      s.segment(i,len) = w.segment(i,len) + beta * s.segment(i,len);
+      p.segment(i,len) = u.segment(i,len) + beta * p.segment(i,len);
+      x.segment(i,len) += alpha * p.segment(i,len);
+      r.segment(i,len) -= alpha * s.segment(i,len);
+      u.segment(i,len) -= alpha * q.segment(i,len);
+      w.segment(i,len) -= alpha * z.segment(i,len);
+      g   += numext::real(r.segment(i,len).dot(u.segment(i,len)));
+      d   += numext::real(u.segment(i,len).dot(w.segment(i,len)));
+      rn2 += r.segment(i,len).squaredNorm();
+    }
+    partial(0,t) = g;
+    partial(1,t) = d;
+    partial(2,t) = rn2;
+  }
+  gamma = partial.row(0).sum();
+  delta = partial.row(1).sum();
+  residualNorm2 = partial.row(2).sum();
+}
+
+/** \internal Low-level pipelined conjugate gradient algorithm
+  *
+  * This is the preconditioned pipelined CG of Ghysels and Vanroose. It is mathematically equivalent to the
+  * conjugate gradient, but its iterations only depend on the reductions of the previous one, such that all the
+  * reductions and vector updates of an iteration are computed in a single pass, while the product by the matrix
+  * and the preconditioner do not wait for any reduction. This costs four more vectors, and a slightly lower
+  * attainable accuracy. Therefore, when the recursively updated residual reaches the tolerance, the true residual
+  * is computed, and it replaces the updated one if it is still too large and decreasing. The returned error is
+  * always the one of the true residual, the updated one may stagnate far below it.
+  *
+  * \param mat The matrix A
+  * \param rhs The right hand side vector b
+  * \param x On input and initial solution, on output the computed solution.
+  * \param precond A preconditioner being able to efficiently solve for an
+  *                approximation of Ax=b (regardless of b)
+  * \param iters On input the max number of iteration, on output the number of performed iterations.
+  * \param tol_error On input the tolerance error, on output an estimation of the relative error.
+  *
+  * Reference: P. Ghysels and W. Vanroose, Hiding global synchronization latency in the preconditioned
+  * Conjugate Gradient algorithm, Parallel Computing 40(7), 2014, pp. 224-238.
+  */
+template<typename MatrixType, typename Rhs, typename Dest, typename Preconditioner>
+EIGEN_DONT_INLINE
+void pipelined_conjugate_gradient(const MatrixType& mat, const Rhs& rhs, Dest& x,
+                                  const Preconditioner& precond, int& iters,
+                                  typename Dest::RealScalar& tol_error)
+{
+  using std::sqrt;
+  typedef typename Dest::RealScalar RealScalar;
+  typedef typename Dest::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+
+  RealScalar tol = tol_error;
+  int maxIters = iters;
+
+  int n = mat.cols();
+
+  VectorType residual = rhs - mat * x; //initial residual
+
+  RealScalar rhsNorm2 = rhs.squaredNorm();
+  if(rhsNorm2 == 0)
+  {
+    x.setZero();
+    iters = 0;
+    tol_error = 0;
+    return;
+  }
+  RealScalar threshold = tol*tol*rhsNorm2;
+  RealScalar residualNorm2 = residual.squaredNorm();
+  if (residualNorm2 < threshold)
+  {
+    iters = 0;
+    tol_error = sqrt(residualNorm2 / rhsNorm2);
+    return;
+  }
+
+  VectorType u(n), w(n), m(n), nn(n), z(n), q(n), s(n), p(n);
+  RealScalar gamma(0), gammaOld(0), delta(0);
+  RealScalar trueNorm2 = residualNorm2;
+  Scalar alpha(0);
+  bool restart = true, checked = false;
+  int i = 0;
+  while(i < maxIters)
+  {
+    if(restart)
+    {
+      // (re)start the recurrences from the current residual
+      u = precond.solve(residual);
+      w.noalias() = mat * u;
+      gamma = numext::real(residual.dot(u));
+      delta = numext::real(u.dot(w));
+      z.setZero(); q.setZero(); s.setZero(); p.setZero();
+    }
+    else if(residualNorm2 < threshold)
+    {
+      // the recursively updated residual may have drifted away from the true one: check the latter
+      VectorType trueResidual = rhs - mat * x;
+      RealScalar newTrueNorm2 = trueResidual.squaredNorm();
+      // stop if it converged, or if it stagnates at the attainable accuracy
+      if(newTrueNorm2 < threshold || newTrueNorm2 > RealScalar(0.25) * trueNorm2)
+      {
+        residualNorm2 = newTrueNorm2;
+        checked = true;
+        break;
+      }
+      // otherwise restart from the true residual
+      residual = trueResidual;
+      residualNorm2 = trueNorm2 = newTrueNorm2;
+      restart = true;
+      continue;
+    }
+    if(gamma == RealScalar(0) || delta == RealScalar(0))
+      break;
+
+    m = precond.solve(w);
+    nn.noalias() = mat * m;               // the bottleneck of the algorithm
+
+    Scalar beta(0);
+    if(restart)
+      alpha = gamma / delta;
+    else
+    {
+      beta = gamma / gammaOld;
+      alpha = gamma / (delta - beta * gamma / alpha);
+    }
+    gammaOld = gamma;
+    restart = false;
+
+    pipelined_cg_update(x, residual, u, w, m, nn, z, q, s, p, alpha, beta, gamma, delta, residualNorm2);
+    i++;
+  }
+  if(!checked)
+    residualNorm2 = (rhs - mat * x).squaredNorm();
+  tol_error = sqrt(residualNorm2 / rhsNorm2);
+  iters = i;
+}
+
+}
+
+template< typename _MatrixType, int _UpLo=Lower,
+          typename _Preconditioner = DiagonalPreconditioner<typename _MatrixType::Scalar> >
+class PipelinedConjugateGradient;
+
+namespace internal {
+
+template< typename _MatrixType, int _UpLo, typename _Preconditioner>
+struct traits<PipelinedConjugateGradient<_MatrixType,_UpLo,_Preconditioner> >
+{
+  typedef _MatrixType MatrixType;
+  typedef _Preconditioner Preconditioner;
+};
+
+}
+
+/** \ingroup IterativeSolvers_Module
+  * \brief A pipelined conjugate gradient solver for sparse self-adjoint problems
+  *
+  * This class solves for A.x = b sparse linear problems like ConjugateGradient, with the same API,
+  * the same parameters, and in about the same number of iterations. The pipelined variant reorganizes
+  * the iterations such that the three dot products of an iteration are computed together with its vector updates,
+  * in a single pass over the vectors, instead of the five passes and two separated synchronization points
+  * of the standard algorithm. The matrix-vector product does not depend on any reduction of the same iteration.
+  * This makes each iteration cheaper when the vectors do not fit in cache, and when the products
+  * and the reductions are performed on several threads.
+  *
+  * The price is the storage of four more vectors, and a lower attainable accuracy: the recursively updated
+  * residual is checked against the true one, which replaces it if needed. Unlike ConjugateGradient, error()
+  * is the relative error |b - A.x| / |b| of the true residual of the returned solution.
+  *
+  * \tparam _MatrixType the type of the matrix A, can be a dense or a sparse matrix.
+  * \tparam _UpLo the triangular part that will be used for the computations. It can be Lower,
+  *               Upper, or Lower|Upper in which the full matrix entries will be considered. Default is Lower.
+  * \tparam _Preconditioner the type of the preconditioner. Default is DiagonalPreconditioner
+  *
+  * \b Multithreading: when OpenMP is enabled, the vector updates and reductions are split over Eigen::nbThreads()
+  * threads for large problems, and the matrix-vector products are multithreaded as in ConjugateGradient.
+  *
+  * \sa class ConjugateGradient, class LowSyncGMRES
+  */
+template< typename _MatrixType, int _UpLo, typename _Preconditioner>
+class PipelinedConjugateGradient : public IterativeSolverBase<PipelinedConjugateGradient<_MatrixType,_UpLo,_Preconditioner> >
+{
+  typedef IterativeSolverBase<PipelinedConjugateGradient> Base;
+  using Base::mp_matrix;
+  using Base::m_error;
+  using Base::m_iterations;
+  using Base::m_info;
+  using Base::m_isInitialized;
+public:
+  typedef _MatrixType MatrixType;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef _Preconditioner Preconditioner;
+
+  enum {
+    UpLo = _UpLo
+  };
+
+public:
+
+  /** Default constructor. */
+  PipelinedConjugateGradient() : Base() {}
+
+  /** Initialize the solver with matrix \a A for further \c Ax=b solving.
+    *
+    * This constructor is a shortcut for the default constructor followed
+    * by a call to compute().
+    *
+    * \warning this class stores a reference to the matrix A as well as some
+    * precomputed values that depend on it. Therefore, if \a A is changed
+    * this class becomes invalid. Call compute() to update it with the new
+    * matrix A, or modify a copy of A.
+    */
+  template<typename MatrixDerived>
+  explicit PipelinedConjugateGradient(const EigenBase<MatrixDerived>& A) : Base(A.derived()) {}
+
+  ~PipelinedConjugateGradient() {}
+
+  /** \returns the solution x of \f$ A x = b \f$ using the current decomposition of A
+    * \a x0 as an initial solution.
+    *
+    * \sa compute()
+    */
+  template<typename Rhs,typename Guess>
+  inline const internal::solve_retval_with_guess<PipelinedConjugateGradient, Rhs, Guess>
+  solveWithGuess(const MatrixBase<Rhs>& b, const Guess& x0) const
+  {
+    eigen_assert(m_isInitialized && "PipelinedConjugateGradient is not initialized.");
+    eigen_assert(Base::rows()==b.rows()
+              && "PipelinedConjugateGradient::solve(): invalid number of rows of the right hand side matrix b");
+    return internal::solve_retval_with_guess
+            <PipelinedConjugateGradient, Rhs, Guess>(*this, b.derived(), x0);
+  }
+
+  /** \internal */
+  template<typename Rhs,typename Dest>
+  void _solveWithGuess(const Rhs& b, Dest& x) const
+  {
+    // same matrix wrappers as ConjugateGradient
+    enum {
+      TransposeInput = (UpLo==(Lower|Upper))
+                    && (!MatrixType::IsRowMajor)
+                    && (!NumTraits<Scalar>::IsComplex)
+                    && internal::is_same<typename internal::traits<MatrixType>::StorageKind,Sparse>::value
+    };
+    typedef typename internal::conditional<TransposeInput,
+                                           Transpose<const MatrixType>,
+                                           const MatrixType&
+                                          >::type FullMatrixWrapperType;
+    typedef typename internal::conditional<UpLo==(Lower|Upper),
+                                           FullMatrixWrapperType,
+                                           SparseSelfAdjointView<const MatrixType, UpLo>
+                                          >::type MatrixWrapperType;
+    m_iterations = Base::maxIterations();
+    m_error = Base::m_tolerance;
+
+    for(int j=0; j<b.cols(); ++j)
+    {
+      m_iterations = Base::maxIterations();
+      m_error = Base::m_tolerance;
+
+      typename Dest::ColXpr xj(x,j);
+      internal::pipelined_conjugate_gradient(MatrixWrapperType(*mp_matrix), b.col(j), xj, Base::m_preconditioner, m_iterations, m_error);
+    }
+
+    m_isInitialized = true;
+    m_info = m_error <= Base::m_tolerance ? Success : NoConvergence;
+  }
+
+  /** \internal */
+  template<typename Rhs,typename Dest>
+  void _solve(const Rhs& b, Dest& x) const
+  {
+    x.setZero();
+    _solveWithGuess(b,x);
+  }
+
+protected:
+
+};
+
+
+namespace internal {
+
+template<typename _MatrixType, int _UpLo, typename _Preconditioner, typename Rhs>
+struct solve_retval<PipelinedConjugateGradient<_MatrixType,_UpLo,_Preconditioner>, Rhs>
+  : solve_retval_base<PipelinedConjugateGradient<_MatrixType,_UpLo,_Preconditioner>, Rhs>
+{
+  typedef PipelinedConjugateGradient<_MatrixType,_UpLo,_Preconditioner> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec()._solve(rhs(),dst);
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_PIPELINED_CG_H
@@ -14,7 +14,7 @@
 
 namespace Eigen { 
 
-template<typename Scalar, int Options, typename Index> class SparseMatrix;
+template<typename Scalar, int Options, typename Index, typename OuterIndex> class SparseMatrix;
 
 /*!
  * \brief Kronecker tensor product helper class for dense matrices
@@ -0,0 +1,358 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_GEMM_BLOCKING_TUNER_H
+#define EIGEN_GEMM_BLOCKING_TUNER_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal \returns the elapsed wall clock time in seconds since an arbitrary origin */
+inline double tuner_wall_time()
+{
+#if defined(_WIN32) || defined(__CYGWIN__)
+  return double(std::clock()) / double(CLOCKS_PER_SEC);
+#else
+  timeval tv;
+  gettimeofday(&tv, 0);
+  return double(tv.tv_sec) + 1e-6 * double(tv.tv_usec);
+#endif
+}
+
+inline const char* tuned_blocking_scalar_name(int scalarId)
+{
+  static const char* names[TunedBlockingScalarCount] = { "float", "double", "cfloat", "cdouble" };
+  return names[scalarId];
+}
+
+inline int tuned_blocking_scalar_from_name(const std::string& name)
+{
+  for(int i=0; i<TunedBlockingScalarCount; ++i)
+    if(name==tuned_blocking_scalar_name(i))
+      return i;
+  return -1;
+}
+
+/** \internal \returns a string identifying the configuration the blocking sizes are tuned for */
+inline std::string tuned_blocking_signature()
+{
+  std::ostringstream sig;
+  std::ptrdiff_t l1, l2;
+  manage_caching_sizes(GetAction, &l1, &l2);
+  sig << SimdInstructionSetsInUse() << ";l1=" << l1 << ";l2=" << l2 << ";threads=" << nbThreads();
+  return sig.str();
+}
+
+} // end namespace internal
+
+/** \ingroup ProductTuner_Module
+  *
+  * \class GemmBlockingTuner
+  *
+  * \brief Empirical tuner of the blocking sizes of the general matrix-matrix products
+  *
+  * The blocking sizes \c kc and \c mc of the matrix products are usually derived from the
+  * cache sizes reported by the CPU, see computeProductBlockingSizes(). On some platforms
+  * (e.g., ARM boards or virtual machines) these values are missing or misleading.
+  * This class benchmarks a grid of candidate blockings for a representative product of
+  * each shape class (general, rank-k update, panel) and keeps the fastest one. The cache
+  * size heuristic is always part of the candidates, so that the tuned blocking is never
+  * slower than the default one on the benchmarked products.
+  *
+  * The results can be saved to and loaded from a small text file, and must be installed
+  * with apply() to be used by the subsequent products. Results are only reloaded if they
+  * have been computed for the same instruction sets, cache sizes and number of threads.
+  *
+  * \code
+  * GemmBlockingTuner tuner;
+  * if(!tuner.load("gemm_blocking.txt") || !tuner.isTuned<double>())
+  * {
+  *   tuner.tune<double>();
+  *   tuner.save("gemm_blocking.txt");
+  * }
+  * tuner.apply();
+  * \endcode
+  *
+  * \sa autotuneProductBlockingSizes(), computeProductBlockingSizes()
+  */
+class GemmBlockingTuner
+{
+  public:
+    typedef DenseIndex Index;
+
+    /** Tuning result for one scalar type and one product shape class */
+    struct Entry
+    {
+      Entry() : kc(0), mc(0), heuristicTime(0), tunedTime(0) {}
+      /** blocking size along the depth, 0 if not tuned */
+      Index kc;
+      /** blocking size along the rows of the lhs */
+      Index mc;
+      /** best time in seconds of the benchmarked product with the cache size heuristic */
+      double heuristicTime;
+      /** best time in seconds of the benchmarked product with the tuned blocking sizes */
+      double tunedTime;
+    };
+
+    /** \param size the size of the representative products which are benchmarked
+      * \param tries the number of runs of each candidate, the best one being retained */
+    GemmBlockingTuner(Index size = 384, int tries = 3)
+      : m_size(size), m_tries(tries)
+    {
+      eigen_assert(size>=16 && tries>=1);
+    }
+
+    /** Tunes the blocking sizes of \a Scalar for all the product shape classes. */
+    template<typename Scalar>
+    void tune()
+    {
+      for(int shape=0; shape<internal::ProductShapeCount; ++shape)
+        tune<Scalar>(shape);
+    }
+
+    /** Tunes the blocking sizes of \a Scalar for the product shape class \a shape. */
+    template<typename Scalar>
+    void tune(int shape)
+    {
+      enum { ScalarId = internal::tuned_blocking_scalar_id<Scalar>::value };
+      EIGEN_STATIC_ASSERT(ScalarId>=0, YOU_MADE_A_PROGRAMMING_MISTAKE);
+      eigen_assert(shape>=0 && shape<internal::ProductShapeCount);
+      typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+
+      Index m, n, k;
+      representativeSizes(shape, m, n, k);
+      MatrixType a = MatrixType::Random(m,k);
+      MatrixType b = MatrixType::Random(k,n);
+      MatrixType c(m,n);
+
+      // temporarily disable any installed tuned values to measure the heuristic
+      std::ptrdiff_t oldKc, oldMc, kc = 0, mc = 0;
+      internal::manage_tuned_blocking_sizes(GetAction, ScalarId, shape, &oldKc, &oldMc);
+      internal::manage_tuned_blocking_sizes(SetAction, ScalarId, shape, &kc, &mc);
+
+      Index hkc = k, hmc = m, hnc = n;
+      internal::computeProductBlockingSizes<Scalar,Scalar>(hkc, hmc, hnc);
+      Entry& e = m_entries[ScalarId][shape];
+      e.kc = hkc;
+      e.mc = hmc;
+      e.heuristicTime = benchmark(a, b, c);
+      e.tunedTime = e.heuristicTime;
+
+      static const Index candidates[] = { 16, 32, 48, 64, 96, 128, 192, 256, 320, 384, 512, 768, 1024 };
+      const int nbCandidates = sizeof(candidates)/sizeof(candidates[0]);
+      for(int i=0; i<nbCandidates && candidates[i]<=k; ++i)
+      {
+        for(int j=0; j<nbCandidates && candidates[j]<=m; ++j)
+        {
+          kc = candidates[i];
+          mc = candidates[j];
+          internal::manage_tuned_blocking_sizes(SetAction, ScalarId, shape, &kc, &mc);
+          double t = benchmark(a, b, c);
+          if(t<e.tunedTime)
+          {
+            e.tunedTime = t;
+            e.kc = kc;
+            e.mc = mc;
+          }
+        }
+      }
+
+      internal::manage_tuned_blocking_sizes(SetAction, ScalarId, shape, &oldKc, &oldMc);
+    }
+
+    /** \returns true if the blocking sizes of \a Scalar are known for all the product shape classes */
+    template<typename Scalar>
+    bool isTuned() const
+    {
+      enum { ScalarId = internal::tuned_blocking_scalar_id<Scalar>::value };
+      if(ScalarId<0)
+        return false;
+      for(int shape=0; shape<internal::ProductShapeCount; ++shape)
+        if(m_entries[ScalarId][shape].kc<=0)
+          return false;
+      return true;
+    }
+
+    /** \returns the tuning result of \a Scalar for the product shape class \a shape */
+    template<typename Scalar>
+    const Entry& entry(int shape) const
+    {
+      enum { ScalarId = internal::tuned_blocking_scalar_id<Scalar>::value };
+      EIGEN_STATIC_ASSERT(ScalarId>=0, YOU_MADE_A_PROGRAMMING_MISTAKE);
+      eigen_assert(shape>=0 && shape<internal::ProductShapeCount);
+      return m_entries[ScalarId][shape];
+    }
+
+    /** Installs the tuned blocking sizes, so that they are used by all the subsequent matrix products.
+      * Scalar types and shapes which have not been tuned keep their current setting. */
+    void apply() const
+    {
+      for(int s=0; s<internal::TunedBlockingScalarCount; ++s)
+        for(int shape=0; shape<internal::ProductShapeCount; ++shape)
+        {
+          const Entry& e = m_entries[s][shape];
+          if(e.kc<=0)
+            continue;
+          std::ptrdiff_t kc = e.kc, mc = e.mc;
+          internal::manage_tuned_blocking_sizes(SetAction, s, shape, &kc, &mc);
+        }
+    }
+
+    /** Restores the cache size heuristic for all the scalar types and product shape classes. */
+    static void reset()
+    {
+      for(int s=0; s<internal::TunedBlockingScalarCount; ++s)
+        for(int shape=0; shape<internal::ProductShapeCount; ++shape)
+        {
+          std::ptrdiff_t kc = 0, mc = 0;
+          internal::manage_tuned_blocking_sizes(SetAction, s, shape, &kc, &mc);
+        }
+    }
+
+    /** Saves the tuning results to the file \a filename.
+      * \returns false if the file cannot be written */
+    bool save(const std::string& filename) const
+    {
+      std::ofstream out(filename.c_str(), std::ios::out);
+      if(!out)
+        return false;
+      out << "EigenGemmBlocking 1\n" << internal::tuned_blocking_signature() << "\n";
+      out.precision(9);
+      for(int s=0; s<internal::TunedBlockingScalarCount; ++s)
+        for(int shape=0; shape<internal::ProductShapeCount; ++shape)
+        {
+          const Entry& e = m_entries[s][shape];
+          if(e.kc>0)
+            out << internal::tuned_blocking_scalar_name(s) << " " << shape << " " << e.kc << " " << e.mc << " "
+                << e.heuristicTime << " " << e.tunedTime << "\n";
+        }
+      return bool(out);
+    }
+
+    /** Loads the tuning results from the file \a filename.
+      * \returns false if the file does not exist, is invalid, or has been generated for a different
+      * configuration (instruction sets, cache sizes or number of threads). In that case no result is kept. */
+    bool load(const std::string& filename)
+    {
+      clear();
+      std::ifstream in(filename.c_str(), std::ios::in);
+      if(!in)
+        return false;
+
+      std::string line;
+      if(!std::getline(in, line) || line!="EigenGemmBlocking 1")
+        return false;
+      if(!std::getline(in, line) || line!=internal::tuned_blocking_signature())
+        return false;
+
+      while(std::getline(in, line))
+      {
+        if(line.empty())
+          continue;
+        std::istringstream fields(line);
+        std::string name;
+        int shape;
+        Entry e;
+        fields >> name >> shape >> e.kc >> e.mc >> e.heuristicTime >> e.tunedTime;
+        int s = internal::tuned_blocking_scalar_from_name(name);
+        if(fields.fail() || s<0 || shape<0 || shape>=internal::ProductShapeCount || e.kc<=0 || e.mc<=0)
+        {
+          clear();
+          return false;
+        }
+        m_entries[s][shape] = e;
+      }
+      return true;
+    }
+
+    /** Discards all the tuning results of this object (the installed blocking sizes are not affected). */
+    void clear()
+    {
+      for(int s=0; s<internal::TunedBlockingScalarCount; ++s)
+        for(int shape=0; shape<internal::ProductShapeCount; ++shape)
+          m_entries[s][shape] = Entry();
+    }
+
+    /** Prints the tuned blocking sizes along with the speedup over the cache size heuristic. */
+    void report(std::ostream& os) const
+    {
+      static const char* shapeNames[internal::ProductShapeCount] = { "general", "rank-update", "panel" };
+      for(int s=0; s<internal::TunedBlockingScalarCount; ++s)
+        for(int shape=0; shape<internal::ProductShapeCount; ++shape)
+        {
+          const Entry& e = m_entries[s][shape];
+          if(e.kc<=0)
+            continue;
+          os << internal::tuned_blocking_scalar_name(s) << "\t" << shapeNames[shape]
+             << "\tkc=" << e.kc << "\tmc=" << e.mc
+             << "\theuristic=" << e.heuristicTime*1e3 << "ms\ttuned=" << e.tunedTime*1e3 << "ms"
+             << "\tspeedup=" << (e.tunedTime>0 ? e.heuristicTime/e.tunedTime : 1.) << "\n";
+        }
+    }
+
+    /** \returns the sizes m x k times k x n of the product benchmarked for the shape class \a shape */
+    void representativeSizes(int shape, Index& m, Index& n, Index& k) const
+    {
+      m = n = k = m_size;
+      if(shape==internal::RankUpdateProductShape)
+        k = m_size/8;
+      else if(shape==internal::PanelProductShape)
+        n = m_size/8;
+    }
+
+  protected:
+
+    template<typename MatrixType>
+    double benchmark(const MatrixType& a, const MatrixType& b, MatrixType& c) const
+    {
+      double best = 0;
+      for(int i=0; i<m_tries; ++i)
+      {
+        double t = internal::tuner_wall_time();
+        c.noalias() = a * b;
+        t = internal::tuner_wall_time() - t;
+        if(i==0 || t<best)
+          best = t;
+      }
+      return best;
+    }
+
+    Index m_size;
+    int m_tries;
+    Entry m_entries[internal::TunedBlockingScalarCount][internal::ProductShapeCount];
+};
+
+/** \ingroup ProductTuner_Module
+  *
+  * Installs tuned blocking sizes for the matrix products of \a Scalar.
+  * The tuning results are read from \a cacheFile if they are available for the current
+  * configuration. Otherwise the blocking sizes are tuned and the results are written to \a cacheFile,
+  * preserving the results of the other scalar types.
+  *
+  * \returns true if the results were loaded from \a cacheFile, false if the tuning had to be performed
+  *
+  * \sa class GemmBlockingTuner
+  */
+template<typename Scalar>
+bool autotuneProductBlockingSizes(const std::string& cacheFile, DenseIndex size = 384, int tries = 3)
+{
+  GemmBlockingTuner tuner(size, tries);
+  bool cached = tuner.load(cacheFile) && tuner.isTuned<Scalar>();
+  if(!cached)
+  {
+    tuner.tune<Scalar>();
+    tuner.save(cacheFile);
+  }
+  tuner.apply();
+  return cached;
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_GEMM_BLOCKING_TUNER_H
@@ -18,10 +18,6 @@
 #ifndef EIGEN_BDCSVD_H
 #define EIGEN_BDCSVD_H
 
-#define EPSILON 0.0000000000000001
-
-#define ALGOSWAP 32
-
 namespace Eigen {
 /** \ingroup SVD_Module
  *
@@ -31,36 +27,43 @@ namespace Eigen {
  * \brief class Bidiagonal Divide and Conquer SVD
  *
  * \param MatrixType the type of the matrix of which we are computing the SVD decomposition
- * We plan to have a very similar interface to JacobiSVD on this class.
- * It should be used to speed up the calcul of SVD for big matrices. 
+ *
+ * This class first reduces the input matrix to bi-diagonal form using class UpperBidiagonalization,
+ * and then performs a divide-and-conquer diagonalization. Small blocks are diagonalized using class JacobiSVD.
+ * You can control the switching size with the setSwitchSize() method, default is 16.
+ * For small matrices (<16), it is thus preferable to directly use JacobiSVD. For larger ones, BDCSVD is highly
+ * recommended and can be several orders of magnitude faster.
+ *
+ * The subproblems of the divide step are independent, and are diagonalized on several threads when
+ * OpenMP is enabled. The interface is the same as the one of JacobiSVD, thin \a U and \a V included.
  */
-template<typename _MatrixType> 
+template<typename _MatrixType>
 class BDCSVD : public SVDBase<_MatrixType>
 {
   typedef SVDBase<_MatrixType> Base;
-    
+
 public:
   using Base::rows;
   using Base::cols;
-  
+
   typedef _MatrixType MatrixType;
   typedef typename MatrixType::Scalar Scalar;
   typedef typename NumTraits<typename MatrixType::Scalar>::Real RealScalar;
   typedef typename MatrixType::Index Index;
   enum {
-    RowsAtCompileTime = MatrixType::RowsAtCompileTime, 
-    ColsAtCompileTime = MatrixType::ColsAtCompileTime, 
-    DiagSizeAtCompileTime = EIGEN_SIZE_MIN_PREFER_DYNAMIC(RowsAtCompileTime, ColsAtCompileTime), 
-    MaxRowsAtCompileTime = MatrixType::MaxRowsAtCompileTime, 
-    MaxColsAtCompileTime = MatrixType::MaxColsAtCompileTime, 
-    MaxDiagSizeAtCompileTime = EIGEN_SIZE_MIN_PREFER_FIXED(MaxRowsAtCompileTime, MaxColsAtCompileTime), 
+    RowsAtCompileTime = MatrixType::RowsAtCompileTime,
+    ColsAtCompileTime = MatrixType::ColsAtCompileTime,
+    DiagSizeAtCompileTime = EIGEN_SIZE_MIN_PREFER_DYNAMIC(RowsAtCompileTime, ColsAtCompileTime),
+    MaxRowsAtCompileTime = MatrixType::MaxRowsAtCompileTime,
+    MaxColsAtCompileTime = MatrixType::MaxColsAtCompileTime,
+    MaxDiagSizeAtCompileTime = EIGEN_SIZE_MIN_PREFER_FIXED(MaxRowsAtCompileTime, MaxColsAtCompileTime),
     MatrixOptions = MatrixType::Options
   };
 
-  typedef Matrix<Scalar, RowsAtCompileTime, RowsAtCompileTime, 
+  typedef Matrix<Scalar, RowsAtCompileTime, RowsAtCompileTime,
 		 MatrixOptions, MaxRowsAtCompileTime, MaxRowsAtCompileTime>
   MatrixUType;
-  typedef Matrix<Scalar, ColsAtCompileTime, ColsAtCompileTime, 
+  typedef Matrix<Scalar, ColsAtCompileTime, ColsAtCompileTime,
 		 MatrixOptions, MaxColsAtCompileTime, MaxColsAtCompileTime>
   MatrixVType;
   typedef typename internal::plain_diag_type<MatrixType, RealScalar>::type SingularValuesType;
@@ -69,6 +72,8 @@ public:
   typedef Matrix<Scalar, Dynamic, Dynamic> MatrixX;
   typedef Matrix<RealScalar, Dynamic, Dynamic> MatrixXr;
   typedef Matrix<RealScalar, Dynamic, 1> VectorType;
+  typedef Array<RealScalar, Dynamic, 1> ArrayXr;
+  typedef Array<Index, Dynamic, 1> ArrayXi;
 
   /** \brief Default Constructor.
    *
@@ -76,8 +81,8 @@ public:
    * perform decompositions via BDCSVD::compute(const MatrixType&).
    */
   BDCSVD()
-    : SVDBase<_MatrixType>::SVDBase(), 
-      algoswap(ALGOSWAP)
+    : SVDBase<_MatrixType>::SVDBase(),
+      algoswap(16)
   {}
 
 
@@ -88,8 +93,8 @@ public:
    * \sa BDCSVD()
    */
   BDCSVD(Index rows, Index cols, unsigned int computationOptions = 0)
-    : SVDBase<_MatrixType>::SVDBase(), 
-      algoswap(ALGOSWAP)
+    : SVDBase<_MatrixType>::SVDBase(),
+      algoswap(16)
   {
     allocate(rows, cols, computationOptions);
   }
@@ -98,31 +103,29 @@ public:
    *
    * \param matrix the matrix to decompose
    * \param computationOptions optional parameter allowing to specify if you want full or thin U or V unitaries to be computed.
-   *                           By default, none is computed. This is a bit - field, the possible bits are #ComputeFullU, #ComputeThinU, 
+   *                           By default, none is computed. This is a bit - field, the possible bits are #ComputeFullU, #ComputeThinU,
    *                           #ComputeFullV, #ComputeThinV.
    *
-   * Thin unitaries are only available if your matrix type has a Dynamic number of columns (for example MatrixXf). They also are not
-   * available with the (non - default) FullPivHouseholderQR preconditioner.
+   * Thin unitaries are only available if your matrix type has a Dynamic number of columns (for example MatrixXf).
    */
   BDCSVD(const MatrixType& matrix, unsigned int computationOptions = 0)
-    : SVDBase<_MatrixType>::SVDBase(), 
-      algoswap(ALGOSWAP)
+    : SVDBase<_MatrixType>::SVDBase(),
+      algoswap(16)
   {
     compute(matrix, computationOptions);
   }
 
-  ~BDCSVD() 
+  ~BDCSVD()
   {
   }
   /** \brief Method performing the decomposition of given matrix using custom options.
    *
    * \param matrix the matrix to decompose
    * \param computationOptions optional parameter allowing to specify if you want full or thin U or V unitaries to be computed.
-   *                           By default, none is computed. This is a bit - field, the possible bits are #ComputeFullU, #ComputeThinU, 
+   *                           By default, none is computed. This is a bit - field, the possible bits are #ComputeFullU, #ComputeThinU,
    *                           #ComputeFullV, #ComputeThinV.
    *
-   * Thin unitaries are only available if your matrix type has a Dynamic number of columns (for example MatrixXf). They also are not
-   * available with the (non - default) FullPivHouseholderQR preconditioner.
+   * Thin unitaries are only available if your matrix type has a Dynamic number of columns (for example MatrixXf).
    */
   SVDBase<MatrixType>& compute(const MatrixType& matrix, unsigned int computationOptions);
 
@@ -137,9 +140,11 @@ public:
     return compute(matrix, this->m_computationOptions);
   }
 
-  void setSwitchSize(int s) 
+  /** Sets the size below which the subproblems of the divide step, and the matrices themselves,
+    * are diagonalized by JacobiSVD. The default is 16. */
+  void setSwitchSize(int s)
   {
-    eigen_assert(s>3 && "BDCSVD the size of the algo switch has to be greater than 4");
+    eigen_assert(s>3 && "BDCSVD the size of the algo switch has to be greater than 3");
     algoswap = s;
   }
 
@@ -158,58 +163,59 @@ public:
   solve(const MatrixBase<Rhs>& b) const
   {
     eigen_assert(this->m_isInitialized && "BDCSVD is not initialized.");
-    eigen_assert(SVDBase<_MatrixType>::computeU() && SVDBase<_MatrixType>::computeV() && 
+    eigen_assert(SVDBase<_MatrixType>::computeU() && SVDBase<_MatrixType>::computeV() &&
 		 "BDCSVD::solve() requires both unitaries U and V to be computed (thin unitaries suffice).");
     return internal::solve_retval<BDCSVD, Rhs>(*this, b.derived());
   }
 
- 
-  const MatrixUType& matrixU() const
+  /** \internal \returns the number of threads processing \a count independent subproblems */
+  static Index subProblemThreads(Index count)
   {
-    eigen_assert(this->m_isInitialized && "SVD is not initialized.");
-    if (isTranspose){
-      eigen_assert(this->computeV() && "This SVD decomposition didn't compute U. Did you ask for it?");
-      return this->m_matrixV;
-    }
-    else 
-    {
-      eigen_assert(this->computeU() && "This SVD decomposition didn't compute U. Did you ask for it?");
-      return this->m_matrixU;
-    }
-     
+#ifdef EIGEN_HAS_OPENMP
+    // do not create nested parallel regions
+    if(omp_get_num_threads()==1)
+      return (std::max)(Index(1), (std::min)(Index(nbThreads()), count));
+#else
+    EIGEN_UNUSED_VARIABLE(count);
+#endif
+    return 1;
   }
 
+private:
+  // A subproblem of the divide step, see divide()
+  struct SubProblem
+  {
+    Index firstCol, lastCol, firstRowW, firstColW, shift;
+    RealScalar alphaK, betaK;
+  };
 
-  const MatrixVType& matrixV() const
+  static void check_template_parameters()
   {
-    eigen_assert(this->m_isInitialized && "SVD is not initialized.");
-    if (isTranspose){
-      eigen_assert(this->computeU() && "This SVD decomposition didn't compute V. Did you ask for it?");
-      return this->m_matrixU;
-    }
-    else
-    {
-      eigen_assert(this->computeV() && "This SVD decomposition didn't compute V. Did you ask for it?");
-      return this->m_matrixV;
-    }
+    EIGEN_STATIC_ASSERT_NON_INTEGER(Scalar);
   }
- 
-private:
+
   void allocate(Index rows, Index cols, unsigned int computationOptions);
-  void divide (Index firstCol, Index lastCol, Index firstRowW, 
-	       Index firstColW, Index shift);
+  void divide (Index firstCol, Index lastCol, Index firstRowW,
+	       Index firstColW, Index shift, Index depth);
+  void conquer(const SubProblem& p);
+  void computeSVDofM(Index firstCol, Index n, MatrixXr& U, VectorType& singVals, MatrixXr& V);
+  void computeSingVals(const ArrayXr& col0, const ArrayXr& diag, const ArrayXi& perm, VectorType& singVals, ArrayXr& shifts, ArrayXr& mus);
+  void perturbCol0(const ArrayXr& col0, const ArrayXr& diag, const ArrayXi& perm, const VectorType& singVals, const ArrayXr& shifts, const ArrayXr& mus, ArrayXr& zhat);
+  void computeSingVecs(const ArrayXr& zhat, const ArrayXr& diag, const ArrayXi& perm, const VectorType& singVals, const ArrayXr& shifts, const ArrayXr& mus, MatrixXr& U, MatrixXr& V);
   void deflation43(Index firstCol, Index shift, Index i, Index size);
   void deflation44(Index firstColu , Index firstColm, Index firstRowW, Index firstColW, Index i, Index j, Index size);
   void deflation(Index firstCol, Index lastCol, Index k, Index firstRowW, Index firstColW, Index shift);
-  void copyUV(MatrixXr naiveU, MatrixXr naiveV, MatrixX householderU, MatrixX houseHolderV);
+  void copyUV(const internal::UpperBidiagonalization<MatrixX>& bid);
+  static void structured_update(Block<MatrixXr,Dynamic,Dynamic> A, const MatrixXr& B, Index n1);
+  static RealScalar secularEq(RealScalar x, const ArrayXr& col0, const ArrayXr& diag, const ArrayXi& perm, const ArrayXr& diagShifted, RealScalar shift);
 
 protected:
   MatrixXr m_naiveU, m_naiveV;
   MatrixXr m_computed;
-  Index nRec;
+  std::vector<std::vector<SubProblem> > m_levels;
   int algoswap;
   bool isTranspose, compU, compV;
-  
+
 }; //end class BDCSVD
 
 
@@ -220,85 +226,83 @@ void BDCSVD<MatrixType>::allocate(Index rows, Index cols, unsigned int computati
   isTranspose = (cols > rows);
   if (SVDBase<MatrixType>::allocate(rows, cols, computationOptions)) return;
   m_computed = MatrixXr::Zero(this->m_diagSize + 1, this->m_diagSize );
-  if (isTranspose){
-    compU = this->computeU();
-    compV = this->computeV();    
-  } 
-  else
-  {
-    compV = this->computeU();
-    compU = this->computeV();   
-  }
+  // the U and V of the bidiagonal matrix give respectively the V and U of the input matrix,
+  // or the U and V of its adjoint
+  compU = this->computeV();
+  compV = this->computeU();
+  if (isTranspose)
+    std::swap(compU, compV);
+
   if (compU) m_naiveU = MatrixXr::Zero(this->m_diagSize + 1, this->m_diagSize + 1 );
   else m_naiveU = MatrixXr::Zero(2, this->m_diagSize + 1 );
-  
+
   if (compV) m_naiveV = MatrixXr::Zero(this->m_diagSize, this->m_diagSize);
-  
-
-  //should be changed for a cleaner implementation
-  if (isTranspose){
-    bool aux;
-    if (this->computeU()||this->computeV()){
-      aux = this->m_computeFullU;
-      this->m_computeFullU = this->m_computeFullV;
-      this->m_computeFullV = aux;
-      aux = this->m_computeThinU;
-      this->m_computeThinU = this->m_computeThinV;
-      this->m_computeThinV = aux;
-    } 
-  }
 }// end allocate
 
-// Methode which compute the BDCSVD for the int
-template<>
-SVDBase<Matrix<int, Dynamic, Dynamic> >&
-BDCSVD<Matrix<int, Dynamic, Dynamic> >::compute(const MatrixType& matrix, unsigned int computationOptions) {
-  allocate(matrix.rows(), matrix.cols(), computationOptions);
-  this->m_nonzeroSingularValues = 0;
-  m_computed = Matrix<int, Dynamic, Dynamic>::Zero(rows(), cols());
-  for (int i=0; i<this->m_diagSize; i++)   {
-    this->m_singularValues.coeffRef(i) = 0;
-  }
-  if (this->m_computeFullU) this->m_matrixU = Matrix<int, Dynamic, Dynamic>::Zero(rows(), rows());
-  if (this->m_computeFullV) this->m_matrixV = Matrix<int, Dynamic, Dynamic>::Zero(cols(), cols()); 
-  this->m_isInitialized = true;
-  return *this;
-}
-
 
 // Methode which compute the BDCSVD
 template<typename MatrixType>
 SVDBase<MatrixType>&
-BDCSVD<MatrixType>::compute(const MatrixType& matrix, unsigned int computationOptions) 
+BDCSVD<MatrixType>::compute(const MatrixType& matrix, unsigned int computationOptions)
 {
+  check_template_parameters();
   allocate(matrix.rows(), matrix.cols(), computationOptions);
   using std::abs;
 
-  //**** step 1 Bidiagonalization  isTranspose = (matrix.cols()>matrix.rows()) ;
-  MatrixType copy;
-  if (isTranspose) copy = matrix.adjoint();
-  else copy = matrix;
-  
-  internal::UpperBidiagonalization<MatrixX > bid(copy);
-
-  //**** step 2 Divide
-  // this is ugly and has to be redone (care of complex cast)
-  MatrixXr temp;
-  temp = bid.bidiagonal().toDenseMatrix().transpose();
-  m_computed.setZero();
-  for (int i=0; i<this->m_diagSize - 1; i++)   {
-    m_computed(i, i) = temp(i, i);
-    m_computed(i + 1, i) = temp(i + 1, i);
-  }
-  m_computed(this->m_diagSize - 1, this->m_diagSize - 1) = temp(this->m_diagSize - 1, this->m_diagSize - 1);
-  divide(0, this->m_diagSize - 1, 0, 0, 0);
+  const RealScalar considerZero = (std::numeric_limits<RealScalar>::min)();
+
+  //**** step 0 If the problem is too small, directly falls back to JacobiSVD
+  if (this->m_diagSize < algoswap)
+  {
+    JacobiSVD<MatrixType> jsvd(matrix, computationOptions);
+    if (this->computeU()) this->m_matrixU = jsvd.matrixU();
+    if (this->computeV()) this->m_matrixV = jsvd.matrixV();
+    this->m_singularValues = jsvd.singularValues();
+    this->m_nonzeroSingularValues = jsvd.nonzeroSingularValues();
+    this->m_isInitialized = true;
+    return *this;
+  }
+
+  //**** step 1 Bidiagonalization, after a scaling reducing over and underflows
+  RealScalar scale = matrix.cwiseAbs().maxCoeff();
+  if (scale == RealScalar(0)) scale = RealScalar(1);
+  MatrixX copy;
+  if (isTranspose) copy = matrix.adjoint() / scale;
+  else copy = matrix / scale;
+
+  internal::UpperBidiagonalization<MatrixX> bid(copy);
+
+  //**** step 2 Divide and conquer
+  m_naiveU.setZero();
+  if (compV) m_naiveV.setZero();
+  m_computed.topRows(this->m_diagSize) = bid.bidiagonal().toDenseMatrix().transpose();
+  m_computed.template bottomRows<1>().setZero();
+  for (size_t d = 0; d < m_levels.size(); ++d)
+    m_levels[d].clear();
+  divide(0, this->m_diagSize - 1, 0, 0, 0, 0);
+
+  // the subproblems of a level are independent, and only depend on the ones of the deeper levels
+  for (Index d = Index(m_levels.size()) - 1; d >= 0; --d)
+  {
+    const std::vector<SubProblem>& level = m_levels[d];
+    const Index count = Index(level.size());
+    Index threads = subProblemThreads(count);
+    if (threads > 1)
+      Eigen::initParallel();
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for num_threads(int(threads)) schedule(dynamic,1) if(threads>1)
+#endif
+    for (Index i = 0; i < count; ++i)
+      conquer(level[i]);
+  }
 
   //**** step 3 copy
-  for (int i=0; i<this->m_diagSize; i++)   {
+  for (Index i=0; i<this->m_diagSize; i++)   {
     RealScalar a = abs(m_computed.coeff(i, i));
-    this->m_singularValues.coeffRef(i) = a;
-    if (a == 0){
+    this->m_singularValues.coeffRef(i) = a * scale;
+    if (a < considerZero){
       this->m_nonzeroSingularValues = i;
+      this->m_singularValues.tail(this->m_diagSize - i - 1).setZero();
       break;
     }
     else  if (i == this->m_diagSize - 1)
@@ -307,106 +311,204 @@ BDCSVD<MatrixType>::compute(const MatrixType& matrix, unsigned int computationOp
       break;
     }
   }
-  copyUV(m_naiveV, m_naiveU, bid.householderU(), bid.householderV());
+  copyUV(bid);
   this->m_isInitialized = true;
   return *this;
 }// end compute
 
 
+namespace internal {
+
+/** \internal Applies the sequence H_0 ... H_{n-1} of the Householder reflectors stored below the diagonal of
+  * \a vectors, with the coefficients \a hCoeffs, to the last vectors.rows() rows of \a dst.
+  * Unlike HouseholderSequence::applyThisOnTheLeft(), the reflectors are applied by blocks, such that most
+  * of the work is done by matrix products. */
+template<typename VectorsType, typename CoeffsType, typename Dest>
+void bdcsvd_apply_householder_on_the_left(const VectorsType& vectors, const CoeffsType& hCoeffs, Dest& dst)
+{
+  typedef typename Dest::Index Index;
+  typedef typename Dest::Scalar Scalar;
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixX;
+  const Index blockSize = 48;
+  const Index shift = dst.rows() - vectors.rows();
+
+  MatrixX V, T, tmp;
+  for (Index end = hCoeffs.size(); end > 0; end -= blockSize)
+  {
+    const Index k = (std::max)(Index(0), end - blockSize);
+    const Index bs = end - k;
+    V = vectors.block(k, k, vectors.rows() - k, bs);
+    T.resize(bs, bs);
+    make_block_householder_triangular_factor(T, V, hCoeffs.segment(k, bs));
+
+    // H_k ... H_{end-1} = I - V T V^*
+    Block<Dest,Dynamic,Dynamic> sub(dst, shift + k, 0, dst.rows() - shift - k, dst.cols());
+    tmp.noalias() = V.template triangularView<UnitLower>().adjoint() * sub;
+    tmp = T.template triangularView<Upper>() * tmp;
+    sub.noalias() -= V.template triangularView<UnitLower>() * tmp;
+  }
+}
+
+} // end namespace internal
+
+
 template<typename MatrixType>
-void BDCSVD<MatrixType>::copyUV(MatrixXr naiveU, MatrixXr naiveV, MatrixX householderU, MatrixX householderV){
-  if (this->computeU()){
-    MatrixX temp = MatrixX::Zero(naiveU.rows(), naiveU.cols());
-    temp.real() = naiveU;
-    if (this->m_computeThinU){
-      this->m_matrixU = MatrixX::Identity(householderU.cols(), this->m_nonzeroSingularValues );
-      this->m_matrixU.block(0, 0, this->m_diagSize, this->m_nonzeroSingularValues) = 
-	temp.block(0, 0, this->m_diagSize, this->m_nonzeroSingularValues);
-      this->m_matrixU = householderU * this->m_matrixU ;
-    }
-    else
-    {
-      this->m_matrixU = MatrixX::Identity(householderU.cols(), householderU.cols());
-      this->m_matrixU.block(0, 0, this->m_diagSize, this->m_diagSize) = temp.block(0, 0, this->m_diagSize, this->m_diagSize);
-      this->m_matrixU = householderU * this->m_matrixU ;
-    }
+void BDCSVD<MatrixType>::copyUV(const internal::UpperBidiagonalization<MatrixX>& bid)
+{
+  // The bidiagonal matrix B is the adjoint of the top of m_computed, so that B = naiveV S naiveU^T, and the
+  // bidiagonalized matrix is H_U B H_V^*, where H_U and H_V are the Householder sequences of bid.
+  const MatrixX& householder = bid.householder();
+  const Index diagSize = this->m_diagSize;
+
+  if (isTranspose ? this->computeV() : this->computeU())
+  {
+    const bool thin = isTranspose ? this->m_computeThinV : this->m_computeThinU;
+    MatrixX u = MatrixX::Identity(householder.rows(), thin ? diagSize : householder.rows());
+    u.topLeftCorner(diagSize, diagSize) = m_naiveV.template cast<Scalar>();
+    internal::bdcsvd_apply_householder_on_the_left(householder, householder.diagonal().conjugate(), u);
+    if (isTranspose) this->m_matrixV = u;
+    else this->m_matrixU = u;
   }
-  if (this->computeV()){
-    MatrixX temp = MatrixX::Zero(naiveV.rows(), naiveV.cols());
-    temp.real() = naiveV;
-    if (this->m_computeThinV){
-      this->m_matrixV = MatrixX::Identity(householderV.cols(),this->m_nonzeroSingularValues );
-      this->m_matrixV.block(0, 0, this->m_nonzeroSingularValues, this->m_nonzeroSingularValues) = 
-	temp.block(0, 0, this->m_nonzeroSingularValues, this->m_nonzeroSingularValues);
-      this->m_matrixV = householderV * this->m_matrixV ;
-    }
-    else  
+  if (isTranspose ? this->computeU() : this->computeV())
+  {
+    const bool thin = isTranspose ? this->m_computeThinU : this->m_computeThinV;
+    MatrixX v = MatrixX::Identity(diagSize, thin ? diagSize : householder.cols());
+    v.topLeftCorner(diagSize, diagSize) = m_naiveU.topLeftCorner(diagSize, diagSize).template cast<Scalar>();
+    // the right reflectors are stored in the rows of householder, starting after the diagonal
+    MatrixX vectors = householder.block(0, 1, diagSize - 1, diagSize - 1).adjoint();
+    internal::bdcsvd_apply_householder_on_the_left(vectors, householder.template diagonal<1>(), v);
+    if (isTranspose) this->m_matrixU = v;
+    else this->m_matrixV = v;
+  }
+}
+
+/** \internal
+  * Performs A = A * B exploiting the special structure of the matrix A. Splitting A as:
+  *  A = [A1]
+  *      [A2]
+  * such that A1.rows()==n1, then we assume that at least half of the columns of A1 and A2 are zeros.
+  * We can thus pack them prior to the the matrix product. However, this is only worth the effort if the matrix is large
+  * enough.
+  */
+template<typename MatrixType>
+void BDCSVD<MatrixType>::structured_update(Block<MatrixXr,Dynamic,Dynamic> A, const MatrixXr& B, Index n1)
+{
+  Index n = A.rows();
+  if (n > 100)
+  {
+    // If the matrices are large enough, let's exploit the sparse structure of A by
+    // splitting it in half (wrt n1), and packing the non-zero columns.
+    Index n2 = n - n1;
+    MatrixXr A1(n1, n), A2(n2, n), B1(n, n), B2(n, n);
+    Index k1 = 0, k2 = 0;
+    for (Index j = 0; j < n; ++j)
     {
-      this->m_matrixV = MatrixX::Identity(householderV.cols(), householderV.cols());
-      this->m_matrixV.block(0, 0, this->m_diagSize, this->m_diagSize) = temp.block(0, 0, this->m_diagSize, this->m_diagSize);
-      this->m_matrixV = householderV * this->m_matrixV;
+      if ((A.col(j).head(n1).array() != RealScalar(0)).any())
+      {
+        A1.col(k1) = A.col(j).head(n1);
+        B1.row(k1) = B.row(j);
+        ++k1;
+      }
+      if ((A.col(j).tail(n2).array() != RealScalar(0)).any())
+      {
+        A2.col(k2) = A.col(j).tail(n2);
+        B2.row(k2) = B.row(j);
+        ++k2;
+      }
     }
+
+    A.topRows(n1).noalias()    = A1.leftCols(k1) * B1.topRows(k1);
+    A.bottomRows(n2).noalias() = A2.leftCols(k2) * B2.topRows(k2);
+  }
+  else
+  {
+    MatrixXr tmp = A * B;
+    A = tmp;
   }
 }
 
-// The divide algorithm is done "in place", we are always working on subsets of the same matrix. The divide methods takes as argument the 
+// The divide algorithm is done "in place", we are always working on subsets of the same matrix. The divide methods takes as argument the
 // place of the submatrix we are currently working on.
 
 //@param firstCol : The Index of the first column of the submatrix of m_computed and for m_naiveU;
-//@param lastCol : The Index of the last column of the submatrix of m_computed and for m_naiveU; 
+//@param lastCol : The Index of the last column of the submatrix of m_computed and for m_naiveU;
 // lastCol + 1 - firstCol is the size of the submatrix.
 //@param firstRowW : The Index of the first row of the matrix W that we are to change. (see the reference paper section 1 for more information on W)
 //@param firstRowW : Same as firstRowW with the column.
-//@param shift : Each time one takes the left submatrix, one must add 1 to the shift. Why? Because! We actually want the last column of the U submatrix 
+//@param shift : Each time one takes the left submatrix, one must add 1 to the shift. Why? Because! We actually want the last column of the U submatrix
 // to become the first column (*coeff) and to shift all the other columns to the right. There are more details on the reference paper.
+// The submatrix of m_computed, and then its singular values, are at (firstCol + shift, firstCol + shift).
+//@param depth : the depth of the submatrix in the tree of the subproblems.
+//
+// This only splits the submatrix recursively and records the subproblems by depth: they are solved by conquer(), starting
+// from the deepest ones. The left submatrix is moved one step down the diagonal beforehand, such that the subproblems of a
+// given depth work on disjoint parts of m_computed, m_naiveU and m_naiveV, and can be solved concurrently.
 template<typename MatrixType>
-void BDCSVD<MatrixType>::divide (Index firstCol, Index lastCol, Index firstRowW, 
-				 Index firstColW, Index shift)
+void BDCSVD<MatrixType>::divide (Index firstCol, Index lastCol, Index firstRowW,
+				 Index firstColW, Index shift, Index depth)
 {
   // requires nbRows = nbCols + 1;
-  using std::pow;
+  const Index n = lastCol - firstCol + 1;
+  const Index k = n/2;
+  const Index start = firstCol + shift;
+  SubProblem p = { firstCol, lastCol, firstRowW, firstColW, shift, RealScalar(0), RealScalar(0) };
+  if (n >= algoswap)
+  {
+    p.alphaK = m_computed(start + k, start + k);
+    p.betaK = m_computed(start + k + 1, start + k);
+    for (Index i = k - 1; i >= 0; --i)
+    {
+      m_computed(start + i + 1, start + i + 1) = m_computed(start + i, start + i);
+      m_computed(start + i + 2, start + i + 1) = m_computed(start + i + 1, start + i);
+    }
+    divide(k + 1 + firstCol, lastCol, k + 1 + firstRowW, k + 1 + firstColW, shift, depth + 1);
+    divide(firstCol, k - 1 + firstCol, firstRowW, firstColW + 1, shift + 1, depth + 1);
+  }
+  if (Index(m_levels.size()) <= depth)
+    m_levels.resize(depth + 1);
+  m_levels[depth].push_back(p);
+}// end divide
+
+
+// Diagonalizes the submatrix of the subproblem p, whose left and right submatrices, if any, are already diagonalized.
+template<typename MatrixType>
+void BDCSVD<MatrixType>::conquer (const SubProblem& p)
+{
   using std::sqrt;
   using std::abs;
+  const Index firstCol = p.firstCol, lastCol = p.lastCol, firstRowW = p.firstRowW, firstColW = p.firstColW, shift = p.shift;
   const Index n = lastCol - firstCol + 1;
   const Index k = n/2;
-  RealScalar alphaK;
-  RealScalar betaK; 
-  RealScalar r0; 
+  const Index start = firstCol + shift;
+  const RealScalar considerZero = (std::numeric_limits<RealScalar>::min)();
+  RealScalar alphaK = p.alphaK;
+  RealScalar betaK = p.betaK;
+  RealScalar r0;
   RealScalar lambda, phi, c0, s0;
-  MatrixXr l, f;
-  // We use the other algorithm which is more efficient for small 
+  VectorType l, f;
+  // We use the other algorithm which is more efficient for small
   // matrices.
   if (n < algoswap){
-    JacobiSVD<MatrixXr> b(m_computed.block(firstCol, firstCol, n + 1, n), 
-			  ComputeFullU | (ComputeFullV * compV)) ;
-    if (compU) m_naiveU.block(firstCol, firstCol, n + 1, n + 1).real() << b.matrixU();
-    else 
-    {
-      m_naiveU.row(0).segment(firstCol, n + 1).real() << b.matrixU().row(0);
-      m_naiveU.row(1).segment(firstCol, n + 1).real() << b.matrixU().row(n);
-    }
-    if (compV) m_naiveV.block(firstRowW, firstColW, n, n).real() << b.matrixV();
-    m_computed.block(firstCol + shift, firstCol + shift, n + 1, n).setZero();
-    for (int i=0; i<n; i++)
+    JacobiSVD<MatrixXr> b(m_computed.block(start, start, n + 1, n),
+			  ComputeFullU | (compV ? ComputeFullV : 0)) ;
+    if (compU) m_naiveU.block(firstCol, firstCol, n + 1, n + 1) = b.matrixU();
+    else
     {
-      m_computed(firstCol + shift + i, firstCol + shift +i) = b.singularValues().coeffRef(i);
+      m_naiveU.row(0).segment(firstCol, n + 1) = b.matrixU().row(0);
+      m_naiveU.row(1).segment(firstCol, n + 1) = b.matrixU().row(n);
     }
+    if (compV) m_naiveV.block(firstRowW, firstColW, n, n) = b.matrixV();
+    m_computed.block(start, start, n + 1, n).setZero();
+    m_computed.diagonal().segment(start, n) = b.singularValues().head(n);
     return;
   }
   // We use the divide and conquer algorithm
-  alphaK =  m_computed(firstCol + k, firstCol + k);
-  betaK = m_computed(firstCol + k + 1, firstCol + k);
-  // The divide must be done in that order in order to have good results. Divide change the data inside the submatrices
-  // and the divide of the right submatrice reads one column of the left submatrice. That's why we need to treat the 
-  // right submatrix before the left one. 
-  divide(k + 1 + firstCol, lastCol, k + 1 + firstRowW, k + 1 + firstColW, shift);
-  divide(firstCol, k - 1 + firstCol, firstRowW, firstColW + 1, shift + 1);
   if (compU)
   {
     lambda = m_naiveU(firstCol + k, firstCol + k);
     phi = m_naiveU(firstCol + k + 1, lastCol + 1);
-  } 
-  else 
+  }
+  else
   {
     lambda = m_naiveU(1, firstCol + k);
     phi = m_naiveU(0, lastCol + 1);
@@ -417,14 +519,14 @@ void BDCSVD<MatrixType>::divide (Index firstCol, Index lastCol, Index firstRowW,
   {
     l = m_naiveU.row(firstCol + k).segment(firstCol, k);
     f = m_naiveU.row(firstCol + k + 1).segment(firstCol + k + 1, n - k - 1);
-  } 
-  else 
+  }
+  else
   {
     l = m_naiveU.row(1).segment(firstCol, k);
     f = m_naiveU.row(0).segment(firstCol + k + 1, n - k - 1);
   }
   if (compV) m_naiveV(firstRowW+k, firstColW) = 1;
-  if (r0 == 0)
+  if (r0 < considerZero)
   {
     c0 = 1;
     s0 = 0;
@@ -436,27 +538,27 @@ void BDCSVD<MatrixType>::divide (Index firstCol, Index lastCol, Index firstRowW,
   }
   if (compU)
   {
-    MatrixXr q1 (m_naiveU.col(firstCol + k).segment(firstCol, k + 1));     
+    MatrixXr q1 (m_naiveU.col(firstCol + k).segment(firstCol, k + 1));
     // we shiftW Q1 to the right
-    for (Index i = firstCol + k - 1; i >= firstCol; i--) 
+    for (Index i = firstCol + k - 1; i >= firstCol; i--)
     {
-      m_naiveU.col(i + 1).segment(firstCol, k + 1) << m_naiveU.col(i).segment(firstCol, k + 1);
+      m_naiveU.col(i + 1).segment(firstCol, k + 1) = m_naiveU.col(i).segment(firstCol, k + 1);
     }
     // we shift q1 at the left with a factor c0
-    m_naiveU.col(firstCol).segment( firstCol, k + 1) << (q1 * c0);
+    m_naiveU.col(firstCol).segment( firstCol, k + 1) = (q1 * c0);
     // last column = q1 * - s0
-    m_naiveU.col(lastCol + 1).segment(firstCol, k + 1) << (q1 * ( - s0));
+    m_naiveU.col(lastCol + 1).segment(firstCol, k + 1) = (q1 * ( - s0));
     // first column = q2 * s0
-    m_naiveU.col(firstCol).segment(firstCol + k + 1, n - k) << 
-      m_naiveU.col(lastCol + 1).segment(firstCol + k + 1, n - k) *s0; 
+    m_naiveU.col(firstCol).segment(firstCol + k + 1, n - k) =
+      m_naiveU.col(lastCol + 1).segment(firstCol + k + 1, n - k) *s0;
     // q2 *= c0
-    m_naiveU.col(lastCol + 1).segment(firstCol + k + 1, n - k) *= c0; 
-  } 
-  else 
+    m_naiveU.col(lastCol + 1).segment(firstCol + k + 1, n - k) *= c0;
+  }
+  else
   {
     RealScalar q1 = (m_naiveU(0, firstCol + k));
     // we shift Q1 to the right
-    for (Index i = firstCol + k - 1; i >= firstCol; i--) 
+    for (Index i = firstCol + k - 1; i >= firstCol; i--)
     {
       m_naiveU(0, i + 1) = m_naiveU(0, i);
     }
@@ -465,37 +567,355 @@ void BDCSVD<MatrixType>::divide (Index firstCol, Index lastCol, Index firstRowW,
     // last column = q1 * - s0
     m_naiveU(0, lastCol + 1) = (q1 * ( - s0));
     // first column = q2 * s0
-    m_naiveU(1, firstCol) = m_naiveU(1, lastCol + 1) *s0; 
+    m_naiveU(1, firstCol) = m_naiveU(1, lastCol + 1) *s0;
     // q2 *= c0
     m_naiveU(1, lastCol + 1) *= c0;
     m_naiveU.row(1).segment(firstCol + 1, k).setZero();
     m_naiveU.row(0).segment(firstCol + k + 1, n - k - 1).setZero();
   }
-  m_computed(firstCol + shift, firstCol + shift) = r0;
-  m_computed.col(firstCol + shift).segment(firstCol + shift + 1, k) << alphaK * l.transpose().real();
-  m_computed.col(firstCol + shift).segment(firstCol + shift + k + 1, n - k - 1) << betaK * f.transpose().real();
+  m_computed(start, start) = r0;
+  m_computed.col(start).segment(start + 1, k) = alphaK * l;
+  m_computed.col(start).segment(start + k + 1, n - k - 1) = betaK * f;
 
+  // Second part: deflation of the combined matrix, see section 4 of the reference paper
+  deflation(firstCol, lastCol, k, firstRowW, firstColW, shift);
 
-  // the line below do the deflation of the matrix for the third part of the algorithm
-  // Here the deflation is commented because the third part of the algorithm is not implemented
-  // the third part of the algorithm is a fast SVD on the matrix m_computed which works thanks to the deflation
+  // Third part: SVD of the combined matrix, through the secular equation
+  MatrixXr UofSVD, VofSVD;
+  VectorType singVals;
+  computeSVDofM(start, n, UofSVD, singVals, VofSVD);
 
-  deflation(firstCol, lastCol, k, firstRowW, firstColW, shift);
+  if (compU) structured_update(m_naiveU.block(firstCol, firstCol, n + 1, n + 1), UofSVD, (n + 2)/2);
+  else
+  {
+    MatrixXr tmp = m_naiveU.middleCols(firstCol, n + 1) * UofSVD;
+    m_naiveU.middleCols(firstCol, n + 1) = tmp;
+  }
 
-  // Third part of the algorithm, since the real third part of the algorithm is not implemeted we use a JacobiSVD
-  JacobiSVD<MatrixXr> res= JacobiSVD<MatrixXr>(m_computed.block(firstCol + shift, firstCol +shift, n + 1, n), 
-					       ComputeFullU | (ComputeFullV * compV)) ;
-  if (compU) m_naiveU.block(firstCol, firstCol, n + 1, n + 1) *= res.matrixU();
-  else m_naiveU.block(0, firstCol, 2, n + 1) *= res.matrixU();
-  
-  if (compV) m_naiveV.block(firstRowW, firstColW, n, n) *= res.matrixV();
-  m_computed.block(firstCol + shift, firstCol + shift, n, n) << MatrixXr::Zero(n, n);
-  for (int i=0; i<n; i++)
-    m_computed(firstCol + shift + i, firstCol + shift +i) = res.singularValues().coeffRef(i);
-  // end of the third part
+  if (compV) structured_update(m_naiveV.block(firstRowW, firstColW, n, n), VofSVD, (n + 1)/2);
 
+  m_computed.block(start, start, n, n).setZero();
+  m_computed.block(start, start, n, n).diagonal() = singVals;
+}// end conquer
 
-}// end divide
+
+// Compute SVD of m_computed.block(firstCol, firstCol, n + 1, n); this block only has non-zeros in
+// the first column and on the diagonal and has undergone deflation, so diagonal is in increasing
+// order except for possibly the (0,0) entry. The computed SVD is stored U, singVals and V, except
+// that if compV is false, then V is not computed. Singular values are sorted in decreasing order.
+template <typename MatrixType>
+void BDCSVD<MatrixType>::computeSVDofM(Index firstCol, Index n, MatrixXr& U, VectorType& singVals, MatrixXr& V)
+{
+  using std::abs;
+  const RealScalar considerZero = (std::numeric_limits<RealScalar>::min)();
+  ArrayXr col0 = m_computed.col(firstCol).segment(firstCol, n).array();
+  ArrayXr diag = m_computed.block(firstCol, firstCol, n, n).diagonal().array();
+  diag(0) = 0;
+
+  // Allocate space for singular values and vectors
+  singVals.resize(n);
+  U.resize(n+1, n+1);
+  if (compV) V.resize(n, n);
+
+  // Many singular values might have been deflated, the zero ones have been moved to the end,
+  // but others are interleaved and we must ignore them at this stage.
+  // To this end, let's compute a permutation skipping them:
+  Index actual_n = n;
+  while (actual_n > 1 && diag(actual_n - 1) == 0) --actual_n;
+  ArrayXi perm(actual_n);
+  Index m = 0; // size of the deflated problem
+  for (Index k = 0; k < actual_n; ++k)
+    if (abs(col0(k)) > considerZero)
+      perm(m++) = k;
+  perm.conservativeResize(m);
+
+  ArrayXr shifts(n), mus(n), zhat(n);
+
+  // Compute singVals, shifts, and mus
+  computeSingVals(col0, diag, perm, singVals, shifts, mus);
+
+  // Compute zhat
+  perturbCol0(col0, diag, perm, singVals, shifts, mus, zhat);
+
+  // Compute singular vectors
+  computeSingVecs(zhat, diag, perm, singVals, shifts, mus, U, V);
+
+  // Because of deflation, the singular values might not be completely sorted.
+  // Fortunately, reordering them is a O(n) problem
+  for (Index i = 0; i < actual_n - 1; ++i)
+  {
+    if (singVals(i) > singVals(i + 1))
+    {
+      using std::swap;
+      swap(singVals(i), singVals(i + 1));
+      U.col(i).swap(U.col(i + 1));
+      if (compV) V.col(i).swap(V.col(i + 1));
+    }
+  }
+
+  // Reverse order so that singular values are in decreasing order
+  // Because of deflation, the zeros singular-values are already at the end
+  singVals.head(actual_n).reverseInPlace();
+  U.leftCols(actual_n) = U.leftCols(actual_n).rowwise().reverse().eval();
+  if (compV) V.leftCols(actual_n) = V.leftCols(actual_n).rowwise().reverse().eval();
+}
+
+template <typename MatrixType>
+typename BDCSVD<MatrixType>::RealScalar BDCSVD<MatrixType>::secularEq(RealScalar mu, const ArrayXr& col0, const ArrayXr& diag, const ArrayXi& perm, const ArrayXr& diagShifted, RealScalar shift)
+{
+  Index m = perm.size();
+  RealScalar res = 1;
+  for (Index i = 0; i < m; ++i)
+  {
+    Index j = perm(i);
+    // The following expression could be rewritten to involve only a single division,
+    // but this would make the expression more sensitive to overflow.
+    res += (col0(j) / (diagShifted(j) - mu)) * (col0(j) / (diag(j) + shift + mu));
+  }
+  return res;
+}
+
+// Finds the roots of the secular equation 1 + sum_j z_j^2 / (d_j^2 - s^2) = 0, one between each pair of
+// consecutive non deflated d_j, and the last one after the largest d_j. Each root is computed relatively to
+// the closest end of its interval, the shift, to keep the differences d_j - s accurate.
+template <typename MatrixType>
+void BDCSVD<MatrixType>::computeSingVals(const ArrayXr& col0, const ArrayXr& diag, const ArrayXi& perm,
+                                         VectorType& singVals, ArrayXr& shifts, ArrayXr& mus)
+{
+  using std::abs;
+  using std::swap;
+  using std::sqrt;
+
+  Index n = col0.size();
+  Index actual_n = n;
+  // Note that here actual_n is computed based on col0(i)==0 instead of diag(i)==0 as above
+  // because 1) we have diag(i)==0 => col0(i)==0 and 2) if col0(i)==0, then diag(i) is already a singular value.
+  while (actual_n > 1 && col0(actual_n - 1) == 0) --actual_n;
+
+  ArrayXr diagShifted(n);
+  for (Index k = 0; k < n; ++k)
+  {
+    if (col0(k) == 0 || actual_n == 1)
+    {
+      // if col0(k) == 0, then entry is deflated, so singular value is on diagonal
+      // if actual_n==1, then the deflated problem is already diagonalized
+      singVals(k) = k == 0 ? col0(0) : diag(k);
+      mus(k) = 0;
+      shifts(k) = k == 0 ? col0(0) : diag(k);
+      continue;
+    }
+
+    // otherwise, use secular equation to find singular value
+    RealScalar left = diag(k);
+    RealScalar right;
+    if (k == actual_n - 1)
+      right = (diag(actual_n - 1) + col0.matrix().norm());
+    else
+    {
+      // Skip deflated singular values
+      Index l = k + 1;
+      while (col0(l) == 0) { ++l; eigen_internal_assert(l < actual_n); }
+      right = diag(l);
+    }
+
+    // first decide whether it's closer to the left end or the right end
+    RealScalar mid = left + (right - left) / RealScalar(2);
+    RealScalar fMid = secularEq(mid, col0, diag, perm, diag, 0);
+    RealScalar shift = (k == actual_n - 1 || fMid > 0) ? left : right;
+
+    // measure everything relative to shift
+    diagShifted = diag - shift;
+
+    if (k != actual_n - 1)
+    {
+      // check that after the shift, f(mid) is still negative:
+      RealScalar midShifted = (right - left) / RealScalar(2);
+      if (shift == right)
+        midShifted = -midShifted;
+      RealScalar fMidShifted = secularEq(midShifted, col0, diag, perm, diagShifted, shift);
+      if (fMidShifted > 0)
+      {
+        // fMid was erroneous, fix it:
+        shift = left;
+        diagShifted = diag - shift;
+      }
+    }
+
+    // initial guess
+    RealScalar muPrev, muCur;
+    if (shift == left)
+    {
+      muPrev = (right - left) * RealScalar(0.1);
+      if (k == actual_n - 1) muCur = right - left;
+      else muCur = (right - left) * RealScalar(0.5);
+    }
+    else
+    {
+      muPrev = -(right - left) * RealScalar(0.1);
+      muCur = -(right - left) * RealScalar(0.5);
+    }
+
+    RealScalar fPrev = secularEq(muPrev, col0, diag, perm, diagShifted, shift);
+    RealScalar fCur = secularEq(muCur, col0, diag, perm, diagShifted, shift);
+    if (abs(fPrev) < abs(fCur))
+    {
+      swap(fPrev, fCur);
+      swap(muPrev, muCur);
+    }
+
+    // rational interpolation: fit a function of the form a / mu + b through the two previous
+    // iterates and use its zero to compute the next iterate
+    bool useBisection = fPrev * fCur > 0;
+    while (fCur != 0 && abs(muCur - muPrev) > RealScalar(8) * NumTraits<RealScalar>::epsilon() * (std::max)(abs(muCur), abs(muPrev))
+           && abs(fCur - fPrev) > NumTraits<RealScalar>::epsilon() && !useBisection)
+    {
+      // Find a and b such that the function f(mu) = a / mu + b matches the current and previous samples.
+      RealScalar a = (fCur - fPrev) / (RealScalar(1)/muCur - RealScalar(1)/muPrev);
+      RealScalar b = fCur - a / muCur;
+      // And find mu such that f(mu)==0:
+      RealScalar muZero = -a/b;
+      RealScalar fZero = secularEq(muZero, col0, diag, perm, diagShifted, shift);
+
+      muPrev = muCur;
+      fPrev = fCur;
+      muCur = muZero;
+      fCur = fZero;
+
+      if (shift == left  && (muCur < 0 || muCur > right - left)) useBisection = true;
+      if (shift == right && (muCur < -(right - left) || muCur > 0)) useBisection = true;
+      if (abs(fCur) > abs(fPrev)) useBisection = true;
+    }
+
+    // fall back on bisection method if rational interpolation did not work
+    if (useBisection)
+    {
+      RealScalar leftShifted, rightShifted;
+      if (shift == left)
+      {
+        // to avoid overflow, we must have mu > max(real_min, |z(k)|/sqrt(real_max)),
+        // the factor 2 is to be more conservative
+        leftShifted = (std::max)((std::numeric_limits<RealScalar>::min)(),
+                                 RealScalar(2) * abs(col0(k)) / sqrt((std::numeric_limits<RealScalar>::max)()));
+        rightShifted = (k == actual_n - 1) ? right : ((right - left) * RealScalar(0.51)); // theoretically we can take 0.5, but let's be safe
+      }
+      else
+      {
+        leftShifted = -(right - left) * RealScalar(0.51);
+        if (k + 1 < n)
+          rightShifted = -(std::max)((std::numeric_limits<RealScalar>::min)(),
+                                     abs(col0(k + 1)) / sqrt((std::numeric_limits<RealScalar>::max)()));
+        else
+          rightShifted = -(std::numeric_limits<RealScalar>::min)();
+      }
+
+      RealScalar fLeft = secularEq(leftShifted, col0, diag, perm, diagShifted, shift);
+
+      while (rightShifted - leftShifted > RealScalar(2) * NumTraits<RealScalar>::epsilon() * (std::max)(abs(leftShifted), abs(rightShifted)))
+      {
+        RealScalar midShifted = (leftShifted + rightShifted) / RealScalar(2);
+        fMid = secularEq(midShifted, col0, diag, perm, diagShifted, shift);
+        if (fLeft * fMid < 0)
+        {
+          rightShifted = midShifted;
+        }
+        else
+        {
+          leftShifted = midShifted;
+          fLeft = fMid;
+        }
+      }
+
+      muCur = (leftShifted + rightShifted) / RealScalar(2);
+    }
+
+    singVals[k] = shift + muCur;
+    shifts[k] = shift;
+    mus[k] = muCur;
+  }
+}
+
+
+// zhat is perturbation of col0 for which singular vectors can be computed stably (see Section 3.1)
+template <typename MatrixType>
+void BDCSVD<MatrixType>::perturbCol0(const ArrayXr& col0, const ArrayXr& diag, const ArrayXi& perm, const VectorType& singVals,
+                                     const ArrayXr& shifts, const ArrayXr& mus, ArrayXr& zhat)
+{
+  using std::sqrt;
+  Index n = col0.size();
+  Index m = perm.size();
+  if (m == 0)
+  {
+    zhat.setZero();
+    return;
+  }
+  Index lastIdx = perm(m - 1);
+  for (Index k = 0; k < n; ++k)
+  {
+    if (col0(k) == 0) // deflated
+      zhat(k) = 0;
+    else
+    {
+      // see equation (3.6)
+      RealScalar dk = diag(k);
+      RealScalar prod = (singVals(lastIdx) + dk) * (mus(lastIdx) + (shifts(lastIdx) - dk));
+
+      for (Index l = 0; l < m; ++l)
+      {
+        Index i = perm(l);
+        if (i != k)
+        {
+          Index j = i < k ? i : perm(l - 1);
+          prod *= ((singVals(j) + dk) / ((diag(i) + dk))) * ((mus(j) + (shifts(j) - dk)) / ((diag(i) - dk)));
+        }
+      }
+      // prod is only negative because of roundoff errors
+      RealScalar tmp = sqrt((std::max)(prod, RealScalar(0)));
+      zhat(k) = col0(k) > 0 ? tmp : -tmp;
+    }
+  }
+}
+
+// compute singular vectors
+template <typename MatrixType>
+void BDCSVD<MatrixType>::computeSingVecs(const ArrayXr& zhat, const ArrayXr& diag, const ArrayXi& perm, const VectorType& singVals,
+                                         const ArrayXr& shifts, const ArrayXr& mus, MatrixXr& U, MatrixXr& V)
+{
+  Index n = zhat.size();
+  Index m = perm.size();
+
+  for (Index k = 0; k < n; ++k)
+  {
+    if (zhat(k) == 0)
+    {
+      U.col(k) = VectorType::Unit(n + 1, k);
+      if (compV) V.col(k) = VectorType::Unit(n, k);
+    }
+    else
+    {
+      U.col(k).setZero();
+      for (Index l = 0; l < m; ++l)
+      {
+        Index i = perm(l);
+        U(i, k) = zhat(i) / (((diag(i) - shifts(k)) - mus(k))) / ((diag(i) + singVals[k]));
+      }
+      U(n, k) = 0;
+      U.col(k).normalize();
+
+      if (compV)
+      {
+        V.col(k).setZero();
+        for (Index l = 1; l < m; ++l)
+        {
+          Index i = perm(l);
+          V(i, k) = diag(i) * zhat(i) / (((diag(i) - shifts(k)) - mus(k))) / ((diag(i) + singVals[k]));
+        }
+        V(0, k) = -1;
+        V.col(k).normalize();
+      }
+    }
+  }
+  U.col(n) = VectorType::Unit(n + 1, n);
+}
 
 
 // page 12_13
@@ -503,30 +923,21 @@ void BDCSVD<MatrixType>::divide (Index firstCol, Index lastCol, Index firstRowW,
 // We use a rotation to zero out zi applied to the left of M
 template <typename MatrixType>
 void BDCSVD<MatrixType>::deflation43(Index firstCol, Index shift, Index i, Index size){
-  using std::abs;
-  using std::sqrt;
-  using std::pow;
-  RealScalar c = m_computed(firstCol + shift, firstCol + shift);
-  RealScalar s = m_computed(i, firstCol + shift);
-  RealScalar r = sqrt(pow(abs(c), 2) + pow(abs(s), 2));
+  Index start = firstCol + shift;
+  RealScalar c = m_computed(start, start);
+  RealScalar s = m_computed(start + i, start);
+  RealScalar r = numext::hypot(c, s);
   if (r == 0){
-    m_computed(i, i)=0;
+    m_computed(start + i, start + i) = 0;
     return;
   }
-  c/=r;
-  s/=r;
-  m_computed(firstCol + shift, firstCol + shift) = r;  
-  m_computed(i, firstCol + shift) = 0;
-  m_computed(i, i) = 0;
-  if (compU){
-    m_naiveU.col(firstCol).segment(firstCol,size) = 
-      c * m_naiveU.col(firstCol).segment(firstCol, size) - 
-      s * m_naiveU.col(i).segment(firstCol, size) ;
-
-    m_naiveU.col(i).segment(firstCol, size) = 
-      (c + s*s/c) * m_naiveU.col(i).segment(firstCol, size) + 
-      (s/c) * m_naiveU.col(firstCol).segment(firstCol,size);
-  }
+  m_computed(start, start) = r;
+  m_computed(start + i, start) = 0;
+  m_computed(start + i, start + i) = 0;
+
+  JacobiRotation<RealScalar> J(c/r, -s/r);
+  if (compU) m_naiveU.middleRows(firstCol, size + 1).applyOnTheRight(firstCol, firstCol + i, J);
+  else m_naiveU.applyOnTheRight(firstCol, firstCol + i, J);
 }// end deflation 43
 
 
@@ -535,165 +946,141 @@ void BDCSVD<MatrixType>::deflation43(Index firstCol, Index shift, Index i, Index
 // We apply two rotations to have zj = 0;
 template <typename MatrixType>
 void BDCSVD<MatrixType>::deflation44(Index firstColu , Index firstColm, Index firstRowW, Index firstColW, Index i, Index j, Index size){
-  using std::abs;
   using std::sqrt;
-  using std::conj;
-  using std::pow;
-  RealScalar c = m_computed(firstColm, firstColm + j - 1);
-  RealScalar s = m_computed(firstColm, firstColm + i - 1);
-  RealScalar r = sqrt(pow(abs(c), 2) + pow(abs(s), 2));
-  if (r==0){
+  RealScalar c = m_computed(firstColm + i, firstColm);
+  RealScalar s = m_computed(firstColm + j, firstColm);
+  RealScalar r = sqrt(numext::abs2(c) + numext::abs2(s));
+  if (r == 0){
     m_computed(firstColm + i, firstColm + i) = m_computed(firstColm + j, firstColm + j);
     return;
   }
   c/=r;
   s/=r;
-  m_computed(firstColm + i, firstColm) = r;  
-  m_computed(firstColm + i, firstColm + i) = m_computed(firstColm + j, firstColm + j);
+  m_computed(firstColm + i, firstColm) = r;
+  m_computed(firstColm + j, firstColm + j) = m_computed(firstColm + i, firstColm + i);
   m_computed(firstColm + j, firstColm) = 0;
-  if (compU){
-    m_naiveU.col(firstColu + i).segment(firstColu, size) = 
-      c * m_naiveU.col(firstColu + i).segment(firstColu, size) - 
-      s * m_naiveU.col(firstColu + j).segment(firstColu, size) ;
-
-    m_naiveU.col(firstColu + j).segment(firstColu, size) = 
-      (c + s*s/c) *  m_naiveU.col(firstColu + j).segment(firstColu, size) + 
-      (s/c) * m_naiveU.col(firstColu + i).segment(firstColu, size);
-  } 
-  if (compV){
-    m_naiveV.col(firstColW + i).segment(firstRowW, size - 1) = 
-      c * m_naiveV.col(firstColW + i).segment(firstRowW, size - 1) + 
-      s * m_naiveV.col(firstColW + j).segment(firstRowW, size - 1) ;
-
-    m_naiveV.col(firstColW + j).segment(firstRowW, size - 1)  = 
-      (c + s*s/c) * m_naiveV.col(firstColW + j).segment(firstRowW, size - 1) - 
-      (s/c) * m_naiveV.col(firstColW + i).segment(firstRowW, size - 1);
-  }
-}// end deflation 44
 
+  JacobiRotation<RealScalar> J(c, -s);
+  if (compU) m_naiveU.middleRows(firstColu, size + 1).applyOnTheRight(firstColu + i, firstColu + j, J);
+  else m_naiveU.applyOnTheRight(firstColu + i, firstColu + j, J);
+  if (compV) m_naiveV.middleRows(firstRowW, size).applyOnTheRight(firstColW + i, firstColW + j, J);
+}// end deflation 44
 
 
+// acts on block from (firstCol+shift, firstCol+shift) to (lastCol+shift, lastCol+shift) [inclusive]
 template <typename MatrixType>
 void BDCSVD<MatrixType>::deflation(Index firstCol, Index lastCol, Index k, Index firstRowW, Index firstColW, Index shift){
-  //condition 4.1
-  RealScalar EPS = EPSILON * (std::max<RealScalar>(m_computed(firstCol + shift + 1, firstCol + shift + 1), m_computed(firstCol + k, firstCol + k)));
+  using std::abs;
   const Index length = lastCol + 1 - firstCol;
-  if (m_computed(firstCol + shift, firstCol + shift) < EPS){
-    m_computed(firstCol + shift, firstCol + shift) = EPS;
+
+  Block<MatrixXr,Dynamic,1> col0(m_computed, firstCol + shift, firstCol + shift, length, 1);
+  Diagonal<MatrixXr> fulldiag(m_computed);
+  VectorBlock<Diagonal<MatrixXr>,Dynamic> diag(fulldiag, firstCol + shift, length);
+
+  // the thresholds are relative to the norm of the combined matrix
+  const RealScalar considerZero = (std::numeric_limits<RealScalar>::min)();
+  RealScalar maxDiag = diag.tail((std::max)(Index(1), length - 1)).cwiseAbs().maxCoeff();
+  RealScalar epsilon_strict = (std::max)(considerZero, NumTraits<RealScalar>::epsilon() * maxDiag);
+  RealScalar epsilon_coarse = RealScalar(8) * NumTraits<RealScalar>::epsilon() * (std::max)(col0.cwiseAbs().maxCoeff(), maxDiag);
+
+  //condition 4.1
+  if (diag(0) < epsilon_coarse){
+    diag(0) = epsilon_coarse;
   }
+
   //condition 4.2
-  for (Index i=firstCol + shift + 1;i<=lastCol + shift;i++){
-    if (std::abs(m_computed(i, firstCol + shift)) < EPS){
-      m_computed(i, firstCol + shift) = 0;
-    }
-  }
+  for (Index i = 1; i < length; ++i)
+    if (abs(col0(i)) < epsilon_strict)
+      col0(i) = 0;
 
   //condition 4.3
-  for (Index i=firstCol + shift + 1;i<=lastCol + shift; i++){
-    if (m_computed(i, i) < EPS){
+  for (Index i = 1; i < length; i++)
+    if (diag(i) < epsilon_coarse)
       deflation43(firstCol, shift, i, length);
-    }
-  }
 
-  //condition 4.4
- 
-  Index i=firstCol + shift + 1, j=firstCol + shift + k + 1;
-  //we stock the final place of each line
-  Index *permutation = new Index[length];
-
-  for (Index p =1; p < length; p++) {
-    if (i> firstCol + shift + k){
-      permutation[p] = j;
-      j++;
-    } else if (j> lastCol + shift) 
+  {
+    // Check for total deflation
+    // If we have a total deflation, then we have to consider col0(0)==diag(0) as a singular value during sorting
+    bool total_deflation = (col0.tail(length - 1).array().abs() < considerZero).all();
+
+    // Sort the diagonal entries, since diag(1:k-1) and diag(k:length) are already sorted, let's do a sorted merge.
+    // First, compute the respective permutation.
+    ArrayXi permutation(length);
     {
-      permutation[p] = i;
-      i++;
+      permutation[0] = 0;
+      Index p = 1;
+
+      // Move deflated diagonal entries at the end.
+      for (Index i = 1; i < length; ++i)
+        if (abs(diag(i)) < considerZero)
+          permutation[p++] = i;
+
+      Index i = 1, j = k + 1;
+      for ( ; p < length; ++p)
+      {
+             if (i > k)             permutation[p] = j++;
+        else if (j >= length)       permutation[p] = i++;
+        else if (diag(i) < diag(j)) permutation[p] = j++;
+        else                        permutation[p] = i++;
+      }
     }
-    else 
+
+    // If we have a total deflation, then we have to insert diag(0) at the right place
+    if (total_deflation)
     {
-      if (m_computed(i, i) < m_computed(j, j)){
-        permutation[p] = j;
-        j++;
-      } 
-      else
+      for (Index i = 1; i < length; ++i)
       {
-        permutation[p] = i;
-        i++;
+        Index pi = permutation[i];
+        if (abs(diag(pi)) < considerZero || diag(0) < diag(pi))
+          permutation[i - 1] = permutation[i];
+        else
+        {
+          permutation[i - 1] = 0;
+          break;
+        }
       }
     }
-  }
-  //we do the permutation
-  RealScalar aux;
-  //we stock the current index of each col
-  //and the column of each index
-  Index *realInd = new Index[length];
-  Index *realCol = new Index[length];
-  for (int pos = 0; pos< length; pos++){
-    realCol[pos] = pos + firstCol + shift;
-    realInd[pos] = pos;
-  }
-  const Index Zero = firstCol + shift;
-  VectorType temp;
-  for (int i = 1; i < length - 1; i++){
-    const Index I = i + Zero;
-    const Index realI = realInd[i];
-    const Index j  = permutation[length - i] - Zero;
-    const Index J = realCol[j];
-    
-    //diag displace
-    aux = m_computed(I, I); 
-    m_computed(I, I) = m_computed(J, J);
-    m_computed(J, J) = aux;
-    
-    //firstrow displace
-    aux = m_computed(I, Zero); 
-    m_computed(I, Zero) = m_computed(J, Zero);
-    m_computed(J, Zero) = aux;
-
-    // change columns
-    if (compU) {
-      temp = m_naiveU.col(I - shift).segment(firstCol, length + 1);
-      m_naiveU.col(I - shift).segment(firstCol, length + 1) << 
-        m_naiveU.col(J - shift).segment(firstCol, length + 1);
-      m_naiveU.col(J - shift).segment(firstCol, length + 1) << temp;
-    } 
-    else
+
+    // Current index of each col, and current column of each index
+    ArrayXi realInd(length), realCol(length);
+    for (Index pos = 0; pos < length; pos++)
     {
-      temp = m_naiveU.col(I - shift).segment(0, 2);
-      m_naiveU.col(I - shift).segment(0, 2) << 
-        m_naiveU.col(J - shift).segment(0, 2);
-      m_naiveU.col(J - shift).segment(0, 2) << temp;      
-    }
-    if (compV) {
-      const Index CWI = I + firstColW - Zero;
-      const Index CWJ = J + firstColW - Zero;
-      temp = m_naiveV.col(CWI).segment(firstRowW, length);
-      m_naiveV.col(CWI).segment(firstRowW, length) << m_naiveV.col(CWJ).segment(firstRowW, length);
-      m_naiveV.col(CWJ).segment(firstRowW, length) << temp;
+      realCol[pos] = pos;
+      realInd[pos] = pos;
     }
 
-    //update real pos
-    realCol[realI] = J;
-    realCol[j] = I;
-    realInd[J - Zero] = realI;
-    realInd[I - Zero] = j;
-  }
-  for (Index i = firstCol + shift + 1; i<lastCol + shift;i++){
-    if ((m_computed(i + 1, i + 1) - m_computed(i, i)) < EPS){
-      deflation44(firstCol , 
-		  firstCol + shift, 
-		  firstRowW, 
-		  firstColW, 
-		  i - Zero, 
-		  i + 1 - Zero, 
-		  length);
+    for (Index i = total_deflation ? 0 : 1; i < length; i++)
+    {
+      const Index pi = permutation[length - (total_deflation ? i + 1 : i)];
+      const Index J = realCol[pi];
+
+      using std::swap;
+      // swap diagonal and first column entries:
+      swap(diag(i), diag(J));
+      if (i != 0 && J != 0) swap(col0(i), col0(J));
+
+      // change columns
+      if (compU) m_naiveU.col(firstCol + i).segment(firstCol, length + 1).swap(m_naiveU.col(firstCol + J).segment(firstCol, length + 1));
+      else m_naiveU.col(firstCol + i).segment(0, 2).swap(m_naiveU.col(firstCol + J).segment(0, 2));
+      if (compV) m_naiveV.col(firstColW + i).segment(firstRowW, length).swap(m_naiveV.col(firstColW + J).segment(firstRowW, length));
+
+      //update real pos
+      const Index realI = realInd[i];
+      realCol[realI] = J;
+      realCol[pi] = i;
+      realInd[J] = realI;
+      realInd[i] = pi;
     }
   }
-  delete [] permutation;
-  delete [] realInd;
-  delete [] realCol;
 
+  //condition 4.4
+  {
+    Index i = length - 1;
+    while (i > 0 && (abs(diag(i)) < considerZero || abs(col0(i)) < considerZero)) --i;
+    for (; i > 1; --i)
+      if ((diag(i) - diag(i - 1)) < NumTraits<RealScalar>::epsilon() * maxDiag)
+        deflation44(firstCol, firstCol + shift, firstRowW, firstColW, i - 1, i, length);
+  }
 }//end deflation
 
 
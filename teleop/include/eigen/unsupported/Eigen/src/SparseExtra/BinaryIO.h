@@ -0,0 +1,371 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SPARSE_BINARY_IO_H
+#define EIGEN_SPARSE_BINARY_IO_H
+
+namespace Eigen {
+
+namespace internal
+{
+  /** \internal Header of the binary sparse files.
+    *
+    * The header is followed by the arrays of a compressed sparse matrix, in the native byte order:
+    * the outer index array, the inner index array and the values, each of them starting at an offset
+    * multiple of 16 bytes. The sizes are stored as pairs of 32 bits words. The entries of the outer index
+    * array have their own size, which is the one of the inner indices in the files not recording it. */
+  struct binary_sparse_header
+  {
+    enum { Version = 1, RowMajorFlag = 0x1, ComplexFlag = 0x2, IntegerFlag = 0x4, Alignment = 16 };
+
+    char magic[8];
+    int version;
+    int flags;
+    int scalarSize;
+    int indexSize;
+    unsigned int sizes[6];
+    int outerIndexSize;
+    char reserved[12];
+
+    static const char* magicString() { return "EIGENSPB"; }
+
+    template<typename Scalar, typename Index, typename OuterIndex>
+    void set(bool isRowMajor, Index rows, Index cols, OuterIndex nnz)
+    {
+      std::memset(this, 0, sizeof(binary_sparse_header));
+      std::memcpy(magic, magicString(), 8);
+      version = Version;
+      flags = (isRowMajor ? RowMajorFlag : 0)
+            | (NumTraits<Scalar>::IsComplex ? ComplexFlag : 0)
+            | (NumTraits<Scalar>::IsInteger ? IntegerFlag : 0);
+      scalarSize = sizeof(Scalar);
+      indexSize = sizeof(Index);
+      outerIndexSize = sizeof(OuterIndex);
+      setSize(0, rows);
+      setSize(1, cols);
+      setSize(2, nnz);
+    }
+
+    /** \returns whether the file holds a matrix of the given scalar, index and outer index types */
+    template<typename Scalar, typename Index, typename OuterIndex>
+    bool matches() const
+    {
+      return std::memcmp(magic, magicString(), 8)==0 && version==Version
+          && scalarSize==int(sizeof(Scalar)) && indexSize==int(sizeof(Index))
+          && (outerIndexSize ? outerIndexSize : indexSize)==int(sizeof(OuterIndex))
+          && bool(flags & ComplexFlag)==bool(NumTraits<Scalar>::IsComplex)
+          && bool(flags & IntegerFlag)==bool(NumTraits<Scalar>::IsInteger);
+    }
+
+    bool isRowMajor() const { return (flags & RowMajorFlag)!=0; }
+
+    /** \returns whether the sizes can be represented by the index types, and the arrays fit in the \a length bytes following the header */
+    template<typename Scalar, typename Index, typename OuterIndex>
+    bool fits(std::size_t length) const
+    {
+      const std::size_t rows = size(0), cols = size(1), nnz = size(2);
+      const std::size_t maxIndex = std::size_t(NumTraits<Index>::highest());
+      if(rows>maxIndex || cols>maxIndex || nnz>maxIndex || nnz>std::size_t(NumTraits<OuterIndex>::highest()))
+        return false;
+      const std::size_t outerSize = isRowMajor() ? rows : cols;
+      return consume(length, outerSize+1, sizeof(OuterIndex))
+          && consume(length, nnz, sizeof(Index))
+          && consume(length, nnz, sizeof(Scalar));
+    }
+
+    void setSize(int k, std::size_t size)
+    {
+      sizes[2*k]   = static_cast<unsigned int>(size & 0xffffffffu);
+      sizes[2*k+1] = static_cast<unsigned int>((size >> 16) >> 16);
+    }
+    std::size_t size(int k) const
+    {
+      return std::size_t(sizes[2*k]) | ((std::size_t(sizes[2*k+1]) << 16) << 16);
+    }
+
+    static std::size_t padding(std::size_t bytes) { return (Alignment - bytes % Alignment) % Alignment; }
+
+    // removes from length an array of count elements and its padding, which may be missing at the end of the file
+    static bool consume(std::size_t& length, std::size_t count, std::size_t elementSize)
+    {
+      if(count > length/elementSize)
+        return false;
+      const std::size_t bytes = count*elementSize;
+      length -= bytes;
+      length -= (std::min)(padding(bytes), length);
+      return true;
+    }
+  };
+
+  inline bool write_binary_array(std::FILE* file, const void* data, std::size_t bytes)
+  {
+    static const char zeros[binary_sparse_header::Alignment] = { 0 };
+    return std::fwrite(data, 1, bytes, file)==bytes
+        && std::fwrite(zeros, 1, binary_sparse_header::padding(bytes), file)==binary_sparse_header::padding(bytes);
+  }
+
+  /** \internal \returns the number of bytes between the current position of \a file and its end, or 0 if it cannot be determined */
+  inline std::size_t remaining_file_length(std::FILE* file)
+  {
+    const long position = std::ftell(file);
+    if(position<0 || std::fseek(file, 0, SEEK_END)!=0)
+      return 0;
+    const long end = std::ftell(file);
+    if(std::fseek(file, position, SEEK_SET)!=0 || end<position)
+      return 0;
+    return std::size_t(end - position);
+  }
+
+  /** \internal \returns whether the outer index array starts at 0, is non-decreasing and ends at \a nnz,
+    * and whether the inner indices are in [0, \a innerSize) */
+  template<typename Index, typename OuterIndex>
+  bool check_compressed_arrays(const OuterIndex* outer, const Index* inner, Index outerSize, Index innerSize, OuterIndex nnz)
+  {
+    if(outer[0]!=0 || outer[outerSize]!=nnz)
+      return false;
+    for(Index j = 0; j < outerSize; ++j)
+      if(outer[j+1] < outer[j])
+        return false;
+    for(OuterIndex p = 0; p < nnz; ++p)
+      if(inner[p] < 0 || inner[p] >= innerSize)
+        return false;
+    return true;
+  }
+
+  inline bool read_binary_array(std::FILE* file, void* data, std::size_t bytes)
+  {
+    char skip[binary_sparse_header::Alignment];
+    return std::fread(data, 1, bytes, file)==bytes
+        && std::fread(skip, 1, binary_sparse_header::padding(bytes), file)==binary_sparse_header::padding(bytes);
+  }
+
+} // end namespace internal
+
+/** \ingroup SparseExtra_Module
+  * Saves the sparse matrix \a mat in the binary format read by loadBinary() and MappedBinarySparseMatrix.
+  *
+  * The file stores the compressed arrays of \a mat as they are in memory, in the storage order of \a mat.
+  * It is therefore much faster to write and to read than the Matrix Market format, but it is only portable
+  * between systems having the same byte order.
+  *
+  * \returns false if the file could not be written
+  *
+  * \sa loadBinary(), MappedBinarySparseMatrix, saveMarket() */
+template<typename Scalar, int Options, typename Index, typename OuterIndex>
+bool saveBinary(const SparseMatrix<Scalar,Options,Index,OuterIndex>& mat, const std::string& filename)
+{
+  if(!mat.isCompressed())
+  {
+    SparseMatrix<Scalar,Options,Index,OuterIndex> tmp(mat);
+    tmp.makeCompressed();
+    return saveBinary(tmp, filename);
+  }
+  std::FILE* file = std::fopen(filename.c_str(), "wb");
+  if(!file)
+    return false;
+  internal::binary_sparse_header header;
+  header.set<Scalar,Index,OuterIndex>(mat.IsRowMajor, mat.rows(), mat.cols(), mat.nonZeros());
+  const std::size_t nnz = std::size_t(mat.nonZeros());
+  bool ok = std::fwrite(&header, sizeof(header), 1, file)==1
+         && internal::write_binary_array(file, mat.outerIndexPtr(), (mat.outerSize()+1)*sizeof(OuterIndex))
+         && internal::write_binary_array(file, mat.innerIndexPtr(), nnz*sizeof(Index))
+         && internal::write_binary_array(file, mat.valuePtr(), nnz*sizeof(Scalar));
+  return (std::fclose(file)==0) && ok;
+}
+
+/** \ingroup SparseExtra_Module
+  * Overload of saveBinary() for any other sparse expression, which is first evaluated into a SparseMatrix. */
+template<typename Derived>
+bool saveBinary(const SparseMatrixBase<Derived>& mat, const std::string& filename)
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename Derived::Index Index;
+  typedef typename internal::sparse_outer_index<Derived>::type OuterIndex;
+  SparseMatrix<Scalar,Derived::IsRowMajor?RowMajor:ColMajor,Index,OuterIndex> tmp(mat.derived());
+  return saveBinary(tmp, filename);
+}
+
+/** \ingroup SparseExtra_Module
+  * Loads into \a mat a sparse matrix saved by saveBinary().
+  *
+  * The arrays are directly read into \a mat when the storage orders match, otherwise the matrix is read
+  * in the storage order of the file and then converted.
+  *
+  * The sizes of the header are checked against the length of the file before anything is allocated, and the
+  * index arrays are checked after they are read, such that a truncated or corrupted file is rejected.
+  *
+  * \returns false if the file could not be read, if it is invalid, or if it does not hold a matrix of the same scalar, index
+  * and outer index types. In the former cases, \a mat is left empty.
+  *
+  * \sa saveBinary(), MappedBinarySparseMatrix, loadMarket() */
+template<typename Scalar, int Options, typename Index, typename OuterIndex>
+bool loadBinary(SparseMatrix<Scalar,Options,Index,OuterIndex>& mat, const std::string& filename)
+{
+  std::FILE* file = std::fopen(filename.c_str(), "rb");
+  if(!file)
+    return false;
+  internal::binary_sparse_header header;
+  if(std::fread(&header, sizeof(header), 1, file)!=1 || !header.matches<Scalar,Index,OuterIndex>())
+  {
+    std::fclose(file);
+    return false;
+  }
+  if(header.isRowMajor()!=bool(Options&RowMajorBit))
+  {
+    std::fclose(file);
+    SparseMatrix<Scalar,(Options&RowMajorBit)?ColMajor:RowMajor,Index,OuterIndex> tmp;
+    bool ok = loadBinary(tmp, filename);
+    mat = tmp;
+    return ok;
+  }
+  if(!header.fits<Scalar,Index,OuterIndex>(internal::remaining_file_length(file)))
+  {
+    std::fclose(file);
+    mat.resize(0,0);
+    return false;
+  }
+  const Index rows = Index(header.size(0)), cols = Index(header.size(1));
+  const OuterIndex nnz = OuterIndex(header.size(2));
+  mat.resize(rows, cols);
+  mat.resizeNonZeros(nnz);
+  bool ok = internal::read_binary_array(file, mat.outerIndexPtr(), (mat.outerSize()+1)*sizeof(OuterIndex))
+         && internal::read_binary_array(file, mat.innerIndexPtr(), std::size_t(nnz)*sizeof(Index))
+         && internal::read_binary_array(file, mat.valuePtr(), std::size_t(nnz)*sizeof(Scalar))
+         && internal::check_compressed_arrays(mat.outerIndexPtr(), mat.innerIndexPtr(), mat.outerSize(), mat.innerSize(), nnz);
+  std::fclose(file);
+  if(!ok)
+    mat.resize(0,0);
+  return ok;
+}
+
+#if !defined(_WIN32)
+
+namespace internal {
+
+/** \internal Memory mapping of a binary sparse file, initialized before the MappedSparseMatrix base of MappedBinarySparseMatrix */
+template<typename Scalar, int Options, typename Index>
+class binary_sparse_mapping
+{
+  protected:
+    typedef typename sparse_outer_index<MappedSparseMatrix<Scalar,Options,Index> >::type OuterIndex;
+
+    binary_sparse_mapping(const std::string& filename)
+      : m_address(0), m_length(0), m_rows(0), m_cols(0), m_nonZeros(0), m_outerPtr(&m_emptyOuter), m_innerPtr(0), m_valuePtr(0), m_emptyOuter(0)
+    {
+      int fd = ::open(filename.c_str(), O_RDONLY);
+      if(fd<0)
+        return;
+      struct stat st;
+      if(::fstat(fd, &st)==0 && std::size_t(st.st_size)>=sizeof(binary_sparse_header))
+      {
+        m_length = std::size_t(st.st_size);
+        // private writable mapping: the coefficients can be modified in memory without changing the file
+        void* address = ::mmap(0, m_length, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if(address!=MAP_FAILED)
+          m_address = address;
+      }
+      ::close(fd);
+      if(m_address && !setPointers())
+        unmap();
+    }
+
+    ~binary_sparse_mapping() { unmap(); }
+
+    bool setPointers()
+    {
+      const binary_sparse_header& header = *static_cast<const binary_sparse_header*>(m_address);
+      if(!header.matches<Scalar,Index,OuterIndex>() || header.isRowMajor()!=bool(Options&RowMajorBit)
+         || !header.fits<Scalar,Index,OuterIndex>(m_length - sizeof(binary_sparse_header)))
+        return false;
+      const std::size_t rows = header.size(0), cols = header.size(1), nnz = header.size(2);
+      const std::size_t outerSize = (Options&RowMajorBit) ? rows : cols;
+      const std::size_t outerBytes = (outerSize+1)*sizeof(OuterIndex), innerBytes = nnz*sizeof(Index);
+      const std::size_t innerOffset = sizeof(binary_sparse_header) + outerBytes + binary_sparse_header::padding(outerBytes);
+      const std::size_t valueOffset = innerOffset + innerBytes + binary_sparse_header::padding(innerBytes);
+      char* base = static_cast<char*>(m_address);
+      m_outerPtr  = reinterpret_cast<OuterIndex*>(base + sizeof(binary_sparse_header));
+      m_innerPtr  = reinterpret_cast<Index*>(base + innerOffset);
+      m_valuePtr = reinterpret_cast<Scalar*>(base + valueOffset);
+      m_rows = Index(rows);
+      m_cols = Index(cols);
+      m_nonZeros  = Index(nnz);
+      return m_outerPtr[outerSize]==OuterIndex(m_nonZeros);
+    }
+
+    void unmap()
+    {
+      if(m_address)
+        ::munmap(m_address, m_length);
+      m_address = 0;
+      m_rows = m_cols = m_nonZeros = 0;
+      m_outerPtr = &m_emptyOuter;
+      m_innerPtr = 0;
+      m_valuePtr = 0;
+    }
+
+    void* m_address;
+    std::size_t m_length;
+    Index m_rows, m_cols, m_nonZeros;
+    OuterIndex* m_outerPtr;
+    Index* m_innerPtr;
+    Scalar* m_valuePtr;
+    OuterIndex m_emptyOuter;
+
+  private:
+    binary_sparse_mapping(const binary_sparse_mapping&);
+    binary_sparse_mapping& operator=(const binary_sparse_mapping&);
+};
+
+} // end namespace internal
+
+/** \ingroup SparseExtra_Module
+  * \class MappedBinarySparseMatrix
+  *
+  * \brief A MappedSparseMatrix viewing a file written by saveBinary() through a memory mapping
+  *
+  * The file is mapped in memory when the object is constructed, and unmapped when it is destroyed.
+  * No data is read or copied upfront: the pages are loaded by the system when they are first accessed.
+  * The mapping is private, so that the coefficients can be modified in memory without changing the file.
+  *
+  * The storage order, the scalar type and the index type of the file must be the ones of the
+  * MappedBinarySparseMatrix, otherwise isValid() returns false and the matrix is empty.
+  *
+  * \code
+  * saveBinary(A, "A.bin");
+  * MappedBinarySparseMatrix<double> mA("A.bin");
+  * if(mA.isValid())
+  *   x = SimplicialLDLT<SparseMatrix<double> >(mA).solve(b);
+  * \endcode
+  *
+  * This class is not available on Windows.
+  *
+  * \sa saveBinary(), loadBinary()
+  */
+template<typename _Scalar, int _Options = ColMajor, typename _Index = int>
+class MappedBinarySparseMatrix
+  : protected internal::binary_sparse_mapping<_Scalar,_Options,_Index>,
+    public MappedSparseMatrix<_Scalar,_Options,_Index>
+{
+    typedef internal::binary_sparse_mapping<_Scalar,_Options,_Index> Mapping;
+  public:
+    typedef MappedSparseMatrix<_Scalar,_Options,_Index> Base;
+
+    /** Maps the file \a filename */
+    explicit MappedBinarySparseMatrix(const std::string& filename)
+      : Mapping(filename),
+        Base(Mapping::m_rows, Mapping::m_cols, Mapping::m_nonZeros, Mapping::m_outerPtr, Mapping::m_innerPtr, Mapping::m_valuePtr)
+    {}
+
+    /** \returns whether the file has been mapped */
+    bool isValid() const { return Mapping::m_address!=0; }
+};
+
+#endif // !defined(_WIN32)
+
+} // end namespace Eigen
+
+#endif // EIGEN_SPARSE_BINARY_IO_H
@@ -0,0 +1,399 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BLOCK_SPARSE_LLT_H
+#define EIGEN_BLOCK_SPARSE_LLT_H
+
+namespace Eigen {
+
+/** \ingroup SparseExtra_Module
+  * \class BlockSparseLLT
+  *
+  * \brief A sparse Cholesky factorization working on the blocks of a BlockSparseMatrix
+  *
+  * This class performs the LL^T Cholesky factorization of a symmetric positive definite BlockSparseMatrix A,
+  * such that P A P^T = L L^*, where L is a lower triangular block sparse matrix and P is a permutation
+  * of the blocks. The ordering, the elimination tree, and the sparsity pattern of L are computed on the
+  * graph of the blocks, which is BlockSize^2 times smaller than the graph of the coefficients. The numerical
+  * factorization is a block up-looking algorithm whose operations are fixed-size dense products on the
+  * blocks. The inverses of the diagonal blocks of L are kept, such that the solves only involve products too.
+  *
+  * \tparam _MatrixType the type of the block sparse matrix A, a BlockSparseMatrix<>
+  * \tparam _UpLo the triangular part that will be used for the computations. It can be Lower
+  *               or Upper. Default is Lower.
+  * \tparam _Ordering The ordering method to use, either AMDOrdering<> or NaturalOrdering<>. Default is AMDOrdering<>
+  *
+  * \sa BlockSparseMatrix, SimplicialLLT
+  */
+template<typename _MatrixType, int _UpLo = Lower, typename _Ordering = AMDOrdering<typename _MatrixType::Index> >
+class BlockSparseLLT
+{
+  public:
+    typedef _MatrixType MatrixType;
+    typedef _Ordering OrderingType;
+    enum { UpLo = _UpLo, BlockSize = MatrixType::BlockSize };
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::RealScalar RealScalar;
+    typedef typename MatrixType::Index Index;
+    typedef typename MatrixType::BlockType BlockType;
+    typedef typename MatrixType::BlockMap BlockMap;
+    typedef typename MatrixType::ConstBlockMap ConstBlockMap;
+    typedef Matrix<Scalar,BlockSize,1> BlockVector;
+    typedef Matrix<Index,Dynamic,1> IndexVector;
+    typedef Matrix<Scalar,Dynamic,1> ScalarVector;
+    typedef PermutationMatrix<Dynamic,Dynamic,Index> PermutationType;
+
+    BlockSparseLLT() : m_blocks(0), m_info(Success), m_isInitialized(false), m_analysisIsOk(false), m_factorizationIsOk(false) {}
+
+    explicit BlockSparseLLT(const MatrixType& matrix)
+      : m_blocks(0), m_info(Success), m_isInitialized(false), m_analysisIsOk(false), m_factorizationIsOk(false)
+    {
+      compute(matrix);
+    }
+
+    inline Index rows() const { return m_blocks*BlockSize; }
+    inline Index cols() const { return m_blocks*BlockSize; }
+
+    /** \brief Reports whether previous computation was successful.
+      *
+      * \returns \c Success if computation was succesful,
+      *          \c NumericalIssue if the matrix is not positive definite.
+      */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "Decomposition is not initialized.");
+      return m_info;
+    }
+
+    /** Computes the sparse Cholesky decomposition of \a matrix */
+    BlockSparseLLT& compute(const MatrixType& matrix)
+    {
+      analyzePattern(matrix);
+      factorize(matrix);
+      return *this;
+    }
+
+    /** Performs a symbolic decomposition on the sparsity pattern of the blocks of \a matrix.
+      *
+      * This function is particularly useful when solving for several problems having the same structure.
+      *
+      * \sa factorize()
+      */
+    void analyzePattern(const MatrixType& matrix);
+
+    /** Performs a numeric decomposition of \a matrix
+      *
+      * The given matrix must have the same sparsity pattern as the matrix on which the symbolic decomposition has been performed.
+      *
+      * \sa analyzePattern()
+      */
+    void factorize(const MatrixType& matrix);
+
+    /** \returns the solution x of \f$ A x = b \f$ using the current decomposition of A.
+      *
+      * \sa compute()
+      */
+    template<typename Rhs>
+    inline const internal::solve_retval<BlockSparseLLT, Rhs>
+    solve(const MatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_factorizationIsOk && "The decomposition is not in a valid state for solving, you must first call either compute() or symbolic()/numeric()");
+      eigen_assert(rows()==b.rows() && "BlockSparseLLT::solve(): invalid number of rows of the right hand side matrix b");
+      return internal::solve_retval<BlockSparseLLT, Rhs>(*this, b.derived());
+    }
+
+    /** \returns the permutation P of the blocks
+      * \sa permutationPinv() */
+    const PermutationType& permutationP() const { return m_P; }
+
+    /** \returns the inverse P^-1 of the permutation P of the blocks
+      * \sa permutationP() */
+    const PermutationType& permutationPinv() const { return m_Pinv; }
+
+    /** \returns the number of stored blocks of the factor L */
+    Index nonZeroBlocks() const
+    {
+      eigen_assert(m_analysisIsOk && "You must first call analyzePattern()");
+      return m_Lp[m_blocks];
+    }
+
+    /** \returns the factor L as a scalar SparseMatrix, in the permuted ordering of the blocks */
+    SparseMatrix<Scalar,ColMajor,Index> matrixL() const
+    {
+      eigen_assert(m_factorizationIsOk && "BlockSparseLLT not factorized");
+      SparseMatrix<Scalar,ColMajor,Index> L(rows(), cols());
+      L.reserve(nonZeroBlocks()*BlockSize*BlockSize);
+      for(Index j=0; j<m_blocks; ++j)
+        for(Index c=0; c<BlockSize; ++c)
+        {
+          L.startVec(j*BlockSize+c);
+          for(Index p=m_Lp[j]; p<m_Lp[j+1]; ++p)
+          {
+            ConstBlockMap block(m_Lx.data() + p*BlockSize*BlockSize);
+            for(Index r=(p==m_Lp[j] ? c : 0); r<BlockSize; ++r)
+              L.insertBackByOuterInner(j*BlockSize+c, m_Li[p]*BlockSize+r) = block(r,c);
+          }
+        }
+      L.finalize();
+      return L;
+    }
+
+    /** \returns the determinant of the underlying matrix from the current factorization */
+    Scalar determinant() const
+    {
+      Scalar detL = Scalar(1);
+      for(Index j=0; j<m_blocks; ++j)
+        detL *= ConstBlockMap(m_Lx.data() + m_Lp[j]*BlockSize*BlockSize).diagonal().prod();
+      return numext::abs2(detL);
+    }
+
+    #ifndef EIGEN_PARSED_BY_DOXYGEN
+    /** \internal */
+    template<typename Rhs, typename Dest>
+    void _solve(const MatrixBase<Rhs> &b, MatrixBase<Dest> &dest) const;
+    #endif
+
+  protected:
+    /** \internal \returns whether the block (\a i, \a j) belongs to the triangular part \a UpLo */
+    static bool isInTriangle(Index i, Index j) { return int(UpLo)==Lower ? j<=i : i<=j; }
+
+    // the permuted upper triangular part of the matrix, stored per block column, refers to the blocks of the input matrix
+    IndexVector m_apOuter, m_apRow, m_apBlock;
+    Matrix<bool,Dynamic,1> m_apTransposed;
+
+    // the factor L, stored per block column, the diagonal block being first
+    IndexVector m_parent, m_Lp, m_Li;
+    ScalarVector m_Lx;
+    ScalarVector m_diagInverse;   // inverses of the diagonal blocks of L
+
+    PermutationType m_P, m_Pinv;
+    Index m_blocks;
+    ComputationInfo m_info;
+    bool m_isInitialized, m_analysisIsOk, m_factorizationIsOk;
+};
+
+template<typename MatrixType, int UpLo, typename Ordering>
+void BlockSparseLLT<MatrixType,UpLo,Ordering>::analyzePattern(const MatrixType& matrix)
+{
+  eigen_assert(matrix.blockRows()==matrix.blockCols());
+  const Index n = matrix.blockRows();
+  const Index* outer = matrix.outerIndexPtr();
+  const Index* inner = matrix.innerIndexPtr();
+  m_blocks = n;
+
+  // ordering of the graph of the blocks
+  {
+    SparseMatrix<Scalar,ColMajor,Index> graph(n,n);
+    std::vector<Triplet<Scalar,Index> > triplets;
+    triplets.reserve(outer[n]);
+    for(Index i=0; i<n; ++i)
+      for(Index k=outer[i]; k<outer[i+1]; ++k)
+        if(isInTriangle(i, inner[k]))
+          triplets.push_back(Triplet<Scalar,Index>(i, inner[k], Scalar(1)));
+    graph.setFromTriplets(triplets.begin(), triplets.end());
+    Ordering ordering;
+    ordering(graph.template selfadjointView<UpLo>(), m_Pinv);
+    if(m_Pinv.size()>0)
+      m_P = m_Pinv.inverse();
+    else
+    {
+      m_P.setIdentity(n);
+      m_Pinv.setIdentity(n);
+    }
+  }
+
+  // the upper triangular part of P A P^T, per block column: the block (i,k), i<=k, is either
+  // the block of the input matrix or its adjoint. The diagonal blocks are stored such that
+  // their lower triangular part, which is the one read by LLT, is the triangular part UpLo.
+  IndexVector count = IndexVector::Zero(n+1);
+  for(Index i=0; i<n; ++i)
+    for(Index k=outer[i]; k<outer[i+1]; ++k)
+      if(isInTriangle(i, inner[k]))
+        ++count[(std::max)(m_P.indices()[i], m_P.indices()[inner[k]])+1];
+  for(Index j=0; j<n; ++j) count[j+1] += count[j];
+  m_apOuter = count;
+  m_apRow.resize(count[n]);
+  m_apBlock.resize(count[n]);
+  m_apTransposed.resize(count[n]);
+  for(Index i=0; i<n; ++i)
+    for(Index k=outer[i]; k<outer[i+1]; ++k)
+      if(isInTriangle(i, inner[k]))
+      {
+        Index pi = m_P.indices()[i], pj = m_P.indices()[inner[k]];
+        Index p = count[(std::max)(pi,pj)]++;
+        m_apRow[p] = (std::min)(pi,pj);
+        m_apBlock[p] = k;
+        m_apTransposed[p] = pi>pj || (pi==pj && int(UpLo)==Upper);
+      }
+
+  // elimination tree and column counts of the block factor
+  m_parent.resize(n);
+  IndexVector colCount(n), tags(n);
+  for(Index k=0; k<n; ++k)
+  {
+    m_parent[k] = -1;
+    tags[k] = k;
+    colCount[k] = 1;
+    for(Index p=m_apOuter[k]; p<m_apOuter[k+1]; ++p)
+    {
+      for(Index i=m_apRow[p]; tags[i]!=k; i=m_parent[i])
+      {
+        if(m_parent[i]==-1)
+          m_parent[i] = k;
+        ++colCount[i];
+        tags[i] = k;
+      }
+    }
+  }
+  m_Lp.resize(n+1);
+  m_Lp[0] = 0;
+  for(Index k=0; k<n; ++k)
+    m_Lp[k+1] = m_Lp[k] + colCount[k];
+  m_Li.resize(m_Lp[n]);
+  m_Lx.resize(m_Lp[n]*BlockSize*BlockSize);
+  m_diagInverse.resize(n*BlockSize*BlockSize);
+
+  m_isInitialized = true;
+  m_info = Success;
+  m_analysisIsOk = true;
+  m_factorizationIsOk = false;
+}
+
+template<typename MatrixType, int UpLo, typename Ordering>
+void BlockSparseLLT<MatrixType,UpLo,Ordering>::factorize(const MatrixType& matrix)
+{
+  eigen_assert(m_analysisIsOk && "You must first call analyzePattern()");
+  eigen_assert(matrix.blockRows()==m_blocks && matrix.blockCols()==m_blocks);
+  const Index n = m_blocks;
+  const Index bs2 = BlockSize*BlockSize;
+  const Scalar* values = matrix.valuePtr();
+
+  // Y holds the blocks of the current block column of the upper part
+  ScalarVector Ybuffer = ScalarVector::Zero(n*bs2);
+  IndexVector pattern(n), tags(n), filled(n);
+  bool ok = true;
+
+  for(Index k=0; k<n; ++k)
+  {
+    // pattern of the k-th block row of L, in topological order, and scattering of A(0:k,k)
+    Index top = n;
+    tags[k] = k;
+    filled[k] = 0;
+    for(Index p=m_apOuter[k]; p<m_apOuter[k+1]; ++p)
+    {
+      Index i = m_apRow[p];
+      ConstBlockMap a(values + m_apBlock[p]*bs2);
+      if(m_apTransposed[p]) BlockMap(Ybuffer.data() + i*bs2) += a.adjoint();
+      else                  BlockMap(Ybuffer.data() + i*bs2) += a;
+      Index len;
+      for(len=0; tags[i]!=k; i=m_parent[i])
+      {
+        pattern[len++] = i;
+        tags[i] = k;
+      }
+      while(len>0)
+        pattern[--top] = pattern[--len];
+    }
+
+    BlockMap Ykk(Ybuffer.data() + k*bs2);
+    BlockType d = Ykk;
+    Ykk.setZero();
+    for(; top<n; ++top)
+    {
+      Index i = pattern[top];
+      BlockMap Yi(Ybuffer.data() + i*bs2);
+      // X = L(i,i)^-1 Y(i), and L(k,i) = X^*
+      BlockType x;
+      x.noalias() = ConstBlockMap(m_diagInverse.data() + i*bs2) * Yi;
+      Yi.setZero();
+      Index p = m_Lp[i]+1, end = m_Lp[i]+filled[i];
+      for(; p<end; ++p)
+        BlockMap(Ybuffer.data() + m_Li[p]*bs2).noalias() -= ConstBlockMap(m_Lx.data() + p*bs2) * x;
+      d.noalias() -= x.adjoint() * x;
+      m_Li[p] = k;
+      BlockMap(m_Lx.data() + p*bs2) = x.adjoint();
+      ++filled[i];
+    }
+
+    LLT<BlockType> llt(d);
+    if(llt.info()!=Success)
+    {
+      ok = false;
+      break;
+    }
+    Index p = m_Lp[k];
+    m_Li[p] = k;
+    filled[k] = 1;
+    BlockMap(m_Lx.data() + p*bs2) = llt.matrixL();
+    BlockMap(m_diagInverse.data() + k*bs2) = llt.matrixL().solve(BlockType::Identity());
+  }
+
+  m_info = ok ? Success : NumericalIssue;
+  m_factorizationIsOk = true;
+}
+
+template<typename MatrixType, int UpLo, typename Ordering>
+template<typename Rhs, typename Dest>
+void BlockSparseLLT<MatrixType,UpLo,Ordering>::_solve(const MatrixBase<Rhs> &b, MatrixBase<Dest> &dest) const
+{
+  eigen_assert(m_factorizationIsOk && "The decomposition is not in a valid state for solving, you must first call either compute() or symbolic()/numeric()");
+  eigen_assert(rows()==b.rows());
+  if(m_info!=Success)
+    return;
+
+  const Index n = m_blocks;
+  const Index bs2 = BlockSize*BlockSize;
+  typedef typename Dest::PlainObject DestPlain;
+  DestPlain x(b.rows(), b.cols());
+  for(Index i=0; i<n; ++i)
+    x.template middleRows<BlockSize>(m_P.indices()[i]*BlockSize) = b.template middleRows<BlockSize>(i*BlockSize);
+
+  for(Index c=0; c<x.cols(); ++c)
+  {
+    // forward substitution with L
+    for(Index j=0; j<n; ++j)
+    {
+      BlockVector xj = ConstBlockMap(m_diagInverse.data() + j*bs2) * x.col(c).template segment<BlockSize>(j*BlockSize);
+      x.col(c).template segment<BlockSize>(j*BlockSize) = xj;
+      for(Index p=m_Lp[j]+1; p<m_Lp[j+1]; ++p)
+        x.col(c).template segment<BlockSize>(m_Li[p]*BlockSize).noalias() -= ConstBlockMap(m_Lx.data() + p*bs2) * xj;
+    }
+    // backward substitution with L^*
+    for(Index j=n-1; j>=0; --j)
+    {
+      BlockVector xj = x.col(c).template segment<BlockSize>(j*BlockSize);
+      for(Index p=m_Lp[j]+1; p<m_Lp[j+1]; ++p)
+        xj.noalias() -= ConstBlockMap(m_Lx.data() + p*bs2).adjoint() * x.col(c).template segment<BlockSize>(m_Li[p]*BlockSize);
+      x.col(c).template segment<BlockSize>(j*BlockSize).noalias() = ConstBlockMap(m_diagInverse.data() + j*bs2).adjoint() * xj;
+    }
+  }
+
+  dest.derived().resize(b.rows(), b.cols());
+  for(Index i=0; i<n; ++i)
+    dest.template middleRows<BlockSize>(i*BlockSize) = x.template middleRows<BlockSize>(m_P.indices()[i]*BlockSize);
+}
+
+namespace internal {
+
+template<typename _MatrixType, int _UpLo, typename _Ordering, typename Rhs>
+struct solve_retval<BlockSparseLLT<_MatrixType,_UpLo,_Ordering>, Rhs>
+  : solve_retval_base<BlockSparseLLT<_MatrixType,_UpLo,_Ordering>, Rhs>
+{
+  typedef BlockSparseLLT<_MatrixType,_UpLo,_Ordering> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec()._solve(rhs(),dst);
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_BLOCK_SPARSE_LLT_H
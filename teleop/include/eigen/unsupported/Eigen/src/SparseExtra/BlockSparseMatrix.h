@@ -0,0 +1,440 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BLOCK_SPARSE_MATRIX_H
+#define EIGEN_BLOCK_SPARSE_MATRIX_H
+
+namespace Eigen {
+
+template<typename _Scalar, int _BlockSize, typename _Index = int> class BlockSparseMatrix;
+
+namespace internal {
+template<typename Lhs, typename Rhs> class block_sparse_dense_product;
+}
+
+/** \ingroup SparseExtra_Module
+  * \class BlockTriplet
+  *
+  * \brief A block of a BlockSparseMatrix with its block coordinates, used to assemble the matrix
+  *
+  * \sa BlockSparseMatrix::setFromBlockTriplets()
+  */
+template<typename Scalar, int BlockSize, typename Index = int>
+class BlockTriplet
+{
+  public:
+    typedef Matrix<Scalar,BlockSize,BlockSize> BlockType;
+
+    BlockTriplet() : m_row(0), m_col(0), m_value(BlockType::Zero()) {}
+
+    BlockTriplet(const Index& i, const Index& j, const BlockType& v) : m_row(i), m_col(j), m_value(v) {}
+
+    /** \returns the block row index of the block */
+    const Index& row() const { return m_row; }
+
+    /** \returns the block column index of the block */
+    const Index& col() const { return m_col; }
+
+    /** \returns the coefficients of the block */
+    const BlockType& value() const { return m_value; }
+
+  protected:
+    Index m_row, m_col;
+    BlockType m_value;
+
+  public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF(BlockType::NeedsToAlign)
+};
+
+/** \ingroup SparseExtra_Module
+  * \class BlockSparseMatrix
+  *
+  * \brief A sparse matrix made of dense square blocks of fixed size, stored in the block compressed row (BSR) format
+  *
+  * \tparam _Scalar the scalar type, i.e. the type of the coefficients
+  * \tparam _BlockSize the number of rows and columns of the blocks, known at compile time
+  * \tparam _Index the type of the indices. It has to be a \b signed type (e.g., short, int, std::ptrdiff_t). Default is \c int.
+  *
+  * This class is tailored to the matrices made of small dense blocks, like the Hessians of pose graphs
+  * and of bundle adjustment problems with 6x6 or 3x3 blocks. Compared to a SparseMatrix, a single index
+  * is stored per block instead of one per coefficient, and the products are performed by fixed-size
+  * dense kernels on each block.
+  *
+  * The blocks of each block row are sorted by increasing block column index. The coefficients of each
+  * block are stored contiguously in column-major order. The sparsity pattern is defined by
+  * setFromTriplets() or setFromBlockTriplets(), after which the values of the blocks can be updated
+  * in place, e.g., to assemble a new Hessian with the same structure:
+  * \code
+  * BlockSparseMatrix<double,6> H(nbPoses, nbPoses);
+  * H.setFromBlockTriplets(blocks.begin(), blocks.end()); // defines the pattern
+  * // ...
+  * H.coeffs().setZero();
+  * H.blockRef(i,j) += Ji.transpose() * Jj;               // updates existing blocks
+  * \endcode
+  *
+  * The product by a dense vector or matrix is multithreaded over the block rows when OpenMP is enabled.
+  * Symmetric positive definite block matrices can be factorized by BlockSparseLLT.
+  *
+  * \sa BlockSparseLLT, SparseMatrix
+  */
+template<typename _Scalar, int _BlockSize, typename _Index>
+class BlockSparseMatrix
+{
+  public:
+    typedef _Scalar Scalar;
+    typedef _Index Index;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    enum {
+      BlockSize = _BlockSize,
+      RowsAtCompileTime = Dynamic,
+      ColsAtCompileTime = Dynamic,
+      MaxRowsAtCompileTime = Dynamic,
+      MaxColsAtCompileTime = Dynamic
+    };
+    typedef Matrix<Scalar,BlockSize,BlockSize> BlockType;
+    typedef Map<BlockType> BlockMap;
+    typedef Map<const BlockType> ConstBlockMap;
+    typedef Matrix<Index,Dynamic,1> IndexVector;
+    typedef Matrix<Scalar,Dynamic,1> ScalarVector;
+
+    /** Default constructor yielding an empty \c 0 \c x \c 0 matrix */
+    BlockSparseMatrix() { resize(0,0); }
+
+    /** Constructs a \a blockRows x \a blockCols matrix of blocks, i.e., of size
+      * \a blockRows * BlockSize x \a blockCols * BlockSize, without any non zero blocks */
+    BlockSparseMatrix(Index blockRows, Index blockCols) { resize(blockRows, blockCols); }
+
+    /** Constructs a block sparse matrix from the sparse matrix \a other, whose dimensions must be multiples
+      * of the block size. A block is stored for each block containing at least one non zero of \a other. */
+    template<typename OtherDerived>
+    explicit BlockSparseMatrix(const SparseMatrixBase<OtherDerived>& other) { *this = other; }
+
+    template<typename OtherDerived>
+    BlockSparseMatrix& operator=(const SparseMatrixBase<OtherDerived>& other)
+    {
+      eigen_assert(other.rows()%BlockSize==0 && other.cols()%BlockSize==0 && "the dimensions must be multiples of the block size");
+      std::vector<Triplet<Scalar,Index> > triplets;
+      triplets.reserve(other.nonZeros());
+      for(Index j=0; j<other.outerSize(); ++j)
+        for(typename OtherDerived::InnerIterator it(other.derived(),j); it; ++it)
+          triplets.push_back(Triplet<Scalar,Index>(it.row(), it.col(), it.value()));
+      resize(other.rows()/BlockSize, other.cols()/BlockSize);
+      setFromTriplets(triplets.begin(), triplets.end());
+      return *this;
+    }
+
+    /** Resizes the matrix to \a blockRows x \a blockCols blocks, and removes all the non zero blocks */
+    void resize(Index blockRows, Index blockCols)
+    {
+      m_blockRows = blockRows;
+      m_blockCols = blockCols;
+      m_outer.setZero(blockRows+1);
+      m_inner.resize(0);
+      m_values.resize(0);
+    }
+
+    /** \returns the number of rows of the matrix */
+    inline Index rows() const { return m_blockRows*BlockSize; }
+    /** \returns the number of columns of the matrix */
+    inline Index cols() const { return m_blockCols*BlockSize; }
+    /** \returns the number of rows of blocks */
+    inline Index blockRows() const { return m_blockRows; }
+    /** \returns the number of columns of blocks */
+    inline Index blockCols() const { return m_blockCols; }
+    /** \returns the number of stored blocks */
+    inline Index nonZeroBlocks() const { return m_outer[m_blockRows]; }
+    /** \returns the number of stored coefficients, including the zeros of the stored blocks */
+    inline Index nonZeros() const { return nonZeroBlocks()*BlockSize*BlockSize; }
+
+    /** \returns the index of the first block of each block row, followed by the number of stored blocks */
+    inline const Index* outerIndexPtr() const { return m_outer.data(); }
+    /** \returns the block column index of each stored block */
+    inline const Index* innerIndexPtr() const { return m_inner.data(); }
+    /** \returns the coefficients of the stored blocks, each block being stored in column-major order */
+    inline const Scalar* valuePtr() const { return m_values.data(); }
+    inline Scalar* valuePtr() { return m_values.data(); }
+
+    /** \returns the coefficients of all the stored blocks as a vector, e.g., to reset them while keeping the pattern */
+    inline Map<ScalarVector> coeffs() { return Map<ScalarVector>(m_values.data(), m_values.size()); }
+    inline Map<const ScalarVector> coeffs() const { return Map<const ScalarVector>(m_values.data(), m_values.size()); }
+
+    /** \returns the \a k -th stored block */
+    inline BlockMap valueBlock(Index k)
+    {
+      eigen_internal_assert(k>=0 && k<nonZeroBlocks());
+      return BlockMap(m_values.data() + k*BlockSize*BlockSize);
+    }
+    inline ConstBlockMap valueBlock(Index k) const
+    {
+      eigen_internal_assert(k>=0 && k<nonZeroBlocks());
+      return ConstBlockMap(m_values.data() + k*BlockSize*BlockSize);
+    }
+
+    /** \returns the storage position of the block at the block coordinates (\a i, \a j), or -1 if it is not stored */
+    Index findBlock(Index i, Index j) const
+    {
+      eigen_assert(i>=0 && i<m_blockRows && j>=0 && j<m_blockCols);
+      const Index* begin = m_inner.data() + m_outer[i];
+      const Index* end = m_inner.data() + m_outer[i+1];
+      const Index* p = std::lower_bound(begin, end, j);
+      return (p!=end && *p==j) ? Index(p - m_inner.data()) : Index(-1);
+    }
+
+    /** \returns a writable reference to the stored block at the block coordinates (\a i, \a j), which must exist */
+    BlockMap blockRef(Index i, Index j)
+    {
+      Index k = findBlock(i,j);
+      eigen_assert(k>=0 && "the block is not part of the sparsity pattern");
+      return valueBlock(k);
+    }
+
+    /** \returns the block at the block coordinates (\a i, \a j), or a zero block if it is not stored */
+    BlockType block(Index i, Index j) const
+    {
+      Index k = findBlock(i,j);
+      return k>=0 ? BlockType(valueBlock(k)) : BlockType(BlockType::Zero());
+    }
+
+    /** Fills the matrix from a list of scalar triplets (row, column, value), whose duplicates are summed.
+      * A block is stored for each block containing at least one triplet.
+      * \sa SparseMatrix::setFromTriplets() */
+    template<typename InputIterator>
+    void setFromTriplets(const InputIterator& begin, const InputIterator& end)
+    {
+      Index n = 0;
+      for(InputIterator it(begin); it!=end; ++it) ++n;
+      IndexVector bi(n), bj(n), pos;
+      n = 0;
+      for(InputIterator it(begin); it!=end; ++it, ++n)
+      {
+        eigen_assert(it->row()>=0 && it->row()<rows() && it->col()>=0 && it->col()<cols());
+        bi[n] = Index(it->row())/BlockSize;
+        bj[n] = Index(it->col())/BlockSize;
+      }
+      setPattern(bi, bj, pos);
+      n = 0;
+      for(InputIterator it(begin); it!=end; ++it, ++n)
+        m_values[pos[n]*BlockSize*BlockSize + (Index(it->col())%BlockSize)*BlockSize + Index(it->row())%BlockSize] += it->value();
+    }
+
+    /** Fills the matrix from a list of BlockTriplet (block row, block column, block value), whose duplicates are summed.
+      * \sa setFromTriplets() */
+    template<typename InputIterator>
+    void setFromBlockTriplets(const InputIterator& begin, const InputIterator& end)
+    {
+      Index n = 0;
+      for(InputIterator it(begin); it!=end; ++it) ++n;
+      IndexVector bi(n), bj(n), pos;
+      n = 0;
+      for(InputIterator it(begin); it!=end; ++it, ++n)
+      {
+        eigen_assert(it->row()>=0 && it->row()<m_blockRows && it->col()>=0 && it->col()<m_blockCols);
+        bi[n] = it->row();
+        bj[n] = it->col();
+      }
+      setPattern(bi, bj, pos);
+      n = 0;
+      for(InputIterator it(begin); it!=end; ++it, ++n)
+        valueBlock(pos[n]) += it->value();
+    }
+
+    /** \returns a row-major SparseMatrix holding the coefficients of the stored blocks */
+    SparseMatrix<Scalar,RowMajor,Index> toSparseMatrix() const
+    {
+      SparseMatrix<Scalar,RowMajor,Index> res(rows(), cols());
+      res.resizeNonZeros(nonZeros());
+      Index* outer = res.outerIndexPtr();
+      Index* inner = res.innerIndexPtr();
+      Scalar* values = res.valuePtr();
+      Index p = 0;
+      for(Index i=0; i<m_blockRows; ++i)
+        for(Index r=0; r<BlockSize; ++r)
+        {
+          outer[i*BlockSize+r] = p;
+          for(Index k=m_outer[i]; k<m_outer[i+1]; ++k)
+            for(Index c=0; c<BlockSize; ++c, ++p)
+            {
+              inner[p] = m_inner[k]*BlockSize + c;
+              values[p] = m_values[k*BlockSize*BlockSize + c*BlockSize + r];
+            }
+        }
+      outer[rows()] = p;
+      return res;
+    }
+
+    /** \returns an expression of the product of the matrix by the dense vector or matrix \a other */
+    template<typename OtherDerived>
+    const internal::block_sparse_dense_product<BlockSparseMatrix, OtherDerived>
+    operator*(const MatrixBase<OtherDerived>& other) const
+    {
+      return internal::block_sparse_dense_product<BlockSparseMatrix, OtherDerived>(*this, other.derived());
+    }
+
+  protected:
+    /** Builds the sparsity pattern from the block coordinates \a bi, \a bj, and returns in \a pos
+      * the storage position of each of them. The values are set to zero. */
+    void setPattern(const IndexVector& bi, const IndexVector& bj, IndexVector& pos)
+    {
+      const Index n = bi.size();
+      // group the entries per block row
+      IndexVector rowStart = IndexVector::Zero(m_blockRows+1), order(n);
+      for(Index e=0; e<n; ++e) ++rowStart[bi[e]+1];
+      for(Index i=0; i<m_blockRows; ++i) rowStart[i+1] += rowStart[i];
+      IndexVector next = rowStart.head(m_blockRows);
+      for(Index e=0; e<n; ++e) order[next[bi[e]]++] = e;
+
+      // collect the distinct block columns of each block row
+      IndexVector mark = IndexVector::Constant(m_blockCols,-1), position(m_blockCols);
+      m_inner.resize(n);
+      pos.resize(n);
+      Index nnz = 0;
+      for(Index i=0; i<m_blockRows; ++i)
+      {
+        m_outer[i] = nnz;
+        for(Index k=rowStart[i]; k<rowStart[i+1]; ++k)
+        {
+          Index j = bj[order[k]];
+          if(mark[j]!=i)
+          {
+            mark[j] = i;
+            m_inner[nnz++] = j;
+          }
+        }
+        std::sort(m_inner.data()+m_outer[i], m_inner.data()+nnz);
+        for(Index p=m_outer[i]; p<nnz; ++p)
+          position[m_inner[p]] = p;
+        for(Index k=rowStart[i]; k<rowStart[i+1]; ++k)
+          pos[order[k]] = position[bj[order[k]]];
+      }
+      m_outer[m_blockRows] = nnz;
+      m_inner.conservativeResize(nnz);
+      m_values.setZero(nnz*BlockSize*BlockSize);
+    }
+
+    Index m_blockRows, m_blockCols;
+    IndexVector m_outer;
+    IndexVector m_inner;
+    ScalarVector m_values;
+};
+
+namespace internal {
+
+template<typename Lhs, typename Rhs>
+struct traits<block_sparse_dense_product<Lhs,Rhs> >
+{
+  typedef Matrix<typename Lhs::Scalar, Dynamic, Rhs::ColsAtCompileTime, ColMajor, Dynamic, Rhs::MaxColsAtCompileTime> ReturnType;
+};
+
+/** \internal Product of a BlockSparseMatrix by a dense matrix.
+  * Each block row of the result is accumulated in a fixed-size vector, and the block rows are split into
+  * ranges holding about the same number of blocks, which are processed in parallel with OpenMP. */
+template<typename Lhs, typename Rhs>
+class block_sparse_dense_product : public ReturnByValue<block_sparse_dense_product<Lhs,Rhs> >
+{
+    typedef typename Lhs::Scalar Scalar;
+    typedef typename Lhs::Index StorageIndex;
+    typedef typename Lhs::ConstBlockMap ConstBlockMap;
+    typedef typename ReturnByValue<block_sparse_dense_product>::Index Index;
+    enum { BlockSize = Lhs::BlockSize };
+    typedef Matrix<Scalar,BlockSize,1> BlockVector;
+    // the rhs coefficients are read once per block, expressions are evaluated beforehand
+    typedef typename conditional<bool(traits<Rhs>::Flags&DirectAccessBit),
+                                 const Rhs&, typename plain_matrix_type<Rhs>::type>::type RhsNested;
+
+  public:
+    block_sparse_dense_product(const Lhs& lhs, const Rhs& rhs) : m_lhs(lhs), m_rhs(rhs)
+    {
+      eigen_assert(lhs.cols()==rhs.rows() && "invalid matrix product");
+    }
+
+    inline Index rows() const { return m_lhs.rows(); }
+    inline Index cols() const { return m_rhs.cols(); }
+
+    template<typename Dest> void evalTo(Dest& dst) const { run(dst, 0); }
+    template<typename Dest> void addTo(Dest& dst) const { run(dst, 1); }
+    template<typename Dest> void subTo(Dest& dst) const { run(dst, -1); }
+
+  protected:
+    /** computes dst = lhs*rhs if \a mode is 0, dst += lhs*rhs if it is 1, and dst -= lhs*rhs if it is -1 */
+    template<typename Dest> void run(Dest& dst, int mode) const
+    {
+      eigen_assert(mode!=0 || (dst.rows()==rows() && dst.cols()==cols()));
+      if(dst.data()!=0 && dst.data()==m_rhs.data())
+      {
+        // the destination is the right hand side: evaluate into a temporary
+        typename traits<block_sparse_dense_product>::ReturnType tmp(rows(), cols());
+        run(tmp, 0);
+        if(mode==0)     dst = tmp;
+        else if(mode>0) dst += tmp;
+        else            dst -= tmp;
+        return;
+      }
+
+      const StorageIndex* outer = m_lhs.outerIndexPtr();
+      const Index blockRows = m_lhs.blockRows();
+      Index threads = 1;
+      Index starts[MaxThreads+1];
+      starts[0] = 0;
+      starts[1] = blockRows;
+#ifdef EIGEN_HAS_OPENMP
+      // do not create nested parallel regions
+      if(omp_get_num_threads()==1)
+      {
+        const Index work = Index(outer[blockRows]) * BlockSize * BlockSize * cols();
+        const Index minWorkPerThread = 20000;
+        threads = (std::min)(Index(nbThreads()), work/minWorkPerThread);
+        threads = (std::max)(Index(1), (std::min)(threads, Index(MaxThreads)));
+        for(Index t=1; t<threads; ++t)
+        {
+          StorageIndex target = StorageIndex((Index(outer[blockRows])*t)/threads);
+          starts[t] = std::lower_bound(outer+starts[t-1], outer+blockRows, target) - outer;
+        }
+        starts[threads] = blockRows;
+      }
+      if(threads>1)
+      {
+        #pragma omp parallel num_threads(threads)
+        {
+          Index actualThreads = omp_get_num_threads();
+          for(Index t=omp_get_thread_num(); t<threads; t+=actualThreads)
+            runRange(dst, mode, starts[t], starts[t+1]);
+        }
+        return;
+      }
+#endif
+      runRange(dst, mode, starts[0], starts[1]);
+    }
+
+    template<typename Dest> void runRange(Dest& dst, int mode, Index first, Index last) const
+    {
+      const StorageIndex* outer = m_lhs.outerIndexPtr();
+      const StorageIndex* inner = m_lhs.innerIndexPtr();
+      const Scalar* values = m_lhs.valuePtr();
+      for(Index c=0; c<cols(); ++c)
+        for(Index i=first; i<last; ++i)
+        {
+          BlockVector acc = BlockVector::Zero();
+          for(Index k=outer[i]; k<outer[i+1]; ++k)
+            acc.noalias() += ConstBlockMap(values + k*BlockSize*BlockSize)
+                           * m_rhs.col(c).template segment<BlockSize>(Index(inner[k])*BlockSize);
+          if(mode==0)     dst.col(c).template segment<BlockSize>(i*BlockSize) = acc;
+          else if(mode>0) dst.col(c).template segment<BlockSize>(i*BlockSize) += acc;
+          else            dst.col(c).template segment<BlockSize>(i*BlockSize) -= acc;
+        }
+    }
+
+    enum { MaxThreads = 64 };
+
+    const Lhs& m_lhs;
+    RhsNested m_rhs;
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_BLOCK_SPARSE_MATRIX_H
@@ -0,0 +1,318 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_DELTA_COMPRESSED_SPARSEMATRIX_H
+#define EIGEN_DELTA_COMPRESSED_SPARSEMATRIX_H
+
+namespace Eigen {
+
+template<typename _Scalar, int _Options = 0, typename _Index = int, typename _OuterIndex = _Index>
+class DeltaCompressedSparseMatrix;
+
+/** \class DeltaCompressedSparseMatrix
+  *
+  * \brief A read-only compressed sparse matrix storing its inner indices as variable length deltas
+  *
+  * \param _Scalar the scalar type, i.e. the type of the coefficients
+  * \param _Options Union of bit flags controlling the storage scheme. Currently the only possibility
+  *                 is ColMajor or RowMajor. The default is 0 which means column-major.
+  * \param _Index the type of the inner indices and of the sizes.
+  * \param _OuterIndex the type of the positions stored in the outer arrays, see SparseMatrix.
+  *
+  * The layout follows the one of a compressed SparseMatrix except that the array of inner indices is replaced
+  * by a byte stream: within each inner vector, the gap between two consecutive inner indices (the first one
+  * being relative to 0) is stored as an unsigned LEB128 integer, i.e., 7 bits per byte with the highest bit
+  * flagging that more bytes follow. Matrices with a good locality (banded matrices, finite element or grid
+  * matrices after a bandwidth reducing ordering) thus require a single byte per nonzero instead of 4 or 8.
+  * Since memory bandwidth is the bottleneck of sparse matrix - vector products, this reduces their cost when
+  * the matrix does not fit in cache.
+  *
+  * The matrix is built at once from another sparse expression and then only supports sequential reads through
+  * its InnerIterator, which is enough for products with dense objects and for conversions back to a SparseMatrix.
+  * The inner vectors of the source must be sorted.
+  *
+  * \code
+  * SparseMatrix<double> A;
+  * // ... assemble A ...
+  * DeltaCompressedSparseMatrix<double> Ac(A);
+  * y = Ac * x;
+  * \endcode
+  *
+  * \sa SparseMatrix
+  */
+
+namespace internal {
+template<typename _Scalar, int _Options, typename _Index, typename _OuterIndex>
+struct traits<DeltaCompressedSparseMatrix<_Scalar, _Options, _Index, _OuterIndex> >
+{
+  typedef _Scalar Scalar;
+  typedef _Index Index;
+  typedef Sparse StorageKind;
+  typedef MatrixXpr XprKind;
+  enum {
+    RowsAtCompileTime = Dynamic,
+    ColsAtCompileTime = Dynamic,
+    MaxRowsAtCompileTime = Dynamic,
+    MaxColsAtCompileTime = Dynamic,
+    Flags = _Options | NestByRefBit,
+    CoeffReadCost = NumTraits<Scalar>::ReadCost,
+    SupportedAccessPatterns = OuterRandomAccessPattern
+  };
+};
+}
+
+template<typename _Scalar, int _Options, typename _Index, typename _OuterIndex>
+class DeltaCompressedSparseMatrix
+  : public SparseMatrixBase<DeltaCompressedSparseMatrix<_Scalar, _Options, _Index, _OuterIndex> >
+{
+  public:
+    EIGEN_SPARSE_PUBLIC_INTERFACE(DeltaCompressedSparseMatrix)
+    using Base::IsRowMajor;
+    typedef _Index StorageIndex;
+    typedef _OuterIndex OuterIndex;
+    enum {
+      Options = _Options
+    };
+
+    class InnerIterator;
+
+  protected:
+
+    typedef SparseMatrix<Scalar,Options,Index,OuterIndex> CompressedMatrix;
+
+    Index m_innerSize;
+    Index m_outerSize;
+    Matrix<OuterIndex,Dynamic,1> m_outerIndex;  // position of the first value of each inner vector
+    Matrix<OuterIndex,Dynamic,1> m_outerBytes;  // position of the first byte of each inner vector
+    std::vector<unsigned char> m_deltas;
+    Matrix<Scalar,Dynamic,1> m_values;
+
+  public:
+
+    /** Default constructor yielding an empty 0 x 0 matrix */
+    DeltaCompressedSparseMatrix()
+      : m_innerSize(0), m_outerSize(0), m_outerIndex(OuterIndex(1))
+    {
+      m_outerIndex.setZero();
+      m_outerBytes = m_outerIndex;
+    }
+
+    /** Constructs a delta compressed copy of the sparse expression \a other */
+    template<typename OtherDerived>
+    explicit DeltaCompressedSparseMatrix(const SparseMatrixBase<OtherDerived>& other)
+      : m_innerSize(0), m_outerSize(0)
+    {
+      *this = other.derived();
+    }
+
+    inline DeltaCompressedSparseMatrix(const DeltaCompressedSparseMatrix& other)
+      : Base(), m_innerSize(other.m_innerSize), m_outerSize(other.m_outerSize), m_outerIndex(other.m_outerIndex),
+        m_outerBytes(other.m_outerBytes), m_deltas(other.m_deltas), m_values(other.m_values)
+    {}
+
+    inline DeltaCompressedSparseMatrix& operator=(const DeltaCompressedSparseMatrix& other)
+    {
+      m_innerSize = other.m_innerSize;
+      m_outerSize = other.m_outerSize;
+      m_outerIndex = other.m_outerIndex;
+      m_outerBytes = other.m_outerBytes;
+      m_deltas = other.m_deltas;
+      m_values = other.m_values;
+      return *this;
+    }
+
+    /** Replaces the content of \c *this by a delta compressed copy of the sparse expression \a other.
+      * Expressions with the opposite storage order are first transposed into a SparseMatrix. */
+    template<typename OtherDerived>
+    DeltaCompressedSparseMatrix& operator=(const SparseMatrixBase<OtherDerived>& other)
+    {
+      const bool needToTranspose = (Flags & RowMajorBit) != (internal::traits<OtherDerived>::Flags & RowMajorBit);
+      if(needToTranspose)
+      {
+        CompressedMatrix tmp(other.derived());
+        return compressFrom(tmp);
+      }
+      return compressFrom(other.derived());
+    }
+
+    inline Index rows() const { return IsRowMajor ? m_outerSize : m_innerSize; }
+    inline Index cols() const { return IsRowMajor ? m_innerSize : m_outerSize; }
+    inline Index innerSize() const { return m_innerSize; }
+    inline Index outerSize() const { return m_outerSize; }
+
+    /** \returns the number of non zero coefficients */
+    inline OuterIndex nonZeros() const { return m_outerIndex[m_outerSize]; }
+
+    /** \returns the number of non zeros of the inner vector \a j */
+    inline Index innerNonZeros(Index j) const { return Index(m_outerIndex[j+1] - m_outerIndex[j]); }
+
+    /** \returns a const pointer to the array of values */
+    inline const Scalar* valuePtr() const { return m_values.data(); }
+    /** \returns a const pointer to the positions of the first value of each inner vector, as for SparseMatrix */
+    inline const OuterIndex* outerIndexPtr() const { return m_outerIndex.data(); }
+    /** \returns a const pointer to the byte stream of encoded inner indices */
+    inline const unsigned char* deltaPtr() const { return m_deltas.empty() ? 0 : &m_deltas[0]; }
+    /** \returns a const pointer to the position of the first byte of each inner vector in the byte stream */
+    inline const OuterIndex* outerBytesPtr() const { return m_outerBytes.data(); }
+
+    /** \returns the number of bytes used to store the sparsity pattern, i.e., the two outer arrays and the
+      * byte stream. The same pattern requires <tt>(outerSize()+1)*sizeof(OuterIndex) + nonZeros()*sizeof(Index)</tt>
+      * bytes in a compressed SparseMatrix. */
+    inline std::size_t indexBytes() const
+    {
+      return 2 * std::size_t(m_outerSize+1) * sizeof(OuterIndex) + m_deltas.size();
+    }
+
+    /** \returns the coefficient value at given position \a row, \a col.
+      * This requires decoding the inner vector up to \a row, \a col. */
+    Scalar coeff(Index row, Index col) const
+    {
+      const Index outer = IsRowMajor ? row : col;
+      const Index inner = IsRowMajor ? col : row;
+      for(InnerIterator it(*this,outer); it && it.index()<=inner; ++it)
+        if(it.index()==inner)
+          return it.value();
+      return Scalar(0);
+    }
+
+    void swap(DeltaCompressedSparseMatrix& other)
+    {
+      std::swap(m_innerSize, other.m_innerSize);
+      std::swap(m_outerSize, other.m_outerSize);
+      m_outerIndex.swap(other.m_outerIndex);
+      m_outerBytes.swap(other.m_outerBytes);
+      m_deltas.swap(other.m_deltas);
+      m_values.swap(other.m_values);
+    }
+
+  protected:
+
+    template<typename OtherDerived>
+    DeltaCompressedSparseMatrix& compressFrom(const OtherDerived& other)
+    {
+      typedef typename internal::nested<OtherDerived,2>::type OtherCopy;
+      typedef typename internal::remove_all<OtherCopy>::type _OtherCopy;
+      OtherCopy otherCopy(other);
+
+      m_innerSize = IsRowMajor ? otherCopy.cols() : otherCopy.rows();
+      m_outerSize = IsRowMajor ? otherCopy.rows() : otherCopy.cols();
+      m_outerIndex.resize(m_outerSize+1);
+      m_outerBytes.resize(m_outerSize+1);
+
+      // first pass: count the nonzeros and the bytes of each inner vector
+      m_outerIndex[0] = 0;
+      m_outerBytes[0] = 0;
+      for(Index j=0; j<m_outerSize; ++j)
+      {
+        OuterIndex count = 0, bytes = 0;
+        Index prev = 0;
+        for(typename _OtherCopy::InnerIterator it(otherCopy,j); it; ++it)
+        {
+          eigen_assert((count==0 || it.index()>prev) && "DeltaCompressedSparseMatrix requires sorted inner vectors");
+          bytes += encodedSize(it.index()-prev);
+          prev = it.index();
+          ++count;
+        }
+        m_outerIndex[j+1] = m_outerIndex[j] + count;
+        m_outerBytes[j+1] = m_outerBytes[j] + bytes;
+      }
+
+      // second pass: encode
+      m_values.resize(m_outerIndex[m_outerSize]);
+      m_deltas.resize(std::size_t(m_outerBytes[m_outerSize]));
+      for(Index j=0; j<m_outerSize; ++j)
+      {
+        OuterIndex p = m_outerIndex[j];
+        unsigned char* bytes = m_deltas.empty() ? 0 : &m_deltas[0] + m_outerBytes[j];
+        Index prev = 0;
+        for(typename _OtherCopy::InnerIterator it(otherCopy,j); it; ++it, ++p)
+        {
+          bytes = encode(it.index()-prev, bytes);
+          prev = it.index();
+          m_values[p] = it.value();
+        }
+      }
+      return *this;
+    }
+
+    static inline OuterIndex encodedSize(Index delta)
+    {
+      OuterIndex n = 1;
+      for(Index d = delta; d >= 0x80; d >>= 7)
+        ++n;
+      return n;
+    }
+
+    static inline unsigned char* encode(Index delta, unsigned char* bytes)
+    {
+      Index d = delta;
+      while(d >= 0x80)
+      {
+        *bytes++ = static_cast<unsigned char>(d | 0x80);
+        d >>= 7;
+      }
+      *bytes++ = static_cast<unsigned char>(d);
+      return bytes;
+    }
+};
+
+template<typename Scalar, int _Options, typename _Index, typename _OuterIndex>
+class DeltaCompressedSparseMatrix<Scalar,_Options,_Index,_OuterIndex>::InnerIterator
+{
+  public:
+    InnerIterator(const DeltaCompressedSparseMatrix& mat, Index outer)
+      : m_values(mat.valuePtr()), m_bytes(mat.deltaPtr() + mat.outerBytesPtr()[outer]),
+        m_id(mat.outerIndexPtr()[outer]), m_end(mat.outerIndexPtr()[outer+1]), m_outer(outer), m_index(0)
+    {
+      if(m_id<m_end)
+        m_index = decode();
+    }
+
+    inline InnerIterator& operator++()
+    {
+      ++m_id;
+      if(m_id<m_end)
+        m_index += decode();
+      return *this;
+    }
+
+    inline const Scalar& value() const { return m_values[m_id]; }
+
+    inline Index index() const { return m_index; }
+    inline Index outer() const { return m_outer; }
+    inline Index row() const { return IsRowMajor ? m_outer : m_index; }
+    inline Index col() const { return IsRowMajor ? m_index : m_outer; }
+
+    inline operator bool() const { return (m_id < m_end); }
+
+  protected:
+    inline Index decode()
+    {
+      unsigned char b = *m_bytes++;
+      if(b < 0x80)
+        return Index(b);
+      Index d = b & 0x7f;
+      int shift = 7;
+      do {
+        b = *m_bytes++;
+        d |= Index(b & 0x7f) << shift;
+        shift += 7;
+      } while(b & 0x80);
+      return Index(d);
+    }
+
+    const Scalar* m_values;
+    const unsigned char* m_bytes;
+    OuterIndex m_id;
+    const OuterIndex m_end;
+    const Index m_outer;
+    Index m_index;
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_DELTA_COMPRESSED_SPARSEMATRIX_H
@@ -104,6 +104,88 @@ namespace internal
     out << value.real << " " << value.imag()<< "\n"; 
   }
 
+  /** \internal reads the whole file into \a buffer, followed by a null character */
+  inline bool read_market_file(const std::string& filename, std::vector<char>& buffer)
+  {
+    std::FILE* file = std::fopen(filename.c_str(), "rb");
+    if(!file)
+      return false;
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    bool ok = size>=0;
+    if(ok)
+    {
+      buffer.resize(std::size_t(size)+1);
+      ok = std::fread(&buffer[0], 1, std::size_t(size), file)==std::size_t(size);
+      buffer[std::size_t(size)] = '\0';
+    }
+    std::fclose(file);
+    return ok;
+  }
+
+  /** \internal \returns a pointer to the first character after the end of the line containing \a p */
+  inline const char* market_next_line(const char* p, const char* end)
+  {
+    const char* eol = static_cast<const char*>(std::memchr(p, '\n', end-p));
+    return eol ? eol+1 : end;
+  }
+
+  inline bool market_blank_line(const char* begin, const char* end)
+  {
+    for(; begin<end; ++begin)
+      if(!std::isspace(static_cast<unsigned char>(*begin)))
+        return false;
+    return true;
+  }
+
+  template <typename Scalar>
+  inline Scalar parse_market_value(const char* p, char** q, Scalar*)
+  {
+    return Scalar(std::strtod(p, q));
+  }
+  template <typename Scalar>
+  inline std::complex<Scalar> parse_market_value(const char* p, char** q, std::complex<Scalar>*)
+  {
+    Scalar valR = Scalar(std::strtod(p, q));
+    Scalar valI = Scalar(std::strtod(*q, q));
+    return std::complex<Scalar>(valR, valI);
+  }
+
+  inline int parse_market_index(const char* p, char** q)
+  {
+    while(*p==' ' || *p=='\t') ++p;
+    int i = 0;
+    for(; *p>='0' && *p<='9'; ++p)
+      i = 10*i + (*p-'0');
+    *q = const_cast<char*>(p);
+    return i;
+  }
+
+  /** \internal parses the entries of the lines in [\a p, \a end), appends the valid ones to \a elements,
+    * and returns the number of entries out of the \a M x \a N range */
+  template <typename Scalar>
+  int parse_market_entries(const char* p, const char* end, int M, int N, std::vector<Triplet<Scalar,int> >& elements)
+  {
+    int invalid = 0;
+    while(p<end)
+    {
+      // skip blank lines and comments
+      if(std::isspace(static_cast<unsigned char>(*p))) { ++p; continue; }
+      if(*p=='%') { p = market_next_line(p, end); continue; }
+      char* q;
+      int i = parse_market_index(p, &q) - 1;
+      int j = parse_market_index(q, &q) - 1;
+      Scalar value = parse_market_value(q, &q, static_cast<Scalar*>(0));
+      if(i>=0 && j>=0 && i<M && j<N)
+        elements.push_back(Triplet<Scalar,int>(i,j,value));
+      else
+        ++invalid;
+      p = market_next_line(q, end);
+    }
+    return invalid;
+  }
+
 } // end namepsace internal
 
 inline bool getMarketHeader(const std::string& filename, int& sym, bool& iscomplex, bool& isvector)
@@ -129,62 +211,82 @@ inline bool getMarketHeader(const std::string& filename, int& sym, bool& iscompl
   return true;
 }
   
+/** \ingroup SparseExtra_Module
+  * Loads into \a mat the sparse matrix stored in the Matrix Market file \a filename.
+  *
+  * The whole file is read at once, and the entries are parsed without iostreams. Large files are split
+  * into chunks of lines which are parsed in parallel when OpenMP is enabled.
+  *
+  * \sa saveMarket(), loadBinary() */
 template<typename SparseMatrixType>
 bool loadMarket(SparseMatrixType& mat, const std::string& filename)
 {
   typedef typename SparseMatrixType::Scalar Scalar;
-  std::ifstream input(filename.c_str(),std::ios::in);
-  if(!input)
+  typedef Triplet<Scalar,int> T;
+
+  std::vector<char> buffer;
+  if(!internal::read_market_file(filename, buffer))
     return false;
-  
-  const int maxBuffersize = 2048;
-  char buffer[maxBuffersize];
-  
-  bool readsizes = false;
+  const char* data = &buffer[0];
+  const char* end = data + buffer.size() - 1;
 
-  typedef Triplet<Scalar,int> T;
-  std::vector<T> elements;
-  
+  // skip the comments and read the sizes
   int M(-1), N(-1), NNZ(-1);
-  int count = 0;
-  while(input.getline(buffer, maxBuffersize))
+  const char* p = data;
+  while(p<end)
   {
-    // skip comments   
-    //NOTE An appropriate test should be done on the header to get the  symmetry
-    if(buffer[0]=='%')
+    const char* line = p;
+    p = internal::market_next_line(p, end);
+    if(*line=='%' || internal::market_blank_line(line, p))
       continue;
-    
-    std::stringstream line(buffer);
-    
-    if(!readsizes)
-    {
-      line >> M >> N >> NNZ;
-      if(M > 0 && N > 0 && NNZ > 0) 
-      {
-        readsizes = true;
-        std::cout << "sizes: " << M << "," << N << "," << NNZ << "\n";
-        mat.resize(M,N);
-        mat.reserve(NNZ);
-      }
-    }
-    else
-    { 
-      int i(-1), j(-1);
-      Scalar value; 
-      if( internal::GetMarketLine(line, M, N, i, j, value) ) 
-      {
-        ++ count;
-        elements.push_back(T(i,j,value));
-      }
-      else 
-        std::cerr << "Invalid read: " << i << "," << j << "\n";        
-    }
+    char* q;
+    M = int(std::strtol(line, &q, 10));
+    N = int(std::strtol(q, &q, 10));
+    NNZ = int(std::strtol(q, &q, 10));
+    break;
   }
-  mat.setFromTriplets(elements.begin(), elements.end());
-  if(count!=NNZ)
-    std::cerr << count << "!=" << NNZ << "\n";
-  
-  input.close();
+  if(M<=0 || N<=0 || NNZ<0)
+    return false;
+  std::cout << "sizes: " << M << "," << N << "," << NNZ << "\n";
+
+  // split the entries into chunks of complete lines
+  const std::ptrdiff_t bytes = end - p;
+  int chunks = 1;
+#ifdef EIGEN_HAS_OPENMP
+  const std::ptrdiff_t minBytesPerChunk = 1<<20;
+  if(omp_get_num_threads()==1)
+    chunks = int((std::max)(std::ptrdiff_t(1), (std::min)(std::ptrdiff_t(nbThreads()), bytes/minBytesPerChunk)));
+#endif
+  std::vector<const char*> starts(chunks+1);
+  starts[0] = p;
+  for(int c=1; c<chunks; ++c)
+    starts[c] = (std::max)(starts[c-1], internal::market_next_line(p + (bytes*c)/chunks - 1, end));
+  starts[chunks] = end;
+
+  std::vector<std::vector<T> > elements(chunks);
+  std::vector<int> invalid(chunks, 0);
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for num_threads(chunks) schedule(static,1) if(chunks>1)
+#endif
+  for(int c=0; c<chunks; ++c)
+  {
+    elements[c].reserve(std::size_t((double(NNZ) * double(starts[c+1]-starts[c])) / double((std::max)(bytes,std::ptrdiff_t(1)))) + 16);
+    invalid[c] = internal::parse_market_entries(starts[c], starts[c+1], M, N, elements[c]);
+  }
+
+  for(int c=1; c<chunks; ++c)
+  {
+    elements[0].insert(elements[0].end(), elements[c].begin(), elements[c].end());
+    std::vector<T>().swap(elements[c]);
+    invalid[0] += invalid[c];
+  }
+  if(invalid[0]>0)
+    std::cerr << "Invalid read: " << invalid[0] << " entries out of range\n";
+
+  mat.resize(M,N);
+  mat.setFromTriplets(elements[0].begin(), elements[0].end());
+  if(int(elements[0].size())!=NNZ)
+    std::cerr << elements[0].size() << "!=" << NNZ << "\n";
   return true;
 }
 
@@ -229,7 +331,8 @@ bool saveMarket(const SparseMatrixType& mat, const std::string& filename, int sy
     return false;
   
   out.flags(std::ios_base::scientific);
-  out.precision(64);
+  // enough digits to read back the same values
+  out.precision(std::numeric_limits<typename NumTraits<Scalar>::Real>::digits10 + 2);
   std::string header; 
   internal::putMarketHeader<Scalar>(header, sym); 
   out << header << std::endl; 
@@ -255,7 +358,8 @@ bool saveMarketVector (const VectorType& vec, const std::string& filename)
     return false;
   
   out.flags(std::ios_base::scientific);
-  out.precision(64);
+  // enough digits to read back the same values
+  out.precision(std::numeric_limits<typename NumTraits<Scalar>::Real>::digits10 + 2);
   if(internal::is_same<Scalar, std::complex<float> >::value || internal::is_same<Scalar, std::complex<double> >::value)
       out << "%%MatrixMarket matrix array complex general\n"; 
   else
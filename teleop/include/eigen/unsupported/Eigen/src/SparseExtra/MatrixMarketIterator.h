@@ -31,6 +31,9 @@ enum {
  * 
  * Sometimes a reference solution is available. In this case, it should be named as matname_x.mtx
  * 
+ * If a file matname.bin written by saveBinary() exists, the matrix is loaded from it rather than from matname.mtx,
+ * which is much faster for large matrices.
+ * 
  * Sample code
  * \code
  * 
@@ -79,7 +82,8 @@ class MatrixMarketIterator
       if (m_matIsLoaded) return m_mat;
       
       std::string matrix_file = m_folder + "/" + m_matname + ".mtx";
-      if ( !loadMarket(m_mat, matrix_file)) 
+      std::string binary_file = m_folder + "/" + m_matname + ".bin";
+      if ( !(Fileexists(binary_file) && loadBinary(m_mat, binary_file)) && !loadMarket(m_mat, matrix_file))
       {
         m_matIsLoaded = false;
         return m_mat;
@@ -179,6 +183,9 @@ class MatrixMarketIterator
         curfile = m_folder + "/" + m_curs_id->d_name;
         // Discard if it is a folder
         if (m_curs_id->d_type == DT_DIR) continue; //FIXME This may not be available on non BSD systems
+        // Discard the files which are not in the Matrix Market format, like the binary copies of the matrices
+        std::string name = m_curs_id->d_name;
+        if (name.length()<4 || name.compare(name.length()-4, 4, ".mtx")!=0) continue;
 //         struct stat st_buf; 
 //         stat (curfile.c_str(), &st_buf);
 //         if (S_ISDIR(st_buf.st_mode)) continue;
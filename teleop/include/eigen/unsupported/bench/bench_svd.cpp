@@ -22,7 +22,7 @@ using namespace std;
 
 // number of computations of each algorithm before the print of the time
 #ifndef REPEAT
-#define REPEAT 10
+#define REPEAT 2
 #endif
 
 // number of tests of the same type
@@ -30,60 +30,39 @@ using namespace std;
 #define NUMBER_SAMPLE 2
 #endif
 
+// JacobiSVD is only run up to this size, it is too slow for the largest matrices
+#ifndef JACOBI_MAX_SIZE
+#define JACOBI_MAX_SIZE 1000
+#endif
+
 template<typename MatrixType>
-void bench_svd(const MatrixType& a = MatrixType())
+void bench_svd_options(const MatrixType& m, unsigned int computationOptions)
 {
-  MatrixType m = MatrixType::Random(a.rows(), a.cols());
   BenchTimer timerJacobi;
   BenchTimer timerBDC;
   timerJacobi.reset();
   timerBDC.reset();
+  bool jacobi = m.cols() <= JACOBI_MAX_SIZE;
 
-  cout << " Only compute Singular Values" <<endl;
   for (int k=1; k<=NUMBER_SAMPLE; ++k)
   {
     timerBDC.start();
     for (int i=0; i<REPEAT; ++i) 
     {
-      BDCSVD<MatrixType> bdc_matrix(m);
+      BDCSVD<MatrixType> bdc_matrix(m, computationOptions);
     }
     timerBDC.stop();
-    
-    timerJacobi.start();
-    for (int i=0; i<REPEAT; ++i) 
-    {
-      JacobiSVD<MatrixType> jacobi_matrix(m);
-    }
-    timerJacobi.stop();
 
-
-    cout << "Sample " << k << " : " << REPEAT << " computations :  Jacobi : " << fixed << timerJacobi.value() << "s ";
-    cout << " || " << " BDC : " << timerBDC.value() << "s " <<endl <<endl;
-      
-    if (timerBDC.value() >= timerJacobi.value())  
-      cout << "KO : BDC is " <<  timerJacobi.value() / timerBDC.value() << "  times faster than Jacobi" <<endl;
-    else 
-      cout << "OK : BDC is " << timerJacobi.value() / timerBDC.value() << "  times faster than Jacobi"  <<endl;
-      
-  }
-  cout << "       =================" <<endl;
-  std::cout<< std::endl;
-  timerJacobi.reset();
-  timerBDC.reset();
-  cout << " Computes rotaion matrix" <<endl;
-  for (int k=1; k<=NUMBER_SAMPLE; ++k)
-  {
-    timerBDC.start();
-    for (int i=0; i<REPEAT; ++i) 
+    if (!jacobi)
     {
-      BDCSVD<MatrixType> bdc_matrix(m, ComputeFullU|ComputeFullV);
+      cout << "Sample " << k << " : " << REPEAT << " computations :  BDC : " << fixed << timerBDC.value() << "s " << endl;
+      continue;
     }
-    timerBDC.stop();
     
     timerJacobi.start();
     for (int i=0; i<REPEAT; ++i) 
     {
-      JacobiSVD<MatrixType> jacobi_matrix(m, ComputeFullU|ComputeFullV);
+      JacobiSVD<MatrixType> jacobi_matrix(m, computationOptions);
     }
     timerJacobi.stop();
 
@@ -97,6 +76,19 @@ void bench_svd(const MatrixType& a = MatrixType())
       cout << "OK : BDC is " << timerJacobi.value() / timerBDC.value() << "  times faster than Jacobi"  <<endl;
       
   }
+}
+
+template<typename MatrixType>
+void bench_svd(const MatrixType& a = MatrixType())
+{
+  MatrixType m = MatrixType::Random(a.rows(), a.cols());
+
+  cout << " Only compute Singular Values" <<endl;
+  bench_svd_options(m, 0);
+  cout << "       =================" <<endl;
+  std::cout<< std::endl;
+  cout << " Computes thin U and V" <<endl;
+  bench_svd_options(m, ComputeThinU|ComputeThinV);
   std::cout<< std::endl;
 }
 
@@ -106,17 +98,15 @@ int main(int argc, char* argv[])
 {
   std::cout<< std::endl;
 
-  std::cout<<"On a (Dynamic, Dynamic) (6, 6) Matrix" <<std::endl;
-  bench_svd<Matrix<double,Dynamic,Dynamic> >(Matrix<double,Dynamic,Dynamic>(6, 6));
-  
-  std::cout<<"On a (Dynamic, Dynamic) (32, 32) Matrix" <<std::endl;
-  bench_svd<Matrix<double,Dynamic,Dynamic> >(Matrix<double,Dynamic,Dynamic>(32, 32));
-
-  //std::cout<<"On a (Dynamic, Dynamic) (128, 128) Matrix" <<std::endl;
-  //bench_svd<Matrix<double,Dynamic,Dynamic> >(Matrix<double,Dynamic,Dynamic>(128, 128));
+  const int sizes[] = { 100, 200, 500, 1000, 2000, 4000 };
+  for (int i=0; i<6; ++i)
+  {
+    std::cout<<"On a (Dynamic, Dynamic) (" << sizes[i] << ", " << sizes[i] << ") Matrix" <<std::endl;
+    bench_svd<Matrix<double,Dynamic,Dynamic> >(Matrix<double,Dynamic,Dynamic>(sizes[i], sizes[i]));
+  }
 
-  std::cout<<"On a (Dynamic, Dynamic) (160, 160) Matrix" <<std::endl;
-  bench_svd<Matrix<double,Dynamic,Dynamic> >(Matrix<double,Dynamic,Dynamic>(160, 160));
+  std::cout<<"On a (Dynamic, Dynamic) (2000, 500) Matrix" <<std::endl;
+  bench_svd<Matrix<double,Dynamic,Dynamic> >(Matrix<double,Dynamic,Dynamic>(2000, 500));
   
   std::cout<< "--------------------------------------------------------------------"<< std::endl;
            
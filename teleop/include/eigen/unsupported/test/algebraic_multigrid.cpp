@@ -0,0 +1,111 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "../../test/sparse_solver.h"
+#include <Eigen/IterativeSolvers>
+
+// 5-point finite difference discretization of -laplacian(u) + c.grad(u) on a n x n grid
+template<typename Scalar>
+void convection_diffusion_2d(int n, const Scalar& c, SparseMatrix<Scalar>& A)
+{
+  typedef Triplet<Scalar> T;
+  std::vector<T> triplets;
+  for(int j=0; j<n; ++j)
+    for(int i=0; i<n; ++i)
+    {
+      int k = i + j*n;
+      triplets.push_back(T(k, k, Scalar(4)));
+      if(i>0)   triplets.push_back(T(k, k-1, Scalar(-1)-c));
+      if(i<n-1) triplets.push_back(T(k, k+1, Scalar(-1)+c));
+      if(j>0)   triplets.push_back(T(k, k-n, Scalar(-1)));
+      if(j<n-1) triplets.push_back(T(k, k+n, Scalar(-1)));
+    }
+  A.resize(n*n, n*n);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+}
+
+template<typename T> void test_algebraic_multigrid_T()
+{
+  ConjugateGradient<SparseMatrix<T>, Lower, AlgebraicMultigridPreconditioner<T,Lower> > cg_colmajor_lower_amg;
+  ConjugateGradient<SparseMatrix<T>, Upper, AlgebraicMultigridPreconditioner<T,Upper> > cg_colmajor_upper_amg;
+  ConjugateGradient<SparseMatrix<T,RowMajor>, Lower, AlgebraicMultigridPreconditioner<T,Lower> > cg_rowmajor_lower_amg;
+  // small coarse operators, so that the random problems get several levels
+  cg_colmajor_lower_amg.preconditioner().setMaxCoarseSize(16);
+  cg_colmajor_upper_amg.preconditioner().setMaxCoarseSize(16);
+  cg_rowmajor_lower_amg.preconditioner().setMaxCoarseSize(16);
+  cg_rowmajor_lower_amg.preconditioner().setSmoothingSteps(2);
+
+  CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_lower_amg) );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_upper_amg) );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_rowmajor_lower_amg) );
+}
+
+template<typename T> void test_algebraic_multigrid_scaling()
+{
+  typedef Matrix<T,Dynamic,1> Vector;
+  ConjugateGradient<SparseMatrix<T>, Lower|Upper, AlgebraicMultigridPreconditioner<T> > cg;
+  ConjugateGradient<SparseMatrix<T>, Lower|Upper, DiagonalPreconditioner<T> > cg_diag;
+  cg.preconditioner().setMaxCoarseSize(64);
+
+  // the number of iterations stays about constant with the size of a Poisson problem,
+  // while it doubles with the diagonal preconditioner each time the grid is refined
+  SparseMatrix<T> A;
+  int iterations[3], iterationsDiag[3];
+  for(int k=0; k<3; ++k)
+  {
+    int n = 32 << k;
+    convection_diffusion_2d<T>(n, T(0), A);
+    Vector b = Vector::Random(n*n);
+    cg.setTolerance(1e-8);
+    cg_diag.setTolerance(1e-8);
+    Vector x = cg.compute(A).solve(b);
+    VERIFY_IS_EQUAL(cg.info(), Success);
+    VERIFY(cg.preconditioner().levels()>2);
+    VERIFY(cg.preconditioner().operatorComplexity()<2);
+    VERIFY((A*x-b).norm() <= 1e-7*b.norm());
+    iterations[k] = cg.iterations();
+    x = cg_diag.compute(A).solve(b);
+    iterationsDiag[k] = cg_diag.iterations();
+  }
+  VERIFY(iterations[2] <= iterations[0] + 6);
+  VERIFY(iterations[2] < iterationsDiag[2]/5);
+
+  // reuse the aggregates for a matrix having the same pattern
+  {
+    Vector b = Vector::Random(A.rows());
+    cg.analyzePattern(A);
+    int levels = cg.preconditioner().levels();
+    SparseMatrix<T> I(A.rows(), A.cols());
+    I.setIdentity();
+    SparseMatrix<T> A2 = A * T(3) + I * T(0.5);
+    cg.factorize(A2);
+    VERIFY_IS_EQUAL(cg.preconditioner().levels(), levels);
+    Vector x = cg.solve(b);
+    VERIFY_IS_EQUAL(cg.info(), Success);
+    VERIFY((A2*x-b).norm() <= 1e-7*b.norm());
+    VERIFY(cg.iterations() <= iterations[2]);
+  }
+
+  // non symmetric problem
+  {
+    BiCGSTAB<SparseMatrix<T>, AlgebraicMultigridPreconditioner<T> > bicgstab;
+    bicgstab.preconditioner().setMaxCoarseSize(64);
+    bicgstab.setTolerance(1e-8);
+    convection_diffusion_2d<T>(64, T(0.3), A);
+    Vector b = Vector::Random(A.rows());
+    Vector x = bicgstab.compute(A).solve(b);
+    VERIFY_IS_EQUAL(bicgstab.info(), Success);
+    VERIFY((A*x-b).norm() <= 1e-7*b.norm());
+  }
+}
+
+void test_algebraic_multigrid()
+{
+  CALL_SUBTEST_1(test_algebraic_multigrid_T<double>());
+  CALL_SUBTEST_2(test_algebraic_multigrid_T<std::complex<double> >());
+  CALL_SUBTEST_3(test_algebraic_multigrid_scaling<double>());
+}
@@ -0,0 +1,154 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <Eigen/LU>
+#include <Eigen/Cholesky>
+#include <Eigen/SVD>
+#include <unsupported/Eigen/BatchedMatrix>
+
+template<typename Scalar, int Rows, int Depth, int Cols> void batched_product()
+{
+  typedef typename BatchedMatrix<Scalar,Rows,Cols>::Index Index;
+  Index count = internal::random<Index>(1,50);
+  BatchedMatrix<Scalar,Rows,Depth> a(count);
+  BatchedMatrix<Scalar,Depth,Cols> b(count);
+  BatchedMatrix<Scalar,Rows,Cols> c;
+  a.setRandom();
+  b.setRandom();
+  batchedProduct(a, b, c);
+
+  VERIFY_IS_EQUAL(c.count(), count);
+  VERIFY(c.stride()>=count && c.stride()%int(internal::packet_traits<Scalar>::size)==0);
+  for(Index k=0; k<count; ++k)
+  {
+    Matrix<Scalar,Rows,Cols> ref = a.matrix(k) * b.matrix(k);
+    VERIFY_IS_APPROX(c.matrix(k), ref);
+  }
+
+  // the padding matrices remain zero
+  VERIFY_IS_EQUAL(c.storage().bottomRows(c.stride()-count).squaredNorm(), Scalar(0));
+}
+
+template<typename Scalar, int Size> void batched_lu()
+{
+  typedef Matrix<Scalar,Size,Size> MatrixType;
+  typedef Matrix<Scalar,Size,2> RhsType;
+  typedef typename BatchedMatrix<Scalar,Size,Size>::Index Index;
+  Index count = internal::random<Index>(1,50);
+  BatchedMatrix<Scalar,Size,Size> a(count);
+  BatchedMatrix<Scalar,Size,2> b(count), x;
+  for(Index k=0; k<count; ++k)
+  {
+    MatrixType m;
+    Matrix<Scalar,Size,1> sv;
+    do {
+      m.setRandom();
+      // force some pivoting
+      if(internal::random<bool>())
+        m(0,0) = Scalar(0);
+      sv = JacobiSVD<MatrixType>(m).singularValues();
+    } while(sv(Size-1)<Scalar(1e-2)*sv(0));
+    a.setMatrix(k, m);
+  }
+  b.setRandom();
+
+  BatchedPartialPivLU<Scalar,Size> lu(a);
+  lu.solve(b, x);
+  BatchedMatrix<Scalar,Size,Size> inv;
+  lu.inverse(inv);
+  Matrix<Scalar,Dynamic,1> det = lu.determinant();
+  VERIFY_IS_EQUAL(det.size(), count);
+
+  for(Index k=0; k<count; ++k)
+  {
+    MatrixType m = a.matrix(k);
+    PartialPivLU<MatrixType> ref(m);
+    VERIFY_IS_APPROX(lu.matrixLU().matrix(k), ref.matrixLU());
+    VERIFY_IS_APPROX(x.matrix(k), RhsType(ref.solve(b.matrix(k))));
+    VERIFY_IS_APPROX(m * x.matrix(k), b.matrix(k));
+    VERIFY_IS_APPROX(inv.matrix(k), ref.inverse());
+    VERIFY_IS_APPROX(det(k), m.determinant());
+  }
+
+  BatchedMatrix<Scalar,Size,Size> inv2;
+  batchedInverse(a, inv2);
+  Matrix<Scalar,Dynamic,1> det2 = batchedDeterminant(a);
+  for(Index k=0; k<count; ++k)
+  {
+    VERIFY_IS_APPROX(inv2.matrix(k), inv.matrix(k));
+    VERIFY_IS_APPROX(det2(k), det(k));
+  }
+
+  // in place solve
+  lu.solve(b, b);
+  for(Index k=0; k<count; ++k)
+    VERIFY_IS_APPROX(b.matrix(k), x.matrix(k));
+}
+
+template<typename Scalar, int Size> void batched_llt()
+{
+  typedef Matrix<Scalar,Size,Size> MatrixType;
+  typedef Matrix<Scalar,Size,1> RhsType;
+  typedef typename BatchedMatrix<Scalar,Size,Size>::Index Index;
+  Index count = internal::random<Index>(1,50);
+  BatchedMatrix<Scalar,Size,Size> a(count);
+  BatchedMatrix<Scalar,Size,1> b(count), x;
+  for(Index k=0; k<count; ++k)
+  {
+    MatrixType m = MatrixType::Random();
+    a.setMatrix(k, m*m.transpose() + MatrixType::Identity());
+  }
+  b.setRandom();
+
+  BatchedLLT<Scalar,Size> llt(a);
+  VERIFY(llt.info()==Success);
+  llt.solve(b, x);
+  BatchedMatrix<Scalar,Size,Size> inv;
+  llt.inverse(inv);
+  Matrix<Scalar,Dynamic,1> det = llt.determinant();
+
+  for(Index k=0; k<count; ++k)
+  {
+    MatrixType m = a.matrix(k);
+    LLT<MatrixType> ref(m);
+    VERIFY_IS_APPROX(MatrixType(llt.matrixL().matrix(k)), MatrixType(ref.matrixL()));
+    VERIFY_IS_APPROX(x.matrix(k), RhsType(ref.solve(b.matrix(k))));
+    VERIFY_IS_APPROX(inv.matrix(k), m.inverse());
+    VERIFY_IS_APPROX(det(k), m.determinant());
+  }
+
+  // a single indefinite matrix is reported
+  MatrixType m = a.matrix(count-1);
+  m(Size-1,Size-1) = -m(Size-1,Size-1);
+  a.setMatrix(count-1, m);
+  llt.compute(a);
+  VERIFY(llt.info()==NumericalIssue);
+}
+
+void test_batched_matrix()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1(( batched_product<float,3,3,3>() ));
+    CALL_SUBTEST_1(( batched_product<float,4,4,1>() ));
+    CALL_SUBTEST_2(( batched_product<double,3,3,3>() ));
+    CALL_SUBTEST_2(( batched_product<double,6,6,6>() ));
+    CALL_SUBTEST_2(( batched_product<double,2,5,3>() ));
+    CALL_SUBTEST_3(( batched_product<std::complex<double>,3,3,3>() ));
+
+    CALL_SUBTEST_4(( batched_lu<float,3>() ));
+    CALL_SUBTEST_4(( batched_lu<float,4>() ));
+    CALL_SUBTEST_5(( batched_lu<double,2>() ));
+    CALL_SUBTEST_5(( batched_lu<double,3>() ));
+    CALL_SUBTEST_5(( batched_lu<double,6>() ));
+
+    CALL_SUBTEST_6(( batched_llt<float,3>() ));
+    CALL_SUBTEST_6(( batched_llt<double,4>() ));
+    CALL_SUBTEST_6(( batched_llt<double,6>() ));
+  }
+}
@@ -70,6 +70,18 @@ template<typename MatrixType>
 void bdcsvd_inf_nan()
 {
   svd_inf_nan< MatrixType, BDCSVD< MatrixType > >();
+
+  // larger matrices go through the divide and conquer steps
+  BDCSVD<MatrixType> svd;
+  typedef typename MatrixType::Scalar Scalar;
+  Scalar some_inf = Scalar(1) / zero<Scalar>();
+  Scalar some_nan = zero<Scalar>() / zero<Scalar>();
+  MatrixType m = MatrixType::Random(60, 60);
+  m(internal::random<int>(0,59), internal::random<int>(0,59)) = some_inf;
+  svd.compute(m, ComputeFullU | ComputeFullV);
+  m(internal::random<int>(0,59), internal::random<int>(0,59)) = some_nan;
+  svd.compute(m, ComputeFullU | ComputeFullV);
+  svd.compute(MatrixType::Constant(60, 60, some_nan), ComputeThinU | ComputeThinV);
 }// end template bdcsvd_inf_nan
 
 
@@ -84,7 +96,6 @@ void bdcsvd_preallocate()
 template<typename MatrixType> 
 void compare_bdc_jacobi(const MatrixType& a = MatrixType(), unsigned int computationOptions = 0)
 {
-  std::cout << "debut compare" << std::endl;
   MatrixType m = MatrixType::Random(a.rows(), a.cols());
   BDCSVD<MatrixType> bdc_svd(m);
   JacobiSVD<MatrixType> jacobi_svd(m);
@@ -97,10 +108,49 @@ void compare_bdc_jacobi(const MatrixType& a = MatrixType(), unsigned int computa
     VERIFY_IS_APPROX(bdc_svd.matrixV(), jacobi_svd.matrixV());
   if(computationOptions & ComputeThinV)
     VERIFY_IS_APPROX(bdc_svd.matrixV(), jacobi_svd.matrixV());
-  std::cout << "fin compare" << std::endl;
 } // end template compare_bdc_jacobi
 
 
+// matrices with repeated, clustered and zero singular values, which are deflated by the conquer step
+template<typename MatrixType>
+void bdcsvd_deflation(const MatrixType& a)
+{
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef Matrix<typename MatrixType::Scalar, Dynamic, Dynamic> SquareMatrixType;
+  typedef Matrix<RealScalar, Dynamic, 1> RealVectorType;
+  Index rows = a.rows(), cols = a.cols(), diagSize = (std::min)(rows, cols);
+
+  SquareMatrixType U = HouseholderQR<SquareMatrixType>(SquareMatrixType::Random(rows, rows)).householderQ();
+  SquareMatrixType V = HouseholderQR<SquareMatrixType>(SquareMatrixType::Random(cols, cols)).householderQ();
+  RealVectorType sigma(diagSize);
+  for (Index i = 0; i < diagSize; ++i)
+  {
+    switch (i % 4)
+    {
+      case 0: sigma(i) = RealScalar(1); break;
+      case 1: sigma(i) = RealScalar(1) + NumTraits<RealScalar>::epsilon() * RealScalar(i); break;
+      case 2: sigma(i) = internal::random<RealScalar>(RealScalar(0.1), RealScalar(2)); break;
+      default: sigma(i) = RealScalar(0);
+    }
+  }
+  MatrixType S = MatrixType::Zero(rows, cols);
+  S.diagonal() = sigma.template cast<typename MatrixType::Scalar>();
+  MatrixType m = U * S * V.adjoint();
+
+  BDCSVD<MatrixType> svd(m, ComputeFullU | ComputeFullV);
+  bdcsvd_check_full(m, svd);
+  std::sort(sigma.data(), sigma.data() + diagSize, std::greater<RealScalar>());
+  VERIFY_IS_APPROX(svd.singularValues(), sigma);
+  VERIFY((svd.singularValues().tail(diagSize / 4).array() <= test_precision<RealScalar>()).all());
+
+  // deep trees of subproblems
+  svd.setSwitchSize(4);
+  svd.compute(m, ComputeThinU | ComputeThinV);
+  VERIFY_IS_APPROX(svd.singularValues(), sigma);
+  VERIFY_IS_APPROX(m, svd.matrixU() * svd.singularValues().template cast<typename MatrixType::Scalar>().asDiagonal() * svd.matrixV().adjoint());
+}
+
 // call the tests
 void test_bdcsvd()
 {
@@ -185,13 +235,12 @@ void test_bdcsvd()
       0, 1;
     CALL_SUBTEST_2(( bdcsvd(n, false) ));
     
-    // Statics matrix don't work with BDSVD yet
     // bdc algo on a random 3x3 float matrix
-    // CALL_SUBTEST_3(( bdcsvd<Matrix3f>() ));
+    CALL_SUBTEST_3(( bdcsvd<Matrix3f>() ));
     // bdc algo on a random 4x4 double matrix
-    // CALL_SUBTEST_4(( bdcsvd<Matrix4d>() ));
+    CALL_SUBTEST_4(( bdcsvd<Matrix4d>() ));
     // bdc algo on a random 3x5 float matrix
-    // CALL_SUBTEST_5(( bdcsvd<Matrix<float,3,5> >() ));
+    CALL_SUBTEST_5(( bdcsvd<Matrix<float,3,5> >() ));
 
     int r = internal::random<int>(1, 30),
       c = internal::random<int>(1, 30);
@@ -207,6 +256,21 @@ void test_bdcsvd()
   CALL_SUBTEST_7(( bdcsvd<MatrixXf>(MatrixXf(internal::random<int>(EIGEN_TEST_MAX_SIZE/4, EIGEN_TEST_MAX_SIZE/2), internal::random<int>(EIGEN_TEST_MAX_SIZE/4, EIGEN_TEST_MAX_SIZE/2))) ));
   CALL_SUBTEST_8(( bdcsvd<MatrixXcd>(MatrixXcd(internal::random<int>(EIGEN_TEST_MAX_SIZE/4, EIGEN_TEST_MAX_SIZE/3), internal::random<int>(EIGEN_TEST_MAX_SIZE/4, EIGEN_TEST_MAX_SIZE/3))) ));
 
+  // larger matrices, solved by divide and conquer
+  {
+    int r = internal::random<int>(100, 300),
+      c = internal::random<int>(100, 300);
+    CALL_SUBTEST_19(( bdcsvd<MatrixXd>(MatrixXd(r, r)) ));
+    CALL_SUBTEST_19(( bdcsvd<MatrixXd>(MatrixXd(r, c)) ));
+    CALL_SUBTEST_19(( compare_bdc_jacobi<MatrixXd>(MatrixXd(r, c)) ));
+    CALL_SUBTEST_20(( bdcsvd<MatrixXcf>(MatrixXcf(r / 2, c / 2)) ));
+    CALL_SUBTEST_20(( compare_bdc_jacobi<MatrixXcf>(MatrixXcf(r / 2, c / 2)) ));
+    CALL_SUBTEST_21(( bdcsvd_deflation<MatrixXd>(MatrixXd(r, c)) ));
+    CALL_SUBTEST_21(( bdcsvd_deflation<MatrixXcd>(MatrixXcd(c / 2, r / 2)) ));
+    (void) r;
+    (void) c;
+  }
+
   // Test problem size constructors
   CALL_SUBTEST_7( BDCSVD<MatrixXf>(10,10) );
 
@@ -0,0 +1,210 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "sparse.h"
+#include <Eigen/SparseCholesky>
+#include <unsupported/Eigen/SparseExtra>
+
+// symmetric positive definite block matrix with a random pattern of blocks, like a pose graph Hessian
+template<typename Scalar, int BlockSize>
+void random_spd_blocks(int blocks, std::vector<BlockTriplet<Scalar,BlockSize> >& triplets)
+{
+  typedef Matrix<Scalar,BlockSize,BlockSize> BlockType;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  triplets.clear();
+  for(int i=0; i<blocks; ++i)
+  {
+    BlockType d = BlockType::Random();
+    d = d*d.adjoint();
+    d.diagonal().array() += RealScalar(4*BlockSize);
+    triplets.push_back(BlockTriplet<Scalar,BlockSize>(i,i,d));
+    int neighbors = internal::random<int>(0,3);
+    for(int k=0; k<neighbors; ++k)
+    {
+      int j = internal::random<int>(0,blocks-1);
+      if(j==i) continue;
+      BlockType b = BlockType::Random() / RealScalar(4);
+      triplets.push_back(BlockTriplet<Scalar,BlockSize>(i,j,b));
+      triplets.push_back(BlockTriplet<Scalar,BlockSize>(j,i,b.adjoint()));
+      // duplicated blocks are summed
+      triplets.push_back(BlockTriplet<Scalar,BlockSize>(i,i,BlockType::Identity()));
+    }
+  }
+}
+
+template<typename Scalar, int BlockSize> void block_sparse_basic()
+{
+  typedef BlockSparseMatrix<Scalar,BlockSize> BlockMatrix;
+  typedef typename BlockMatrix::Index Index;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  typedef Matrix<Scalar,Dynamic,1> DenseVector;
+  typedef SparseMatrix<Scalar,RowMajor> RowSpMat;
+
+  const int blockRows = internal::random<int>(1,40);
+  const int blockCols = internal::random<int>(1,40);
+  const int rows = blockRows*BlockSize, cols = blockCols*BlockSize;
+
+  // assembly from scalar triplets, with duplicates
+  std::vector<Triplet<Scalar> > triplets;
+  DenseMatrix ref = DenseMatrix::Zero(rows,cols);
+  int nnz = internal::random<int>(0, rows*cols/4+1);
+  for(int k=0; k<nnz; ++k)
+  {
+    int i = internal::random<int>(0,rows-1), j = internal::random<int>(0,cols-1);
+    Scalar v = internal::random<Scalar>();
+    triplets.push_back(Triplet<Scalar>(i,j,v));
+    ref(i,j) += v;
+  }
+  BlockMatrix m(blockRows, blockCols);
+  m.setFromTriplets(triplets.begin(), triplets.end());
+  VERIFY_IS_EQUAL(m.rows(), rows);
+  VERIFY_IS_EQUAL(m.cols(), cols);
+  RowSpMat sm = m.toSparseMatrix();
+  VERIFY_IS_APPROX(DenseMatrix(sm), ref);
+
+  // the stored blocks are exactly the non empty ones, sorted per block row
+  Index count = 0;
+  for(Index i=0; i<blockRows; ++i)
+    for(Index j=0; j<blockCols; ++j)
+    {
+      bool nonEmpty = false;
+      for(int k=0; k<nnz; ++k)
+        nonEmpty = nonEmpty || (triplets[k].row()/BlockSize==i && triplets[k].col()/BlockSize==j);
+      VERIFY((m.findBlock(i,j)>=0) == nonEmpty);
+      if(nonEmpty)
+      {
+        VERIFY_IS_EQUAL(m.innerIndexPtr()[count], j);
+        VERIFY_IS_APPROX(DenseMatrix(m.block(i,j)), DenseMatrix(ref.block(i*BlockSize,j*BlockSize,BlockSize,BlockSize)));
+        ++count;
+      }
+    }
+  VERIFY_IS_EQUAL(m.nonZeroBlocks(), count);
+
+  // conversion from a SparseMatrix
+  SparseMatrix<Scalar> colMajor(sm);
+  BlockMatrix m2(colMajor);
+  VERIFY_IS_EQUAL(m2.nonZeroBlocks(), m.nonZeroBlocks());
+  VERIFY_IS_APPROX(m2.coeffs(), m.coeffs());
+
+  // update of the values with the same pattern
+  if(m.nonZeroBlocks()>0)
+  {
+    m.coeffs().setZero();
+    Index i = 0;
+    while(m.outerIndexPtr()[i+1]==0) ++i;
+    Index j = m.innerIndexPtr()[0];
+    m.blockRef(i,j).setIdentity();
+    ref.setZero();
+    ref.block(i*BlockSize,j*BlockSize,BlockSize,BlockSize).setIdentity();
+    VERIFY_IS_APPROX(DenseMatrix(m.toSparseMatrix()), ref);
+  }
+
+  // products
+  m.setFromTriplets(triplets.begin(), triplets.end());
+  ref = DenseMatrix(m.toSparseMatrix());
+  DenseVector x = DenseVector::Random(cols), y = DenseVector::Random(rows), y0 = y;
+  VERIFY_IS_APPROX(DenseVector(m*x), ref*x);
+  y += m*x;
+  VERIFY_IS_APPROX(y, y0 + ref*x);
+  y -= m*(x*Scalar(2));
+  VERIFY_IS_APPROX(y, y0 - ref*x);
+  DenseMatrix X = DenseMatrix::Random(cols,3), Y;
+  Y = m*X;
+  VERIFY_IS_APPROX(Y, ref*X);
+  if(rows==cols)
+  {
+    // aliasing
+    DenseVector z = x;
+    z = m*z;
+    VERIFY_IS_APPROX(z, ref*x);
+  }
+}
+
+template<typename Scalar, int BlockSize, int UpLo, typename Ordering> void block_sparse_llt()
+{
+  typedef BlockSparseMatrix<Scalar,BlockSize> BlockMatrix;
+  typedef typename BlockMatrix::Index Index;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  typedef Matrix<Scalar,Dynamic,1> DenseVector;
+
+  const int blocks = internal::random<int>(1,60);
+  const int size = blocks*BlockSize;
+  std::vector<BlockTriplet<Scalar,BlockSize> > triplets;
+  random_spd_blocks<Scalar,BlockSize>(blocks, triplets);
+  BlockMatrix A(blocks, blocks);
+  A.setFromBlockTriplets(triplets.begin(), triplets.end());
+  DenseMatrix dA(A.toSparseMatrix());
+  VERIFY_IS_APPROX(dA, dA.adjoint());
+
+  // only the triangular part UpLo is used
+  BlockMatrix halfA(A);
+  for(Index i=0; i<blocks; ++i)
+    for(Index k=halfA.outerIndexPtr()[i]; k<halfA.outerIndexPtr()[i+1]; ++k)
+    {
+      Index j = halfA.innerIndexPtr()[k];
+      if(UpLo==Lower && j>i) halfA.valueBlock(k).setRandom();
+      if(UpLo==Upper && j<i) halfA.valueBlock(k).setRandom();
+      if(j==i)
+      {
+        if(UpLo==Lower) halfA.valueBlock(k).template triangularView<StrictlyUpper>().setZero();
+        else            halfA.valueBlock(k).template triangularView<StrictlyLower>().setZero();
+      }
+    }
+
+  BlockSparseLLT<BlockMatrix,UpLo,Ordering> llt(halfA);
+  VERIFY(llt.info()==Success);
+  DenseVector b = DenseVector::Random(size);
+  DenseVector x = llt.solve(b);
+  VERIFY_IS_APPROX(dA*x, b);
+  DenseMatrix B = DenseMatrix::Random(size,3), X;
+  X = llt.solve(B);
+  VERIFY_IS_APPROX(dA*X, B);
+  if(size<=16) // otherwise the determinant overflows
+    VERIFY_IS_APPROX(llt.determinant(), dA.determinant());
+
+  // P A P^T = L L^*, P permuting the blocks
+  PermutationMatrix<Dynamic,Dynamic,int> P(size);
+  for(Index i=0; i<blocks; ++i)
+    for(int r=0; r<BlockSize; ++r)
+      P.indices()[i*BlockSize+r] = llt.permutationP().indices()[i]*BlockSize+r;
+  DenseMatrix L(llt.matrixL());
+  VERIFY_IS_APPROX(DenseMatrix(L.template triangularView<Lower>()), L);
+  VERIFY_IS_APPROX(L*L.adjoint(), DenseMatrix(P*dA*P.transpose()));
+
+  // factorization of new values with the same pattern
+  halfA.coeffs() *= Scalar(2);
+  llt.factorize(halfA);
+  VERIFY(llt.info()==Success);
+  VERIFY_IS_APPROX(Scalar(2)*(dA*llt.solve(b)), b);
+
+  // not positive definite
+  halfA.coeffs() *= Scalar(-1);
+  llt.factorize(halfA);
+  VERIFY(llt.info()==NumericalIssue);
+
+  // the same factor as the scalar factorization, up to the ordering
+  SimplicialLLT<SparseMatrix<Scalar>,Lower,NaturalOrdering<int> > ref;
+  SparseMatrix<Scalar> PAPt = DenseMatrix(P*dA*P.transpose()).sparseView();
+  ref.compute(PAPt);
+  VERIFY_IS_APPROX(DenseMatrix(ref.matrixL()), L);
+}
+
+void test_block_sparse_matrix()
+{
+  for(int i = 0; i < g_repeat; i++)
+  {
+    CALL_SUBTEST_1(( block_sparse_basic<double,1>() ));
+    CALL_SUBTEST_1(( block_sparse_basic<double,6>() ));
+    CALL_SUBTEST_2(( block_sparse_basic<float,3>() ));
+    CALL_SUBTEST_2(( block_sparse_basic<std::complex<double>,2>() ));
+    CALL_SUBTEST_3(( block_sparse_llt<double,6,Lower,AMDOrdering<int> >() ));
+    CALL_SUBTEST_3(( block_sparse_llt<double,3,Upper,AMDOrdering<int> >() ));
+    CALL_SUBTEST_3(( block_sparse_llt<double,1,Lower,NaturalOrdering<int> >() ));
+    CALL_SUBTEST_4(( block_sparse_llt<float,4,Lower,AMDOrdering<int> >() ));
+    CALL_SUBTEST_4(( block_sparse_llt<std::complex<double>,2,Upper,AMDOrdering<int> >() ));
+  }
+}
@@ -0,0 +1,112 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <unsupported/Eigen/ProductTuner>
+#include <cstdio>
+
+template<typename Scalar> void tuned_blocking_sizes()
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  typedef typename MatrixType::Index Index;
+  enum { ScalarId = internal::tuned_blocking_scalar_id<Scalar>::value };
+
+  GemmBlockingTuner::reset();
+
+  // the installed values take precedence over the cache size heuristic
+  std::ptrdiff_t kc = 48, mc = 64;
+  internal::manage_tuned_blocking_sizes(SetAction, ScalarId, internal::GeneralProductShape, &kc, &mc);
+  std::ptrdiff_t k = 300, m = 300, n = 300;
+  internal::computeProductBlockingSizes<Scalar,Scalar>(k, m, n);
+  VERIFY_IS_EQUAL(k, 48);
+  VERIFY_IS_EQUAL(m, 64);
+
+  // other shape classes are not affected
+  k = 16; m = 300; n = 300;
+  VERIFY_IS_EQUAL(internal::product_shape_class(k,m,n), int(internal::RankUpdateProductShape));
+  internal::computeProductBlockingSizes<Scalar,Scalar>(k, m, n);
+  VERIFY_IS_EQUAL(k, 16);
+
+  // products remain correct with arbitrary blocking sizes
+  Index rows = internal::random<Index>(100,200), cols = internal::random<Index>(100,200), depth = internal::random<Index>(100,200);
+  MatrixType a = MatrixType::Random(rows,depth), b = MatrixType::Random(depth,cols);
+  MatrixType ref = a.lazyProduct(b);
+  kc = internal::random<int>(1,64); mc = internal::random<int>(1,64);
+  internal::manage_tuned_blocking_sizes(SetAction, ScalarId, internal::product_shape_class(depth,rows,cols), &kc, &mc);
+  MatrixType c = a * b;
+  VERIFY_IS_APPROX(c, ref);
+
+  GemmBlockingTuner::reset();
+  k = 300; m = 300; n = 300;
+  internal::computeProductBlockingSizes<Scalar,Scalar>(k, m, n);
+  VERIFY(k>0 && k<=300 && m>0 && m<=300 && n==300);
+}
+
+template<typename Scalar> void tuner_roundtrip()
+{
+  const std::string filename = "gemm_blocking_tuner_cache.txt";
+  std::remove(filename.c_str());
+  GemmBlockingTuner::reset();
+
+  GemmBlockingTuner tuner(64, 1);
+  VERIFY(!tuner.load(filename));
+  VERIFY(!tuner.isTuned<Scalar>());
+  tuner.tune<Scalar>();
+  VERIFY(tuner.isTuned<Scalar>());
+  for(int shape=0; shape<internal::ProductShapeCount; ++shape)
+  {
+    const GemmBlockingTuner::Entry& e = tuner.entry<Scalar>(shape);
+    VERIFY(e.kc>0 && e.mc>0);
+    VERIFY(e.tunedTime<=e.heuristicTime);
+  }
+  VERIFY(tuner.save(filename));
+
+  GemmBlockingTuner loaded;
+  VERIFY(loaded.load(filename));
+  VERIFY(loaded.isTuned<Scalar>());
+  for(int shape=0; shape<internal::ProductShapeCount; ++shape)
+  {
+    VERIFY_IS_EQUAL(loaded.entry<Scalar>(shape).kc, tuner.entry<Scalar>(shape).kc);
+    VERIFY_IS_EQUAL(loaded.entry<Scalar>(shape).mc, tuner.entry<Scalar>(shape).mc);
+  }
+
+  // tuning only installs the results on demand
+  std::ptrdiff_t kc, mc;
+  internal::manage_tuned_blocking_sizes(GetAction, internal::tuned_blocking_scalar_id<Scalar>::value, internal::GeneralProductShape, &kc, &mc);
+  VERIFY_IS_EQUAL(kc, 0);
+  loaded.apply();
+  internal::manage_tuned_blocking_sizes(GetAction, internal::tuned_blocking_scalar_id<Scalar>::value, internal::GeneralProductShape, &kc, &mc);
+  VERIFY_IS_EQUAL(kc, tuner.entry<Scalar>(internal::GeneralProductShape).kc);
+  VERIFY_IS_EQUAL(mc, tuner.entry<Scalar>(internal::GeneralProductShape).mc);
+
+  // the cached results are reused by the automatic tuning
+  GemmBlockingTuner::reset();
+  VERIFY(autotuneProductBlockingSizes<Scalar>(filename, 64, 1));
+
+  // results computed for other cache sizes are discarded
+  std::ptrdiff_t l1, l2;
+  internal::manage_caching_sizes(GetAction, &l1, &l2);
+  setCpuCacheSizes(l1, 2*l2);
+  VERIFY(!loaded.load(filename));
+  VERIFY(!loaded.isTuned<Scalar>());
+  VERIFY(!autotuneProductBlockingSizes<Scalar>(filename, 64, 1));
+  VERIFY(autotuneProductBlockingSizes<Scalar>(filename, 64, 1));
+  setCpuCacheSizes(l1, l2);
+
+  GemmBlockingTuner::reset();
+  std::remove(filename.c_str());
+}
+
+void test_gemm_blocking_tuner()
+{
+  CALL_SUBTEST_1( tuned_blocking_sizes<float>() );
+  CALL_SUBTEST_2( tuned_blocking_sizes<double>() );
+  CALL_SUBTEST_3( tuned_blocking_sizes<std::complex<double> >() );
+  CALL_SUBTEST_4( tuner_roundtrip<float>() );
+  CALL_SUBTEST_5( tuner_roundtrip<double>() );
+}
@@ -0,0 +1,62 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "../../test/sparse_solver.h"
+#include <Eigen/IterativeSolvers>
+
+template<typename T> void test_lowsync_gmres_T()
+{
+  LowSyncGMRES<SparseMatrix<T>, DiagonalPreconditioner<T> > gmres_colmajor_diag;
+  LowSyncGMRES<SparseMatrix<T>, IncompleteLUT<T> >           gmres_colmajor_ilut;
+
+  CALL_SUBTEST( check_sparse_square_solving(gmres_colmajor_diag)  );
+  CALL_SUBTEST( check_sparse_square_solving(gmres_colmajor_ilut)  );
+}
+
+// a large 2D convection-diffusion problem, for which the Gram-Schmidt process is split over several threads
+void test_lowsync_gmres_convection_diffusion()
+{
+  typedef SparseMatrix<double,RowMajor> SpMat;
+  const int size = 300, n = size*size;
+  std::vector<Triplet<double> > triplets;
+  for(int i=0; i<size; ++i)
+    for(int j=0; j<size; ++j)
+    {
+      const int k = i*size+j;
+      triplets.push_back(Triplet<double>(k, k, 4));
+      if(i>0)      triplets.push_back(Triplet<double>(k, k-size, -1.2));
+      if(i<size-1) triplets.push_back(Triplet<double>(k, k+size, -0.8));
+      if(j>0)      triplets.push_back(Triplet<double>(k, k-1, -1));
+      if(j<size-1) triplets.push_back(Triplet<double>(k, k+1, -1));
+    }
+  SpMat A(n, n);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+  VectorXd b = VectorXd::Random(n);
+
+  int threads = nbThreads();
+  for(int k=1; k<=4; k*=4)
+  {
+    setNbThreads(k);
+    LowSyncGMRES<SpMat, IncompleteLUT<double> > gmres(A);
+    gmres.setTolerance(1e-10);
+    gmres.set_restart(20);
+    VectorXd x = gmres.solve(b);
+    VERIFY_IS_EQUAL(gmres.info(), Success);
+    VERIFY((A*x-b).norm() <= 1e-10*b.norm());
+    // restarted from the solution
+    x = gmres.solveWithGuess(b, x);
+    VERIFY_IS_EQUAL(gmres.iterations(), 0);
+  }
+  setNbThreads(threads);
+}
+
+void test_lowsync_gmres()
+{
+  CALL_SUBTEST_1(test_lowsync_gmres_T<double>());
+  CALL_SUBTEST_2(test_lowsync_gmres_T<std::complex<double> >());
+  CALL_SUBTEST_3(test_lowsync_gmres_convection_diffusion());
+}
@@ -0,0 +1,147 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <Eigen/Dense>
+#include <Eigen/SparseCholesky>
+#include <Eigen/SparseLU>
+#include <unsupported/Eigen/IterativeSolvers>
+
+template<typename Solver, typename MatrixType, typename Rhs>
+void check_mixed_precision_solution(const Solver& solver, const MatrixType& A, const Rhs& b, const Rhs& x)
+{
+  typedef typename Rhs::RealScalar RealScalar;
+  VERIFY_IS_EQUAL(solver.info(), Success);
+  VERIFY(solver.error() <= solver.tolerance());
+  for(int j=0; j<b.cols(); ++j)
+  {
+    RealScalar bwdError = (b.col(j) - A*x.col(j)).template lpNorm<Infinity>()
+                        / ((A.cwiseAbs() * Matrix<RealScalar,Dynamic,1>::Ones(A.cols())).maxCoeff() * x.col(j).template lpNorm<Infinity>());
+    VERIFY(bwdError <= solver.tolerance());
+  }
+}
+
+template<typename Scalar> void test_mixed_precision_dense()
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  const int size = internal::random<int>(20,200);
+  const int cols = internal::random<int>(1,4);
+  MatrixType A = MatrixType::Random(size,size) + MatrixType::Identity(size,size) * Scalar(size);
+  MatrixType b = MatrixType::Random(size,cols), x;
+
+  // general matrix
+  MixedPrecisionSolver<PartialPivLU<MatrixType> > lu(A);
+  x = lu.solve(b);
+  VERIFY(lu.usesLowPrecision());
+  check_mixed_precision_solution(lu, A, b, x);
+  VERIFY(x.isApprox(A.partialPivLu().solve(b), test_precision<Scalar>()));
+  VERIFY(lu.iterations() <= 8);
+
+  // selfadjoint matrix
+  MatrixType M = MatrixType::Random(size,size);
+  MatrixType S = M * M.adjoint() + MatrixType::Identity(size,size);
+  MixedPrecisionSolver<LDLT<MatrixType> > ldlt(S);
+  x = ldlt.solve(b);
+  VERIFY(ldlt.usesLowPrecision());
+  check_mixed_precision_solution(ldlt, S, b, x);
+
+  // entries out of the range of single precision: the factorization is done in double precision
+  MatrixType A2 = A * Scalar(1e40);
+  lu.compute(A2);
+  VERIFY(!lu.usesLowPrecision());
+  x = lu.solve(b);
+  check_mixed_precision_solution(lu, A2, b, x);
+  VERIFY_IS_EQUAL(lu.iterations(), 0);
+}
+
+// 5-point finite difference discretization of -laplacian(u) + c.grad(u) on a n x n grid
+void convection_diffusion_2d(int n, double c, SparseMatrix<double>& A)
+{
+  typedef Triplet<double> T;
+  std::vector<T> triplets;
+  for(int j=0; j<n; ++j)
+    for(int i=0; i<n; ++i)
+    {
+      int k = i + j*n;
+      triplets.push_back(T(k, k, 4));
+      if(i>0)   triplets.push_back(T(k, k-1, -1-c));
+      if(i<n-1) triplets.push_back(T(k, k+1, -1+c));
+      if(j>0)   triplets.push_back(T(k, k-n, -1));
+      if(j<n-1) triplets.push_back(T(k, k+n, -1));
+    }
+  A.resize(n*n, n*n);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+}
+
+void test_mixed_precision_sparse()
+{
+  typedef SparseMatrix<double> SpMat;
+  SpMat A;
+  const int n = internal::random<int>(10,40);
+  MatrixXd b = MatrixXd::Random(n*n,2), x;
+
+  convection_diffusion_2d(n, 0, A);
+  MixedPrecisionSolver<SimplicialLDLT<SpMat> > ldlt(A);
+  x = ldlt.solve(b);
+  VERIFY(ldlt.usesLowPrecision());
+  VERIFY_IS_EQUAL(ldlt.lowPrecisionDecomposition().info(), Success);
+  check_mixed_precision_solution(ldlt, A, b, x);
+
+  convection_diffusion_2d(n, 0.3, A);
+  MixedPrecisionSolver<SparseLU<SpMat> > lu(A);
+  x = lu.solve(b);
+  VERIFY(lu.usesLowPrecision());
+  check_mixed_precision_solution(lu, A, b, x);
+
+  // a matrix which is not positive definite is factorized in double precision
+  SpMat I(A.rows(), A.cols());
+  I.setIdentity();
+  convection_diffusion_2d(n, 0, A);
+  SpMat A2 = A - I * 20.;
+  MixedPrecisionSolver<SimplicialLLT<SpMat> > llt(A2);
+  VERIFY(!llt.usesLowPrecision());
+  VERIFY_IS_EQUAL(llt.info(), NumericalIssue);
+}
+
+void test_mixed_precision_ill_conditioned()
+{
+  const int size = internal::random<int>(30,80);
+  MatrixXd U = HouseholderQR<MatrixXd>(MatrixXd::Random(size,size)).householderQ();
+  MatrixXd V = HouseholderQR<MatrixXd>(MatrixXd::Random(size,size)).householderQ();
+  VectorXd b = VectorXd::Random(size), x;
+
+  // a condition number of 1e9: the classical refinement diverges, but not the GMRES one
+  VectorXd sigma = VectorXd::LinSpaced(size, 0, -9);
+  for(int i=0; i<size; ++i)
+    sigma(i) = std::pow(10., sigma(i));
+  MatrixXd A = U * sigma.asDiagonal() * V.transpose();
+  MixedPrecisionSolver<PartialPivLU<MatrixXd> > lu(A);
+  x = lu.solve(b);
+  VERIFY(lu.usesLowPrecision());
+  check_mixed_precision_solution(lu, A, b, x);
+
+  // without the GMRES refinement, the matrix is factorized in double precision
+  lu.compute(A);
+  lu.setGmresRefinement(false);
+  x = lu.solve(b);
+  VERIFY(!lu.usesLowPrecision());
+  check_mixed_precision_solution(lu, A, b, x);
+  // and the following solves use this factorization
+  x = lu.solve(b);
+  VERIFY_IS_EQUAL(lu.iterations(), 0);
+  check_mixed_precision_solution(lu, A, b, x);
+}
+
+void test_mixed_precision_solver()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1(test_mixed_precision_dense<double>());
+    CALL_SUBTEST_2(test_mixed_precision_dense<std::complex<double> >());
+    CALL_SUBTEST_3(test_mixed_precision_sparse());
+    CALL_SUBTEST_4(test_mixed_precision_ill_conditioned());
+  }
+}
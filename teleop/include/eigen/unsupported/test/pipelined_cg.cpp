@@ -0,0 +1,104 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "../../test/sparse_solver.h"
+#include <Eigen/IterativeSolvers>
+
+template<typename T> void test_pipelined_cg_T()
+{
+  PipelinedConjugateGradient<SparseMatrix<T>, Lower      > cg_colmajor_lower_diag;
+  PipelinedConjugateGradient<SparseMatrix<T>, Upper      > cg_colmajor_upper_diag;
+  PipelinedConjugateGradient<SparseMatrix<T>, Lower|Upper> cg_colmajor_loup_diag;
+  PipelinedConjugateGradient<SparseMatrix<T>, Lower, IdentityPreconditioner> cg_colmajor_lower_I;
+  PipelinedConjugateGradient<SparseMatrix<T>, Upper, IdentityPreconditioner> cg_colmajor_upper_I;
+  // the default tolerance, the machine epsilon, is below the attainable accuracy of the pipelined recurrences
+  cg_colmajor_lower_diag.setTolerance(1e-12);
+  cg_colmajor_upper_diag.setTolerance(1e-12);
+  cg_colmajor_loup_diag.setTolerance(1e-12);
+  cg_colmajor_lower_I.setTolerance(1e-12);
+  cg_colmajor_upper_I.setTolerance(1e-12);
+
+  CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_lower_diag)  );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_upper_diag)  );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_loup_diag)   );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_lower_I)     );
+  CALL_SUBTEST( check_sparse_spd_solving(cg_colmajor_upper_I)     );
+}
+
+// a large 2D Poisson problem, for which the vector updates are split over several threads
+void test_pipelined_cg_poisson()
+{
+  typedef SparseMatrix<double,RowMajor> SpMat;
+  const int size = 400, n = size*size;
+  std::vector<Triplet<double> > triplets;
+  for(int i=0; i<size; ++i)
+    for(int j=0; j<size; ++j)
+    {
+      const int k = i*size+j;
+      triplets.push_back(Triplet<double>(k, k, 4));
+      if(i>0)      triplets.push_back(Triplet<double>(k, k-size, -1));
+      if(i<size-1) triplets.push_back(Triplet<double>(k, k+size, -1));
+      if(j>0)      triplets.push_back(Triplet<double>(k, k-1, -1));
+      if(j<size-1) triplets.push_back(Triplet<double>(k, k+1, -1));
+    }
+  SpMat A(n, n);
+  A.setFromTriplets(triplets.begin(), triplets.end());
+  VectorXd b = VectorXd::Random(n);
+
+  ConjugateGradient<SpMat, Lower|Upper> cg(A);
+  cg.setTolerance(1e-10);
+  VectorXd x0 = cg.solve(b);
+  VERIFY_IS_EQUAL(cg.info(), Success);
+
+  int threads = nbThreads();
+  for(int k=1; k<=4; k*=4)
+  {
+    setNbThreads(k);
+    PipelinedConjugateGradient<SpMat, Lower|Upper> pcg(A);
+    pcg.setTolerance(1e-10);
+    VectorXd x = pcg.solve(b);
+    VERIFY_IS_EQUAL(pcg.info(), Success);
+    VERIFY((A*x-b).norm() <= 1e-10*b.norm());
+    VERIFY(x.isApprox(x0, 1e-8));
+    // same number of iterations as CG, up to rounding errors
+    VERIFY(pcg.iterations() <= cg.iterations() + cg.iterations()/10);
+  }
+  setNbThreads(threads);
+}
+
+// a tolerance below the attainable accuracy: the reported error must be the one of the true residual
+void test_pipelined_cg_stagnation()
+{
+  typedef SparseMatrix<double> SpMat;
+  const int n = internal::random<int>(50,100);
+  // a large rank one term makes the updated residual stagnate far from the true one
+  MatrixXd dA = MatrixXd::Constant(n, n, 1e6/n);
+  for(int i=0; i<n; ++i)
+  {
+    dA(i, i) += 4;
+    if(i>0) dA(i, i-1) -= 1;
+    if(i<n-1) dA(i, i+1) -= 1;
+  }
+  SpMat A = dA.sparseView();
+  VectorXd b = VectorXd::Random(n);
+
+  PipelinedConjugateGradient<SpMat, Lower|Upper, IdentityPreconditioner> pcg(A);
+  pcg.setTolerance(1e-14);
+  VectorXd x = pcg.solve(b);
+  VERIFY_IS_EQUAL(pcg.info(), NoConvergence);
+  VERIFY(pcg.error() > pcg.tolerance());
+  VERIFY_IS_APPROX(pcg.error(), (b - A*x).norm() / b.norm());
+}
+
+void test_pipelined_cg()
+{
+  CALL_SUBTEST_1(test_pipelined_cg_T<double>());
+  CALL_SUBTEST_2(test_pipelined_cg_T<std::complex<double> >());
+  CALL_SUBTEST_3(test_pipelined_cg_poisson());
+  for(int i = 0; i < g_repeat; i++)
+    CALL_SUBTEST_4(test_pipelined_cg_stagnation());
+}
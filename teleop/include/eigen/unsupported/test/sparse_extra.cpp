@@ -130,6 +130,74 @@ template<typename SparseMatrixType> void sparse_extra(const SparseMatrixType& re
 
 }
 
+template<typename Scalar, int Options, typename OuterIndex> void delta_compressed(int rows, int cols)
+{
+  typedef SparseMatrix<Scalar,Options,int,OuterIndex> SpMat;
+  typedef DeltaCompressedSparseMatrix<Scalar,Options,int,OuterIndex> DeltaMat;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  typedef Matrix<Scalar,Dynamic,1> DenseVector;
+  typedef typename SpMat::Index Index;
+
+  double density = (std::max)(8./(rows*cols), 0.01);
+  DenseMatrix refMat = DenseMatrix::Zero(rows, cols);
+  SpMat m(rows, cols);
+  initSparse<Scalar>(density, refMat, m);
+  // add entries far apart so that some deltas need two and three bytes
+  m.conservativeResize(rows+20000, cols+20000);
+  m.insert(rows+19999, 0) = Scalar(1);
+  m.insert(rows+300, cols+1) = Scalar(2);
+  m.insert(0, cols+19999) = Scalar(3);
+  m.makeCompressed();
+
+  DeltaMat dm(m);
+  VERIFY_IS_EQUAL(dm.rows(), m.rows());
+  VERIFY_IS_EQUAL(dm.cols(), m.cols());
+  VERIFY_IS_EQUAL(Index(dm.nonZeros()), Index(m.nonZeros()));
+  // all indices are below 2^21 and thus need at most 3 bytes
+  VERIFY(dm.indexBytes() - 2*std::size_t(m.outerSize()+1)*sizeof(OuterIndex) <= 3*std::size_t(m.nonZeros()));
+  VERIFY_IS_EQUAL(dm.coeff(rows+19999, 0), Scalar(1));
+  VERIFY_IS_EQUAL(dm.coeff(rows+300, cols+1), Scalar(2));
+  VERIFY_IS_EQUAL(dm.coeff(0, cols+19999), Scalar(3));
+  VERIFY_IS_EQUAL(dm.coeff(rows+1, cols+1), Scalar(0));
+
+  // round trip
+  SpMat m2(dm);
+  VERIFY_IS_EQUAL(m2.nonZeros(), m.nonZeros());
+  VERIFY((m2 - m).norm() == 0);
+  for(Index j=0; j<m.outerSize(); ++j)
+  {
+    typename DeltaMat::InnerIterator it2(dm,j);
+    for(typename SpMat::InnerIterator it(m,j); it; ++it, ++it2)
+    {
+      VERIFY(it2);
+      VERIFY_IS_EQUAL(it2.index(), it.index());
+      VERIFY_IS_EQUAL(it2.value(), it.value());
+    }
+    VERIFY(!it2);
+  }
+
+  // products with dense objects
+  DenseVector x = DenseVector::Random(m.cols());
+  DenseVector y1 = m * x, y2 = dm * x;
+  VERIFY_IS_APPROX(y2, y1);
+  DenseMatrix X = DenseMatrix::Random(m.cols(), 3);
+  DenseMatrix Y1 = m * X, Y2 = dm * X;
+  VERIFY_IS_APPROX(Y2, Y1);
+
+  // conversion from the opposite storage order and from expressions
+  SparseMatrix<Scalar,Options==RowMajor ? ColMajor : RowMajor> mt(m);
+  DeltaMat dmt(mt);
+  VERIFY_IS_EQUAL(Index(dmt.nonZeros()), Index(m.nonZeros()));
+  VERIFY_IS_APPROX(SpMat(dmt) * x, y1);
+  DeltaMat dm2(m * Scalar(2));
+  VERIFY_IS_APPROX(SpMat(dm2) * x, Scalar(2) * y1);
+
+  DeltaMat dm3;
+  VERIFY_IS_EQUAL(dm3.rows(), 0);
+  dm3 = dm;
+  VERIFY_IS_APPROX(dm3 * x, y1);
+}
+
 void test_sparse_extra()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -144,5 +212,8 @@ void test_sparse_extra()
 
     CALL_SUBTEST_3( (sparse_product<DynamicSparseMatrix<float, ColMajor> >()) );
     CALL_SUBTEST_3( (sparse_product<DynamicSparseMatrix<float, RowMajor> >()) );
+
+    CALL_SUBTEST_4(( delta_compressed<double,ColMajor,int>(s, s) ));
+    CALL_SUBTEST_4(( delta_compressed<std::complex<double>,RowMajor,long>(s, internal::random<int>(1,50)) ));
   }
 }
@@ -0,0 +1,308 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "sparse.h"
+#include <cstdio>
+#include <unsupported/Eigen/SparseExtra>
+
+// value of the entries written in the test file
+template<typename Scalar> Scalar market_test_value(Scalar*) { return Scalar(1.5); }
+template<typename Scalar> std::complex<Scalar> market_test_value(std::complex<Scalar>*) { return std::complex<Scalar>(1.5,-2); }
+
+template<typename Scalar> void sparse_market_io()
+{
+  typedef SparseMatrix<Scalar> SpMat;
+  typedef SparseMatrix<Scalar,RowMajor> RowSpMat;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+
+  const int rows = internal::random<int>(1,300), cols = internal::random<int>(1,300);
+  double density = (std::max)(8./(rows*cols), 0.05);
+  DenseMatrix refMat = DenseMatrix::Zero(rows, cols);
+  SpMat m(rows, cols);
+  initSparse<Scalar>(density, refMat, m);
+
+  std::string filename = "sparse_io_test.mtx";
+  VERIFY(saveMarket(m, filename));
+  SpMat m1;
+  VERIFY(loadMarket(m1, filename));
+  VERIFY_IS_APPROX(DenseMatrix(m1), refMat);
+  RowSpMat m2;
+  VERIFY(loadMarket(m2, filename));
+  VERIFY_IS_APPROX(DenseMatrix(m2), refMat);
+
+  // comments, blank lines, duplicated and out of range entries
+  {
+    std::FILE* file = std::fopen(filename.c_str(), "w");
+    std::fprintf(file, "%%%%MatrixMarket matrix coordinate %s general\n%% comment\n\n  %d %d 4\n",
+                 NumTraits<Scalar>::IsComplex ? "complex" : "real", rows, cols);
+    const char* value = NumTraits<Scalar>::IsComplex ? "1.5 -2" : "1.5";
+    std::fprintf(file, "1 1 %s\r\n%% comment\n%d %d %s\n1 1 %s\n%d 1 %s", value, rows, cols, value, value, rows+1, value);
+    std::fclose(file);
+    Scalar v = market_test_value(static_cast<Scalar*>(0));
+    VERIFY(loadMarket(m1, filename));
+    VERIFY_IS_EQUAL(m1.rows(), rows);
+    VERIFY_IS_EQUAL(m1.cols(), cols);
+    if(rows==1 && cols==1)
+    {
+      VERIFY_IS_EQUAL(m1.nonZeros(), 1);
+      VERIFY_IS_APPROX(m1.coeff(0,0), Scalar(3)*v);
+    }
+    else
+    {
+      VERIFY_IS_EQUAL(m1.nonZeros(), 2);
+      VERIFY_IS_APPROX(m1.coeff(0,0), Scalar(2)*v);
+      VERIFY_IS_APPROX(m1.coeff(rows-1,cols-1), v);
+    }
+  }
+
+  VERIFY(!loadMarket(m1, "sparse_io_missing.mtx"));
+  std::remove(filename.c_str());
+}
+
+template<typename Scalar, typename Index> void sparse_binary_io()
+{
+  typedef SparseMatrix<Scalar,ColMajor,Index> SpMat;
+  typedef SparseMatrix<Scalar,RowMajor,Index> RowSpMat;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+
+  const Index rows = internal::random<Index>(1,300), cols = internal::random<Index>(1,300);
+  double density = (std::max)(8./(rows*cols), 0.05);
+  DenseMatrix refMat = DenseMatrix::Zero(rows, cols);
+  SpMat m(rows, cols);
+  initSparse<Scalar>(density, refMat, m);
+
+  std::string filename = "sparse_io_test.bin";
+  VERIFY(saveBinary(m, filename));
+
+  // same and opposite storage orders
+  SpMat m1;
+  VERIFY(loadBinary(m1, filename));
+  VERIFY(m1.isCompressed());
+  VERIFY_IS_EQUAL(m1.nonZeros(), m.nonZeros());
+  VERIFY_IS_APPROX(DenseMatrix(m1), refMat);
+  RowSpMat m2;
+  VERIFY(loadBinary(m2, filename));
+  VERIFY_IS_APPROX(DenseMatrix(m2), refMat);
+
+  // uncompressed matrices and expressions
+  m1.reserve(VectorXi::Constant(cols, 2));
+  VERIFY(!m1.isCompressed());
+  VERIFY(saveBinary(m1, filename));
+  VERIFY(loadBinary(m2, filename));
+  VERIFY_IS_APPROX(DenseMatrix(m2), refMat);
+  VERIFY(saveBinary(m1.transpose(), filename));
+  VERIFY(loadBinary(m2, filename));
+  VERIFY_IS_APPROX(DenseMatrix(m2), DenseMatrix(refMat.transpose()));
+
+  // mapping, the storage order must match
+#if !defined(_WIN32)
+  {
+    MappedBinarySparseMatrix<Scalar,RowMajor,Index> map(filename);
+    VERIFY(map.isValid());
+    VERIFY_IS_EQUAL(map.rows(), cols);
+    VERIFY_IS_EQUAL(map.cols(), rows);
+    VERIFY_IS_EQUAL(map.nonZeros(), m.nonZeros());
+    VERIFY_IS_APPROX(DenseMatrix(map), DenseMatrix(refMat.transpose()));
+    // the coefficients can be modified in memory without changing the file
+    map.valuePtr()[0] = Scalar(0);
+    VERIFY(loadBinary(m2, filename));
+    VERIFY_IS_APPROX(DenseMatrix(m2), DenseMatrix(refMat.transpose()));
+    MappedBinarySparseMatrix<Scalar,ColMajor,Index> wrongOrder(filename);
+    VERIFY(!wrongOrder.isValid());
+    VERIFY_IS_EQUAL(wrongOrder.nonZeros(), 0);
+  }
+  {
+    MappedBinarySparseMatrix<Scalar,RowMajor,Index> missing("sparse_io_missing.bin");
+    VERIFY(!missing.isValid());
+    VERIFY_IS_EQUAL(missing.rows(), 0);
+  }
+#endif
+
+  // wrong scalar or index types, and truncated files
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef typename internal::conditional<NumTraits<Scalar>::IsComplex,RealScalar,std::complex<RealScalar> >::type OtherScalar;
+  SparseMatrix<OtherScalar,ColMajor,Index> c;
+  VERIFY(!loadBinary(c, filename));
+  typedef typename internal::conditional<sizeof(Index)==sizeof(int),long,int>::type OtherIndex;
+  SparseMatrix<Scalar,ColMajor,OtherIndex> l;
+  VERIFY(!loadBinary(l, filename));
+  {
+    std::vector<char> content;
+    VERIFY(internal::read_market_file(filename, content));
+    std::FILE* file = std::fopen(filename.c_str(), "wb");
+    std::fwrite(&content[0], 1, content.size()-1-sizeof(Scalar)-16, file);
+    std::fclose(file);
+  }
+  VERIFY(!loadBinary(m1, filename));
+  VERIFY_IS_EQUAL(m1.nonZeros(), 0);
+#if !defined(_WIN32)
+  {
+    MappedBinarySparseMatrix<Scalar,RowMajor,Index> truncated(filename);
+    VERIFY(!truncated.isValid());
+  }
+#endif
+  VERIFY(!loadBinary(m1, "sparse_io_missing.bin"));
+  std::remove(filename.c_str());
+}
+
+// 64 bits outer index array with 32 bits inner indices
+void sparse_binary_io_wide_outer()
+{
+  typedef SparseMatrix<double,ColMajor,int,std::ptrdiff_t> SpMat;
+  typedef SparseMatrix<double,RowMajor,int,std::ptrdiff_t> RowSpMat;
+  const int rows = internal::random<int>(1,300), cols = internal::random<int>(1,300);
+  MatrixXd refMat = MatrixXd::Random(rows, cols);
+  refMat = (refMat.array().abs() < 0.8).select(0, refMat);
+  SpMat m = refMat.sparseView();
+
+  std::string filename = "sparse_io_test.bin";
+  VERIFY(saveBinary(m, filename));
+  SpMat m1;
+  VERIFY(loadBinary(m1, filename));
+  VERIFY_IS_EQUAL(m1.nonZeros(), m.nonZeros());
+  VERIFY_IS_APPROX(MatrixXd(m1), refMat);
+  RowSpMat m2;
+  VERIFY(loadBinary(m2, filename));
+  VERIFY_IS_APPROX(MatrixXd(m2), refMat);
+
+  // the outer index type must match
+  SparseMatrix<double,ColMajor,int> narrow;
+  VERIFY(!loadBinary(narrow, filename));
+  VERIFY(saveBinary(SparseMatrix<double,ColMajor,int>(refMat.sparseView()), filename));
+  VERIFY(!loadBinary(m1, filename));
+  std::remove(filename.c_str());
+}
+
+// corrupted sizes and index arrays are rejected before they are used
+void write_binary_content(const std::string& filename, const std::vector<char>& content)
+{
+  std::FILE* file = std::fopen(filename.c_str(), "wb");
+  std::fwrite(&content[0], 1, content.size(), file);
+  std::fclose(file);
+}
+
+void sparse_binary_io_corrupt()
+{
+  typedef SparseMatrix<double,ColMajor,int> SpMat;
+  const int rows = internal::random<int>(2,100), cols = internal::random<int>(2,100);
+  MatrixXd refMat = MatrixXd::Random(rows, cols);
+  refMat.row(0).setOnes();
+  SpMat m = refMat.sparseView();
+
+  std::string filename = "sparse_io_test.bin";
+  VERIFY(saveBinary(m, filename));
+  std::vector<char> content;
+  VERIFY(internal::read_market_file(filename, content));
+  internal::binary_sparse_header header;
+  std::memcpy(&header, &content[0], sizeof(header));
+  const std::size_t outerBytes = (cols+1)*sizeof(int);
+  int* outer = reinterpret_cast<int*>(&content[sizeof(header)]);
+  int* inner = reinterpret_cast<int*>(&content[sizeof(header) + outerBytes + internal::binary_sparse_header::padding(outerBytes)]);
+
+  SpMat m1 = m;
+  // sizes which do not fit in the index type, or arrays which do not fit in the file (the rows only size the inner indices)
+  const std::size_t wrongSizes[] = { std::size_t(NumTraits<int>::highest())+1, ~std::size_t(0), std::size_t(1)<<28 };
+  for(int k = 0; k < 3; ++k)
+  {
+    for(int s = 0; s < (k==0 ? 2 : 3); ++s)
+    {
+      internal::binary_sparse_header wrong = header;
+      wrong.setSize(k, wrongSizes[s]);
+      std::vector<char> corrupt(content);
+      std::memcpy(&corrupt[0], &wrong, sizeof(wrong));
+      write_binary_content(filename, corrupt);
+      VERIFY(!loadBinary(m1, filename));
+      VERIFY_IS_EQUAL(m1.rows(), 0);
+#if !defined(_WIN32)
+      MappedBinarySparseMatrix<double> map(filename);
+      VERIFY(!map.isValid());
+#endif
+      m1 = m;
+    }
+  }
+
+  // outer index array not starting at 0, or decreasing
+  std::vector<char> corrupt(content);
+  reinterpret_cast<int*>(&corrupt[sizeof(header)])[0] = 1;
+  write_binary_content(filename, corrupt);
+  VERIFY(!loadBinary(m1, filename));
+  VERIFY_IS_EQUAL(m1.nonZeros(), 0);
+  corrupt = content;
+  reinterpret_cast<int*>(&corrupt[sizeof(header)])[1] = outer[2] + 1;
+  write_binary_content(filename, corrupt);
+  VERIFY(!loadBinary(m1, filename));
+  VERIFY_IS_EQUAL(m1.nonZeros(), 0);
+
+  // inner indices out of range
+  const std::size_t p = internal::random<std::size_t>(0, m.nonZeros()-1);
+  const std::ptrdiff_t innerOffset = reinterpret_cast<char*>(inner) - &content[0];
+  corrupt = content;
+  reinterpret_cast<int*>(&corrupt[innerOffset])[p] = rows;
+  write_binary_content(filename, corrupt);
+  VERIFY(!loadBinary(m1, filename));
+  VERIFY_IS_EQUAL(m1.nonZeros(), 0);
+  corrupt = content;
+  reinterpret_cast<int*>(&corrupt[innerOffset])[p] = -1;
+  write_binary_content(filename, corrupt);
+  VERIFY(!loadBinary(m1, filename));
+  VERIFY_IS_EQUAL(m1.nonZeros(), 0);
+
+  // the untouched content is still valid
+  write_binary_content(filename, content);
+  VERIFY(loadBinary(m1, filename));
+  VERIFY_IS_APPROX(MatrixXd(m1), refMat);
+  std::remove(filename.c_str());
+}
+
+#if !defined(_WIN32)
+void sparse_market_iterator()
+{
+  typedef SparseMatrix<double> SpMat;
+  const int size = internal::random<int>(1,100);
+  MatrixXd refMat = MatrixXd::Zero(size, size);
+  SpMat m(size, size);
+  initSparse<double>(0.1, refMat, m);
+
+  std::string folder = "sparse_io_folder";
+  mkdir(folder.c_str(), 0755);
+  VERIFY(saveMarket(m, folder + "/A.mtx"));
+  int count = 0;
+  for(MatrixMarketIterator<double> it(folder); it; ++it, ++count)
+    VERIFY_IS_APPROX(MatrixXd(it.matrix()), refMat);
+  VERIFY_IS_EQUAL(count, 1);
+
+  // the binary copy is preferred, and is not listed as another matrix
+  SpMat m2 = m * 2.;
+  VERIFY(saveBinary(m2, folder + "/A.bin"));
+  count = 0;
+  for(MatrixMarketIterator<double> it(folder); it; ++it, ++count)
+    VERIFY_IS_APPROX(MatrixXd(it.matrix()), MatrixXd(refMat * 2.));
+  VERIFY_IS_EQUAL(count, 1);
+
+  std::remove((folder + "/A.mtx").c_str());
+  std::remove((folder + "/A.bin").c_str());
+  rmdir(folder.c_str());
+}
+#endif
+
+void test_sparse_io()
+{
+  for(int i = 0; i < g_repeat; i++)
+  {
+    CALL_SUBTEST_1( sparse_market_io<double>() );
+    CALL_SUBTEST_1( sparse_market_io<float>() );
+    CALL_SUBTEST_1( sparse_market_io<std::complex<double> >() );
+    CALL_SUBTEST_2(( sparse_binary_io<double,int>() ));
+    CALL_SUBTEST_2(( sparse_binary_io<float,long>() ));
+    CALL_SUBTEST_2(( sparse_binary_io<std::complex<double>,int>() ));
+    CALL_SUBTEST_2( sparse_binary_io_wide_outer() );
+    CALL_SUBTEST_2( sparse_binary_io_corrupt() );
+#if !defined(_WIN32)
+    CALL_SUBTEST_3( sparse_market_iterator() );
+#endif
+  }
+}